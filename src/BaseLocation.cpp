@@ -51,17 +51,9 @@ BaseLocation::BaseLocation(CCBot & bot, int baseID, const std::vector<Unit> & re
 		// pull the resource center toward the resource
 		resourceCenterX += resource.getPosition().x;
 		resourceCenterY += resource.getPosition().y;        
-
-        // set the limits of the base location bounding box
-        CCPositionType resWidth = Util::TileToPosition(1);
-        CCPositionType resHeight = Util::TileToPosition(0.5);
-
-        m_left   = std::min(m_left,   resource.getPosition().x - resWidth);
-        m_right  = std::max(m_right,  resource.getPosition().x + resWidth);
-        m_top    = std::max(m_top,    resource.getPosition().y + resHeight);
-        m_bottom = std::min(m_bottom, resource.getPosition().y - resHeight);
     }
 
+    ComputeBoundingBox(resources, m_left, m_right, m_top, m_bottom);
     m_centerOfResources = CCPosition(m_left + (m_right-m_left)/2, m_top + (m_bottom-m_top)/2);
 
 	for (auto & mineral : m_minerals)
@@ -133,8 +125,7 @@ BaseLocation::BaseLocation(CCBot & bot, int baseID, const std::vector<Unit> & re
 	const auto vectorAwayFromBase = Util::Normalized(getDepotPosition() - Util::GetPosition(getCenterOfMinerals()));
 	m_repairStationTilePosition = getDepotPosition() + vectorAwayFromBase * 4.f;
 
-	// also compute the distance map from the depot position
-	m_bot.Map().getDistanceMap(m_depotPosition);
+	// the distance map from the depot position is computed by the BaseLocationManager, with the ones of the other bases
 
 	//Determine if the geysers are together or split
 	if (m_geyserPositions.size() == 1)
@@ -602,6 +593,31 @@ const CCPosition & BaseLocation::getPosition() const
     return m_centerOfResources;
 }
 
+void BaseLocation::ComputeBoundingBox(const std::vector<Unit> & resources, CCPositionType & left, CCPositionType & right, CCPositionType & top, CCPositionType & bottom)
+{
+    for (auto & resource : resources)
+    {
+        // set the limits of the base location bounding box
+        CCPositionType resWidth = Util::TileToPosition(1);
+        CCPositionType resHeight = Util::TileToPosition(0.5);
+
+        left   = std::min(left,   resource.getPosition().x - resWidth);
+        right  = std::max(right,  resource.getPosition().x + resWidth);
+        top    = std::max(top,    resource.getPosition().y + resHeight);
+        bottom = std::min(bottom, resource.getPosition().y - resHeight);
+    }
+}
+
+CCPosition BaseLocation::GetCenterOfResources(const std::vector<Unit> & resources)
+{
+    CCPositionType left = std::numeric_limits<CCPositionType>::max();
+    CCPositionType right = std::numeric_limits<CCPositionType>::lowest();
+    CCPositionType top = std::numeric_limits<CCPositionType>::lowest();
+    CCPositionType bottom = std::numeric_limits<CCPositionType>::max();
+    ComputeBoundingBox(resources, left, right, top, bottom);
+    return CCPosition(left + (right-left)/2, top + (bottom-top)/2);
+}
+
 int BaseLocation::getGroundDistance(const CCPosition & pos) const
 {
     return m_distanceMap.getDistance(pos);
@@ -51,8 +51,13 @@ class BaseLocation
 	bool						m_snapshotsRemoved = false;
 
 	const int ApproximativeBaseLocationTileDistance = 30;
+
+    static void ComputeBoundingBox(const std::vector<Unit> & resources, CCPositionType & left, CCPositionType & right, CCPositionType & top, CCPositionType & bottom);
 public:
     BaseLocation(CCBot & bot, int baseID, const std::vector<Unit> & resources);
+
+    // Center of the distance map of the base, known before the base is created
+    static CCPosition GetCenterOfResources(const std::vector<Unit> & resources);
     
     int getGroundDistance(const CCPosition & pos) const;
     int getGroundDistance(const CCTilePosition & pos) const;
@@ -2,6 +2,7 @@
 #include "Util.h"
 
 #include "CCBot.h"
+#include "libvoxelbot/utilities/thread_pool.h"
 
 BaseLocationManager::BaseLocationManager(CCBot & bot)
     : m_bot(bot)
@@ -10,7 +11,7 @@ BaseLocationManager::BaseLocationManager(CCBot & bot)
     
 }
 
-void BaseLocationManager::onStart()
+void BaseLocationManager::onStart(ThreadPool & pool)
 {
     m_tileBaseLocations = std::vector<std::vector<BaseLocation *>>(m_bot.Map().totalWidth(), std::vector<BaseLocation *>(m_bot.Map().totalHeight(), nullptr));
     m_playerStartingBaseLocations[Players::Self]  = nullptr;
@@ -104,7 +105,7 @@ void BaseLocationManager::onStart()
 	m_bot.Commander().Combat().updateBlockedTilesWithNeutral();
 
 	// add the base locations if there are more than 6 resouces in the cluster
-    int baseID = 0;
+	std::vector<const std::vector<Unit> *> baseClusters;
     for (auto & cluster : resourceClusters)
     {
         if (cluster.size() > 6)
@@ -119,10 +120,25 @@ void BaseLocationManager::onStart()
 				}
 			}
         	if (hasGeyser)
-				m_baseLocationData.push_back(BaseLocation(m_bot, baseID++, cluster));
+				baseClusters.push_back(&cluster);
         }
     }
 
+	// the distance maps of the bases are computed in parallel before the bases need them
+	std::vector<CCTilePosition> distanceMapTiles;
+	for (const auto cluster : baseClusters)
+		distanceMapTiles.push_back(Util::GetTilePosition(BaseLocation::GetCenterOfResources(*cluster)));
+	m_bot.Map().precomputeDistanceMaps(distanceMapTiles, pool);
+
+    int baseID = 0;
+	for (const auto cluster : baseClusters)
+		m_baseLocationData.push_back(BaseLocation(m_bot, baseID++, *cluster));
+
+	distanceMapTiles.clear();
+	for (const auto & baseLocation : m_baseLocationData)
+		distanceMapTiles.push_back(Util::GetTilePosition(baseLocation.getDepotPosition()));
+	m_bot.Map().precomputeDistanceMaps(distanceMapTiles, pool);
+
     // construct the vectors of base location pointers, this is safe since they will never change
     for (auto & baseLocation : m_baseLocationData)
     {
@@ -150,11 +166,13 @@ void BaseLocationManager::onStart()
 		Util::DisplayError("Invalid setup detected.", "0x0000000", m_bot);
 	}
 
-    // construct the map of tile positions to base locations
+    // construct the map of tile positions to base locations, the columns are independent but the tiles are added to the bases in order afterwards
 	const CCPosition mapMin = m_bot.Map().mapMin();
 	const CCPosition mapMax = m_bot.Map().mapMax();
-    for (int x = mapMin.x; x < mapMax.x; ++x)
+	std::vector<std::vector<std::pair<BaseLocation *, CCTilePosition>>> columnBaseTiles(int(mapMax.x - mapMin.x));
+	pool.parallelFor(int(mapMax.x - mapMin.x), [&](int column)
     {
+		const int x = int(mapMin.x) + column;
         for (int y = mapMin.y; y < mapMax.y; ++y)
         {
 			float minDistance = 0.f;
@@ -191,11 +209,16 @@ void BaseLocationManager::onStart()
 				{
 					minDistance = groundDistanceSq;//to be able to use DistSq above
 					m_tileBaseLocations[x][y] = &base;
-					base.addBaseTile(CCTilePosition(x, y));
+					columnBaseTiles[column].push_back(std::make_pair(&base, CCTilePosition(x, y)));
 				}
 			}
         }
-    }
+    });
+	for (const auto & baseTiles : columnBaseTiles)
+	{
+		for (const auto & baseTile : baseTiles)
+			baseTile.first->addBaseTile(baseTile.second);
+	}
 
 	// extend the base tiles 1 tile further because some tiles at the edges of bases are not identified
 	std::vector<std::pair<std::pair<int, int>, BaseLocation*>> newBaseLocationTiles;
@@ -275,9 +298,9 @@ bool BaseLocationManager::affectToCluster(std::vector<std::vector<Unit>> & resou
 
 void BaseLocationManager::onFrame()
 {
-	m_bot.StartProfiling("0.6.0   drawBaseLocations");
+	PROFILE_BEGIN("drawBaseLocations");
     drawBaseLocations();
-	m_bot.StopProfiling("0.6.0   drawBaseLocations");
+	PROFILE_END("drawBaseLocations");
 
 	drawTileBaseLocationAssociations();
 
@@ -285,12 +308,12 @@ void BaseLocationManager::onFrame()
 
 	if (m_bot.Bases().getPlayerStartingBaseLocation(Players::Self) == nullptr)
 	{
-		m_bot.StartProfiling("0.6.1   FixNullPlayerStartingBaseLocation");
+		PROFILE_BEGIN("FixNullPlayerStartingBaseLocation");
 		FixNullPlayerStartingBaseLocation();
-		m_bot.StopProfiling("0.6.1   FixNullPlayerStartingBaseLocation");
+		PROFILE_END("FixNullPlayerStartingBaseLocation");
 	}
 
-	m_bot.StartProfiling("0.6.2   resetBaseLocations");
+	PROFILE_BEGIN("resetBaseLocations");
     // reset the player occupation information for each location
     for (auto & baseLocation : m_baseLocationData)
     {
@@ -299,9 +322,9 @@ void BaseLocationManager::onFrame()
 		baseLocation.clearGasBunkers();
         baseLocation.setPlayerOccupying(Players::Enemy, false);
     }
-	m_bot.StopProfiling("0.6.2   resetBaseLocations");
+	PROFILE_END("resetBaseLocations");
 
-	m_bot.StartProfiling("0.6.3   updateBaseLocations");
+	PROFILE_BEGIN("updateBaseLocations");
     // for each unit on the map, update which base location it may be occupying
 	for (const auto & unitPair : m_bot.GetAllyUnits())
 	{
@@ -336,9 +359,9 @@ void BaseLocationManager::onFrame()
 			}
 		}
     }
-	m_bot.StopProfiling("0.6.3   updateBaseLocations");
+	PROFILE_END("updateBaseLocations");
 
-	m_bot.StartProfiling("0.6.4   updateEnemyBaseLocations");
+	PROFILE_BEGIN("updateEnemyBaseLocations");
     // update enemy base occupations
     /*for (const auto & kv : m_bot.UnitInfo().getUnitInfoMap(Players::Enemy))
     {
@@ -395,7 +418,7 @@ void BaseLocationManager::onFrame()
 			}
 		}
 	}
-	m_bot.StopProfiling("0.6.4   updateEnemyBaseLocations");
+	PROFILE_END("updateEnemyBaseLocations");
 
     // update the starting locations of the enemy player
     // this will happen one of two ways:
@@ -403,7 +426,7 @@ void BaseLocationManager::onFrame()
     // 1. we've seen the enemy base directly, so the baselocation will know
     if (m_playerStartingBaseLocations[Players::Enemy] == nullptr)
     {
-		m_bot.StartProfiling("0.6.5   updateEnemyStartingBaseLocation");
+		PROFILE_BEGIN("updateEnemyStartingBaseLocation");
         for (auto & baseLocation : m_baseLocationData)
         {
             if (baseLocation.isPlayerStartLocation(Players::Enemy))
@@ -411,13 +434,13 @@ void BaseLocationManager::onFrame()
                 m_playerStartingBaseLocations[Players::Enemy] = &baseLocation;
             }
         }
-		m_bot.StopProfiling("0.6.5   updateEnemyStartingBaseLocation");
+		PROFILE_END("updateEnemyStartingBaseLocation");
     }
 
     // 2. we've explored every other start location and haven't seen the enemy yet
     if (m_playerStartingBaseLocations[Players::Enemy] == nullptr)
     {
-		m_bot.StartProfiling("0.6.6   updateEnemyStartingBaseLocation2");
+		PROFILE_BEGIN("updateEnemyStartingBaseLocation2");
         int numStartLocations = (int)getStartingBaseLocations().size();
         int numExploredLocations = 0;
         BaseLocation * unexplored = nullptr;
@@ -445,10 +468,10 @@ void BaseLocationManager::onFrame()
             m_playerStartingBaseLocations[Players::Enemy] = unexplored;
             unexplored->setPlayerOccupying(Players::Enemy, true);
         }
-		m_bot.StopProfiling("0.6.6   updateEnemyStartingBaseLocation2");
+		PROFILE_END("updateEnemyStartingBaseLocation2");
     }
 
-	m_bot.StartProfiling("0.6.7   setOccupiedBaseLocations");
+	PROFILE_BEGIN("setOccupiedBaseLocations");
     // update the occupied base locations for each player
     m_occupiedBaseLocations[Players::Self] = std::set<BaseLocation *>();
     m_occupiedBaseLocations[Players::Enemy] = std::set<BaseLocation *>();
@@ -464,7 +487,7 @@ void BaseLocationManager::onFrame()
             m_occupiedBaseLocations[Players::Enemy].insert(&baseLocation);
         }
     }
-	m_bot.StopProfiling("0.6.7   setOccupiedBaseLocations");
+	PROFILE_END("setOccupiedBaseLocations");
 
 	if(!m_areBaseLocationPtrsSorted && m_playerStartingBaseLocations[Players::Enemy] != nullptr)
 	{
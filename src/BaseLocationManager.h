@@ -3,6 +3,7 @@
 #include "BaseLocation.h"
 
 class CCBot;
+struct ThreadPool;
 
 class BaseLocationManager
 {
@@ -28,7 +29,7 @@ public:
 
     BaseLocationManager(CCBot & bot);
     
-    void onStart();
+    void onStart(ThreadPool & pool);
 	bool affectToCluster(std::vector<std::vector<Unit>> & resourceClusters, Unit & resource, float maxDistanceWithCluster) const;
     void onFrame();
     void drawBaseLocations();
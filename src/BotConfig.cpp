@@ -53,10 +53,15 @@ BotConfig::BotConfig()
 	DrawUnitActions = false;
 	DrawResourcesProximity = false;
 	DrawCombatInformation = false;
+	BenchmarkPathfinding = false;
+	RecordTrace = false;
+	RecordSnapshots = false;
+	StepLatencyBudget = 40;
 	TimeControl = false;
 
     KiteWithRangedUnits = true;
     ScoutHarassEnemy = true;
+	OptimizeBuildOrder = false;
     MaxTargetDistance = 25.0f;
     MaxWorkerRepairDistance = 20.0f;
 
@@ -178,6 +183,7 @@ void BotConfig::readConfigFile()
 		JSONTools::ReadBool("RandomProxyLocation", macro, RandomProxyLocation);
 		JSONTools::ReadInt("ProductionPrintFrequency", macro, ProductionPrintFrequency);
 		JSONTools::ReadInt("LogFrameDurationThreshold", macro, LogFrameDurationThreshold);
+		JSONTools::ReadInt("StepLatencyBudget", macro, StepLatencyBudget);
     }
 
     // Parse the Debug Options
@@ -186,6 +192,16 @@ void BotConfig::readConfigFile()
         const json & debug = j["Debug"];
 		const json & info = j["SC2API"];
 		JSONTools::ReadBool("AllowDebug", debug, AllowDebug);
+		JSONTools::ReadBool("RecordTrace", debug, RecordTrace);
+		JSONTools::ReadBool("RecordSnapshots", debug, RecordSnapshots);
+		if (debug.count("LogLevels") && debug["LogLevels"].is_object())
+		{
+			for (auto it = debug["LogLevels"].begin(); it != debug["LogLevels"].end(); ++it)
+			{
+				if (it.value().is_string())
+					LogLevels[it.key()] = it.value().get<std::string>();
+			}
+		}
 		if (AllowDebug)
 		{
 			JSONTools::ReadBool("AllowKeyControl", debug, AllowKeyControl);
@@ -229,6 +245,7 @@ void BotConfig::readConfigFile()
 			JSONTools::ReadBool("DrawCurrentStartingStrategy", debug, DrawCurrentStartingStrategy);
 			JSONTools::ReadBool("DrawMainBaseSiegePositions", debug, DrawMainBaseSiegePositions);
 			JSONTools::ReadBool("LogArmyActions", debug, LogArmyActions);
+			JSONTools::ReadBool("BenchmarkPathfinding", debug, BenchmarkPathfinding);
 		}
     }
 
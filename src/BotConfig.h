@@ -71,11 +71,16 @@ public:
 	bool DrawCurrentStartingStrategy;
 	bool DrawMainBaseSiegePositions;
 	bool LogArmyActions;
+	bool BenchmarkPathfinding;
+	bool RecordTrace;
+	bool RecordSnapshots;
+	std::map<std::string, std::string> LogLevels;	// minimum severity logged by category (function name), "Default" for the others
 	bool TimeControl;
 	bool PrintGreetingMessage;
 	bool RandomProxyLocation;
 	int ProductionPrintFrequency;
 	int LogFrameDurationThreshold;
+	int StepLatencyBudget;
     
     CCColor ColorLineTarget;
     CCColor ColorLineMineral;
@@ -87,6 +92,7 @@ public:
     float MaxWorkerRepairDistance;
     bool ScoutHarassEnemy;
 	bool AutoCompleteBuildOrder;
+	bool OptimizeBuildOrder;
 	bool NoScoutOn2PlayersMap;
 
     bool AlphaBetaPruning;
@@ -0,0 +1,136 @@
+#include "BuildOrderOptimizer.h"
+#include "CCBot.h"
+#include "Util.h"
+#include "libvoxelbot/buildorder/optimizer.h"
+#include "libvoxelbot/common/unit_lists.h"
+#include "libvoxelbot/utilities/mappings.h"
+
+namespace
+{
+	const uint32_t BUILD_ORDER_OPTIMIZER_FREQUENCY = 112;		// 5 seconds between two optimizations
+	const uint32_t BUILD_ORDER_SUGGESTION_MAX_AGE = 112;		// the queue changed too much for older suggestions to be relevant
+	const double BUILD_ORDER_OPTIMIZER_TIME_BUDGET = 200.0;		// milliseconds spent by the background thread on a single optimization
+	const int BUILD_ORDER_OPTIMIZER_ITERATIONS = 4096;			// upper bound, the time budget usually stops the optimizer before
+}
+
+BuildOrderOptimizer::BuildOrderOptimizer(CCBot & bot)
+	: m_bot(bot)
+{
+}
+
+BuildOrderOptimizer::~BuildOrderOptimizer()
+{
+	// The optimizer stops by itself once its time budget is spent
+	if (m_job.valid())
+		m_job.wait();
+}
+
+void BuildOrderOptimizer::onStart()
+{
+	// The mappings of libvoxelbot are initialized with the combat simulator, on its own thread, the first optimization waits for them
+	m_initialized = true;
+}
+
+BuildOrderOptimizer::OptimizationResult BuildOrderOptimizer::Optimize(const libvoxelbot::BuildState & startState, const std::vector<sc2::UNIT_TYPEID> & queue)
+{
+	// The target is what we will have once everything in progress is finished plus the queued items,
+	// counted the same way the optimizer computes its requirements
+	libvoxelbot::BuildState finalState = startState;
+	finalState.simulate(finalState.time + 1000000);
+
+	libvoxelbot::BuildOrder queueOrder;
+	std::vector<std::pair<libvoxelbot::BuildOrderItem, int>> target;
+	for (const auto type : queue)
+	{
+		const libvoxelbot::BuildOrderItem item(type);
+		queueOrder.items.push_back(item);
+		auto it = std::find_if(target.begin(), target.end(), [&item](const std::pair<libvoxelbot::BuildOrderItem, int> & count) { return count.first == item; });
+		if (it != target.end())
+		{
+			++it->second;
+			continue;
+		}
+		int count = 1;
+		for (const auto & unit : finalState.units)
+		{
+			if (unit.type == type || getUnitData(unit.type).unit_alias == type)
+				count += unit.units;
+		}
+		target.emplace_back(item, count);
+	}
+
+	BuildOptimizerParams params;
+	params.iterations = BUILD_ORDER_OPTIMIZER_ITERATIONS;
+	params.maxMillis = BUILD_ORDER_OPTIMIZER_TIME_BUDGET;
+	// Leave half of the cores to the game and to the bot
+	params.threadCount = std::max(1, int(std::thread::hardware_concurrency()) / 2);
+	params.allowChronoBoost = startState.race == sc2::Race::Protoss;
+	FitnessCacheStats cacheStats;
+	params.cacheStats = &cacheStats;
+	const auto optimized = findBestBuildOrderGeneticWithFitness(startState, target, &queueOrder, params);
+	const auto queueFitness = calculateFitness(startState, queueOrder);
+
+	OptimizationResult result;
+	result.queueTime = queueFitness.time;
+	result.optimizedTime = optimized.second.time;
+	result.improved = queueFitness < optimized.second;
+	result.cacheHitRate = cacheStats.hitRate();
+	result.cacheMemory = cacheStats.memoryBytes;
+	for (const auto & item : optimized.first.items)
+	{
+		if (item.isUnitType())
+			result.order.push_back(item.typeID());
+	}
+	return result;
+}
+
+void BuildOrderOptimizer::update(const std::vector<MetaType> & queue)
+{
+	const auto currentFrame = m_bot.GetCurrentFrame();
+	if (!m_initialized || !Util::IsCombatSimulatorReady() || m_job.valid() || currentFrame - m_lastJobFrame < BUILD_ORDER_OPTIMIZER_FREQUENCY)
+		return;
+
+	// Only the units known by the optimizer can be reordered, the other items (upgrades, tech) keep their place in the queue
+	const auto race = m_bot.GetSelfRace();
+	const auto & availableUnitTypes = getAvailableUnitsForRace(race, UnitCategory::BuildOrderOptions);
+	std::vector<sc2::UNIT_TYPEID> queuedUnits;
+	for (const auto & type : queue)
+	{
+		if (!type.isUnit())
+			continue;
+		const sc2::UNIT_TYPEID unitType = type.getUnitType().getAPIUnitType();
+		if (availableUnitTypes.contains(unitType))
+			queuedUnits.push_back(unitType);
+	}
+	if (queuedUnits.size() < 2)
+		return;
+
+	// The state is captured on the game thread, the background thread only works on its own copy
+	const float time = currentFrame / 22.4f;
+	const libvoxelbot::BuildState startState(m_bot.APIObservation(), sc2::Unit::Alliance::Self, race, BuildResources(float(m_bot.GetMinerals()), float(m_bot.GetGas())), time);
+	m_job = std::async(std::launch::async, &BuildOrderOptimizer::Optimize, startState, queuedUnits);
+	m_jobFrame = currentFrame;
+	m_lastJobFrame = currentFrame;
+}
+
+bool BuildOrderOptimizer::getSuggestion(std::vector<MetaType> & suggestion)
+{
+	if (!m_job.valid() || m_job.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		return false;
+
+	const auto result = m_job.get();
+	const auto age = m_bot.GetCurrentFrame() - m_jobFrame;
+	if (!result.improved || age > BUILD_ORDER_SUGGESTION_MAX_AGE)
+		return false;
+
+	suggestion.clear();
+	for (const auto type : result.order)
+	{
+		if (type != sc2::UNIT_TYPEID::TERRAN_MULE)
+			suggestion.push_back(MetaType(UnitType(type, m_bot), m_bot));
+	}
+	std::stringstream ss;
+	ss << "Optimized build order found in " << age << " frames: " << result.queueTime << "s -> " << result.optimizedTime << "s (cache hit rate " << int(result.cacheHitRate * 100) << "%, " << result.cacheMemory / 1024 << "KB)";
+	Util::Log(__FUNCTION__, ss.str(), m_bot);
+	return true;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "Common.h"
+#include "MetaType.h"
+#include <future>
+
+class CCBot;
+namespace libvoxelbot { struct BuildState; }
+
+// Runs the genetic build order optimizer of libvoxelbot in the background.
+// The state of our economy is captured on the game thread, the optimizer then searches a better ordering of the
+// production queue on another thread within a time budget and the result is only picked up once it is ready,
+// so a step never waits for it.
+class BuildOrderOptimizer
+{
+	struct OptimizationResult
+	{
+		std::vector<sc2::UNIT_TYPEID> order;	// optimized order, including the implicit steps (workers, supply, requirements)
+		float queueTime = 0.f;					// simulated time to complete the queue in its current order
+		float optimizedTime = 0.f;				// simulated time to complete the optimized order
+		bool improved = false;
+		float cacheHitRate = 0.f;				// evaluations that reused the simulation of a build order prefix
+		size_t cacheMemory = 0;					// bytes used by the simulation cache of the optimizer
+	};
+
+	CCBot & m_bot;
+	bool m_initialized = false;
+	std::future<OptimizationResult> m_job;
+	uint32_t m_jobFrame = 0;
+	uint32_t m_lastJobFrame = 0;
+
+	static OptimizationResult Optimize(const libvoxelbot::BuildState & startState, const std::vector<sc2::UNIT_TYPEID> & queue);
+
+public:
+
+	BuildOrderOptimizer(CCBot & bot);
+	~BuildOrderOptimizer();
+
+	void onStart();
+
+	// Starts a new optimization of the queue (highest priority first) when none is running and the last one is old enough
+	void update(const std::vector<MetaType> & queue);
+
+	// Returns true and fills the suggested order when an optimization found a better ordering of the queue since the last call
+	bool getSuggestion(std::vector<MetaType> & suggestion);
+};
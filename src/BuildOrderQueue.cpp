@@ -1,55 +1,74 @@
 #include "BuildOrderQueue.h"
 #include "CCBot.h"
-#include <list>
 
 BuildOrderQueue::BuildOrderQueue(CCBot & bot)
     : m_bot(bot)
-    , m_highestPriority(0)
-    , m_lowestPriority(0)
+    , m_currentItem(m_queue.end())
+    , m_currentItemRemoved(false)
     , m_defaultPrioritySpacing(10)
-    , m_numSkippedItems(0)
 {
 
 }
 
+int & BuildOrderQueue::getTypeCount(const MetaType & type)
+{
+	// same as contains, the units are matched by API type and the other items by upgrade
+	const auto unitType = type.getUnitType().getAPIUnitType();
+	if (unitType != 0)
+		return m_unitTypeCounts[unitType];
+	return m_upgradeCounts[type.getUpgrade()];
+}
+
+int BuildOrderQueue::getTypeCount(const MetaType & type) const
+{
+	const auto unitType = type.getUnitType().getAPIUnitType();
+	if (unitType != 0)
+	{
+		const auto it = m_unitTypeCounts.find(unitType);
+		return it == m_unitTypeCounts.end() ? 0 : it->second;
+	}
+	const auto it = m_upgradeCounts.find(type.getUpgrade());
+	return it == m_upgradeCounts.end() ? 0 : it->second;
+}
+
+void BuildOrderQueue::eraseItem(Items::iterator it)
+{
+	--getTypeCount(it->type);
+	if (it == m_currentItem)
+		m_currentItem = m_queue.end();
+	m_queue.erase(it);
+}
+
 void BuildOrderQueue::clearAll()
 {
     // clear the queue
     m_queue.clear();
-
-    // reset the priorities
-    m_highestPriority = 0;
-    m_lowestPriority = 0;
+    m_unitTypeCounts.clear();
+    m_upgradeCounts.clear();
+    m_currentItem = m_queue.end();
+    m_currentItemRemoved = false;
 }
 
-MM::BuildOrderItem BuildOrderQueue::getHighestPriorityItem()
+const MM::BuildOrderItem & BuildOrderQueue::getHighestPriorityItem()
 {
-    // reset the number of skipped items to zero
-    m_numSkippedItems = 0;
+    assert(!m_queue.empty());
 
-    // the queue will be sorted with the highest priority at the back
-    return m_queue.back();
+    // reset the skipped items, the queue is sorted with the highest priority at the back
+    m_currentItem = std::prev(m_queue.end());
+    m_currentItemRemoved = false;
+    return *m_currentItem;
 }
 
-MM::BuildOrderItem BuildOrderQueue::getNextHighestPriorityItem()
+const MM::BuildOrderItem & BuildOrderQueue::getNextHighestPriorityItem()
 {
-    assert(m_queue.size() - 1 - m_numSkippedItems >= 0);
+    assert(m_currentItem != m_queue.end());
 
-    // the queue will be sorted with the highest priority at the back
-    return m_queue[m_queue.size() - 1 - m_numSkippedItems];
+    return *m_currentItem;
 }
 
-int BuildOrderQueue::getCountOfType(const MetaType & type)
+int BuildOrderQueue::getCountOfType(const MetaType & type) const
 {
-	int count = 0;
-	for (auto item : m_queue)
-	{
-		if (item.type.getUnitType() == type.getUnitType())
-		{
-			count++;
-		}
-	}
-	return count;
+	return getTypeCount(type);
 }
 
 void BuildOrderQueue::skipItem()
@@ -57,149 +76,161 @@ void BuildOrderQueue::skipItem()
     // make sure we can skip
     assert(canSkipItem());
 
-    // skip it
-    m_numSkippedItems++;
+    // the item below a removed item has not been considered yet
+    if (m_currentItemRemoved)
+        m_currentItemRemoved = false;
+    else
+        --m_currentItem;
 }
 
-bool BuildOrderQueue::canSkipItem()
+bool BuildOrderQueue::canSkipItem() const
 {
-    // does the queue have more elements
-    bool bigEnough = m_queue.size() > (size_t)(1 + m_numSkippedItems);
+    // a removed item does not block the next one
+    if (m_currentItemRemoved)
+        return m_currentItem != m_queue.end();
 
-    if (!bigEnough)
+    // does the queue have more elements
+    if (m_currentItem == m_queue.end() || m_currentItem == m_queue.begin())
     {
         return false;
     }
-	
-    // is the current highest priority item not blocking a skip
-    bool highestNotBlocking = !m_queue[m_queue.size() - 1 - m_numSkippedItems].blocking;
 
-    // this tells us if we can skip
-    return highestNotBlocking;
+    // is the current highest priority item not blocking a skip
+    return !m_currentItem->blocking;
 }
 
-MM::BuildOrderItem BuildOrderQueue::queueItem(const MM::BuildOrderItem & b)
+const MM::BuildOrderItem & BuildOrderQueue::queueItem(const MM::BuildOrderItem & b)
 {
-    // if the queue is empty, set the highest and lowest priorities
-    if (m_queue.empty())
-    {
-        m_highestPriority = b.priority;
-        m_lowestPriority = b.priority;
-    }
-
-    // push the item into the queue
-    if (b.priority <= m_lowestPriority)
-    {
-        m_queue.push_front(b);
-    }
-    else
-    {
-        m_queue.push_back(b);
-    }
+    ++getTypeCount(b.type);
 
-    // if the item is somewhere in the middle, we have to sort again
-    if ((m_queue.size() > 1) && (b.priority < m_highestPriority) && (b.priority > m_lowestPriority))
+    // an item with the same priority as the lowest one goes below it, otherwise above the items with the same priority
+    if (!m_queue.empty() && b.priority <= m_queue.begin()->priority)
     {
-        // sort the list in ascending order, putting highest priority at the top
-        std::sort(m_queue.begin(), m_queue.end());
+        return *m_queue.insert(m_queue.begin(), b);
     }
-
-    // update the highest or lowest if it is beaten
-    m_highestPriority = (b.priority > m_highestPriority) ? b.priority : m_highestPriority;
-    m_lowestPriority  = (b.priority < m_lowestPriority)  ? b.priority : m_lowestPriority;
-
-	return b;
+    return *m_queue.insert(b);
 }
 
-MM::BuildOrderItem BuildOrderQueue::queueAsHighestPriority(const MetaType & type, bool blocking)
+const MM::BuildOrderItem & BuildOrderQueue::queueAsHighestPriority(const MetaType & type, bool blocking)
 {
     // the new priority will be higher
-    int newPriority = m_highestPriority + m_defaultPrioritySpacing;
+    int newPriority = getHighestPriority() + m_defaultPrioritySpacing;
 
-	MM::BuildOrderItem item(type, newPriority, blocking);
     // queue the item
-    queueItem(item);
-
-	return item;
+    return queueItem(MM::BuildOrderItem(type, newPriority, blocking));
 }
 
-MM::BuildOrderItem BuildOrderQueue::queueAsLowestPriority(const MetaType & type, bool blocking)
+const MM::BuildOrderItem & BuildOrderQueue::queueAsLowestPriority(const MetaType & type, bool blocking)
 {
-    // the new priority will be higher
-    int newPriority = m_lowestPriority - m_defaultPrioritySpacing;
+    // the new priority will be lower
+    int newPriority = getLowestPriority() - m_defaultPrioritySpacing;
 
-	MM::BuildOrderItem item(type, newPriority, blocking);
 	// queue the item
-	queueItem(item);
-
-	return item;
+	return queueItem(MM::BuildOrderItem(type, newPriority, blocking));
 }
 
 void BuildOrderQueue::removeHighestPriorityItem()
 {
-    // remove the back element of the vector
-    m_queue.pop_back();
-
-    // if the list is not empty, set the highest accordingly
-    m_highestPriority = m_queue.empty() ? 0 : m_queue.back().priority;
-    m_lowestPriority  = m_queue.empty() ? 0 : m_lowestPriority;
+    // remove the back element of the queue
+    eraseItem(std::prev(m_queue.end()));
 }
 
 void BuildOrderQueue::removeCurrentHighestPriorityItem()
 {
-    // remove the back element of the vector
-    m_queue.erase(m_queue.begin() + m_queue.size() - 1 - m_numSkippedItems);
+    assert(m_currentItem != m_queue.end() && !m_currentItemRemoved);
+
+    // the next item to consider is the one right below the removed item
+    const auto removedItem = m_currentItem;
+    const auto nextItem = removedItem == m_queue.begin() ? m_queue.end() : std::prev(removedItem);
+    eraseItem(removedItem);
+    m_currentItem = nextItem;
+    m_currentItemRemoved = true;
+}
 
-    //assert((int)(queue.size()) < size);
+void BuildOrderQueue::removeAllOfType(const MetaType & type)
+{
+	if (getTypeCount(type) == 0)
+		return;
 
-    // if the list is not empty, set the highest accordingly
-    m_highestPriority = m_queue.empty() ? 0 : m_queue.back().priority;
-    m_lowestPriority  = m_queue.empty() ? 0 : m_lowestPriority;
+	for (auto it = m_queue.begin(); it != m_queue.end();)
+	{
+		if (it->type == type)
+			eraseItem(it++);
+		else
+			++it;
+	}
 }
 
-void BuildOrderQueue::removeAllOfType(const MetaType & type)
+void BuildOrderQueue::reorder(const std::vector<MetaType> & order)
 {
-	std::list<int> stack;
-	for (int i = 0; i < m_queue.size(); i++)
+	// each type of the order takes the next matching item, blocking items are left where they are
+	std::vector<Items::iterator> reordered;
+	for (const auto & type : order)
 	{
-		if (m_queue[i].type == type)
+		if (getTypeCount(type) == 0)
+			continue;
+		for (auto it = m_queue.rbegin(); it != m_queue.rend(); ++it)
 		{
-			stack.push_front(i);
+			const auto item = std::prev(it.base());
+			if (!item->blocking && item->type == type && std::find(reordered.begin(), reordered.end(), item) == reordered.end())
+			{
+				reordered.push_back(item);
+				break;
+			}
 		}
 	}
-	for(int index : stack)
+
+	// the matched items keep the same slots (and priorities) in the queue, only who gets which slot changes
+	std::vector<MM::BuildOrderItem> items;
+	std::vector<int> priorities;
+	for (const auto item : reordered)
 	{
-		m_queue.erase(m_queue.begin() + index);
+		items.push_back(*item);
+		priorities.push_back(item->priority);
+	}
+	std::sort(priorities.begin(), priorities.end(), std::greater<int>());
+	for (const auto item : reordered)
+	{
+		eraseItem(item);
+	}
+	for (size_t i = 0; i < items.size(); ++i)
+	{
+		items[i].priority = priorities[i];
+		queueItem(items[i]);
 	}
 }
 
-size_t BuildOrderQueue::size()
+size_t BuildOrderQueue::size() const
 {
     return m_queue.size();
 }
 
-bool BuildOrderQueue::isEmpty()
+bool BuildOrderQueue::isEmpty() const
+{
+    return m_queue.empty();
+}
+
+int BuildOrderQueue::getHighestPriority() const
 {
-    return (m_queue.size() == 0);
+    return m_queue.empty() ? 0 : m_queue.rbegin()->priority;
 }
 
-MM::BuildOrderItem BuildOrderQueue::operator [] (int i)
+int BuildOrderQueue::getLowestPriority() const
 {
-    return m_queue[i];
+    return m_queue.empty() ? 0 : m_queue.begin()->priority;
 }
 
 std::string BuildOrderQueue::getQueueInformation() const
 {
-    size_t reps = m_queue.size() < 30 ? m_queue.size() : 30;
     std::stringstream ss;
 
-    // for each unit in the queue
-    for (size_t i(0); i<reps; i++)
+    // for each of the 30 highest priority items in the queue
+    int reps = 0;
+    for (auto it = begin(); it != end() && reps < 30; ++it, ++reps)
     {
-		auto item = m_queue[m_queue.size() - 1 - i];
-        const MetaType & type = item.type;
-		ss << type.getName() << std::setw(30 - item.type.getName().length()) << std::right << " [" << item.priority << "]";
-		if (item.blocking)
+        const MetaType & type = it->type;
+		ss << type.getName() << std::setw(30 - type.getName().length()) << std::right << " [" << it->priority << "]";
+		if (it->blocking)
 		{
 			ss << " (B)";
 		}
@@ -211,24 +242,7 @@ std::string BuildOrderQueue::getQueueInformation() const
 
 bool BuildOrderQueue::contains(const MetaType & type) const
 {
-	auto it = m_queue.begin();
-	while (it != m_queue.end())
-	{
-		auto itType = (*it++).type;
-		auto itTypeApi = itType.getUnitType().getAPIUnitType();
-		if (itTypeApi == 0)
-		{//If it isn't a Unit, check the metatype
-			if (type == itType)
-			{
-				return true;
-			}
-		}
-		else if (type.getUnitType().getAPIUnitType() == itTypeApi)
-		{
-			return true;
-		}
-	}
-	return false;
+	return getTypeCount(type) > 0;
 }
 
 
@@ -2,6 +2,7 @@
 
 #include "Common.h"
 #include "MetaType.h"
+#include <map>
 
 class CCBot;
 
@@ -19,40 +20,55 @@ namespace MM {
 	};
 }
 
+// The items are kept sorted by priority in a tree, so queueing and removing an item is O(log n) and the references to the
+// queued items stay valid until they are removed. The number of queued items of each type is indexed for contains.
 class BuildOrderQueue
 {
+    typedef std::multiset<MM::BuildOrderItem> Items;
+
     CCBot & m_bot;
-    std::deque<MM::BuildOrderItem> m_queue;
+    Items m_queue;									// highest priority last
+    std::map<sc2::UnitTypeID, int> m_unitTypeCounts;
+    std::map<CCUpgrade, int> m_upgradeCounts;
+    Items::iterator m_currentItem;					// item considered by the production loop, skipped items are above it
+    bool m_currentItemRemoved;						// the considered item was removed, m_currentItem is the next one to consider
 
-    int m_lowestPriority;
-    int m_highestPriority;
     int m_defaultPrioritySpacing;
-    int m_numSkippedItems;
+
+    int & getTypeCount(const MetaType & type);
+    int getTypeCount(const MetaType & type) const;
+    void eraseItem(Items::iterator it);
 
 public:
 
+    typedef Items::const_reverse_iterator const_iterator;
+
     BuildOrderQueue(CCBot & bot);
 
     void clearAll();											// clears the entire build order queue
     void skipItem();											// increments skippedItems
-    MM::BuildOrderItem queueAsHighestPriority(const MetaType & type, bool blocking);		// queues something at the highest priority
-    MM::BuildOrderItem queueAsLowestPriority(const MetaType & type, bool blocking);		// queues something at the lowest priority
-    MM::BuildOrderItem queueItem(const MM::BuildOrderItem & b);			// queues something with a given priority
+    const MM::BuildOrderItem & queueAsHighestPriority(const MetaType & type, bool blocking);		// queues something at the highest priority
+    const MM::BuildOrderItem & queueAsLowestPriority(const MetaType & type, bool blocking);		// queues something at the lowest priority
+    const MM::BuildOrderItem & queueItem(const MM::BuildOrderItem & b);			// queues something with a given priority
     void removeHighestPriorityItem();								// removes the highest priority item
     void removeCurrentHighestPriorityItem();
 	void removeAllOfType(const MetaType & type);
+	void reorder(const std::vector<MetaType> & order);				// reorders the matching items among their own priorities
 
-    size_t size();													// returns the size of the queue
+    size_t size() const;											// returns the size of the queue
 
-    bool isEmpty();
-    MM::BuildOrderItem getHighestPriorityItem();	// returns the highest priority item
-    MM::BuildOrderItem getNextHighestPriorityItem();	// returns the highest priority item
-	int getCountOfType(const MetaType & type);	// returns the number of items of a type in the queue
+    bool isEmpty() const;
+    int getHighestPriority() const;
+    int getLowestPriority() const;
+    const MM::BuildOrderItem & getHighestPriorityItem();	// returns the highest priority item and considers it as the current item
+    const MM::BuildOrderItem & getNextHighestPriorityItem();	// returns the current item, after the skipped ones
+	int getCountOfType(const MetaType & type) const;	// returns the number of items of a type in the queue
 
-    bool canSkipItem();
+    bool canSkipItem() const;
     std::string getQueueInformation() const;
 	bool contains(const MetaType & type) const;
 
-    // overload the bracket operator for ease of use
-    MM::BuildOrderItem operator [] (int i);
+    // iterates over the items from the highest priority to the lowest
+    const_iterator begin() const { return m_queue.rbegin(); }
+    const_iterator end() const { return m_queue.rend(); }
 };
@@ -22,9 +22,9 @@ void BuildingManager::onFirstFrame()
 	//if (m_bot.GetPlayerRace(Players::Enemy) != sc2::Race::Protoss)
 	{
 		//Ramp wall location
-		std::list<CCTilePosition> checkedTiles;
-		FindRampTiles(m_rampTiles, checkedTiles, m_bot.Bases().getPlayerStartingBaseLocation(Players::Self)->getDepotTilePosition());
-		FindMainRamp(m_rampTiles);
+		const auto mainRamp = m_bot.Map().getTerrainAnalysis().getMainRamp(m_bot.Bases().getPlayerStartingBaseLocation(Players::Self)->getDepotTilePosition());
+		if (mainRamp)
+			m_rampTiles.assign(mainRamp->topTiles.begin(), mainRamp->topTiles.end());
 
 		auto tilesToBlock = FindRampTilesToPlaceBuilding(m_rampTiles);
 		PlaceWallBuildings(tilesToBlock);
@@ -42,33 +42,33 @@ void BuildingManager::onFrame(bool executeMacro)
 	if (executeMacro)
 	{
 		m_bot.Commander().Combat().getAddonBlockingTanks().clear();
-		m_bot.StartProfiling("0.8.0 lowPriorityChecks");
+		PROFILE_BEGIN("lowPriorityChecks");
 		lowPriorityChecks();
-		m_bot.StopProfiling("0.8.0 lowPriorityChecks");
-		m_bot.StartProfiling("0.8.1 updateBaseBuildings");
+		PROFILE_END("lowPriorityChecks");
+		PROFILE_BEGIN("updateBaseBuildings");
 		updateBaseBuildings();
-		m_bot.StopProfiling("0.8.1 updateBaseBuildings");
-		m_bot.StartProfiling("0.8.2 validateWorkersAndBuildings");
+		PROFILE_END("updateBaseBuildings");
+		PROFILE_BEGIN("validateWorkersAndBuildings");
 		validateWorkersAndBuildings();          // check to see if assigned workers have died en route or while constructing
-		m_bot.StopProfiling("0.8.2 validateWorkersAndBuildings");
-		m_bot.StartProfiling("0.8.3 assignWorkersToUnassignedBuildings");
+		PROFILE_END("validateWorkersAndBuildings");
+		PROFILE_BEGIN("assignWorkersToUnassignedBuildings");
 		assignWorkersToUnassignedBuildings();   // assign workers to the unassigned buildings and label them 'planned'
-		m_bot.StopProfiling("0.8.3 assignWorkersToUnassignedBuildings");
-		m_bot.StartProfiling("0.8.4 constructAssignedBuildings");
+		PROFILE_END("assignWorkersToUnassignedBuildings");
+		PROFILE_BEGIN("constructAssignedBuildings");
 		constructAssignedBuildings();           // for each planned building, if the worker isn't constructing, send the command
-		m_bot.StopProfiling("0.8.4 constructAssignedBuildings");
-		m_bot.StartProfiling("0.8.5 checkForStartedConstruction");
+		PROFILE_END("constructAssignedBuildings");
+		PROFILE_BEGIN("checkForStartedConstruction");
 		checkForStartedConstruction();          // check to see if any buildings have started construction and update data structures
-		m_bot.StopProfiling("0.8.5 checkForStartedConstruction");
-		m_bot.StartProfiling("0.8.6 checkForDeadTerranBuilders");
+		PROFILE_END("checkForStartedConstruction");
+		PROFILE_BEGIN("checkForDeadTerranBuilders");
 		checkForDeadTerranBuilders();           // if we are terran and a building is under construction without a worker, assign a new one
-		m_bot.StopProfiling("0.8.6 checkForDeadTerranBuilders");
-		m_bot.StartProfiling("0.8.7 checkForCompletedBuildings");
+		PROFILE_END("checkForDeadTerranBuilders");
+		PROFILE_BEGIN("checkForCompletedBuildings");
 		checkForCompletedBuildings();           // check to see if any buildings have completed and update data structures
-		m_bot.StopProfiling("0.8.7 checkForCompletedBuildings");
-		m_bot.StartProfiling("0.8.8 castBuildingsAbilities");
+		PROFILE_END("checkForCompletedBuildings");
+		PROFILE_BEGIN("castBuildingsAbilities");
 		castBuildingsAbilities();
-		m_bot.StopProfiling("0.8.8 castBuildingsAbilities");
+		PROFILE_END("castBuildingsAbilities");
 	}
     drawBuildingInformation();
 	drawStartingRamp();
@@ -165,96 +165,6 @@ void BuildingManager::lowPriorityChecks()
 	removeBuildings(toRemove);
 }
 
-void BuildingManager::FindRampTiles(std::list<CCTilePosition> &rampTiles, std::list<CCTilePosition> &checkedTiles, CCTilePosition currentTile)
-{
-	if (std::find(checkedTiles.begin(), checkedTiles.end(), currentTile) != checkedTiles.end())
-	{
-		return;
-	}
-
-	checkedTiles.push_front(currentTile);
-	if (m_bot.Map().isWalkable(currentTile))
-	{
-		if (m_bot.Map().isBuildable(currentTile))
-		{
-			FindRampTiles(rampTiles, checkedTiles, CCTilePosition(currentTile.x + 1, currentTile.y));
-			FindRampTiles(rampTiles, checkedTiles, CCTilePosition(currentTile.x - 1, currentTile.y));
-			FindRampTiles(rampTiles, checkedTiles, CCTilePosition(currentTile.x, currentTile.y + 1));
-			FindRampTiles(rampTiles, checkedTiles, CCTilePosition(currentTile.x, currentTile.y - 1));
-		}
-		else
-		{
-			const auto tileHeight = m_bot.Map().terrainHeight(currentTile.x, currentTile.y);
-			auto slightlyLowerDiagonalNeighbors = 0;
-			auto slightlyLowerAdjacentNeighbors = 0;
-			for (int x = -1; x <= 1; ++x)
-			{
-				for (int y = -1; y <= 1; ++y)
-				{
-					if (x == 0 && y == 0)
-						continue;
-					const auto neighborTile = CCTilePosition(currentTile.x + x, currentTile.y + y);
-					if (!m_bot.Map().isWalkable(neighborTile))
-						continue;
-					const auto neighborHeightDiff = tileHeight - m_bot.Map().terrainHeight(neighborTile);
-					if(neighborHeightDiff >= 0.24f && neighborHeightDiff <= 0.26f || neighborHeightDiff >= 1.99f && neighborHeightDiff <= 2.01f)
-					{
-						const auto diagonal = x != 0 && y != 0;
-						if (diagonal)
-							++slightlyLowerDiagonalNeighbors;
-						else
-							++slightlyLowerAdjacentNeighbors;
-					}
-				}
-			}
-			if (slightlyLowerDiagonalNeighbors == 1 || slightlyLowerAdjacentNeighbors == 2)
-			{
-				rampTiles.push_back(currentTile);
-			}
-		}
-	}
-}
-
-void BuildingManager::FindMainRamp(std::list<CCTilePosition> &rampTiles)
-{
-	int minDistance = INT_MAX;
-	CCTilePosition mainRampTile;
-	for (auto & tile : rampTiles)
-	{
-		int distance = Util::DistSq(Util::GetPosition(tile), m_bot.Map().center());
-		if (distance < minDistance)
-		{
-			minDistance = distance;
-			mainRampTile = tile;
-		}
-	}
-	std::list<CCTilePosition> mainRamp;
-	mainRamp.push_back(mainRampTile);
-	for (auto & tile : rampTiles)
-	{
-		if (tile == mainRampTile)
-		{
-			continue;
-		}
-		if (mainRampTile.x + 1 == tile.x && mainRampTile.y + 1 == tile.y)
-		{
-			mainRamp.push_back(tile);
-		}
-		else if (mainRampTile.x + 1 == tile.x && mainRampTile.y - 1 == tile.y)
-		{
-			mainRamp.push_back(tile);
-		}
-		else if (mainRampTile.x - 1 == tile.x && mainRampTile.y + 1 == tile.y)
-		{
-			mainRamp.push_back(tile);
-		}
-		else if (mainRampTile.x - 1 == tile.x && mainRampTile.y - 1 == tile.y)
-		{
-			mainRamp.push_back(tile);
-		}
-	}
-}
-
 std::vector<CCTilePosition> BuildingManager::FindRampTilesToPlaceBuilding(std::list<CCTilePosition> &rampTiles)
 {
 	std::vector<CCTilePosition> tilesToBlock;
@@ -494,17 +404,21 @@ void BuildingManager::FindOpponentMainRamp()
 	const auto enemyBaseLocation = m_bot.Bases().getPlayerStartingBaseLocation(Players::Enemy);
 	if(enemyBaseLocation)
 	{
-		std::list<CCTilePosition> checkedTiles;
-		std::list<CCTilePosition> rampTiles;
-		FindRampTiles(rampTiles, checkedTiles, enemyBaseLocation->getDepotTilePosition());
-		FindMainRamp(rampTiles);
-		CCPosition rampPos;
-		for (const auto & rampTile : rampTiles)
+		const auto ramp = m_bot.Map().getTerrainAnalysis().getMainRamp(enemyBaseLocation->getDepotTilePosition());
+		if (ramp && !ramp->topTiles.empty())
+		{
+			CCPosition rampPos;
+			for (const auto & rampTile : ramp->topTiles)
+			{
+				rampPos += Util::GetPosition(rampTile);
+			}
+			rampPos /= ramp->topTiles.size();
+			m_enemyMainRamp = rampPos;
+		}
+		else if (ramp)
 		{
-			rampPos += Util::GetPosition(rampTile);
+			m_enemyMainRamp = ramp->center;
 		}
-		rampPos /= rampTiles.size();
-		m_enemyMainRamp = rampPos;
 	}
 }
 
@@ -677,7 +591,7 @@ bool BuildingManager::assignWorkerToUnassignedBuilding(Building & b, bool filter
 	}
 	else
 	{
-		m_bot.StartProfiling("0.8.3.1 getBuildingLocation");
+		PROFILE_BEGIN("getBuildingLocation");
 		// grab a worker unit from WorkerManager which is closest to this final position
 		bool isRushed = m_bot.Strategy().isEarlyRushed() || m_bot.Strategy().isWorkerRushed();
 		bool isEarlyWallBuilding = m_bot.Strategy().shouldFinishWallEarly() &&
@@ -705,7 +619,7 @@ bool BuildingManager::assignWorkerToUnassignedBuilding(Building & b, bool filter
 		{
 			testLocation = b.desiredPosition;
 		}
-		m_bot.StopProfiling("0.8.3.1 getBuildingLocation");
+		PROFILE_END("getBuildingLocation");
 
 		// Don't test the location if the building is already started
 		if (!b.underConstruction && (!m_bot.Map().isValidTile(testLocation) || (testLocation.x == 0 && testLocation.y == 0)))
@@ -738,9 +652,9 @@ bool BuildingManager::assignWorkerToUnassignedBuilding(Building & b, bool filter
 
 		if (!isEarlyWallBuilding)
 		{
-			m_bot.StartProfiling("0.8.3.2 IsPathToGoalSafe");
+			PROFILE_BEGIN("IsPathToGoalSafe");
 			const auto isPathToGoalSafe = Util::PathFinding::IsPathToGoalSafe(builderUnit.getUnitPtr(), Util::GetPosition(b.finalPosition), b.type.isRefinery(), m_bot);
-			m_bot.StopProfiling("0.8.3.2 IsPathToGoalSafe");
+			PROFILE_END("IsPathToGoalSafe");
 
 			if (!isPathToGoalSafe && b.canBeBuiltElseWhere)
 			{
@@ -1390,9 +1304,9 @@ void BuildingManager::checkForCompletedBuildings()
 				{
 					if (b.builderUnit.isValid())
 					{
-						m_bot.StartProfiling("0.8.7.1    setGasJob");
+						PROFILE_BEGIN("setGasJob");
 						m_bot.Workers().getWorkerData().setWorkerJob(b.builderUnit, WorkerJobs::Gas, b.buildingUnit);
-						m_bot.StopProfiling("0.8.7.1    setGasJob");
+						PROFILE_END("setGasJob");
 					}
 				}
 				else
@@ -1413,10 +1327,10 @@ void BuildingManager::checkForCompletedBuildings()
 						{
 							if (b.builderUnit.isValid())
 							{
-								m_bot.StartProfiling("0.8.7.3    setRepairJob");
+								PROFILE_BEGIN("setRepairJob");
 								m_bot.Workers().getWorkerData().setWorkerJob(b.builderUnit, WorkerJobs::Repair);
 								b.builderUnit.move(m_proxyLocation);
-								m_bot.StopProfiling("0.8.7.3    setRepairJob");
+								PROFILE_END("setRepairJob");
 							}
 						}
 					}
@@ -1780,7 +1694,8 @@ CCTilePosition BuildingManager::getProxyLocation()
 			if (m_bot.Config().RandomProxyLocation)
 			{
 				const int randomPossibleLocations = 2;
-				std::srand(std::time(nullptr));	// Initialize random seed
+				if (!m_bot.IsOffline())
+					std::srand(std::time(nullptr));	// Initialize random seed, the offline replays keep theirs to take the same decisions
 				const auto maximumRandomBaseIndex = sortedBases.size() >= randomPossibleLocations ? randomPossibleLocations : sortedBases.size();
 				const auto randomValue = std::rand();
 				const auto randomBaseIndex = randomValue % maximumRandomBaseIndex;
@@ -1846,23 +1761,23 @@ CCTilePosition BuildingManager::getBuildingLocation(const Building & b, bool che
 
     if (b.type.isRefinery())
     {
-		m_bot.StartProfiling("0.8.3.1.1 getRefineryPosition");
+		PROFILE_BEGIN("getRefineryPosition");
 		buildingLocation = m_buildingPlacer.getRefineryPosition();
-		m_bot.StopProfiling("0.8.3.1.1 getRefineryPosition");
+		PROFILE_END("getRefineryPosition");
     }
 	else if (b.type.isResourceDepot())
     {
-		m_bot.StartProfiling("0.8.3.1.2 getNextExpansionPosition");
+		PROFILE_BEGIN("getNextExpansionPosition");
 		buildingLocation = m_bot.Bases().getNextExpansionPosition(Players::Self, true, false, false);
-		m_bot.StopProfiling("0.8.3.1.2 getNextExpansionPosition");
+		PROFILE_END("getNextExpansionPosition");
     }
 	else
 	{
 		// get a position within our region
 		// TODO: put back in special pylon / cannon spacing
-		m_bot.StartProfiling("0.8.3.1.3 getBuildLocationNear");
+		PROFILE_BEGIN("getBuildLocationNear");
 		buildingLocation = m_buildingPlacer.getBuildLocationNear(b, false, checkInfluenceMap, includeAddonTiles, ignoreExtraBorder, forceSameHeight);
-		m_bot.StopProfiling("0.8.3.1.3 getBuildLocationNear");
+		PROFILE_END("getBuildLocationNear");
 	}
 	return buildingLocation;
 }
@@ -2193,11 +2108,11 @@ const sc2::Unit * BuildingManager::getLargestCloseMineralForMules(const Unit uni
 
 void BuildingManager::castBuildingsAbilities()
 {
-	m_bot.StartProfiling("0.8.8.1  RunProxyLogic");
+	PROFILE_BEGIN("RunProxyLogic");
 	RunProxyLogic();
-	m_bot.StopProfiling("0.8.8.1  RunProxyLogic");
+	PROFILE_END("RunProxyLogic");
 
-	m_bot.StartProfiling("0.8.8.2  Barracks");
+	PROFILE_BEGIN("Barracks");
 	for (const auto & barracks : m_bot.GetAllyUnits(sc2::UNIT_TYPEID::TERRAN_BARRACKS))
 	{
 		//If the building is in the wall
@@ -2234,9 +2149,9 @@ void BuildingManager::castBuildingsAbilities()
 			break;
 		}
 	}
-	m_bot.StopProfiling("0.8.8.2  Barracks");
+	PROFILE_END("Barracks");
 
-	m_bot.StartProfiling("0.8.8.3  OrbitalCommands");
+	PROFILE_BEGIN("OrbitalCommands");
 	for (const auto & b : m_bot.GetAllyUnits(sc2::UNIT_TYPEID::TERRAN_ORBITALCOMMAND))
 	{
 		const auto energy = b.getEnergy();
@@ -2264,7 +2179,7 @@ void BuildingManager::castBuildingsAbilities()
 		if (!burrowedAndInvisUnits.empty())
 		{
 			keepEnergy = true;
-			m_bot.StartProfiling("0.8.8.3.1   FindCombatUnitCloseToBurrowedOrInvisUnits");
+			PROFILE_BEGIN("FindCombatUnitCloseToBurrowedOrInvisUnits");
 			const auto & combatUnits = m_bot.Commander().Combat().GetCombatUnits();
 			sc2::Units closeBurrowedOrInvisUnits;
 			std::set<const sc2::Unit *> closeCombatUnits;
@@ -2295,10 +2210,10 @@ void BuildingManager::castBuildingsAbilities()
 					}
 				}
 			}
-			m_bot.StopProfiling("0.8.8.3.1   FindCombatUnitCloseToBurrowedOrInvisUnits");
+			PROFILE_END("FindCombatUnitCloseToBurrowedOrInvisUnits");
 			if (!closeBurrowedOrInvisUnits.empty())
 			{
-				m_bot.StartProfiling("0.8.8.3.2   FindOtherTargets");
+				PROFILE_BEGIN("FindOtherTargets");
 				// Check if there are no other ground targets nearby
 				bool otherTargets = false;
 				for (const auto combatUnit : closeCombatUnits)
@@ -2320,11 +2235,11 @@ void BuildingManager::castBuildingsAbilities()
 					if (otherTargets)
 						break;
 				}
-				m_bot.StopProfiling("0.8.8.3.2   FindOtherTargets");
+				PROFILE_END("FindOtherTargets");
 				
 				if (!otherTargets)
 				{
-					m_bot.StartProfiling("0.8.8.3.3   CalcScanPosition");
+					PROFILE_BEGIN("CalcScanPosition");
 					// Calculate the middle point of all close burrowed unit
 					CCPosition middlePoint;
 					for (const auto closeBurrowedOrInvisUnit : closeBurrowedOrInvisUnits)
@@ -2366,7 +2281,7 @@ void BuildingManager::castBuildingsAbilities()
 						}
 						middlePoint = mostCenteredUnit->pos;
 					}
-					m_bot.StartProfiling("0.8.8.3.3   CalcScanPosition");
+					PROFILE_END("CalcScanPosition");
 
 					// Check if we already have a scan near that point (might happen because we receive the observations 1 frame later)
 					bool closeScan = false;
@@ -2459,15 +2374,15 @@ void BuildingManager::castBuildingsAbilities()
 			}
 		}
 	}
-	m_bot.StopProfiling("0.8.8.3  OrbitalCommands");
+	PROFILE_END("OrbitalCommands");
 
-	m_bot.StartProfiling("0.8.8.4  DamagedBuildings");
+	PROFILE_BEGIN("DamagedBuildings");
 	LiftOrLandDamagedBuildings();
-	m_bot.StopProfiling("0.8.8.4  DamagedBuildings");
+	PROFILE_END("DamagedBuildings");
 
-	m_bot.StartProfiling("0.8.8.5  LoadOrUnloadSCVs");
+	PROFILE_BEGIN("LoadOrUnloadSCVs");
 	loadOrUnloadSCVs();
-	m_bot.StopProfiling("0.8.8.5  LoadOrUnloadSCVs");
+	PROFILE_END("LoadOrUnloadSCVs");
 }
 
 void BuildingManager::RunProxyLogic()
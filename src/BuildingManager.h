@@ -66,8 +66,6 @@ public:
 	void						onFirstFrame();
     void						onFrame(bool executeMacro);
 	void						lowPriorityChecks();
-	void						FindRampTiles(std::list<CCTilePosition> &rampTiles, std::list<CCTilePosition> &checkedTiles, CCTilePosition currentTile);
-	void						FindMainRamp(std::list<CCTilePosition> &rampTiles);
 	std::vector<CCTilePosition> FindRampTilesToPlaceBuilding(std::list<CCTilePosition> &rampTiles);
 	void						PlaceWallBuildings(std::vector<CCTilePosition> tilesToBlock);
 	bool						ValidateSupplyDepotPosition(std::list<CCTilePosition> buildingTiles, CCTilePosition possibleTile);
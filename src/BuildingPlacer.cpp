@@ -680,7 +680,7 @@ void BuildingPlacer::freeTilesForBunker(CCTilePosition position)
 
 CCTilePosition BuildingPlacer::getRefineryPosition()
 {
-	m_bot.StartProfiling("getRefineryPosition");
+	PROFILE_BEGIN("getRefineryPosition");
     CCPosition closestGeyser(0, 0);
     double minGeyserDistanceFromHome = std::numeric_limits<double>::max();
     CCPosition homePosition = m_bot.GetStartLocation();
@@ -717,7 +717,7 @@ CCTilePosition BuildingPlacer::getRefineryPosition()
 			}
 		}
 	}
-	m_bot.StopProfiling("getRefineryPosition");
+	PROFILE_END("getRefineryPosition");
 
 #ifdef SC2API
     return Util::GetTilePosition(closestGeyser);
@@ -1,5 +1,13 @@
 #include "CCBot.h"
 #include "Util.h"
+#include "Logger.h"
+#include "libvoxelbot/utilities/thread_pool.h"
+
+namespace
+{
+	// Above the highest unit type id of the game, so the per type vectors never grow during a game
+	const size_t UnitTypeCapacity = 2048;
+}
 
 CCBot::CCBot(std::string botName, std::string botVersion, bool realtime)
 	: m_map(*this)
@@ -10,8 +18,12 @@ CCBot::CCBot(std::string botName, std::string botVersion, bool realtime)
 	, m_strategy(*this)
 	, m_repairStations(*this)
 	, m_combatAnalyzer(*this)
+	, m_latencyGovernor(*this)
+	, m_snapshotRecorder(*this)
 	, m_gameCommander(*this)
 	, m_techTree(*this)
+	, m_enemyUnitsPerType(UnitTypeCapacity)
+	, m_allyUnitsPerType(UnitTypeCapacity)
 	, m_concede(false)
 	, m_saidHallucinationLine(false)
 	, m_botName(botName)
@@ -19,7 +31,21 @@ CCBot::CCBot(std::string botName, std::string botVersion, bool realtime)
 	, m_previousMacroGameLoop(-1)
 	, m_player1IsHuman(false)
 	, m_realtime(realtime)
+	, m_liveObservation(*this)
+	, m_liveQuery(*this)
+	, m_liveActions(*this)
+	, m_observation(&m_liveObservation)
+	, m_query(&m_liveQuery)
+	, m_actions(&m_liveActions)
+{
+}
+
+void CCBot::SetOfflineGame(GameObservation * observation, GameQuery * query, GameActions * actions)
 {
+	m_offline = true;
+	m_observation = observation;
+	m_query = query;
+	m_actions = actions;
 }
 
 CCBot::~CCBot()
@@ -41,6 +67,12 @@ void CCBot::OnGameEnd()
 		ss << "Lose";
 	std::cout << ss.str() << std::endl;
 	Util::Log(__FUNCTION__, ss.str(), *this);
+	if (Config().BenchmarkPathfinding)
+		Util::PathFinding::LogPathfindingBenchmark(*this);
+	m_latencyGovernor.onEnd();
+	m_snapshotRecorder.onEnd();
+	Profiler::StopTrace();
+	Logger::Stop();
 }
 void CCBot::OnUnitDestroyed(const sc2::Unit*) {}
 void CCBot::OnUnitCreated(const sc2::Unit*) {}
@@ -200,9 +232,19 @@ void CCBot::OnNuclearLaunchDetected() {}
 
 void CCBot::OnGameStart() //full start
 {
+	const auto startTime = std::chrono::steady_clock::now();
     m_config.readConfigFile();
-	if (!m_realtime)
+	if (m_offline)
+	{
+		// Nothing can be drawn without the game, and the steps do not have to keep up with it
+		m_config.AllowDebug = false;
+		m_config.IsRealTime = false;
+	}
+	// The offline harness replays the same frames every time, so the simulator is ready from the first one
+	if (m_offline)
 		Util::InitializeCombatSimulator();
+	else
+		Util::StartCombatSimulatorInitialization();
 	Util::Initialize(*this, GetPlayerRace(Players::Self), Observation()->GetGameInfo());
 
     // add all the possible start locations on the map
@@ -219,37 +261,64 @@ void CCBot::OnGameStart() //full start
 
 	// Create logfile
 	Util::CreateLog(*this);
+	if (Config().RecordTrace || Config().RecordSnapshots)
+	{
+		time_t now = time(0);
+		char buf[80];
+		strftime(buf, sizeof(buf), "./data/%Y-%m-%d--%H-%M-%S", localtime(&now));
+		const std::string filePrefix = std::string(buf) + "_" + GetOpponentId();
+		if (Config().RecordTrace)
+			Profiler::StartTrace(filePrefix + ".trace.json");
+		// The recorder answers the queries of the bot to record them
+		if (Config().RecordSnapshots && !m_offline && m_snapshotRecorder.onStart(filePrefix + ".snapshot", *m_query))
+			m_query = &m_snapshotRecorder;
+	}
 	m_versionMessage << m_botName << " v" << m_botVersion;
 	Util::Log(__FUNCTION__, m_versionMessage.str(), *this);
 	std::cout << m_versionMessage.str() << std::endl;
 	selfRace = GetPlayerRace(Players::Self);
     
+    m_techTree.onStart();	// before setUnits because the UnitType properties are read from the tech tree
     setUnits();
-    m_techTree.onStart();
     m_strategy.onStart();
-    m_map.onStart();
+	if (m_offline)
+	{
+		// After the strategy file that can enable it, the build order optimizer reads the observation of the real game
+		m_config.OptimizeBuildOrder = false;
+	}
+	// The independent parts of the map and base analysis run on every core, the game is not running yet
+	ThreadPool startupPool(std::max(1, int(std::thread::hardware_concurrency())));
+    m_map.onStart(startupPool);
     m_unitInfo.onStart();
-    m_bases.onStart();
+    m_bases.onStart(startupPool);
     m_workers.onStart();
 	m_buildings.onStart();
 	m_repairStations.onStart();
 	m_combatAnalyzer.onStart();
+	m_latencyGovernor.onStart();
     m_gameCommander.onStart();
+	m_map.saveStartupCache();
+
+	std::stringstream startupMessage;
+	startupMessage << "Started in " << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count() << " ms";
+	Util::Log(__FUNCTION__, startupMessage.str(), *this);
 
-	StartProfiling("0 Starcraft II");
+	PROFILE_BEGIN("Starcraft II");
 	m_lastFrameEndTime = std::chrono::steady_clock::now();
 }
 
 void CCBot::OnStep()
 {
-	StopProfiling("0 Starcraft II");
-	StartProfiling("0.0 OnStep");	//Do not remove
+	PROFILE_END("Starcraft II");
+	PROFILE_BEGIN("OnStep");	//Do not remove
 	const auto framesSinceLastStep = Observation()->GetGameLoop() - m_gameLoop;
 	m_gameLoop = Observation()->GetGameLoop();
-	if (m_realtime && !m_combatSimulatorInitialized && m_gameLoop > 50)
+	Profiler::SetGameLoop(m_gameLoop);
+	if (m_config.RecordSnapshots)
 	{
-		Util::InitializeCombatSimulator();
-		m_combatSimulatorInitialized = true;
+		PROFILE_BEGIN("m_snapshotRecorder.onFrame");
+		m_snapshotRecorder.onFrame();
+		PROFILE_END("m_snapshotRecorder.onFrame");
 	}
 	if (!m_versionMessage.str().empty() && m_gameLoop >= 5)
 	{
@@ -266,7 +335,7 @@ void CCBot::OnStep()
 	if (executeMacro)
 		m_previousMacroGameLoop = m_gameLoop;
 
-	StartProfiling("0.1 checkKeyState");
+	PROFILE_BEGIN("checkKeyState");
 	if (Config().AllowDebug)
 	{
 		checkKeyState();
@@ -277,82 +346,82 @@ void CCBot::OnStep()
 			DebugMenu();
 		}
 	}
-	StopProfiling("0.1 checkKeyState");
+	PROFILE_END("checkKeyState");
 
-	StartProfiling("0.2 setUnits");
+	PROFILE_BEGIN("setUnits");
 #ifdef ROBUST_MODE
 	if (setjmp(gBuffer) == 0)
 #endif
 		setUnits();
-	StopProfiling("0.2 setUnits");
+	PROFILE_END("setUnits");
 
 #ifdef ROBUST_MODE
 	if (setjmp(gBuffer) == 0)
 #endif
 		checkForConcede();
 
-	StartProfiling("0.4 m_map.onFrame");
+	PROFILE_BEGIN("m_map.onFrame");
 #ifdef ROBUST_MODE
 	if (setjmp(gBuffer) == 0)
 #endif
 		m_map.onFrame();
-	StopProfiling("0.4 m_map.onFrame");
+	PROFILE_END("m_map.onFrame");
 
-	StartProfiling("0.5 m_unitInfo.onFrame");
+	PROFILE_BEGIN("m_unitInfo.onFrame");
 #ifdef ROBUST_MODE
 	if (setjmp(gBuffer) == 0)
 #endif
 		m_unitInfo.onFrame();
-	StopProfiling("0.5 m_unitInfo.onFrame");
+	PROFILE_END("m_unitInfo.onFrame");
 
-	StartProfiling("0.12 m_combatAnalyzer.onFrame");
+	PROFILE_BEGIN("m_combatAnalyzer.onFrame");
 #ifdef ROBUST_MODE
 	if (setjmp(gBuffer) == 0)
 #endif
 		m_combatAnalyzer.onFrame();
-	StopProfiling("0.12 m_combatAnalyzer.onFrame");
+	PROFILE_END("m_combatAnalyzer.onFrame");
 
-	StartProfiling("0.6 m_bases.onFrame");
+	PROFILE_BEGIN("m_bases.onFrame");
 #ifdef ROBUST_MODE
 	if (setjmp(gBuffer) == 0)
 #endif
 		m_bases.onFrame();
-	StopProfiling("0.6 m_bases.onFrame");
+	PROFILE_END("m_bases.onFrame");
 
-	StartProfiling("0.7 m_workers.onFrame");
+	PROFILE_BEGIN("m_workers.onFrame");
 #ifdef ROBUST_MODE
 	if (setjmp(gBuffer) == 0)
 #endif
 		m_workers.onFrame(executeMacro);
-	StopProfiling("0.7 m_workers.onFrame");
+	PROFILE_END("m_workers.onFrame");
 
-	StartProfiling("0.8 m_buildings.onFrame");
+	PROFILE_BEGIN("m_buildings.onFrame");
 #ifdef ROBUST_MODE
 	if (setjmp(gBuffer) == 0)
 #endif
 		m_buildings.onFrame(executeMacro);
-	StopProfiling("0.8 m_buildings.onFrame");
+	PROFILE_END("m_buildings.onFrame");
 
-	StartProfiling("0.9 m_strategy.onFrame");
+	PROFILE_BEGIN("m_strategy.onFrame");
 #ifdef ROBUST_MODE
 	if (setjmp(gBuffer) == 0)
 #endif
 		m_strategy.onFrame(executeMacro);
-	StopProfiling("0.9 m_strategy.onFrame");
+	PROFILE_END("m_strategy.onFrame");
 
-	StartProfiling("0.11 m_repairStations.onFrame");
+	PROFILE_BEGIN("m_repairStations.onFrame");
 #ifdef ROBUST_MODE
 	if (setjmp(gBuffer) == 0)
 #endif
 		m_repairStations.onFrame();
-	StopProfiling("0.11 m_repairStations.onFrame");
+	PROFILE_END("m_repairStations.onFrame");
 
-	StartProfiling("0.10 m_gameCommander.onFrame");
+	PROFILE_BEGIN("m_gameCommander.onFrame");
 #ifdef ROBUST_MODE
 	if (setjmp(gBuffer) == 0)
 #endif
 		m_gameCommander.onFrame(executeMacro);
-	StopProfiling("0.10 m_gameCommander.onFrame");
+	PROFILE_END("m_gameCommander.onFrame");
 
 #ifdef ROBUST_MODE
 	if (setjmp(gBuffer) == 0)
@@ -366,7 +435,10 @@ void CCBot::OnStep()
 		IssueGameStartCheats();
 	}
 
-	StopProfiling("0.0 OnStep");	//Do not remove
+	PROFILE_END("OnStep");	//Do not remove
+
+	PROFILE_COUNT("allyUnits", GetAllyUnits().size());
+	PROFILE_COUNT("enemyUnits", GetEnemyUnits().size());
 
 	drawProfilingInfo();
 
@@ -393,7 +465,7 @@ void CCBot::OnStep()
 		}
 	}
 
-	StartProfiling("0 Starcraft II");
+	PROFILE_BEGIN("Starcraft II");
 }
 
 #pragma optimize( "checkKeyState", off )
@@ -553,11 +625,32 @@ void CCBot::checkKeyState()
 }
 #pragma optimize( "checkKeyState", on )
 
+std::vector<Unit> & CCBot::getUnitsOfType(std::vector<std::vector<Unit>> & unitsPerType, sc2::UNIT_TYPEID type)
+{
+	const auto typeId = size_t(type);
+	if (typeId >= unitsPerType.size())
+		unitsPerType.resize(typeId + 1);
+	return unitsPerType[typeId];
+}
+
+const std::vector<Unit> & CCBot::findUnitsOfType(const std::vector<std::vector<Unit>> & unitsPerType, sc2::UNIT_TYPEID type)
+{
+	static const std::vector<Unit> noUnits;
+	const auto typeId = size_t(type);
+	return typeId < unitsPerType.size() ? unitsPerType[typeId] : noUnits;
+}
+
+void CCBot::clearUnitsPerType(std::vector<std::vector<Unit>> & unitsPerType)
+{
+	// Keep the inner vectors so their memory is reused next frame
+	for (auto & units : unitsPerType)
+		units.clear();
+}
 
 void CCBot::setUnits()
 {
     m_allUnits.clear();
-	m_allyUnitsPerType.clear();
+	clearUnitsPerType(m_allyUnitsPerType);
 	m_unitCount.clear();
 	m_unitCompletedCount.clear();
 	m_strategy.setEnemyCurrentlyHasInvisible(m_gameCommander.Combat().isExpandBlockedByInvis());
@@ -566,7 +659,7 @@ void CCBot::setUnits()
 	auto enemyMainBasePosition = m_enemyBaseLocations[0];
 	bool firstPhoenix = true;
 	const bool zergEnemy = GetPlayerRace(Players::Enemy) == CCRace::Zerg;
-	StartProfiling("0.2.1 loopAllUnits");
+	PROFILE_BEGIN("loopAllUnits");
     for (auto & unitptr : Observation()->GetUnits())
     {
 		Unit unit(unitptr, *this);
@@ -576,8 +669,8 @@ void CCBot::setUnits()
 			continue;
 		if (unitptr->alliance == sc2::Unit::Self || unitptr->alliance == sc2::Unit::Ally)
 		{
-			m_allyUnits[unitptr->tag] = unit;
-			m_allyUnitsPerType[unitptr->unit_type].push_back(unit);
+			m_allyUnits.insert(unitptr->tag, unit);
+			getUnitsOfType(m_allyUnitsPerType, unitptr->unit_type).push_back(unit);
 			bool isMorphingResourceDepot = false;
 			if (unit.getType().isResourceDepot())
 			{
@@ -641,7 +734,7 @@ void CCBot::setUnits()
 				{
 					uint32_t & spawnFrame = it->second;
 					if (GetGameLoop() - spawnFrame > 10)	// Will consider our KD8 Charges to be dangerous only after a few frames
-						m_enemyUnits[unitptr->tag] = unit;
+						m_enemyUnits.insert(unitptr->tag, unit);
 				}
 			}
 		}
@@ -651,7 +744,7 @@ void CCBot::setUnits()
 			{
 				enemyRace = unit.getType().getRace();
 			}
-			m_enemyUnits[unitptr->tag] = unit;
+			m_enemyUnits.insert(unitptr->tag, unit);
 			// Tell the strategy manager that we need to finish the wall early if we spot an enemy before finishing our first Barracks
 			if (!m_strategy.shouldFinishWallEarly() &&
 				!m_strategy.isProxyStartingStrategy() &&
@@ -756,9 +849,9 @@ void CCBot::setUnits()
 								bool enemyHasGroundUnit = false;
 								for (auto & knownEnemyTypes : m_enemyUnitsPerType)
 								{
-									if (!knownEnemyTypes.second.empty())
+									if (!knownEnemyTypes.empty())
 									{
-										if (!knownEnemyTypes.second[0].isFlying())
+										if (!knownEnemyTypes[0].isFlying())
 										{
 											enemyHasGroundUnit = true;
 											break;
@@ -924,24 +1017,24 @@ void CCBot::setUnits()
 		}
 		else //if(unitptr->alliance == sc2::Unit::Neutral)
 		{
-			m_neutralUnits[unitptr->tag] = unit;
+			m_neutralUnits.insert(unitptr->tag, unit);
 		}
         m_allUnits.push_back(unit);
     }
-	StopProfiling("0.2.1 loopAllUnits");
+	PROFILE_END("loopAllUnits");
 
-	StartProfiling("0.2.2 clearDeadUnits");
+	PROFILE_BEGIN("clearDeadUnits");
 	clearDeadUnits();
-	StopProfiling("0.2.2 clearDeadUnits");
-	StartProfiling("0.2.3 clearDuplicateUnits");
+	PROFILE_END("clearDeadUnits");
+	PROFILE_BEGIN("clearDuplicateUnits");
 	clearDuplicateUnits();
-	StopProfiling("0.2.3 clearDuplicateUnits");
+	PROFILE_END("clearDuplicateUnits");
 
 	int armoredEnemies = 0;
 	m_knownEnemyUnits.clear();
 	m_enemyBuildings.clear();
 	m_enemyBuildingsUnderConstruction.clear();
-	m_enemyUnitsPerType.clear();
+	clearUnitsPerType(m_enemyUnitsPerType);
 	m_strategy.setEnemyHasWorkerHiddingInOurMain(false);
 	for(auto& enemyUnitPair : m_enemyUnits)
 	{
@@ -951,7 +1044,7 @@ void CCBot::setUnits()
 		const bool isBurrowedWidowMine = enemyUnitPtr->unit_type == sc2::UNIT_TYPEID::TERRAN_WIDOWMINEBURROWED;
 		const bool isSiegedSiegeTank = enemyUnitPtr->unit_type == sc2::UNIT_TYPEID::TERRAN_SIEGETANKSIEGED;
 
-		m_enemyUnitsPerType[enemyUnitPtr->unit_type].push_back(enemyUnit);
+		getUnitsOfType(m_enemyUnitsPerType, enemyUnitPtr->unit_type).push_back(enemyUnit);
 
 		if (enemyUnit.getType().isBuilding())
 		{
@@ -989,25 +1082,25 @@ void CCBot::setUnits()
 		}
 	}
 
-	StartProfiling("0.2.1   identifyEnemyRepairingSCVs");
+	PROFILE_BEGIN("identifyEnemyRepairingSCVs");
 	identifyEnemyRepairingSCVs();
-	StopProfiling("0.2.1   identifyEnemyRepairingSCVs");
+	PROFILE_END("identifyEnemyRepairingSCVs");
 
-	StartProfiling("0.2.2   identifyEnemySCVBuilders");
+	PROFILE_BEGIN("identifyEnemySCVBuilders");
 	identifyEnemySCVBuilders();
-	StopProfiling("0.2.2   identifyEnemySCVBuilders");
+	PROFILE_END("identifyEnemySCVBuilders");
 
-	StartProfiling("0.2.3   identifyEnemyWorkersGoingIntoRefinery");
+	PROFILE_BEGIN("identifyEnemyWorkersGoingIntoRefinery");
 	identifyEnemyWorkersGoingIntoRefinery();
-	StopProfiling("0.2.3   identifyEnemyWorkersGoingIntoRefinery");
+	PROFILE_END("identifyEnemyWorkersGoingIntoRefinery");
 
-	StartProfiling("0.2.4   identifyStackedEnemyWorkers");
+	PROFILE_BEGIN("identifyStackedEnemyWorkers");
 	identifyStackedEnemyWorkers();
-	StopProfiling("0.2.4   identifyStackedEnemyWorkers");
+	PROFILE_END("identifyStackedEnemyWorkers");
 
 	/*if (!m_strategy.shouldProduceAntiAirDefense())
-		m_strategy.setShouldProduceAntiAirDefense(m_enemyUnitsPerType[sc2::UNIT_TYPEID::PROTOSS_PHOENIX].size() >= 3);*/	// Commented because it uses too much resources and is not very effective
-	m_strategy.setEnemyHasMassZerglings(m_enemyUnitsPerType[sc2::UNIT_TYPEID::ZERG_ZERGLING].size() >= 10);
+		m_strategy.setShouldProduceAntiAirDefense(GetEnemyUnits(sc2::UNIT_TYPEID::PROTOSS_PHOENIX).size() >= 3);*/	// Commented because it uses too much resources and is not very effective
+	m_strategy.setEnemyHasMassZerglings(GetEnemyUnits(sc2::UNIT_TYPEID::ZERG_ZERGLING).size() >= 10);
 	m_strategy.setEnemyHasSeveralArmoredUnits(armoredEnemies >= (enemyRace == sc2::Race::Terran ? 3 : 5));
 }
 
@@ -1016,13 +1109,16 @@ void CCBot::identifyEnemyRepairingSCVs()
 	m_enemyUnitsBeingRepaired.clear();
 	m_enemyRepairingSCVs.clear();
 
-	const auto & enemySCVs = m_enemyUnitsPerType[sc2::UNIT_TYPEID::TERRAN_SCV];
+	const auto & enemySCVs = GetEnemyUnits(sc2::UNIT_TYPEID::TERRAN_SCV);
 	if (enemySCVs.empty())
 		return;
 
-	for(const auto & enemyUnitTypePair : m_enemyUnitsPerType)
+	for(size_t typeId = 0; typeId < m_enemyUnitsPerType.size(); ++typeId)
 	{
-		const auto unitType = UnitType(enemyUnitTypePair.first, *this);
+		const auto & enemyUnitsOfType = m_enemyUnitsPerType[typeId];
+		if (enemyUnitsOfType.empty())
+			continue;
+		const auto unitType = UnitType(sc2::UNIT_TYPEID(typeId), *this);
 		// if this type of unit is not repairable
 		if (!unitType.isRepairable())
 			continue;
@@ -1030,7 +1126,7 @@ void CCBot::identifyEnemyRepairingSCVs()
 		if (!unitType.isCombatUnit())
 			continue;
 
-		for(const auto & enemyUnit : enemyUnitTypePair.second)
+		for(const auto & enemyUnit : enemyUnitsOfType)
 		{
 			// if the unit is not currently visible
 			if (enemyUnit.getUnitPtr()->last_seen_game_loop != m_gameLoop)
@@ -1070,7 +1166,7 @@ void CCBot::identifyEnemySCVBuilders()
 {
 	m_enemySCVBuilders.clear();
 
-	const auto & enemySCVs = m_enemyUnitsPerType[sc2::UNIT_TYPEID::TERRAN_SCV];
+	const auto & enemySCVs = GetEnemyUnits(sc2::UNIT_TYPEID::TERRAN_SCV);
 	if (enemySCVs.empty())
 		return;
 
@@ -1098,13 +1194,13 @@ void CCBot::identifyEnemyWorkersGoingIntoRefinery()
 {
 	m_enemyWorkersGoingInRefinery.clear();
 
-	const auto & enemySCVs = m_enemyUnitsPerType[sc2::UNIT_TYPEID::TERRAN_SCV];
+	const auto & enemySCVs = GetEnemyUnits(sc2::UNIT_TYPEID::TERRAN_SCV);
 	if (enemySCVs.empty())
 		return;
 
 	const auto enemyRace = GetPlayerRace(Players::Enemy);
 	const auto enemyRefineryType = UnitType::getEnemyRefineryType(enemyRace);
-	for (auto & refinery : m_enemyUnitsPerType[enemyRefineryType])
+	for (auto & refinery : GetEnemyUnits(enemyRefineryType))
 	{
 		for (const auto & SCV : enemySCVs)
 		{
@@ -1144,7 +1240,7 @@ void CCBot::identifyStackedEnemyWorkers()
 
 	// Create vectors of stacked enemy workers
 	m_stackedEnemyWorkers.clear();
-	for (auto & enemyWorker : m_enemyUnitsPerType[enemyWorkerType])
+	for (auto & enemyWorker : GetEnemyUnits(enemyWorkerType))
 	{
 		if (enemyWorker.getUnitPtr()->last_seen_game_loop != m_gameLoop)
 			continue;
@@ -1183,18 +1279,20 @@ void CCBot::identifyStackedEnemyWorkers()
 
 void CCBot::clearDeadUnits()
 {
-	std::vector<sc2::Tag> unitsToRemove;
-	// Find dead ally units
-	for (auto& pair : m_allyUnits)
+	// Slots of the registries are stable, so dead units are erased while iterating
+	// Find and remove dead ally units
+	for (auto it = m_allyUnits.begin(); it != m_allyUnits.end();)
 	{
-		auto tag = pair.first;
-		auto& unit = pair.second;
+		auto tag = it->first;
+		auto& unit = it->second;
 		if (!unit.isValid() || !unit.isAlive() ||
 			unit.getPlayer() == Players::Enemy)	// In case of one of our units get neural parasited, its alliance will switch)
 		{
-			unitsToRemove.push_back(tag);
 			if (!unit.isValid())
+			{
+				it = m_allyUnits.erase(it);
 				continue;
+			}
 			if (unit.getUnitPtr()->unit_type == sc2::UNIT_TYPEID::TERRAN_KD8CHARGE)
 				m_KD8ChargesSpawnFrame.erase(tag);
 			if (unit.getPlayer() == Players::Enemy)
@@ -1206,14 +1304,7 @@ void CCBot::clearDeadUnits()
 					case sc2::UNIT_TYPEID::TERRAN_SCV:
 					case sc2::UNIT_TYPEID::PROTOSS_PROBE:
 					case sc2::UNIT_TYPEID::ZERG_DRONE:
-						//Workers().getWorkerData().m_workerMineralMap[]
-						//Workers().getWorkerData().
-						auto workerData = Workers().getWorkerData();
-						if (workerData.m_workerMineralMap.find(unit) != workerData.m_workerMineralMap.end())
-						{
-							workerData.m_mineralWorkersMap[workerData.m_workerMineralMap[unit]].remove(unit.getTag());
-						}
-						workerData.m_workerMineralMap.erase(unit);
+						Workers().getWorkerData().clearWorkerMineral(unit);
 						break;
 				}
 			}
@@ -1222,19 +1313,16 @@ void CCBot::clearDeadUnits()
 			else
 				m_deadAllyUnitsCount[unit.getAPIUnitType()] += 1;
 
+			it = m_allyUnits.erase(it);
 		}
-	}
-	// Remove dead ally units
-	for (auto & tag : unitsToRemove)
-	{
-		m_allyUnits.erase(tag);
+		else
+			++it;
 	}
 
-	unitsToRemove.clear();
-	// Find dead enemy units
-	for (auto& pair : m_enemyUnits)
+	// Find and remove dead enemy units
+	for (auto it = m_enemyUnits.begin(); it != m_enemyUnits.end();)
 	{
-		auto& unit = pair.second;
+		auto& unit = it->second;
 		// Remove dead unit or old snapshot
 		if (!unit.isValid() || !unit.isAlive() || 
 			(unit.getPlayer() == Players::Self && unit.getAPIUnitType() != sc2::UNIT_TYPEID::TERRAN_KD8CHARGE) ||	// In case of one of our units get neural parasited, its alliance will switch
@@ -1242,35 +1330,29 @@ void CCBot::clearDeadUnits()
 			&& m_map.isVisible(unit.getPosition())
 			&& unit.getUnitPtr()->last_seen_game_loop < GetCurrentFrame()))
 		{
-			unitsToRemove.push_back(pair.first);
-			if (!unit.isValid())
-				continue;
-			const auto unitPtr = unit.getUnitPtr();
-			this->Analyzer().increaseDeadEnemy(unitPtr->unit_type);
-			if (unit.getPlayer() == Players::Self)
-				m_parasitedUnits.erase(unitPtr->tag);
+			if (unit.isValid())
+			{
+				const auto unitPtr = unit.getUnitPtr();
+				this->Analyzer().increaseDeadEnemy(unitPtr->unit_type);
+				if (unit.getPlayer() == Players::Self)
+					m_parasitedUnits.erase(unitPtr->tag);
+			}
+			it = m_enemyUnits.erase(it);
 		}
-	}
-	// Remove dead enemy units
-	for (auto & tag : unitsToRemove)
-	{
-		m_enemyUnits.erase(tag);
+		else
+			++it;
 	}
 
-	unitsToRemove.clear();
-	// Find dead neutral units
-	for (auto& pair : m_neutralUnits)
+	// Find and remove dead neutral units
+	for (auto it = m_neutralUnits.begin(); it != m_neutralUnits.end();)
 	{
-		auto& unit = pair.second;
+		auto& unit = it->second;
 		if (!unit.isValid() || !unit.isAlive() || (unit.getUnitPtr()->display_type == sc2::Unit::Snapshot
 			&& m_map.isVisible(unit.getPosition())
 			&& unit.getUnitPtr()->last_seen_game_loop < GetCurrentFrame()))
-			unitsToRemove.push_back(pair.first);
-	}
-	// Remove dead neutral units
-	for (auto & tag : unitsToRemove)
-	{
-		m_neutralUnits.erase(tag);
+			it = m_neutralUnits.erase(it);
+		else
+			++it;
 	}
 }
 
@@ -2493,6 +2575,13 @@ int CCBot::GetFreeGas()
 
 Unit CCBot::GetUnit(const CCUnitID & tag) const
 {
+	// Known units are found in the registries without going through the API
+	if (const auto allyUnit = m_allyUnits.getUnit(tag))
+		return *allyUnit;
+	if (const auto enemyUnit = m_enemyUnits.getUnit(tag))
+		return *enemyUnit;
+	if (const auto neutralUnit = m_neutralUnits.getUnit(tag))
+		return *neutralUnit;
 	auto unitptr = Observation()->GetUnit(tag);
 	if (!unitptr)
 		return {};
@@ -2556,14 +2645,14 @@ int CCBot::GetDeadAllyUnitsCount(sc2::UNIT_TYPEID type) const
 	return 0;
 }
 
-std::map<sc2::Tag, Unit> & CCBot::GetAllyUnits()
+UnitRegistry & CCBot::GetAllyUnits()
 {
 	return m_allyUnits;
 }
 
 const std::vector<Unit> & CCBot::GetAllyUnits(sc2::UNIT_TYPEID type)
 {
-	return m_allyUnitsPerType[type];
+	return findUnitsOfType(m_allyUnitsPerType, type);
 }
 
 const std::vector<Unit> CCBot::GetAllyDepotUnits()
@@ -2638,7 +2727,7 @@ const std::vector<Unit> CCBot::GetAllyGeyserUnits()
 	}
 }
 
-std::map<sc2::Tag, Unit> & CCBot::GetEnemyUnits()
+UnitRegistry & CCBot::GetEnemyUnits()
 {
 	return m_enemyUnits;
 }
@@ -2658,10 +2747,10 @@ const std::vector<Unit> & CCBot::GetKnownEnemyUnits() const
 
 const std::vector<Unit> & CCBot::GetEnemyUnits(sc2::UnitTypeID type)
 {
-	return m_enemyUnitsPerType[type];
+	return findUnitsOfType(m_enemyUnitsPerType, type.ToType());
 }
 
-std::map<sc2::Tag, Unit> & CCBot::GetNeutralUnits()
+UnitRegistry & CCBot::GetNeutralUnits()
 {
 	return m_neutralUnits;
 }
@@ -2733,45 +2822,19 @@ void CCBot::OnError(const std::vector<sc2::ClientError> & client_errors, const s
 	}
 }
 
-void CCBot::StartProfiling(const std::string & profilerName)
-{
-	auto & profiler = m_profilingTimes[profilerName];	// Get the profiling queue tuple
-	profiler.start = std::chrono::steady_clock::now();	// Set the start time (third element of the tuple) to now
-}
-
-void CCBot::StopProfiling(const std::string & profilerName)
-{
-	auto & profiler = m_profilingTimes[profilerName];	// Get the profiling queue tuple
-
-	const auto elapsedTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - profiler.start).count();
-
-	profiler.total += elapsedTime;								// Add the time to the total of the last 100 steps
-	profiler.count++;											// Increase the number of times that profiler has been called
-	auto & queue = profiler.queue;
-	if (queue.empty())
-	{
-		while (queue.size() < 49)
-			queue.push_front(std::make_pair(0, 0));			// Fill up the queue with zeros
-		queue.push_front(std::make_pair(elapsedTime, 1));	// Add the time and count to the queue
-	}
-	else
-	{
-		queue[0].first += elapsedTime;							// Add the time to the queue
-		queue[0].second++;										// Increase the number of time that profiler has been called in that frame
-	}
-}
-
 void CCBot::drawProfilingInfo()
 {
-	const std::string stepString = "0.0 OnStep";
+	const auto & entries = Profiler::CollectFrame();
 	long long stepTime = 0;
 	long long currentStepTime = 0;
-	const auto it = m_profilingTimes.find(stepString);
-	if(it != m_profilingTimes.end())
+	for (const auto & entry : entries)
 	{
-		const auto & profiler = (*it).second;
-		stepTime = profiler.total / profiler.queue.size();
-		currentStepTime = profiler.queue[0].first;
+		if (entry.depth == 0 && *entry.name == "OnStep")
+		{
+			stepTime = entry.averageTime;
+			currentStepTime = entry.frameTime;
+			break;
+		}
 	}
 
 	std::string profilingInfo = "Profiling info (ms)";
@@ -2782,24 +2845,13 @@ void CCBot::drawProfilingInfo()
 		profilingInfo += "\nTotal skipped " + std::to_string(m_skippedFrames) + " frames.";
 		profilingInfo += "\nSkipped " + std::to_string(skipped) + " frames since last loop.";
 	}
-	for (auto & mapPair : m_profilingTimes)
+	for (const auto & entry : entries)
 	{
-		const std::string& key = mapPair.first;
-		auto& profiler = m_profilingTimes.at(key);
-		auto& queue = profiler.queue;
-		const int queueCount = queue.size();
-		const long long time = profiler.total / std::max(queueCount, 1);
-		if (key == stepString)
+		const long long time = entry.averageTime;
+		if (entry.depth == 0 && *entry.name == "OnStep")
 		{
-			long long maxFrameTime = 0;
-			for(const auto & frame : queue)
-			{
-				const auto frameTime = frame.first;
-				if (frameTime > maxFrameTime)
-					maxFrameTime = frameTime;
-			}
-			profilingInfo += "\n Recent Frame Max: " + std::to_string(0.001f * maxFrameTime);
-			if(maxFrameTime > 40900)	//limit for a frame in real time
+			profilingInfo += "\n Recent Frame Max: " + std::to_string(0.001f * entry.maxFrameTime);
+			if (entry.maxFrameTime > 40900)	//limit for a frame in real time
 			{
 				profilingInfo += "!!!";
 			}
@@ -2807,37 +2859,30 @@ void CCBot::drawProfilingInfo()
 		}
 		else if (time * 10 > stepTime)
 		{
-			profilingInfo += "\n" + key + ": (" + std::to_string(profiler.count) + ") " + std::to_string(0.001f * time);
+			profilingInfo += "\n" + std::string(2 * entry.depth, ' ') + *entry.name + ": (" + std::to_string(entry.calls) + ") " + std::to_string(0.001f * time);
 			profilingInfo += " !";
 			if (time * 4 > stepTime)
 			{
 				profilingInfo += "!!";
-				/*if(GetCurrentFrame() - m_lastProfilingLagOutput >= 25 && stepTime > 10000)	// >10ms
-				{
-					m_lastProfilingLagOutput = GetCurrentFrame();
-					Util::Log(__FUNCTION__, mapPair.first + " took " + std::to_string(0.001f * time) + "ms", *this);
-				}*/
 			}
 		}
 
 		// Log only when frames take over 100ms and that specific block of code took more than 5ms
-		if (currentStepTime >= Config().LogFrameDurationThreshold * 1000 && queue.size() > 0 && queue[0].first > 5000)
+		if (currentStepTime >= Config().LogFrameDurationThreshold * 1000 && entry.frameTime > 5000)
 		{
-			Util::Log(__FUNCTION__, mapPair.first + " took " + std::to_string(0.001f * queue[0].first) + "ms for " + std::to_string(queue[0].second) + " calls", *this);
-		}
-
-		if(queue.size() >= 50)
-		{
-			queue.push_front(std::make_pair(0, 0));
-			profiler.total -= queue[50].first;
-			profiler.count -= queue[50].second;
-			queue.pop_back();
+			Util::Log(__FUNCTION__, std::string(2 * entry.depth, ' ') + *entry.name + " took " + std::to_string(0.001f * entry.frameTime) + "ms for " + std::to_string(entry.frameCalls) + " calls", *this);
 		}
 	}
 	if (m_config.DrawProfilingInfo)
 	{
 		m_map.drawTextScreen(0.72f, 0.1f, profilingInfo);
 	}
+
+	m_latencyGovernor.onStep(currentStepTime);
+
+	// After the step duration was measured, the replay is not part of our latency
+	if (Config().BenchmarkPathfinding)
+		Util::PathFinding::RunPathfindingBenchmark(*this);
 }
 
 void CCBot::drawTimeControl()
@@ -38,6 +38,11 @@
 #include "TechTree.h"
 #include "Unit.h"
 #include "RepairStationManager.h"
+#include "UnitRegistry.h"
+#include "Profiler.h"
+#include "LatencyGovernor.h"
+#include "GameInterfaces.h"
+#include "GameSnapshot.h"
 
 #include <csetjmp>
 
@@ -47,15 +52,6 @@ extern jmp_buf gBuffer;
 
 class CCBot : public sc2::Agent 
 {
-	struct Profiler
-	{
-		Profiler() :total(0), count(0) {};
-		std::deque<std::pair<long long, int>> queue;
-		long long total;
-		int count;
-		std::chrono::steady_clock::time_point start;
-	};
-
 	//TEMP [deleteAllTheseTagsAtOnce] all 4 variables below are just for debug, delete them when the action bug test is deleted
 	int actionFrame = 0;
 	int actionTotal = 0;
@@ -65,7 +61,6 @@ class CCBot : public sc2::Agent
 	uint32_t				m_gameLoop = 0;
 	uint32_t				m_previousGameLoop;
 	int						m_previousMacroGameLoop;
-	bool					m_combatSimulatorInitialized = false;
 	uint32_t				m_skippedFrames;
 	uint32_t				m_lastProfilingLagOutput = 0;
     MapTools                m_map;
@@ -78,6 +73,8 @@ class CCBot : public sc2::Agent
     BotConfig               m_config;
     TechTree                m_techTree;
 	CombatAnalyzer			m_combatAnalyzer;
+	LatencyGovernor			m_latencyGovernor;
+	GameSnapshotRecorder	m_snapshotRecorder;
     GameCommander           m_gameCommander;
 	CCPosition				m_startLocation;
 	CCTilePosition			m_buildingArea;
@@ -86,9 +83,9 @@ class CCBot : public sc2::Agent
 	std::map<sc2::UNIT_TYPEID, int> m_unitCount;
 	std::map<sc2::UNIT_TYPEID, int> m_unitCompletedCount;
 	std::map<sc2::UNIT_TYPEID, int> m_deadAllyUnitsCount;
-	std::map<sc2::Tag, Unit> m_allyUnits;
-	std::map<sc2::Tag, Unit> m_enemyUnits;
-	std::map<sc2::Tag, Unit> m_neutralUnits;
+	UnitRegistry m_allyUnits;
+	UnitRegistry m_enemyUnits;
+	UnitRegistry m_neutralUnits;
 	std::set<sc2::Tag> m_parasitedUnits;
 	std::map<sc2::Tag, std::pair<CCPosition, uint32_t>> m_lastSeenPosUnits;
 	std::map<sc2::Tag, CCPosition> m_previousFrameEnemyPos;
@@ -98,8 +95,8 @@ class CCBot : public sc2::Agent
 	std::vector<Unit>		m_enemyBuildings;
 	std::vector<Unit>		m_enemyBuildingsUnderConstruction;
     std::vector<CCPosition> m_enemyBaseLocations;
-	std::map<sc2::UNIT_TYPEID, std::vector<Unit>> m_enemyUnitsPerType;
-	std::map<sc2::UNIT_TYPEID, std::vector<Unit>> m_allyUnitsPerType;
+	std::vector<std::vector<Unit>> m_enemyUnitsPerType;	// indexed by UNIT_TYPEID
+	std::vector<std::vector<Unit>> m_allyUnitsPerType;	// indexed by UNIT_TYPEID
 	std::map<const sc2::Unit *, std::set<const sc2::Unit *>> m_enemyUnitsBeingRepaired;
 	std::set<const sc2::Unit *> m_enemyRepairingSCVs;
 	std::set<const sc2::Unit *> m_enemySCVBuilders;
@@ -107,7 +104,6 @@ class CCBot : public sc2::Agent
 	std::list<sc2::Units> m_stackedEnemyWorkers;
 	CCRace selfRace;
 	CCRace enemyRace = sc2::Random;
-	std::map<std::string, Profiler> m_profilingTimes;
 	std::mutex m_command_mutex;
 	bool m_concede;
 	bool m_saidHallucinationLine;
@@ -116,6 +112,13 @@ class CCBot : public sc2::Agent
 	std::string m_opponentId;
 	bool m_player1IsHuman;
 	bool m_realtime;
+	bool m_offline = false;
+	LiveGameObservation m_liveObservation;
+	LiveGameQuery m_liveQuery;
+	LiveGameActions m_liveActions;
+	GameObservation * m_observation;
+	GameQuery * m_query;
+	GameActions * m_actions;
 	std::stringstream m_versionMessage;
 	int m_totalSentActions = 0;
 	int m_currentAPM = 0;
@@ -141,6 +144,10 @@ class CCBot : public sc2::Agent
 	bool keyF2 = false;
 
 	void checkKeyState();
+	// Only called while the units are stored, since it can grow the vector and invalidate the references to the other types
+	static std::vector<Unit> & getUnitsOfType(std::vector<std::vector<Unit>> & unitsPerType, sc2::UNIT_TYPEID type);
+	static const std::vector<Unit> & findUnitsOfType(const std::vector<std::vector<Unit>> & unitsPerType, sc2::UNIT_TYPEID type);
+	static void clearUnitsPerType(std::vector<std::vector<Unit>> & unitsPerType);
 	void setUnits();
 	void identifyEnemyRepairingSCVs();
 	void identifyEnemySCVBuilders();
@@ -174,11 +181,22 @@ public:
 	void OnUnitEnterVision(const sc2::Unit*) override;
 	void OnNuclearLaunchDetected() override;
 
+	// Hide the interfaces of sc2::Agent, the bot only reaches the game through these
+	const GameObservation * Observation() const { return m_observation; }
+	GameQuery * Query() { return m_query; }
+	GameActions * Actions() { return m_actions; }
+	// For libvoxelbot, that needs the observation of the real game
+	const sc2::ObservationInterface * APIObservation() const { return sc2::Agent::Observation(); }
+	// Replaces the game by other implementations of the interfaces (used by the offline harness), before OnGameStart
+	void SetOfflineGame(GameObservation * observation, GameQuery * query, GameActions * actions);
+	bool IsOffline() const { return m_offline; }
+
           BotConfig & Config();
           WorkerManager & Workers();
 		  BuildingManager & Buildings();
 		  BaseLocationManager & Bases();
 		  CombatAnalyzer & Analyzer();
+	const LatencyGovernor & Latency() const { return m_latencyGovernor; }
 		  GameCommander & Commander();
 		  TechTree & Tech() { return m_techTree; }
     const MapTools & Map() const;
@@ -220,11 +238,11 @@ public:
 	int GetUnitCount(sc2::UNIT_TYPEID type, bool completed = false, bool underConstruction = false);
 	const std::map<sc2::UNIT_TYPEID, int> & GetCompletedUnitCounts() const { return m_unitCompletedCount; }
 	int GetDeadAllyUnitsCount(sc2::UNIT_TYPEID type) const;
-	std::map<sc2::Tag, Unit> & GetAllyUnits();
+	UnitRegistry & GetAllyUnits();
 	const std::vector<Unit> & GetAllyUnits(sc2::UNIT_TYPEID type);
 	const std::vector<Unit> GetAllyDepotUnits();//Cannot be by reference, vector created in function
 	const std::vector<Unit> GetAllyGeyserUnits();//Cannot be by reference, vector created in function
-	std::map<sc2::Tag, Unit> & GetEnemyUnits();
+	UnitRegistry & GetEnemyUnits();
 	const std::map<const sc2::Unit *, std::set<const sc2::Unit *>> & GetEnemyUnitsBeingRepaired() const { return m_enemyUnitsBeingRepaired; }
 	const std::set<const sc2::Unit *> & GetEnemyRepairingSCVs() const { return m_enemyRepairingSCVs; }
 	const std::set<const sc2::Unit *> & GetEnemySCVBuilders() const { return m_enemySCVBuilders; }
@@ -234,13 +252,11 @@ public:
 	const std::vector<Unit> & GetEnemyUnits(sc2::UnitTypeID type);
 	const std::vector<Unit> & GetEnemyBuildings() const { return m_enemyBuildings; }
 	const std::vector<Unit> & GetEnemyBuildingsUnderConstruction() const { return m_enemyBuildingsUnderConstruction; }
-	std::map<sc2::Tag, Unit> & GetNeutralUnits();
+	UnitRegistry & GetNeutralUnits();
 	bool IsParasited(const sc2::Unit * unit) const;
 	std::map<sc2::Tag, CCPosition> & GetPreviousFrameEnemyPos() { return m_previousFrameEnemyPos; }
     const std::vector<CCPosition> & GetStartLocations() const;
     const std::vector<CCPosition> & GetEnemyStartLocations() const;
-	void StartProfiling(const std::string & profilerName);
-	void StopProfiling(const std::string & profilerName);
 	void drawTimeControl();
 	std::mutex & GetCommandMutex();
 	bool shouldConcede() const { return m_concede; }
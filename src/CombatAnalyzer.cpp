@@ -17,15 +17,15 @@ void CombatAnalyzer::onFrame()
 {
 	clearAreasUnderDetection();
 	//Handle our units
-	m_bot.StartProfiling("0.10.4.4    checkUnitsState");
+	PROFILE_BEGIN("checkUnitsState");
 	checkUnitsState();
-	m_bot.StopProfiling("0.10.4.4    checkUnitsState");
-	m_bot.StartProfiling("0.10.4.5    UpdateTotalHealthLoss");
+	PROFILE_END("checkUnitsState");
+	PROFILE_BEGIN("UpdateTotalHealthLoss");
 	UpdateTotalHealthLoss();
-	m_bot.StartProfiling("0.10.4.5    UpdateTotalHealthLoss");
-	m_bot.StartProfiling("0.10.4.6    UpdateRatio");
+	PROFILE_END("UpdateTotalHealthLoss");
+	PROFILE_BEGIN("UpdateRatio");
 	UpdateRatio();
-	m_bot.StartProfiling("0.10.4.6    UpdateRatio");
+	PROFILE_END("UpdateRatio");
 
 	drawDamageHealthRatio();
 
@@ -41,7 +41,7 @@ void CombatAnalyzer::onFrame()
 
 void CombatAnalyzer::lowPriorityChecks()
 {
-	if (m_bot.GetGameLoop() - m_lastLowPriorityFrame < 10)
+	if (m_bot.GetGameLoop() - m_lastLowPriorityFrame < 10 * m_bot.Latency().getLowPriorityChecksMultiplier())
 	{
 		return;
 	}
@@ -541,14 +541,14 @@ void CombatAnalyzer::drawDamageHealthRatio()
 
 void CombatAnalyzer::checkUnitsState()
 {
-	m_bot.StartProfiling("0.10.4.4.1      resetStates");
+	PROFILE_BEGIN("resetStates");
 	for (auto & state : m_unitStates)
 	{
 		state.second.Reset();
 	}
-	m_bot.StopProfiling("0.10.4.4.1      resetStates");
+	PROFILE_END("resetStates");
 
-	m_bot.StartProfiling("0.10.4.4.2      updateStates");
+	PROFILE_BEGIN("updateStates");
 	for (auto & unit : m_bot.Commander().getValidUnits())
 	{
 		checkUnitState(unit);
@@ -557,9 +557,9 @@ void CombatAnalyzer::checkUnitsState()
 	{
 		checkUnitState(building.buildingUnit);
 	}
-	m_bot.StopProfiling("0.10.4.4.2      updateStates");
+	PROFILE_END("updateStates");
 
-	m_bot.StartProfiling("0.10.4.4.3      removeStates");
+	PROFILE_BEGIN("removeStates");
 	std::vector<CCUnitID> toRemove;
 	for (auto & state : m_unitStates)
 	{
@@ -577,7 +577,7 @@ void CombatAnalyzer::checkUnitsState()
 	{
 		m_unitStates.erase(tag);
 	}
-	m_bot.StopProfiling("0.10.4.4.3      removeStates");
+	PROFILE_END("removeStates");
 }
 
 void CombatAnalyzer::checkUnitState(Unit unit)
@@ -587,7 +587,7 @@ void CombatAnalyzer::checkUnitState(Unit unit)
 		return;
 	}
 
-	m_bot.StartProfiling("0.10.4.4.2.1        addState");
+	PROFILE_BEGIN("addState");
 	auto tag = unit.getTag();
 
 	auto it = m_unitStates.find(tag);
@@ -596,19 +596,19 @@ void CombatAnalyzer::checkUnitState(Unit unit)
 		UnitState state = UnitState(unit.getUnitPtr());
 		state.Update();
 		m_unitStates[tag] = state;
-		m_bot.StopProfiling("0.10.4.4.2.1        addState");
+		PROFILE_END("addState");
 		return;
 	}
-	m_bot.StopProfiling("0.10.4.4.2.1        addState");
+	PROFILE_END("addState");
 
-	m_bot.StartProfiling("0.10.4.4.2.2        updateState");
+	PROFILE_BEGIN("updateState");
 	UnitState & state = it->second;
 	state.Update(unit.getHitPoints(), unit.getShields(), unit.getEnergy());
-	m_bot.StopProfiling("0.10.4.4.2.2        updateState");
+	PROFILE_END("updateState");
 	if (state.WasAttacked())
 	{
 		// TODO remove when we can detect all range upgrades
-		m_bot.StartProfiling("0.10.4.4.2.1        checkForRangeUpgrade");
+		PROFILE_BEGIN("checkForRangeUpgrade");
 		const CCTilePosition tilePosition = Util::GetTilePosition(unit.getPosition());
 		if (Util::PathFinding::HasCombatInfluenceOnTile(tilePosition, unit.isFlying(), m_bot))
 		{
@@ -626,10 +626,10 @@ void CombatAnalyzer::checkUnitState(Unit unit)
 				}
 			}
 		}
-		m_bot.StopProfiling("0.10.4.4.2.1        checkForRangeUpgrade");
+		PROFILE_END("checkForRangeUpgrade");
 		if (unit.getUnitPtr() != m_bot.Commander().Combat().getFirstProxyReaperToGoThroughNatural())
 		{
-			m_bot.StartProfiling("0.10.4.4.2.2        checkForDangerousBunker");
+			PROFILE_BEGIN("checkForDangerousBunker");
 			for (const auto & enemyBunker : m_bot.GetEnemyUnits(sc2::UNIT_TYPEID::TERRAN_BUNKER))
 			{
 				float bunkerRange = enemyBunker.getUnitPtr()->radius + unit.getUnitPtr()->radius + (unit.isFlying() ? 6 : 7);
@@ -638,14 +638,14 @@ void CombatAnalyzer::checkUnitState(Unit unit)
 					m_bot.Commander().Combat().setBunkerIsDangerous(enemyBunker.getUnitPtr());
 				}
 			}
-			m_bot.StopProfiling("0.10.4.4.2.2        checkForDangerousBunker");
+			PROFILE_END("checkForDangerousBunker");
 		}
-		m_bot.StartProfiling("0.10.4.4.2.3        saveDetectedArea");
+		PROFILE_BEGIN("saveDetectedArea");
 		if (unit.getUnitPtr()->cloak == sc2::Unit::CloakedAllied && !Util::IsPositionUnderDetection(unit.getPosition(), m_bot))
 		{
 			m_areasUnderDetection.push_back({ unit.getPosition(), m_bot.GetGameLoop() });
 		}
-		m_bot.StopProfiling("0.10.4.4.2.3        saveDetectedArea");
+		PROFILE_END("saveDetectedArea");
 
 		//Is building underconstruction. Cancel building
 		if (unit.isBeingConstructed())
@@ -658,13 +658,13 @@ void CombatAnalyzer::checkUnitState(Unit unit)
 		}
 		
 		//TODO Temporarily commented out since the logic isn't finishes
-		/*m_bot.StartProfiling("0.10.4.4.2.3        detectUpgrades");
+		/*PROFILE_BEGIN("detectUpgrades");
 		detectUpgrades(unit, state);
-		m_bot.StopProfiling("0.10.4.4.2.3        detectUpgrades");
+		PROFILE_END("detectUpgrades");
 
-		m_bot.StartProfiling("0.10.4.4.2.3        detectTechs");
+		PROFILE_BEGIN("detectTechs");
 		detectTechs(unit, state);
-		m_bot.StopProfiling("0.10.4.4.2.3        detectTechs");*/
+		PROFILE_END("detectTechs");*/
 	}
 }
 
@@ -964,7 +964,7 @@ void CombatAnalyzer::detectUpgrades(Unit & unit, UnitState & state)
 
 void CombatAnalyzer::detectTechs(Unit & unit, UnitState & state)
 {
-	m_bot.StartProfiling("0.10.4.4.2.3.1      checkForRangeUpgrade");
+	PROFILE_BEGIN("checkForRangeUpgrade");
 	const CCTilePosition tilePosition = Util::GetTilePosition(unit.getPosition());
 	if (Util::PathFinding::HasCombatInfluenceOnTile(tilePosition, unit.isFlying(), m_bot))
 	{
@@ -982,7 +982,7 @@ void CombatAnalyzer::detectTechs(Unit & unit, UnitState & state)
 			}
 		}
 	}
-	m_bot.StopProfiling("0.10.4.4.2.3.1      checkForRangeUpgrade");
+	PROFILE_END("checkForRangeUpgrade");
 }
 
 std::set<const sc2::Unit *> CombatAnalyzer::getBurrowedAndInvisUnits() const
@@ -33,6 +33,7 @@ const int ACTION_REEXECUTION_FREQUENCY = 50;
 CombatCommander::CombatCommander(CCBot & bot)
     : m_bot(bot)
     , m_squadData(bot)
+	, m_flowFields(bot)
     , m_initialized(false)
     , m_attackStarted(false)
 	, m_currentBaseExplorationIndex(0)
@@ -229,68 +230,70 @@ void CombatCommander::onFrame(const std::vector<Unit> & combatUnits)
 	Util::CCUnitsToSc2Units(combatUnits, units);
 	m_unitsAbilities = m_bot.Query()->GetAbilitiesForUnits(units);
 
-	m_bot.StartProfiling("0.10.4.0    updateInfluenceMaps");
+	PROFILE_BEGIN("updateInfluenceMaps");
 	updateInfluenceMaps();
-	m_bot.StopProfiling("0.10.4.0    updateInfluenceMaps");
+	PROFILE_END("updateInfluenceMaps");
 
-	m_bot.StartProfiling("0.10.4.3    CalcBestFlyingCycloneHelpers");
+	m_flowFields.onFrame();
+
+	PROFILE_BEGIN("CalcBestFlyingCycloneHelpers");
 	CalcBestFlyingCycloneHelpers();
-	m_bot.StopProfiling("0.10.4.3    CalcBestFlyingCycloneHelpers");
+	PROFILE_END("CalcBestFlyingCycloneHelpers");
 
-	m_bot.StartProfiling("0.10.4.5    updateIdlePosition");
+	PROFILE_BEGIN("updateIdlePosition");
 	updateIdlePosition();
-	m_bot.StopProfiling("0.10.4.5    updateIdlePosition");
+	PROFILE_END("updateIdlePosition");
 
-	m_bot.StartProfiling("0.10.4.2    updateSquads");
+	PROFILE_BEGIN("updateSquads");
 #ifndef NO_MICRO
     if (isSquadUpdateFrame())
     {
-		m_bot.StartProfiling("0.10.4.2.a    updateIdleSquad");
+		PROFILE_BEGIN("updateIdleSquad");
 		updateIdleSquad();
-		m_bot.StopProfiling("0.10.4.2.a    updateIdleSquad");
-		m_bot.StartProfiling("0.10.4.2.b    updateBackupSquads");
+		PROFILE_END("updateIdleSquad");
+		PROFILE_BEGIN("updateBackupSquads");
 		updateBackupSquads();
-		m_bot.StopProfiling("0.10.4.2.b    updateBackupSquads");
-		m_bot.StartProfiling("0.10.4.2.c    updateWorkerFleeSquad");
+		PROFILE_END("updateBackupSquads");
+		PROFILE_BEGIN("updateWorkerFleeSquad");
 		updateWorkerFleeSquad();
-		m_bot.StopProfiling("0.10.4.2.c    updateWorkerFleeSquad");
-		m_bot.StartProfiling("0.10.4.2.d    updateScoutDefenseSquad");
+		PROFILE_END("updateWorkerFleeSquad");
+		PROFILE_BEGIN("updateScoutDefenseSquad");
         updateScoutDefenseSquad();
-		m_bot.StopProfiling("0.10.4.2.d    updateScoutDefenseSquad");
-		m_bot.StartProfiling("0.10.4.2.1    updateDefenseBuildings");
+		PROFILE_END("updateScoutDefenseSquad");
+		PROFILE_BEGIN("updateDefenseBuildings");
 		updateDefenseBuildings();
-		m_bot.StopProfiling("0.10.4.2.1    updateDefenseBuildings");
-		m_bot.StartProfiling("0.10.4.2.2    updateDefenseSquads");
+		PROFILE_END("updateDefenseBuildings");
+		PROFILE_BEGIN("updateDefenseSquads");
         updateDefenseSquads();
-		m_bot.StopProfiling("0.10.4.2.2    updateDefenseSquads");
-		m_bot.StartProfiling("0.10.4.2.e    updateClearExpandSquads");
+		PROFILE_END("updateDefenseSquads");
+		PROFILE_BEGIN("updateClearExpandSquads");
 		updateClearExpandSquads();
-		m_bot.StopProfiling("0.10.4.2.e    updateClearExpandSquads");
-		m_bot.StartProfiling("0.10.4.2.f    updateScoutSquad");
+		PROFILE_END("updateClearExpandSquads");
+		PROFILE_BEGIN("updateScoutSquad");
 		updateScoutSquad();
-		m_bot.StopProfiling("0.10.4.2.f    updateScoutSquad");
-		m_bot.StartProfiling("0.10.4.2.3    updateHarassSquads");
+		PROFILE_END("updateScoutSquad");
+		PROFILE_BEGIN("updateHarassSquads");
 		updateHarassSquads();
-		m_bot.StopProfiling("0.10.4.2.3    updateHarassSquads");
-		m_bot.StartProfiling("0.10.4.2.4    updateAttackSquads");
+		PROFILE_END("updateHarassSquads");
+		PROFILE_BEGIN("updateAttackSquads");
 		updateAttackSquads();
-		m_bot.StopProfiling("0.10.4.2.4    updateAttackSquads");
+		PROFILE_END("updateAttackSquads");
     }
 #endif // !NO_MICRO
 	drawCombatInformation();
-	m_bot.StopProfiling("0.10.4.2    updateSquads");
+	PROFILE_END("updateSquads");
 
-	m_bot.StartProfiling("0.10.4.1    m_squadData.onFrame");
+	PROFILE_BEGIN("m_squadData.onFrame");
 	m_squadData.onFrame();
-	m_bot.StopProfiling("0.10.4.1    m_squadData.onFrame");
+	PROFILE_END("m_squadData.onFrame");
 
-	m_bot.StartProfiling("0.10.4.6    ExecuteActions");
+	PROFILE_BEGIN("ExecuteActions");
 	ExecuteActions();
-	m_bot.StopProfiling("0.10.4.6    ExecuteActions");
+	PROFILE_END("ExecuteActions");
 
-	m_bot.StartProfiling("0.10.4.4    lowPriorityCheck");
+	PROFILE_BEGIN("lowPriorityCheck");
 	lowPriorityCheck();
-	m_bot.StopProfiling("0.10.4.4    lowPriorityCheck");
+	PROFILE_END("lowPriorityCheck");
 
 	drawMainBaseSiegePositions();
 }
@@ -405,15 +408,15 @@ void CombatCommander::resetInfluenceMaps()
 
 void CombatCommander::updateInfluenceMaps()
 {
-	m_bot.StartProfiling("0.10.4.0.1      resetInfluenceMaps");
+	PROFILE_BEGIN("resetInfluenceMaps");
 	resetInfluenceMaps();
-	m_bot.StopProfiling("0.10.4.0.1      resetInfluenceMaps");
-	m_bot.StartProfiling("0.10.4.0.2      updateInfluenceMapsWithUnits");
+	PROFILE_END("resetInfluenceMaps");
+	PROFILE_BEGIN("updateInfluenceMapsWithUnits");
 	updateInfluenceMapsWithUnits();
-	m_bot.StopProfiling("0.10.4.0.2      updateInfluenceMapsWithUnits");
-	m_bot.StartProfiling("0.10.4.0.3      updateInfluenceMapsWithEffects");
+	PROFILE_END("updateInfluenceMapsWithUnits");
+	PROFILE_BEGIN("updateInfluenceMapsWithEffects");
 	updateInfluenceMapsWithEffects();
-	m_bot.StopProfiling("0.10.4.0.3      updateInfluenceMapsWithEffects");
+	PROFILE_END("updateInfluenceMapsWithEffects");
 	
 	drawInfluenceMaps();	
 	drawBlockedTiles();
@@ -794,7 +797,7 @@ void CombatCommander::drawInfluenceMaps()
 #endif
 	if (m_bot.Config().DrawInfluenceMaps)
 	{
-		m_bot.StartProfiling("0.10.4.0.4      drawInfluenceMaps");
+		PROFILE_BEGIN("drawInfluenceMaps");
 		const size_t mapWidth = m_bot.Map().totalWidth();
 		const size_t mapHeight = m_bot.Map().totalHeight();
 		for (size_t x = 0; x < mapWidth; ++x)
@@ -831,7 +834,7 @@ void CombatCommander::drawInfluenceMaps()
 				}
 			}
 		}
-		m_bot.StopProfiling("0.10.4.0.4      drawInfluenceMaps");
+		PROFILE_END("drawInfluenceMaps");
 	}
 }
 
@@ -842,7 +845,7 @@ void CombatCommander::drawBlockedTiles()
 #endif
 	if (m_bot.Config().DrawBlockedTiles)
 	{
-		m_bot.StartProfiling("0.10.4.0.5      drawBlockedTiles");
+		PROFILE_BEGIN("drawBlockedTiles");
 		const size_t mapWidth = m_bot.Map().totalWidth();
 		const size_t mapHeight = m_bot.Map().totalHeight();
 		for (size_t x = 0; x < mapWidth; ++x)
@@ -854,7 +857,7 @@ void CombatCommander::drawBlockedTiles()
 					m_bot.Map().drawTile(x, y, sc2::Colors::Red);
 			}
 		}
-		m_bot.StopProfiling("0.10.4.0.5      drawBlockedTiles");
+		PROFILE_END("drawBlockedTiles");
 	}
 }
 
@@ -1692,7 +1695,7 @@ void CombatCommander::updateAttackSquads()
 				hasGround = hasGround || !ally->is_flying;
 				hasAir = hasAir || ally->is_flying;
 			}
-			m_bot.StartProfiling("0.10.4.2.3.0     calcEnemies");
+			PROFILE_BEGIN("calcEnemies");
 			sc2::Units enemyUnits;
 			for (const auto & enemyUnitPair : m_bot.GetEnemyUnits())
 			{
@@ -1729,13 +1732,13 @@ void CombatCommander::updateAttackSquads()
 						enemyUnits.push_back(enemyUnit.getUnitPtr());
 				}
 			}
-			m_bot.StopProfiling("0.10.4.2.3.0     calcEnemies");
-			m_bot.StartProfiling("0.10.4.2.3.1     simulateCombat");
+			PROFILE_END("calcEnemies");
+			PROFILE_BEGIN("simulateCombat");
 			bool considerOurSiegeTanksUnsieged = !m_winAttackSimulation;
 			bool stopSimulationWhenGroupHasNoTarget = false;
 			const auto simulationResult = Util::SimulateCombat(allyUnits, enemyUnits, considerOurSiegeTanksUnsieged, stopSimulationWhenGroupHasNoTarget, m_bot);
 			float armyRemainingDifference = simulationResult.supplyPercentageRemaining - simulationResult.enemySupplyPercentageRemaining;
-			m_bot.StopProfiling("0.10.4.2.3.1     simulateCombat");
+			PROFILE_END("simulateCombat");
 			if (m_winAttackSimulation)
 			{
 				m_winAttackSimulation = armyRemainingDifference > 0.f || m_bot.GetCurrentSupply() >= 195;
@@ -1926,9 +1929,9 @@ void CombatCommander::updateScoutDefenseSquad()
 
 void CombatCommander::updateDefenseBuildings()
 {
-	m_bot.StartProfiling("0.10.4.2.1.1     handleWall");
+	PROFILE_BEGIN("handleWall");
 	handleWall();
-	m_bot.StopProfiling("0.10.4.2.1.1     handleWall");
+	PROFILE_END("handleWall");
 	lowerSupplyDepots();
 }
 
@@ -1939,7 +1942,7 @@ void CombatCommander::handleWall()
 	const auto wallCenter = m_bot.Buildings().getWallPosition();
 	auto & enemies = m_bot.GetKnownEnemyUnits();
 
-	m_bot.StartProfiling("0.10.4.2.1.1.1      CheckEnemies");
+	PROFILE_BEGIN("CheckEnemies");
 	// If there is at least one melee unit, raise the wall. Otherwise, check if we have units that want to go back in our base
 	bool raiseWall = false;
 	float minEnemyMovementTimeToReachWall = 0;
@@ -1957,11 +1960,11 @@ void CombatCommander::handleWall()
 			raiseWall = true;
 		}
 	}
-	m_bot.StopProfiling("0.10.4.2.1.1.1      CheckEnemies");
+	PROFILE_END("CheckEnemies");
 	// Check if we have units that would like to come back to our base. In that case, if they are fast enough to enter without getting followed, we don't want to raise our wall yet
 	if (raiseWall)
 	{
-		m_bot.StartProfiling("0.10.4.2.1.1.2      CheckAllies");
+		PROFILE_BEGIN("CheckAllies");
 		const auto wallHeight = m_bot.Map().terrainHeight(wallCenter);
 		CCPosition rampPosition;
 		// Check 4 tiles around the wall position to find the start of the ramp
@@ -2010,7 +2013,7 @@ void CombatCommander::handleWall()
 		{
 			raiseWall = false;
 		}
-		m_bot.StopProfiling("0.10.4.2.1.1.2      CheckAllies");
+		PROFILE_END("CheckAllies");
 	}
 	//Raise wall
 	if (raiseWall)
@@ -2234,7 +2237,7 @@ struct RegionArmyInformation
 
 void CombatCommander::updateDefenseSquads()
 {
-	m_bot.StartProfiling("0.10.4.2.2.0      prepare");
+	PROFILE_BEGIN("prepare");
 	// reset defense squads
 	for (auto & kv : m_squadData.getSquads())
 	{
@@ -2263,7 +2266,7 @@ void CombatCommander::updateDefenseSquads()
 	bases.insert(ourBases.begin(), ourBases.end());
 	if (nextExpansion)
 		bases.insert(nextExpansion);
-	m_bot.StopProfiling("0.10.4.2.2.0      prepare");
+	PROFILE_END("prepare");
 	for (BaseLocation * myBaseLocation : bases)
 	{
 		// don't defend inside the enemy region, this will end badly when we are stealing gas or cannon rushing
@@ -2275,7 +2278,7 @@ void CombatCommander::updateDefenseSquads()
 		const auto proxyBase = m_bot.Strategy().isProxyStartingStrategy() && myBaseLocation->containsPositionApproximative(Util::GetPosition(m_bot.Buildings().getProxyLocation()));
 		const auto startingBase = myBaseLocation->isStartLocation();
 
-		m_bot.StartProfiling("0.10.4.2.2.1      detectEnemiesInRegions");
+		PROFILE_BEGIN("detectEnemiesInRegions");
 		auto region = RegionArmyInformation(myBaseLocation, m_bot);
 
 		const CCPosition basePosition = Util::GetPosition(myBaseLocation->getDepotTilePosition());
@@ -2392,10 +2395,10 @@ void CombatCommander::updateDefenseSquads()
 		squadName << "Base Defense " << basePosition.x << " " << basePosition.y;
 
 		myBaseLocation->setIsUnderAttack(offensiveUnit);
-		m_bot.StopProfiling("0.10.4.2.2.1      detectEnemiesInRegions");
+		PROFILE_END("detectEnemiesInRegions");
 		if (region.enemyUnits.empty())
 		{
-			m_bot.StartProfiling("0.10.4.2.2.2      clearRegion");
+			PROFILE_BEGIN("clearRegion");
 			// if a defense squad for this region exists, remove it
 			if (m_squadData.squadExists(squadName.str()))
 			{
@@ -2413,7 +2416,7 @@ void CombatCommander::updateDefenseSquads()
 					}
 				}
 			}
-			m_bot.StopProfiling("0.10.4.2.2.2      clearRegion");
+			PROFILE_END("clearRegion");
 
 			// and return, nothing to defend here
 			continue;
@@ -2431,7 +2434,7 @@ void CombatCommander::updateDefenseSquads()
 			}
 		}
 
-		m_bot.StartProfiling("0.10.4.2.2.3      createSquad");
+		PROFILE_BEGIN("createSquad");
 		const SquadOrder defendRegion(SquadOrderTypes::Defend, closestEnemy.getPosition(), m_bot.Strategy().isWorkerRushed() ? WorkerRushDefenseOrderRadius : BaseDefenseOrderRadius, "Defend Region!");
 		// if we don't have a squad assigned to this region already, create one
 		if (!m_squadData.squadExists(squadName.str()))
@@ -2450,13 +2453,13 @@ void CombatCommander::updateDefenseSquads()
 		{
 			BOT_ASSERT(false, "Squad should have existed: %s", squadName.str().c_str());
 		}
-		m_bot.StopProfiling("0.10.4.2.2.3      createSquad");
+		PROFILE_END("createSquad");
 
-		m_bot.StartProfiling("0.10.4.2.2.4      calculateRegionInformation");
+		PROFILE_BEGIN("calculateRegionInformation");
 		region.calcEnemyPower(m_bot.Strategy().isWorkerRushed());
 		region.calcClosestEnemy(m_bot.Strategy().isWorkerRushed());
 		regions.push_back(region);
-		m_bot.StopProfiling("0.10.4.2.2.4      calculateRegionInformation");
+		PROFILE_END("calculateRegionInformation");
 	}
 
 	if (workerRushed)
@@ -2501,7 +2504,7 @@ void CombatCommander::updateDefenseSquads()
 	// If we have at least one region under attack
 	if(!regions.empty())
 	{
-		m_bot.StartProfiling("0.10.4.2.2.5      calculateRegionsScores");
+		PROFILE_BEGIN("calculateRegionsScores");
 		// We sort them (the one with the strongest enemy force is first)
 		regions.sort();
 
@@ -2641,9 +2644,9 @@ void CombatCommander::updateDefenseSquads()
 				}
 			}
 		}
-		m_bot.StopProfiling("0.10.4.2.2.5      calculateRegionsScores");
+		PROFILE_END("calculateRegionsScores");
 
-		m_bot.StartProfiling("0.10.4.2.2.6      affectUnits");
+		PROFILE_BEGIN("affectUnits");
 		while (true)
 		{
 			Unit unit;
@@ -2808,10 +2811,10 @@ void CombatCommander::updateDefenseSquads()
 			// We sort the regions so the one that needs the most support comes back first
 			regions.sort();
 		}
-		m_bot.StopProfiling("0.10.4.2.2.6      affectUnits");
+		PROFILE_END("affectUnits");
 		if (m_bot.Strategy().wasProxyStartingStrategy())
 		{
-			m_bot.StartProfiling("0.10.4.2.2.7      cancelInsufficientDefenseOnProxy");
+			PROFILE_BEGIN("cancelInsufficientDefenseOnProxy");
 			const auto proxyLocation = m_bot.Buildings().getProxyLocation();
 			for (const auto & region : regions)
 			{
@@ -2833,7 +2836,7 @@ void CombatCommander::updateDefenseSquads()
 					break;
 				}
 			}
-			m_bot.StopProfiling("0.10.4.2.2.7      cancelInsufficientDefenseOnProxy");
+			PROFILE_END("cancelInsufficientDefenseOnProxy");
 		}
 	}
 }
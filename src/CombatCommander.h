@@ -4,6 +4,7 @@
 #include "Squad.h"
 #include "SquadData.h"
 #include "BaseLocation.h"
+#include "FlowField.h"
 #include <list>  
 
 class CCBot;
@@ -127,6 +128,8 @@ const float CYCLONE_PREFERRED_MAX_DISTANCE_TO_HELPER = 4.f;
 
 class CombatCommander
 {
+	friend class MicroBenchmarks;	// times updateInfluenceMaps (offline/MicroBenchmarks.cpp)
+
 	const int FRAME_BEFORE_SIGHTING_INVALIDATED = 25;
 
     CCBot &         m_bot;
@@ -136,6 +139,7 @@ class CombatCommander
 	uint32_t m_lastIdlePositionUpdateFrame = 0;
 	CCPosition m_idlePosition;
     SquadData       m_squadData;
+	FlowFieldManager m_flowFields;
     std::vector<Unit>  m_combatUnits;
 	std::map<const sc2::Unit *, UnitAction> unitActions;
 	std::map<const sc2::Unit *, uint32_t> nextCommandFrameForUnit;
@@ -262,6 +266,7 @@ public:
 	std::set<sc2::Tag> & getToggledCyclones() { return m_toggledCyclones; }
 	const std::vector<sc2::UNIT_TYPEID> & getFrontLineTypes() const { return m_frontLineTypes; }
 	const std::vector<std::vector<bool>> & getBlockedTiles() const { return m_blockedTiles; }
+	FlowFieldManager & getFlowFields() { return m_flowFields; }
 	void setBlockedTile(int x, int y);
 	const std::map<const sc2::Unit *, FlyingHelperMission> & getCycloneFlyingHelpers() const { return m_cycloneFlyingHelpers; }
 	const std::map<const sc2::Unit *, const sc2::Unit *> & getCyclonesWithHelper() const { return m_cyclonesWithHelper; }
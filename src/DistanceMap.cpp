@@ -75,6 +75,89 @@ void DistanceMap::computeDistanceMap(CCBot & m_bot, const CCTilePosition & start
     }
 }
 
+// The tiles are written in the order of the search, the distance of a tile being its layer only the size of each layer is kept
+void DistanceMap::save(std::ostream & file) const
+{
+    std::vector<uint16_t> tiles;
+    std::vector<uint32_t> layerSizes;
+    tiles.reserve(m_sortedTiles.size() * 2);
+    for (auto & tile : m_sortedTiles)
+    {
+        tiles.push_back(uint16_t(tile.x));
+        tiles.push_back(uint16_t(tile.y));
+        const size_t dist = getDistance(tile);
+        if (dist >= layerSizes.size())
+        {
+            layerSizes.resize(dist + 1, 0);
+        }
+        ++layerSizes[dist];
+    }
+
+    const int32_t start[2] = { m_startTile.x, m_startTile.y };
+    const uint32_t sizes[2] = { uint32_t(m_sortedTiles.size()), uint32_t(layerSizes.size()) };
+    file.write(reinterpret_cast<const char *>(start), sizeof(start));
+    file.write(reinterpret_cast<const char *>(sizes), sizeof(sizes));
+    file.write(reinterpret_cast<const char *>(tiles.data()), tiles.size() * sizeof(uint16_t));
+    file.write(reinterpret_cast<const char *>(layerSizes.data()), layerSizes.size() * sizeof(uint32_t));
+}
+
+bool DistanceMap::load(std::istream & file, int width, int height)
+{
+    int32_t start[2];
+    uint32_t sizes[2];
+    if (!file.read(reinterpret_cast<char *>(start), sizeof(start)) || !file.read(reinterpret_cast<char *>(sizes), sizeof(sizes))
+        || sizes[0] > uint32_t(width * height) || sizes[1] > sizes[0])
+    {
+        return false;
+    }
+
+    std::vector<uint16_t> tiles(sizes[0] * 2);
+    std::vector<uint32_t> layerSizes(sizes[1]);
+    if (!file.read(reinterpret_cast<char *>(tiles.data()), tiles.size() * sizeof(uint16_t))
+        || !file.read(reinterpret_cast<char *>(layerSizes.data()), layerSizes.size() * sizeof(uint32_t)))
+    {
+        return false;
+    }
+
+    // Reject the files whose layers do not cover exactly the stored tiles before indexing them
+    uint64_t layerTileCount = 0;
+    for (const uint32_t layerSize : layerSizes)
+    {
+        layerTileCount += layerSize;
+    }
+    if (layerTileCount != sizes[0] || start[0] < 0 || start[1] < 0 || start[0] >= width || start[1] >= height)
+    {
+        return false;
+    }
+
+    m_startTile = CCTilePosition(start[0], start[1]);
+    m_width = width;
+    m_height = height;
+    m_dist = std::vector<std::vector<int>>(m_width, std::vector<int>(m_height, -1));
+    m_sortedTiles.clear();
+    m_sortedTiles.reserve(sizes[0]);
+    size_t index = 0;
+    for (size_t dist = 0; dist < layerSizes.size(); ++dist)
+    {
+        for (uint32_t i = 0; i < layerSizes[dist]; ++i, ++index)
+        {
+            if (index >= sizes[0])
+            {
+                return false;
+            }
+            const int x = tiles[index * 2];
+            const int y = tiles[index * 2 + 1];
+            if (x >= m_width || y >= m_height)
+            {
+                return false;
+            }
+            m_dist[x][y] = int(dist);
+            m_sortedTiles.push_back(CCTilePosition(x, y));
+        }
+    }
+    return index == sizes[0];
+}
+
 void DistanceMap::draw(CCBot & bot) const
 {
     const int tilesToDraw = 200;
@@ -21,6 +21,8 @@ public:
     
     DistanceMap();
     void computeDistanceMap(CCBot & m_bot, const CCTilePosition & startTile);
+    void save(std::ostream & file) const;
+    bool load(std::istream & file, int width, int height);
 
     int getDistance(int tileX, int tileY) const;
     int getDistance(const CCTilePosition & pos) const;
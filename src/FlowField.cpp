@@ -0,0 +1,289 @@
+#include "FlowField.h"
+#include "CCBot.h"
+#include "Util.h"
+
+#include <cstring>
+#include <limits>
+#include <queue>
+
+namespace
+{
+	const float FLOW_FIELD_DIAGONAL_DISTANCE = 1.41421356f;
+	const float FLOW_FIELD_UNREACHABLE = std::numeric_limits<float>::max();
+	const float FLOW_FIELD_MAX_INFLUENCE_CHANGE = 50.f;	// summed over every tile of the field
+	const uint32_t FLOW_FIELD_MAX_AGE = 24;				// the blocked tiles and creep are not tracked, so recompute the field at least every second
+	const uint32_t FLOW_FIELD_EXPIRATION = 48;			// fields that are not used anymore are removed
+	const int FLOW_FIELD_STEPS_PER_COMMAND = 2;			// same as Util::PathFinding::GetCommandPositionFromPath that uses the third node of the path
+}
+
+FlowFieldManager::FlowFieldManager(CCBot & bot)
+	: m_bot(bot)
+{
+}
+
+void FlowFieldManager::onFrame()
+{
+	if (m_width == 0)
+	{
+		m_minX = int(m_bot.Map().mapMin().x);
+		m_minY = int(m_bot.Map().mapMin().y);
+		m_width = int(m_bot.Map().mapMax().x) - m_minX;
+		m_height = int(m_bot.Map().mapMax().y) - m_minY;
+	}
+	updateChangedTiles();
+
+	// The micro threads are done, the fields can be modified until the micro of the next frame
+	std::set<FlowFieldKey> usedKeys;
+	{
+		std::lock_guard<std::mutex> lock(m_usedKeysMutex);
+		usedKeys.swap(m_usedKeys);
+	}
+	const auto currentFrame = m_bot.GetCurrentFrame();
+	for (const auto & key : usedKeys)
+		m_flowFields[key].usedFrame = currentFrame;
+
+	for (auto it = m_flowFields.begin(); it != m_flowFields.end();)
+	{
+		auto & flowField = it->second;
+		if (currentFrame - flowField.usedFrame >= FLOW_FIELD_EXPIRATION)
+		{
+			it = m_flowFields.erase(it);
+			continue;
+		}
+		if (flowField.costs.empty() || isOutdated(it->first, flowField))
+		{
+			PROFILE_BEGIN("computeFlowField");
+			computeFlowField(it->first, flowField);
+			PROFILE_END("computeFlowField");
+		}
+		++it;
+	}
+}
+
+bool FlowFieldManager::isValidTile(int x, int y) const
+{
+	return x >= m_minX && y >= m_minY && x < m_minX + m_width && y < m_minY + m_height;
+}
+
+bool FlowFieldManager::isTraversable(int x, int y, bool flying) const
+{
+	if (!isValidTile(x, y))
+		return false;
+	if (flying)
+		return true;
+	return m_bot.Map().isWalkable(x, y) && !m_bot.Commander().Combat().isTileBlocked(x, y);
+}
+
+float FlowFieldManager::getInfluence(int x, int y, const FlowFieldKey & key) const
+{
+	const int radius = key.large ? 1 : 0;
+	float influence = 0.f;
+	for (int dx = -radius; dx <= radius; ++dx)
+	{
+		for (int dy = -radius; dy <= radius; ++dy)
+		{
+			const CCTilePosition tile(x + dx, y + dy);
+			influence += Util::PathFinding::GetEffectInfluenceOnTile(tile, key.flying, m_bot);
+			if (!key.onlyEffects)
+				influence += Util::PathFinding::GetCombatInfluenceOnTile(tile, key.flying, m_bot);
+		}
+	}
+	return influence;
+}
+
+void FlowFieldManager::updateChangedTiles()
+{
+	const size_t size = m_width * m_height;
+	m_tileInfluences.resize(size * 4);
+	m_changedTiles.clear();
+	for (int x = m_minX; x < m_minX + m_width; ++x)
+	{
+		for (int y = m_minY; y < m_minY + m_height; ++y)
+		{
+			const CCTilePosition tile(x, y);
+			const int index = getIndex(x, y);
+			const float influences[4] = {
+				Util::PathFinding::GetEffectInfluenceOnTile(tile, false, m_bot),
+				Util::PathFinding::GetCombatInfluenceOnTile(tile, false, m_bot),
+				Util::PathFinding::GetEffectInfluenceOnTile(tile, true, m_bot),
+				Util::PathFinding::GetCombatInfluenceOnTile(tile, true, m_bot)
+			};
+			float * previousInfluences = &m_tileInfluences[index * 4];
+			if (std::memcmp(influences, previousInfluences, sizeof(influences)) != 0)
+			{
+				std::memcpy(previousInfluences, influences, sizeof(influences));
+				m_changedTiles.push_back(index);
+			}
+		}
+	}
+}
+
+bool FlowFieldManager::isOutdated(const FlowFieldKey & key, FlowField & flowField) const
+{
+	if (m_bot.GetCurrentFrame() - flowField.computedFrame >= FLOW_FIELD_MAX_AGE)
+		return true;
+
+	// Only the tiles around the ones whose influence changed since the previous frame can have a different difference
+	const int radius = key.large ? 1 : 0;
+	for (const int changedIndex : m_changedTiles)
+	{
+		const int changedX = m_minX + changedIndex % m_width;
+		const int changedY = m_minY + changedIndex / m_width;
+		for (int x = changedX - radius; x <= changedX + radius; ++x)
+		{
+			for (int y = changedY - radius; y <= changedY + radius; ++y)
+			{
+				if (!isValidTile(x, y))
+					continue;
+				const int index = getIndex(x, y);
+				const float change = std::abs(getInfluence(x, y, key) - flowField.influences[index]);
+				flowField.influenceChange += change - flowField.influenceChanges[index];
+				flowField.influenceChanges[index] = change;
+			}
+		}
+	}
+	return flowField.influenceChange > FLOW_FIELD_MAX_INFLUENCE_CHANGE;
+}
+
+void FlowFieldManager::computeFlowField(const FlowFieldKey & key, FlowField & flowField)
+{
+	const size_t size = m_width * m_height;
+	flowField.costs.assign(size, FLOW_FIELD_UNREACHABLE);
+	flowField.influences.resize(size);
+	flowField.influenceChanges.assign(size, 0.f);
+	flowField.influenceChange = 0.f;
+	flowField.computedFrame = m_bot.GetCurrentFrame();
+	for (int x = m_minX; x < m_minX + m_width; ++x)
+	{
+		for (int y = m_minY; y < m_minY + m_height; ++y)
+		{
+			flowField.influences[getIndex(x, y)] = getInfluence(x, y, key);
+		}
+	}
+
+	typedef std::pair<float, int> CostIndex;
+	std::priority_queue<CostIndex, std::vector<CostIndex>, std::greater<CostIndex>> opened;
+
+	// Like the A* exit condition, the goal area is every tile in range of the goal without influence
+	const int range = int(std::ceil(key.range));
+	for (int x = key.goal.x - range; x <= key.goal.x + range; ++x)
+	{
+		for (int y = key.goal.y - range; y <= key.goal.y + range; ++y)
+		{
+			if (!isTraversable(x, y, key.flying))
+				continue;
+			if (Util::Dist(CCPosition(x + 0.5f, y + 0.5f), CCPosition(key.goal.x + 0.5f, key.goal.y + 0.5f)) >= key.range)
+				continue;
+			const int index = getIndex(x, y);
+			if (flowField.influences[index] > 0.f)
+				continue;
+			flowField.costs[index] = 0.f;
+			opened.push({ 0.f, index });
+		}
+	}
+
+	// Reverse Dijkstra, moving from a tile to a neighbor costs the same as in the A* (based on the neighbor we enter)
+	while (!opened.empty())
+	{
+		const auto current = opened.top();
+		opened.pop();
+		if (current.first > flowField.costs[current.second])
+			continue;
+		const int x = m_minX + current.second % m_width;
+		const int y = m_minY + current.second / m_width;
+		const float creepCost = !key.flying && m_bot.Observation()->HasCreep(CCPosition(float(x), float(y))) ? Util::PathFinding::HARASS_PATHFINDING_TILE_CREEP_COST : 0.f;
+		const float tileCost = flowField.influences[current.second] + creepCost + Util::PathFinding::HARASS_PATHFINDING_TILE_BASE_COST;
+		for (int dx = -1; dx <= 1; ++dx)
+		{
+			for (int dy = -1; dy <= 1; ++dy)
+			{
+				if (dx == 0 && dy == 0)
+					continue;
+				const int neighborX = x + dx;
+				const int neighborY = y + dy;
+				if (!isTraversable(neighborX, neighborY, key.flying))
+					continue;
+				const bool diagonal = dx != 0 && dy != 0;
+				if (diagonal && (!isTraversable(x + dx, y, key.flying) || !isTraversable(x, y + dy, key.flying)))
+					continue;	// do not cut the corner of a building or a cliff
+				const float cost = current.first + tileCost * (diagonal ? FLOW_FIELD_DIAGONAL_DISTANCE : 1.f);
+				const int neighborIndex = getIndex(neighborX, neighborY);
+				if (cost < flowField.costs[neighborIndex])
+				{
+					flowField.costs[neighborIndex] = cost;
+					opened.push({ cost, neighborIndex });
+				}
+			}
+		}
+	}
+}
+
+CCTilePosition FlowFieldManager::getNextTile(const CCTilePosition & tile, const FlowField & flowField) const
+{
+	CCTilePosition nextTile = tile;
+	float bestCost = isValidTile(tile.x, tile.y) ? flowField.costs[getIndex(tile.x, tile.y)] : FLOW_FIELD_UNREACHABLE;
+	for (int dx = -1; dx <= 1; ++dx)
+	{
+		for (int dy = -1; dy <= 1; ++dy)
+		{
+			if ((dx == 0 && dy == 0) || !isValidTile(tile.x + dx, tile.y + dy))
+				continue;
+			const float cost = flowField.costs[getIndex(tile.x + dx, tile.y + dy)];
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				nextTile = CCTilePosition(tile.x + dx, tile.y + dy);
+			}
+		}
+	}
+	return nextTile;
+}
+
+CCPosition FlowFieldManager::getMovePosition(const sc2::Unit * unit, CCPosition goal, float range, bool considerOnlyEffects)
+{
+	if (unit->unit_type == sc2::UNIT_TYPEID::TERRAN_REAPER)
+		return {};	// the field does not know about cliff jumps
+
+	FlowFieldKey key;
+	key.goal = Util::GetTilePosition(goal);
+	key.range = range;
+	key.flying = unit->is_flying;
+	key.onlyEffects = considerOnlyEffects;
+	key.large = unit->radius >= 1.f;
+	if (!isValidTile(key.goal.x, key.goal.y))
+		return {};
+
+	{
+		std::lock_guard<std::mutex> lock(m_usedKeysMutex);
+		m_usedKeys.insert(key);
+	}
+	// The fields are not modified during the micro
+	const auto it = m_flowFields.find(key);
+	if (it == m_flowFields.end() || it->second.costs.empty())
+		return {};	// computed on the next frame, the unit runs its own A* meanwhile
+	const auto & flowField = it->second;
+	const CCTilePosition startTile = Util::GetTilePosition(unit->pos);
+	if (!isValidTile(startTile.x, startTile.y) || flowField.costs[getIndex(startTile.x, startTile.y)] == 0.f)
+		return {};	// already in the goal area
+
+	CCTilePosition tile = startTile;
+	for (int i = 0; i < FLOW_FIELD_STEPS_PER_COMMAND; ++i)
+	{
+		const auto nextTile = getNextTile(tile, flowField);
+		if (nextTile == tile)
+			break;
+		tile = nextTile;
+	}
+	if (tile == startTile)
+		return {};	// unreachable
+
+	CCPosition movePosition = Util::GetPosition(tile) + CCPosition(0.5f, 0.5f);
+#ifndef PUBLIC_RELEASE
+	if (m_bot.Config().DrawHarassInfo)
+		m_bot.Map().drawTile(tile, sc2::Colors::Purple, 0.3f);
+#endif
+	// Same as Util::PathFinding::GetCommandPositionFromPath, we click far enough for the unit to keep its speed
+	if (Util::DistSq(unit->pos, movePosition) < 3 * 3)
+		movePosition = Util::Normalized(movePosition - unit->pos) * 3 + unit->pos;
+	return movePosition;
+}
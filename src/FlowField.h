@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Common.h"
+#include <mutex>
+#include <set>
+#include <tuple>
+
+class CCBot;
+
+// Flow fields shared by the units moving to the same goal.
+// A single Dijkstra from the goal (using the same tile costs as Util::PathFinding) gives the cost to reach it from every tile,
+// so each unit only has to follow the decreasing cost from its own tile instead of running its own A*.
+// A field is reused as long as the influence it was computed with did not change too much.
+// The fields are only computed and refreshed by the game thread in onFrame, before the micro of the squads, so the micro threads
+// only read them. A field that a unit needs but that does not exist yet is computed on the next frame.
+class FlowFieldManager
+{
+	struct FlowFieldKey
+	{
+		CCTilePosition goal;
+		float range;
+		bool flying;
+		bool onlyEffects;
+		bool large;		// units with a radius of at least 1 consider the influence of the 8 surrounding tiles
+
+		bool operator<(const FlowFieldKey & rhs) const
+		{
+			return std::tie(goal.x, goal.y, range, flying, onlyEffects, large) < std::tie(rhs.goal.x, rhs.goal.y, rhs.range, rhs.flying, rhs.onlyEffects, rhs.large);
+		}
+	};
+
+	struct FlowField
+	{
+		std::vector<float> costs;		// cost to reach the goal area from each tile
+		std::vector<float> influences;	// influence on each tile when the field was computed
+		std::vector<float> influenceChanges;	// difference between the current influence of each tile and the one above
+		float influenceChange = 0.f;			// sum of the differences
+		uint32_t computedFrame = 0;
+		uint32_t usedFrame = 0;
+	};
+
+	CCBot & m_bot;
+	int m_minX = 0;
+	int m_minY = 0;
+	int m_width = 0;
+	int m_height = 0;
+	std::map<FlowFieldKey, FlowField> m_flowFields;
+	std::vector<float> m_tileInfluences;	// effect and combat influence of each tile, for the ground then the air, at the previous frame
+	std::vector<int> m_changedTiles;		// tiles whose influence changed since the previous frame
+	std::mutex m_usedKeysMutex;
+	std::set<FlowFieldKey> m_usedKeys;		// fields looked up by the micro threads during the frame
+
+	int getIndex(int x, int y) const { return (x - m_minX) + (y - m_minY) * m_width; }
+	bool isValidTile(int x, int y) const;
+	bool isTraversable(int x, int y, bool flying) const;
+	float getInfluence(int x, int y, const FlowFieldKey & key) const;
+	void updateChangedTiles();
+	bool isOutdated(const FlowFieldKey & key, FlowField & flowField) const;
+	void computeFlowField(const FlowFieldKey & key, FlowField & flowField);
+	CCTilePosition getNextTile(const CCTilePosition & tile, const FlowField & flowField) const;
+
+public:
+
+	FlowFieldManager(CCBot & bot);
+
+	// Must be called after the influence maps are updated and before the micro of the squads
+	void onFrame();
+
+	// Returns the position a unit should move to in order to reach the goal area (within range of the goal, outside of influence),
+	// or CCPosition() if the unit cannot use a flow field to get there (unreachable, already there, cliff jumper or field not computed yet)
+	CCPosition getMovePosition(const sc2::Unit * unit, CCPosition goal, float range, bool considerOnlyEffects);
+	size_t getFlowFieldCount() const { return m_flowFields.size(); }
+};
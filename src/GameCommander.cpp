@@ -21,19 +21,19 @@ void GameCommander::onStart()
 
 void GameCommander::onFrame(bool executeMacro)
 {
-	m_bot.StartProfiling("0.10.1   handleUnitAssignments");
+	PROFILE_BEGIN("handleUnitAssignments");
     handleUnitAssignments();
-	m_bot.StopProfiling("0.10.1   handleUnitAssignments");
+	PROFILE_END("handleUnitAssignments");
 
-	m_bot.StartProfiling("0.10.2   m_productionManager.onFrame");
+	PROFILE_BEGIN("m_productionManager.onFrame");
 	m_productionManager.onFrame(executeMacro);
-	m_bot.StopProfiling("0.10.2   m_productionManager.onFrame");
-	m_bot.StartProfiling("0.10.3   m_scoutManager.onFrame");
+	PROFILE_END("m_productionManager.onFrame");
+	PROFILE_BEGIN("m_scoutManager.onFrame");
     m_scoutManager.onFrame();
-	m_bot.StopProfiling("0.10.3   m_scoutManager.onFrame");
-	m_bot.StartProfiling("0.10.4   m_combatCommander.onFrame");
+	PROFILE_END("m_scoutManager.onFrame");
+	PROFILE_BEGIN("m_combatCommander.onFrame");
     m_combatCommander.onFrame(m_combatUnits);
-	m_bot.StopProfiling("0.10.4   m_combatCommander.onFrame");
+	PROFILE_END("m_combatCommander.onFrame");
 }
 
 ProductionManager& GameCommander::Production()
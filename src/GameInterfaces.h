@@ -0,0 +1,140 @@
+#pragma once
+
+#include "Common.h"
+
+// The parts of the sc2 observation, query and action interfaces used by the bot. The bot only reaches the game through them
+// (CCBot::Observation, Query and Actions hide the ones of sc2::Agent), so the game can be replaced by another implementation,
+// like the one of the offline harness that replays recorded snapshots (see offline/OfflineGame.h).
+// The signatures are the ones of the sc2 interfaces so the call sites are the same with both.
+class GameObservation
+{
+public:
+
+	virtual ~GameObservation() {}
+
+	virtual uint32_t GetPlayerID() const = 0;
+	virtual uint32_t GetGameLoop() const = 0;
+	virtual sc2::Units GetUnits() const = 0;
+	virtual const sc2::Unit * GetUnit(sc2::Tag tag) const = 0;
+	virtual const std::vector<sc2::PowerSource> & GetPowerSources() const = 0;
+	virtual const std::vector<sc2::Effect> & GetEffects() const = 0;
+	virtual const sc2::Score & GetScore() const = 0;
+	virtual const sc2::Abilities & GetAbilityData(bool force_refresh = false) const = 0;
+	virtual const sc2::UnitTypes & GetUnitTypeData(bool force_refresh = false) const = 0;
+	virtual const sc2::Upgrades & GetUpgradeData(bool force_refresh = false) const = 0;
+	virtual const sc2::Buffs & GetBuffData(bool force_refresh = false) const = 0;
+	virtual const sc2::Effects & GetEffectData(bool force_refresh = false) const = 0;
+	virtual const sc2::GameInfo & GetGameInfo() const = 0;
+	virtual int32_t GetMinerals() const = 0;
+	virtual int32_t GetVespene() const = 0;
+	virtual int32_t GetFoodCap() const = 0;
+	virtual int32_t GetFoodUsed() const = 0;
+	virtual sc2::Point2D GetCameraPos() const = 0;
+	virtual sc2::Point3D GetStartLocation() const = 0;
+	virtual std::vector<sc2::PlayerResult> GetResults() const = 0;
+	virtual bool HasCreep(const sc2::Point2D & point) const = 0;
+	virtual sc2::Visibility GetVisibility(const sc2::Point2D & point) const = 0;
+	virtual bool IsPathable(const sc2::Point2D & point) const = 0;
+	virtual bool IsPlacable(const sc2::Point2D & point) const = 0;
+};
+
+class GameQuery
+{
+public:
+
+	virtual ~GameQuery() {}
+
+	virtual sc2::AvailableAbilities GetAbilitiesForUnit(const sc2::Unit * unit, bool ignore_resource_requirements = false) = 0;
+	virtual std::vector<sc2::AvailableAbilities> GetAbilitiesForUnits(const sc2::Units & units, bool ignore_resource_requirements = false) = 0;
+	virtual bool Placement(const sc2::AbilityID & ability, const sc2::Point2D & target_pos, const sc2::Unit * unit = nullptr) = 0;
+};
+
+class GameActions
+{
+public:
+
+	virtual ~GameActions() {}
+
+	virtual void UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, bool queued_command = false) = 0;
+	virtual void UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, const sc2::Point2D & point, bool queued_command = false) = 0;
+	virtual void UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, const sc2::Unit * target, bool queued_command = false) = 0;
+	virtual void UnitCommand(const sc2::Units & units, sc2::AbilityID ability, bool queued_move = false) = 0;
+	virtual void UnitCommand(const sc2::Units & units, sc2::AbilityID ability, const sc2::Point2D & point, bool queued_command = false) = 0;
+	virtual void UnitCommand(const sc2::Units & units, sc2::AbilityID ability, const sc2::Unit * target, bool queued_command = false) = 0;
+	// Tags of the units commanded since the last time the actions were sent
+	virtual const std::vector<sc2::Tag> & Commands() const = 0;
+	virtual void ToggleAutocast(sc2::Tag unit_tag, sc2::AbilityID ability) = 0;
+	virtual void SendChat(const std::string & message, sc2::ChatChannel channel = sc2::ChatChannel::All) = 0;
+	// For the raw actions that have no dedicated method, they are sent with the next SendActions
+	virtual SC2APIProtocol::RequestAction * GetRequestAction() = 0;
+	virtual void SendActions() = 0;
+};
+
+// Forwards to the interfaces of the agent connected to the game
+class LiveGameObservation : public GameObservation
+{
+	sc2::Agent & m_agent;
+
+public:
+
+	LiveGameObservation(sc2::Agent & agent) : m_agent(agent) {}
+
+	uint32_t GetPlayerID() const override { return m_agent.Observation()->GetPlayerID(); }
+	uint32_t GetGameLoop() const override { return m_agent.Observation()->GetGameLoop(); }
+	sc2::Units GetUnits() const override { return m_agent.Observation()->GetUnits(); }
+	const sc2::Unit * GetUnit(sc2::Tag tag) const override { return m_agent.Observation()->GetUnit(tag); }
+	const std::vector<sc2::PowerSource> & GetPowerSources() const override { return m_agent.Observation()->GetPowerSources(); }
+	const std::vector<sc2::Effect> & GetEffects() const override { return m_agent.Observation()->GetEffects(); }
+	const sc2::Score & GetScore() const override { return m_agent.Observation()->GetScore(); }
+	const sc2::Abilities & GetAbilityData(bool force_refresh = false) const override { return m_agent.Observation()->GetAbilityData(force_refresh); }
+	const sc2::UnitTypes & GetUnitTypeData(bool force_refresh = false) const override { return m_agent.Observation()->GetUnitTypeData(force_refresh); }
+	const sc2::Upgrades & GetUpgradeData(bool force_refresh = false) const override { return m_agent.Observation()->GetUpgradeData(force_refresh); }
+	const sc2::Buffs & GetBuffData(bool force_refresh = false) const override { return m_agent.Observation()->GetBuffData(force_refresh); }
+	const sc2::Effects & GetEffectData(bool force_refresh = false) const override { return m_agent.Observation()->GetEffectData(force_refresh); }
+	const sc2::GameInfo & GetGameInfo() const override { return m_agent.Observation()->GetGameInfo(); }
+	int32_t GetMinerals() const override { return m_agent.Observation()->GetMinerals(); }
+	int32_t GetVespene() const override { return m_agent.Observation()->GetVespene(); }
+	int32_t GetFoodCap() const override { return m_agent.Observation()->GetFoodCap(); }
+	int32_t GetFoodUsed() const override { return m_agent.Observation()->GetFoodUsed(); }
+	sc2::Point2D GetCameraPos() const override { return m_agent.Observation()->GetCameraPos(); }
+	sc2::Point3D GetStartLocation() const override { return m_agent.Observation()->GetStartLocation(); }
+	std::vector<sc2::PlayerResult> GetResults() const override { return m_agent.Observation()->GetResults(); }
+	bool HasCreep(const sc2::Point2D & point) const override { return m_agent.Observation()->HasCreep(point); }
+	sc2::Visibility GetVisibility(const sc2::Point2D & point) const override { return m_agent.Observation()->GetVisibility(point); }
+	bool IsPathable(const sc2::Point2D & point) const override { return m_agent.Observation()->IsPathable(point); }
+	bool IsPlacable(const sc2::Point2D & point) const override { return m_agent.Observation()->IsPlacable(point); }
+};
+
+class LiveGameQuery : public GameQuery
+{
+	sc2::Agent & m_agent;
+
+public:
+
+	LiveGameQuery(sc2::Agent & agent) : m_agent(agent) {}
+
+	sc2::AvailableAbilities GetAbilitiesForUnit(const sc2::Unit * unit, bool ignore_resource_requirements = false) override { return m_agent.Query()->GetAbilitiesForUnit(unit, ignore_resource_requirements); }
+	std::vector<sc2::AvailableAbilities> GetAbilitiesForUnits(const sc2::Units & units, bool ignore_resource_requirements = false) override { return m_agent.Query()->GetAbilitiesForUnits(units, ignore_resource_requirements); }
+	bool Placement(const sc2::AbilityID & ability, const sc2::Point2D & target_pos, const sc2::Unit * unit = nullptr) override { return m_agent.Query()->Placement(ability, target_pos, unit); }
+};
+
+class LiveGameActions : public GameActions
+{
+	sc2::Agent & m_agent;
+
+public:
+
+	LiveGameActions(sc2::Agent & agent) : m_agent(agent) {}
+
+	void UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, bool queued_command = false) override { m_agent.Actions()->UnitCommand(unit, ability, queued_command); }
+	void UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, const sc2::Point2D & point, bool queued_command = false) override { m_agent.Actions()->UnitCommand(unit, ability, point, queued_command); }
+	void UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, const sc2::Unit * target, bool queued_command = false) override { m_agent.Actions()->UnitCommand(unit, ability, target, queued_command); }
+	void UnitCommand(const sc2::Units & units, sc2::AbilityID ability, bool queued_move = false) override { m_agent.Actions()->UnitCommand(units, ability, queued_move); }
+	void UnitCommand(const sc2::Units & units, sc2::AbilityID ability, const sc2::Point2D & point, bool queued_command = false) override { m_agent.Actions()->UnitCommand(units, ability, point, queued_command); }
+	void UnitCommand(const sc2::Units & units, sc2::AbilityID ability, const sc2::Unit * target, bool queued_command = false) override { m_agent.Actions()->UnitCommand(units, ability, target, queued_command); }
+	const std::vector<sc2::Tag> & Commands() const override { return m_agent.Actions()->Commands(); }
+	void ToggleAutocast(sc2::Tag unit_tag, sc2::AbilityID ability) override { m_agent.Actions()->ToggleAutocast(unit_tag, ability); }
+	void SendChat(const std::string & message, sc2::ChatChannel channel = sc2::ChatChannel::All) override { m_agent.Actions()->SendChat(message, channel); }
+	SC2APIProtocol::RequestAction * GetRequestAction() override { return m_agent.Actions()->GetRequestAction(); }
+	void SendActions() override { m_agent.Actions()->SendActions(); }
+};
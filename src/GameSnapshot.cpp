@@ -0,0 +1,830 @@
+#include "GameSnapshot.h"
+#include "CCBot.h"
+#include "Util.h"
+#include <chrono>
+#include <cstring>
+#ifdef _WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	const char SNAPSHOT_MAGIC[] = "MMSNAP";
+	const uint32_t SNAPSHOT_VERSION = 2;
+	const uint32_t MAX_LIST_SIZE = 1 << 24;				// a bigger size comes from a corrupted file
+	const size_t KEY_FRAME_INTERVAL = 224;				// frames, about 10 seconds in step mode
+	const size_t MAX_RECORDED_SIZE = 512 * 1024 * 1024;	// the recording stops there, a ladder game does not fill the disk
+	const int SNAPSHOT_WRITE_INTERVAL_MS = 50;
+	const size_t FRAME_PREFIX_SIZE = sizeof(uint32_t) + sizeof(uint8_t) + sizeof(uint32_t);	// size, flags and game loop
+	const uint8_t KEY_FRAME_FLAG = 1;
+	const size_t MIN_GRID_SKIP = 4;						// shorter runs of unchanged tiles are kept in the literal runs
+
+	enum FrameSection { Resources, Score, Effects, PowerSources, Results, SectionCount };
+
+	// The fields are listed once for the writing and the reading, the values are copied as they are in memory so
+	// the snapshots are only read back on the architecture that recorded them
+	class SnapshotOutput
+	{
+		std::string & m_buffer;
+
+	public:
+
+		SnapshotOutput(std::string & buffer) : m_buffer(buffer) {}
+
+		void raw(const char * data, size_t size) { m_buffer.append(data, size); }
+		template <class T>
+		void value(T & v) { raw(reinterpret_cast<const char *>(&v), sizeof(T)); }
+		void varint(uint64_t v)
+		{
+			while (v >= 0x80)
+			{
+				m_buffer += char(v | 0x80);
+				v >>= 7;
+			}
+			m_buffer += char(v);
+		}
+		void text(std::string & s)
+		{
+			varint(s.size());
+			raw(s.data(), s.size());
+		}
+		template <class T, class Transfer>
+		void list(std::vector<T> & values, Transfer transfer)
+		{
+			varint(values.size());
+			for (auto & v : values)
+				transfer(*this, v);
+		}
+	};
+
+	// Reads from the mapped file, a read past the end sets the failed flag and reads zeros instead
+	class SnapshotInput
+	{
+		const char * m_position;
+		const char * m_end;
+		bool m_failed = false;
+
+	public:
+
+		SnapshotInput(const char * begin, const char * end) : m_position(begin), m_end(end) {}
+
+		bool failed() const { return m_failed; }
+		const char * position() const { return m_position; }
+		const char * raw(size_t size)
+		{
+			if (m_failed || size > size_t(m_end - m_position))
+			{
+				m_failed = true;
+				return nullptr;
+			}
+			const char * data = m_position;
+			m_position += size;
+			return data;
+		}
+		template <class T>
+		void value(T & v)
+		{
+			const char * data = raw(sizeof(T));
+			if (data)
+				memcpy(&v, data, sizeof(T));
+		}
+		uint64_t varint()
+		{
+			uint64_t v = 0;
+			for (int shift = 0; shift < 64; shift += 7)
+			{
+				const char * byte = raw(1);
+				if (!byte)
+					return 0;
+				v |= uint64_t(*byte & 0x7f) << shift;
+				if ((*byte & 0x80) == 0)
+					return v;
+			}
+			m_failed = true;
+			return 0;
+		}
+		void varint(uint64_t & v) { v = varint(); }
+		void text(std::string & s)
+		{
+			const size_t size = size_t(varint());
+			const char * data = raw(size);
+			if (data)
+				s.assign(data, size);
+			else
+				s.clear();
+		}
+		template <class T, class Transfer>
+		void list(std::vector<T> & values, Transfer transfer)
+		{
+			const uint64_t size = varint();
+			if (size > MAX_LIST_SIZE)
+				m_failed = true;
+			values.resize(m_failed ? 0 : size_t(size));
+			for (auto & v : values)
+				transfer(*this, v);
+		}
+	};
+
+	struct TransferValue
+	{
+		template <class Stream, class T>
+		void operator()(Stream & stream, T & v) const { stream.value(v); }
+	};
+
+	struct TransferVarint
+	{
+		template <class Stream>
+		void operator()(Stream & stream, uint64_t & v) const { stream.varint(v); }
+	};
+
+	// The structs with padding are written field by field, the padding would make equal values look different
+	template <class Stream>
+	void TransferOrder(Stream & stream, sc2::UnitOrder & order)
+	{
+		stream.value(order.ability_id);
+		stream.value(order.target_unit_tag);
+		stream.value(order.target_pos);
+		stream.value(order.progress);
+	}
+
+	template <class Stream>
+	void TransferPassenger(Stream & stream, sc2::PassengerUnit & passenger)
+	{
+		stream.value(passenger.tag);
+		stream.value(passenger.health);
+		stream.value(passenger.health_max);
+		stream.value(passenger.shield);
+		stream.value(passenger.shield_max);
+		stream.value(passenger.energy);
+		stream.value(passenger.energy_max);
+		stream.value(passenger.unit_type);
+	}
+
+	template <class Stream>
+	void TransferPowerSource(Stream & stream, sc2::PowerSource & powerSource)
+	{
+		stream.value(powerSource.position);
+		stream.value(powerSource.radius);
+		stream.value(powerSource.tag);
+	}
+
+	template <class Stream>
+	void TransferPlacement(Stream & stream, GameSnapshotPlacement & placement)
+	{
+		stream.value(placement.ability);
+		stream.value(placement.position);
+		stream.value(placement.unitTag);
+		stream.value(placement.result);
+	}
+
+	template <class Stream>
+	void TransferImage(Stream & stream, sc2::ImageData & image)
+	{
+		stream.value(image.width);
+		stream.value(image.height);
+		stream.value(image.bits_per_pixel);
+		stream.text(image.data);
+	}
+
+	template <class Stream>
+	void TransferGameInfo(Stream & stream, sc2::GameInfo & info)
+	{
+		stream.text(info.map_name);
+		stream.text(info.local_map_path);
+		stream.value(info.width);
+		stream.value(info.height);
+		stream.value(info.playable_min);
+		stream.value(info.playable_max);
+		stream.list(info.enemy_start_locations, TransferValue());
+		TransferImage(stream, info.pathing_grid);
+		TransferImage(stream, info.placement_grid);
+		TransferImage(stream, info.terrain_height);
+		stream.list(info.player_info, [](Stream & s, sc2::PlayerInfo & player)
+		{
+			s.value(player.player_id);
+			s.value(player.player_type);
+			s.value(player.race_requested);
+			s.value(player.race_actual);
+			s.value(player.difficulty);
+		});
+	}
+
+	template <class Stream>
+	void TransferHeader(Stream & stream, GameSnapshotHeader & header)
+	{
+		stream.value(header.playerId);
+		TransferGameInfo(stream, header.gameInfo);
+		stream.value(header.startLocation);
+		stream.list(header.buffs, [](Stream & s, sc2::BuffData & buff)
+		{
+			s.value(buff.buff_id);
+			s.text(buff.name);
+		});
+		stream.list(header.effects, [](Stream & s, sc2::EffectData & effect)
+		{
+			s.value(effect.effect_id);
+			s.text(effect.name);
+			s.text(effect.friendly_name);
+			s.value(effect.radius);
+		});
+		stream.text(header.pathable);
+		stream.text(header.placable);
+	}
+
+	// The unit is written field by field so a frame only holds the fields that changed since the previous one
+	const int UNIT_FIELD_COUNT = 37;
+
+	template <class Stream>
+	void TransferUnitField(Stream & stream, sc2::Unit & unit, int field)
+	{
+		switch (field)
+		{
+			case 0: stream.value(unit.display_type); break;
+			case 1: stream.value(unit.alliance); break;
+			case 2: stream.value(unit.unit_type); break;
+			case 3: stream.value(unit.owner); break;
+			case 4: stream.value(unit.pos); break;
+			case 5: stream.value(unit.facing); break;
+			case 6: stream.value(unit.radius); break;
+			case 7: stream.value(unit.build_progress); break;
+			case 8: stream.value(unit.cloak); break;
+			case 9: stream.value(unit.detect_range); break;
+			case 10: stream.value(unit.radar_range); break;
+			case 11: stream.value(unit.is_selected); break;
+			case 12: stream.value(unit.is_blip); break;
+			case 13: stream.value(unit.health); break;
+			case 14: stream.value(unit.health_max); break;
+			case 15: stream.value(unit.shield); break;
+			case 16: stream.value(unit.shield_max); break;
+			case 17: stream.value(unit.energy); break;
+			case 18: stream.value(unit.energy_max); break;
+			case 19: stream.value(unit.mineral_contents); break;
+			case 20: stream.value(unit.vespene_contents); break;
+			case 21: stream.value(unit.is_flying); break;
+			case 22: stream.value(unit.is_burrowed); break;
+			case 23: stream.value(unit.is_hallucination); break;
+			case 24: stream.value(unit.weapon_cooldown); break;
+			case 25: stream.list(unit.orders, TransferOrder<Stream>); break;
+			case 26: stream.value(unit.add_on_tag); break;
+			case 27: stream.list(unit.passengers, TransferPassenger<Stream>); break;
+			case 28: stream.value(unit.cargo_space_taken); break;
+			case 29: stream.value(unit.cargo_space_max); break;
+			case 30: stream.value(unit.assigned_harvesters); break;
+			case 31: stream.value(unit.ideal_harvesters); break;
+			case 32: stream.value(unit.engaged_target_tag); break;
+			case 33: stream.list(unit.buffs, TransferValue()); break;
+			case 34: stream.value(unit.is_powered); break;
+			case 35: stream.value(unit.is_alive); break;
+			case 36: stream.value(unit.last_seen_game_loop); break;
+		}
+	}
+
+	// The parts of the frame that are written whole, when they changed
+	template <class Stream>
+	void TransferSection(Stream & stream, GameSnapshotFrame & frame, int section)
+	{
+		switch (section)
+		{
+			case Resources:
+				stream.value(frame.minerals);
+				stream.value(frame.vespene);
+				stream.value(frame.foodCap);
+				stream.value(frame.foodUsed);
+				stream.value(frame.cameraPos);
+				break;
+			case Score:
+				stream.value(frame.score.score_type);
+				stream.value(frame.score.score);
+				stream.value(frame.score.score_details);
+				break;
+			case Effects:
+				stream.list(frame.effects, [](Stream & s, sc2::Effect & effect)
+				{
+					s.value(effect.effect_id);
+					s.list(effect.positions, TransferValue());
+				});
+				break;
+			case PowerSources:
+				stream.list(frame.powerSources, TransferPowerSource<Stream>);
+				break;
+			case Results:
+				stream.list(frame.results, TransferValue());
+				break;
+		}
+	}
+
+	template <class Stream>
+	void TransferQueries(Stream & stream, GameSnapshotFrame & frame)
+	{
+		stream.list(frame.abilities, [](Stream & s, sc2::AvailableAbilities & abilities)
+		{
+			s.list(abilities.abilities, TransferValue());
+			s.value(abilities.unit_tag);
+			s.value(abilities.unit_type_id);
+		});
+		stream.list(frame.placements, TransferPlacement<Stream>);
+	}
+
+	// Runs of tiles that did not change since the previous grid are skipped, the others are written as they are
+	void EncodeGrid(SnapshotOutput & output, const std::string & grid, std::string & previous)
+	{
+		if (previous.size() != grid.size())
+			previous.assign(grid.size(), 0);
+		output.varint(grid.size());
+		size_t position = 0;
+		while (position < grid.size())
+		{
+			size_t skip = 0;
+			while (position + skip < grid.size() && grid[position + skip] == previous[position + skip])
+				++skip;
+			size_t literal = 0;
+			size_t unchanged = 0;
+			while (position + skip + literal + unchanged < grid.size() && unchanged < MIN_GRID_SKIP)
+			{
+				if (grid[position + skip + literal + unchanged] == previous[position + skip + literal + unchanged])
+				{
+					++unchanged;
+				}
+				else
+				{
+					literal += unchanged + 1;
+					unchanged = 0;
+				}
+			}
+			output.varint(skip);
+			output.varint(literal);
+			output.raw(grid.data() + position + skip, literal);
+			position += skip + literal;
+		}
+		previous = grid;
+	}
+
+	void DecodeGrid(SnapshotInput & input, std::string & grid)
+	{
+		const size_t size = size_t(input.varint());
+		if (size > MAX_LIST_SIZE)
+			return;
+		if (grid.size() != size)
+			grid.assign(size, 0);
+		size_t position = 0;
+		while (position < size && !input.failed())
+		{
+			position += size_t(input.varint());
+			const size_t literal = size_t(input.varint());
+			if (position + literal > size)
+				break;
+			const char * data = input.raw(literal);
+			if (data)
+				memcpy(&grid[position], data, literal);
+			position += literal;
+		}
+	}
+}
+
+GameSnapshotRecorder::GameSnapshotRecorder(CCBot & bot)
+	: m_bot(bot)
+{
+}
+
+GameSnapshotRecorder::~GameSnapshotRecorder()
+{
+	onEnd();
+}
+
+bool GameSnapshotRecorder::onStart(const std::string & path, GameQuery & query)
+{
+	m_file.open(path, std::ios::binary);
+	if (!m_file.is_open())
+	{
+		Util::Log(__FUNCTION__, "Could not create the snapshot file " + path, m_bot);
+		return false;
+	}
+	m_query = &query;
+
+	const auto observation = m_bot.Observation();
+	GameSnapshotHeader header;
+	header.playerId = observation->GetPlayerID();
+	header.gameInfo = observation->GetGameInfo();
+	header.startLocation = observation->GetStartLocation();
+	header.buffs = observation->GetBuffData();
+	header.effects = observation->GetEffectData();
+	const int width = header.gameInfo.width;
+	const int height = header.gameInfo.height;
+	header.pathable.resize(width * height);
+	header.placable.resize(width * height);
+	for (int y = 0; y < height; ++y)
+	{
+		for (int x = 0; x < width; ++x)
+		{
+			const CCPosition tileCenter(x + 0.5f, y + 0.5f);
+			header.pathable[x + y * width] = observation->IsPathable(tileCenter);
+			header.placable[x + y * width] = observation->IsPlacable(tileCenter);
+		}
+	}
+
+	std::string buffer(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+	SnapshotOutput output(buffer);
+	uint32_t version = SNAPSHOT_VERSION;
+	output.value(version);
+	TransferHeader(output, header);
+	m_file.write(buffer.data(), buffer.size());
+	m_recordedSize = buffer.size();
+
+	m_stopping = false;
+	m_writerThread = new std::thread(&GameSnapshotRecorder::writerLoop, this);
+	return true;
+}
+
+void GameSnapshotRecorder::onFrame()
+{
+	// The previous frame is complete with the queries of its step
+	if (m_hasFrame)
+		writeFrame();
+	if (!m_writerThread)
+		return;
+	captureFrame();
+	m_hasFrame = true;
+}
+
+void GameSnapshotRecorder::captureFrame()
+{
+	const auto observation = m_bot.Observation();
+	const auto units = observation->GetUnits();
+	m_frame.gameLoop = observation->GetGameLoop();
+	m_frame.units.clear();
+	for (const auto unit : units)
+		m_frame.units.push_back(*unit);
+	// The units of the API stay allocated for the whole game, the dead ones are only flagged
+	m_frame.deadUnits.clear();
+	for (const auto unit : m_previousUnits)
+	{
+		if (!unit->is_alive)
+			m_frame.deadUnits.push_back(unit->tag);
+	}
+	m_previousUnits = units;
+	m_frame.effects = observation->GetEffects();
+	m_frame.powerSources = observation->GetPowerSources();
+	m_frame.results = observation->GetResults();
+	m_frame.score = observation->GetScore();
+	m_frame.minerals = observation->GetMinerals();
+	m_frame.vespene = observation->GetVespene();
+	m_frame.foodCap = observation->GetFoodCap();
+	m_frame.foodUsed = observation->GetFoodUsed();
+	m_frame.cameraPos = observation->GetCameraPos();
+	{
+		std::lock_guard<std::mutex> lock(m_queriesMutex);
+		m_frame.abilities.clear();
+		m_frame.placements.clear();
+	}
+
+	// Only the playable area can have creep or be seen
+	const auto & gameInfo = observation->GetGameInfo();
+	const int width = gameInfo.width;
+	m_frame.creep.resize(width * gameInfo.height);
+	m_frame.visibility.resize(width * gameInfo.height);
+	for (int y = int(gameInfo.playable_min.y); y < int(gameInfo.playable_max.y); ++y)
+	{
+		for (int x = int(gameInfo.playable_min.x); x < int(gameInfo.playable_max.x); ++x)
+		{
+			const CCPosition tileCenter(x + 0.5f, y + 0.5f);
+			m_frame.creep[x + y * width] = observation->HasCreep(tileCenter);
+			m_frame.visibility[x + y * width] = char(observation->GetVisibility(tileCenter));
+		}
+	}
+}
+
+void GameSnapshotRecorder::writeFrame()
+{
+	const bool keyFrame = m_framesSinceKeyFrame == 0;
+	m_framesSinceKeyFrame = (m_framesSinceKeyFrame + 1) % KEY_FRAME_INTERVAL;
+	if (keyFrame)
+	{
+		m_recordedUnits.clear();
+		m_recordedTags.clear();
+		m_recordedSections.assign(SectionCount, std::string());
+		m_recordedCreep.clear();
+		m_recordedVisibility.clear();
+	}
+
+	std::string frame(sizeof(uint32_t), 0);		// for the size
+	SnapshotOutput output(frame);
+	uint8_t flags = keyFrame ? KEY_FRAME_FLAG : 0;
+	output.value(flags);
+	output.value(m_frame.gameLoop);
+
+	std::string bytes;
+	SnapshotOutput bytesOutput(bytes);
+	for (int section = 0; section < SectionCount; ++section)
+	{
+		bytes.clear();
+		TransferSection(bytesOutput, m_frame, section);
+		bool changed = bytes != m_recordedSections[section];
+		output.value(changed);
+		if (changed)
+		{
+			output.raw(bytes.data(), bytes.size());
+			m_recordedSections[section].swap(bytes);
+		}
+	}
+
+	output.list(m_frame.deadUnits, TransferValue());
+	for (const auto tag : m_frame.deadUnits)
+		m_recordedUnits.erase(tag);
+
+	// The units are usually the same ones in the same order as in the previous frame
+	bool sameUnits = m_frame.units.size() == m_recordedTags.size();
+	for (size_t i = 0; sameUnits && i < m_frame.units.size(); ++i)
+		sameUnits = m_frame.units[i].tag == m_recordedTags[i];
+	output.value(sameUnits);
+	if (!sameUnits)
+	{
+		m_recordedTags.clear();
+		for (const auto & unit : m_frame.units)
+			m_recordedTags.push_back(unit.tag);
+		output.list(m_recordedTags, TransferVarint());
+	}
+	RecordedUnit current;
+	for (auto & unit : m_frame.units)
+	{
+		current.bytes.clear();
+		current.offsets.resize(UNIT_FIELD_COUNT + 1);
+		SnapshotOutput unitOutput(current.bytes);
+		for (int field = 0; field < UNIT_FIELD_COUNT; ++field)
+		{
+			current.offsets[field] = uint32_t(current.bytes.size());
+			TransferUnitField(unitOutput, unit, field);
+		}
+		current.offsets[UNIT_FIELD_COUNT] = uint32_t(current.bytes.size());
+
+		auto & recorded = m_recordedUnits[unit.tag];
+		const bool known = !recorded.offsets.empty();
+		uint64_t changedFields = 0;
+		for (int field = 0; field < UNIT_FIELD_COUNT; ++field)
+		{
+			const uint32_t size = current.offsets[field + 1] - current.offsets[field];
+			if (!known || size != recorded.offsets[field + 1] - recorded.offsets[field]
+				|| memcmp(current.bytes.data() + current.offsets[field], recorded.bytes.data() + recorded.offsets[field], size) != 0)
+				changedFields |= uint64_t(1) << field;
+		}
+		output.varint(changedFields);
+		for (int field = 0; field < UNIT_FIELD_COUNT; ++field)
+		{
+			if (changedFields & (uint64_t(1) << field))
+				output.raw(current.bytes.data() + current.offsets[field], current.offsets[field + 1] - current.offsets[field]);
+		}
+		std::swap(recorded, current);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_queriesMutex);
+		TransferQueries(output, m_frame);
+	}
+	EncodeGrid(output, m_frame.creep, m_recordedCreep);
+	EncodeGrid(output, m_frame.visibility, m_recordedVisibility);
+
+	const uint32_t size = uint32_t(frame.size() - sizeof(uint32_t));
+	memcpy(&frame[0], &size, sizeof(uint32_t));
+	if (m_recordedSize + frame.size() > MAX_RECORDED_SIZE)
+	{
+		Util::Log(__FUNCTION__, "The snapshot reached its maximum size, the recording stops", m_bot);
+		m_hasFrame = false;
+		onEnd();
+		return;
+	}
+	m_recordedSize += frame.size();
+	std::lock_guard<std::mutex> lock(m_pendingMutex);
+	m_pending += frame;
+}
+
+void GameSnapshotRecorder::writerLoop()
+{
+	std::string batch;
+	bool stopping = false;
+	while (!stopping)
+	{
+		{
+			std::unique_lock<std::mutex> lock(m_pendingMutex);
+			m_wakeUp.wait_for(lock, std::chrono::milliseconds(SNAPSHOT_WRITE_INTERVAL_MS), [this] { return m_stopping; });
+			batch.swap(m_pending);
+			stopping = m_stopping;
+		}
+		m_file.write(batch.data(), batch.size());
+		batch.clear();
+	}
+}
+
+void GameSnapshotRecorder::onEnd()
+{
+	if (!m_writerThread)
+		return;
+	std::thread * writerThread = m_writerThread;
+	m_writerThread = nullptr;
+	if (m_hasFrame)
+	{
+		m_hasFrame = false;
+		writeFrame();
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_pendingMutex);
+		m_stopping = true;
+	}
+	m_wakeUp.notify_one();
+	writerThread->join();
+	delete writerThread;
+	m_file.close();
+}
+
+sc2::AvailableAbilities GameSnapshotRecorder::GetAbilitiesForUnit(const sc2::Unit * unit, bool ignore_resource_requirements)
+{
+	auto abilities = m_query->GetAbilitiesForUnit(unit, ignore_resource_requirements);
+	if (m_hasFrame)
+	{
+		std::lock_guard<std::mutex> lock(m_queriesMutex);
+		m_frame.abilities.push_back(abilities);
+	}
+	return abilities;
+}
+
+std::vector<sc2::AvailableAbilities> GameSnapshotRecorder::GetAbilitiesForUnits(const sc2::Units & units, bool ignore_resource_requirements)
+{
+	auto abilities = m_query->GetAbilitiesForUnits(units, ignore_resource_requirements);
+	if (m_hasFrame)
+	{
+		std::lock_guard<std::mutex> lock(m_queriesMutex);
+		m_frame.abilities.insert(m_frame.abilities.end(), abilities.begin(), abilities.end());
+	}
+	return abilities;
+}
+
+bool GameSnapshotRecorder::Placement(const sc2::AbilityID & ability, const sc2::Point2D & target_pos, const sc2::Unit * unit)
+{
+	const bool result = m_query->Placement(ability, target_pos, unit);
+	if (m_hasFrame)
+	{
+		std::lock_guard<std::mutex> lock(m_queriesMutex);
+		m_frame.placements.push_back({ ability, target_pos, unit ? unit->tag : 0, result });
+	}
+	return result;
+}
+
+GameSnapshotReader::~GameSnapshotReader()
+{
+	close();
+}
+
+void GameSnapshotReader::close()
+{
+	if (!m_data)
+		return;
+#ifdef _WINDOWS
+	UnmapViewOfFile(m_data);
+	CloseHandle(m_mappingHandle);
+	CloseHandle(m_fileHandle);
+	m_mappingHandle = nullptr;
+	m_fileHandle = nullptr;
+#else
+	munmap(const_cast<char *>(m_data), m_size);
+#endif
+	m_data = nullptr;
+	m_size = 0;
+	m_frames.clear();
+}
+
+bool GameSnapshotReader::open(const std::string & path, GameSnapshotHeader & header)
+{
+	close();
+#ifdef _WINDOWS
+	m_fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (m_fileHandle == INVALID_HANDLE_VALUE)
+	{
+		m_fileHandle = nullptr;
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	GetFileSizeEx(m_fileHandle, &fileSize);
+	m_mappingHandle = fileSize.QuadPart > 0 ? CreateFileMappingA(m_fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+	const void * data = m_mappingHandle ? MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+	if (!data)
+	{
+		if (m_mappingHandle)
+			CloseHandle(m_mappingHandle);
+		CloseHandle(m_fileHandle);
+		m_mappingHandle = nullptr;
+		m_fileHandle = nullptr;
+		return false;
+	}
+	m_data = static_cast<const char *>(data);
+	m_size = size_t(fileSize.QuadPart);
+#else
+	const int file = ::open(path.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+	struct stat fileStat;
+	void * data = fstat(file, &fileStat) == 0 && fileStat.st_size > 0 ? mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0) : MAP_FAILED;
+	::close(file);		// the mapping keeps the file open
+	if (data == MAP_FAILED)
+		return false;
+	m_data = static_cast<const char *>(data);
+	m_size = size_t(fileStat.st_size);
+#endif
+
+	SnapshotInput input(m_data, m_data + m_size);
+	const char * magic = input.raw(sizeof(SNAPSHOT_MAGIC));
+	uint32_t version = 0;
+	input.value(version);
+	if (!magic || memcmp(magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0 || version != SNAPSHOT_VERSION)
+	{
+		close();
+		return false;
+	}
+	TransferHeader(input, header);
+	if (input.failed())
+	{
+		close();
+		return false;
+	}
+
+	// Index the frames, a game that crashed leaves its last frame incomplete
+	size_t offset = input.position() - m_data;
+	while (offset + FRAME_PREFIX_SIZE <= m_size)
+	{
+		FrameIndex frame;
+		memcpy(&frame.size, m_data + offset, sizeof(uint32_t));
+		if (frame.size > m_size - offset - sizeof(uint32_t))
+			break;
+		frame.offset = offset + sizeof(uint32_t);
+		frame.keyFrame = (m_data[frame.offset] & KEY_FRAME_FLAG) != 0;
+		memcpy(&frame.gameLoop, m_data + frame.offset + sizeof(uint8_t), sizeof(uint32_t));
+		m_frames.push_back(frame);
+		offset = frame.offset + frame.size;
+	}
+	m_nextFrame = 0;
+	return true;
+}
+
+void GameSnapshotReader::seek(uint32_t gameLoop)
+{
+	m_nextFrame = 0;
+	for (size_t i = 0; i < m_frames.size() && m_frames[i].gameLoop <= gameLoop; ++i)
+	{
+		if (m_frames[i].keyFrame)
+			m_nextFrame = i;
+	}
+}
+
+bool GameSnapshotReader::readFrame()
+{
+	if (m_nextFrame >= m_frames.size())
+		return false;
+	const FrameIndex & index = m_frames[m_nextFrame++];
+	SnapshotInput input(m_data + index.offset, m_data + index.offset + index.size);
+	if (index.keyFrame)
+	{
+		m_frame = GameSnapshotFrame();
+		m_units.clear();
+		m_unitTags.clear();
+	}
+
+	uint8_t flags;
+	input.value(flags);
+	input.value(m_frame.gameLoop);
+	for (int section = 0; section < SectionCount; ++section)
+	{
+		bool changed = false;
+		input.value(changed);
+		if (changed)
+			TransferSection(input, m_frame, section);
+	}
+
+	input.list(m_frame.deadUnits, TransferValue());
+	for (const auto tag : m_frame.deadUnits)
+		m_units.erase(tag);
+
+	bool sameUnits = false;
+	input.value(sameUnits);
+	if (!sameUnits)
+		input.list(m_unitTags, TransferVarint());
+	m_frame.units.clear();
+	for (const auto tag : m_unitTags)
+	{
+		auto & unit = m_units[tag];
+		unit.tag = tag;
+		const uint64_t changedFields = input.varint();
+		for (int field = 0; field < UNIT_FIELD_COUNT; ++field)
+		{
+			if (changedFields & (uint64_t(1) << field))
+				TransferUnitField(input, unit, field);
+		}
+		m_frame.units.push_back(unit);
+	}
+
+	TransferQueries(input, m_frame);
+	DecodeGrid(input, m_frame.creep);
+	DecodeGrid(input, m_frame.visibility);
+	return !input.failed();
+}
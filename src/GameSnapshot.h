@@ -0,0 +1,141 @@
+#pragma once
+
+#include "Common.h"
+#include "GameInterfaces.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+class CCBot;
+
+// A game recorded from the point of view of the bot, replayed by the offline harness (see offline/OfflineGame.h).
+// The header holds what does not change during the game, then each frame holds the observation received at the start of a step
+// and the answers to the queries the bot made during that step.
+struct GameSnapshotHeader
+{
+	uint32_t playerId = 0;
+	sc2::GameInfo gameInfo;
+	sc2::Point3D startLocation;
+	sc2::Buffs buffs;
+	sc2::Effects effects;
+	std::string pathable;		// one byte per tile, x + y * width
+	std::string placable;
+};
+
+struct GameSnapshotPlacement
+{
+	sc2::AbilityID ability;
+	sc2::Point2D position;
+	sc2::Tag unitTag;
+	bool result;
+};
+
+struct GameSnapshotFrame
+{
+	uint32_t gameLoop = 0;
+	std::vector<sc2::Unit> units;
+	std::vector<sc2::Tag> deadUnits;	// since the previous frame
+	std::vector<sc2::Effect> effects;
+	std::vector<sc2::PowerSource> powerSources;
+	std::vector<sc2::PlayerResult> results;
+	sc2::Score score;
+	int32_t minerals = 0;
+	int32_t vespene = 0;
+	int32_t foodCap = 0;
+	int32_t foodUsed = 0;
+	sc2::Point2D cameraPos;
+	std::string creep;			// one byte per tile, x + y * width
+	std::string visibility;		// one sc2::Visibility per tile
+	std::vector<sc2::AvailableAbilities> abilities;		// answers to the queries of the step
+	std::vector<GameSnapshotPlacement> placements;
+};
+
+// Records the observation of each step in a compact file, cheap enough to capture ladder games ("RecordSnapshots" in the config).
+// It stands between the bot and the game queries to record their answers. Each frame is encoded on the game thread as a delta
+// of the previous one (only the fields of the units that changed, the grid tiles that changed, the other parts when they changed),
+// with a key frame encoded from scratch at regular intervals so a replay can start from any of them, then written by a background thread.
+class GameSnapshotRecorder : public GameQuery
+{
+	struct RecordedUnit
+	{
+		std::string bytes;
+		std::vector<uint32_t> offsets;		// of each field in the bytes, plus the end
+	};
+
+	CCBot & m_bot;
+	GameQuery * m_query = nullptr;
+	GameSnapshotFrame m_frame;
+	std::mutex m_queriesMutex;			// the queries are also made by the micro threads
+	std::vector<const sc2::Unit *> m_previousUnits;
+	std::unordered_map<sc2::Tag, RecordedUnit> m_recordedUnits;		// the previous state of each unit, for the deltas
+	std::vector<sc2::Tag> m_recordedTags;
+	std::vector<std::string> m_recordedSections;
+	std::string m_recordedCreep;
+	std::string m_recordedVisibility;
+	std::atomic<bool> m_hasFrame { false };
+	size_t m_framesSinceKeyFrame = 0;
+	size_t m_recordedSize = 0;
+	std::ofstream m_file;
+	std::thread * m_writerThread = nullptr;
+	std::mutex m_pendingMutex;
+	std::condition_variable m_wakeUp;
+	std::string m_pending;				// encoded frames waiting for the writer thread
+	bool m_stopping = false;
+
+	void captureFrame();
+	void writeFrame();
+	void writerLoop();
+
+public:
+
+	GameSnapshotRecorder(CCBot & bot);
+	~GameSnapshotRecorder();
+
+	// The queries of the bot must go through the recorder after that
+	bool onStart(const std::string & path, GameQuery & query);
+	void onFrame();
+	void onEnd();
+
+	sc2::AvailableAbilities GetAbilitiesForUnit(const sc2::Unit * unit, bool ignore_resource_requirements = false) override;
+	std::vector<sc2::AvailableAbilities> GetAbilitiesForUnits(const sc2::Units & units, bool ignore_resource_requirements = false) override;
+	bool Placement(const sc2::AbilityID & ability, const sc2::Point2D & target_pos, const sc2::Unit * unit = nullptr) override;
+};
+
+// Reads a snapshot through a memory mapping of the file
+class GameSnapshotReader
+{
+	struct FrameIndex
+	{
+		size_t offset;
+		uint32_t size;
+		uint32_t gameLoop;
+		bool keyFrame;
+	};
+
+	const char * m_data = nullptr;
+	size_t m_size = 0;
+#ifdef _WINDOWS
+	void * m_fileHandle = nullptr;
+	void * m_mappingHandle = nullptr;
+#endif
+	std::vector<FrameIndex> m_frames;
+	size_t m_nextFrame = 0;
+	GameSnapshotFrame m_frame;
+	std::unordered_map<sc2::Tag, sc2::Unit> m_units;		// the last state of each unit, the deltas apply to it
+	std::vector<sc2::Tag> m_unitTags;
+
+	void close();
+
+public:
+
+	~GameSnapshotReader();
+
+	bool open(const std::string & path, GameSnapshotHeader & header);
+	size_t getFrameCount() const { return m_frames.size(); }
+	// The next frame read will be the last key frame at or before that game loop
+	void seek(uint32_t gameLoop);
+	bool readFrame();
+	const GameSnapshotFrame & getFrame() const { return m_frame; }
+};
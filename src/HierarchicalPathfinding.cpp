@@ -0,0 +1,498 @@
+#include "HierarchicalPathfinding.h"
+#include "CCBot.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <limits>
+#include <queue>
+
+namespace
+{
+	const int HPA_CLUSTER_SIZE = 10;
+	const int HPA_MAX_SINGLE_ENTRANCE_WIDTH = 6;	// wider openings get an entrance at each end
+	const uint32_t HPA_UPDATE_FREQUENCY = 24;		// same as the blocked tiles update
+	const float HPA_DIAGONAL_COST = 1.41421356f;
+	const float HPA_INFINITE_COST = std::numeric_limits<float>::max();
+
+	typedef std::pair<float, int> CostIndex;
+	typedef std::priority_queue<CostIndex, std::vector<CostIndex>, std::greater<CostIndex>> MinQueue;
+}
+
+const HierarchicalPathfinding::CorridorStep * HierarchicalPathfinding::Corridor::getStep(const CCTilePosition & tile) const
+{
+	const int clusterX = (tile.x - m_minX) / HPA_CLUSTER_SIZE;
+	const int clusterY = (tile.y - m_minY) / HPA_CLUSTER_SIZE;
+	if (tile.x < m_minX || tile.y < m_minY || clusterX >= m_clustersX || clusterY >= m_clustersY)
+		return nullptr;
+	const auto & step = m_steps[clusterX + clusterY * m_clustersX];
+	return step.valid ? &step : nullptr;
+}
+
+float HierarchicalPathfinding::Corridor::getHeuristic(const CCTilePosition & tile) const
+{
+	const auto step = getStep(tile);
+	if (!step)
+		return -1.f;
+	return Util::Dist(tile, step->exit) + step->remainingCost;
+}
+
+HierarchicalPathfinding::HierarchicalPathfinding(CCBot & bot)
+	: m_bot(bot)
+{
+}
+
+void HierarchicalPathfinding::onStart()
+{
+	m_minX = int(m_bot.Map().mapMin().x);
+	m_minY = int(m_bot.Map().mapMin().y);
+	m_maxX = int(m_bot.Map().mapMax().x);
+	m_maxY = int(m_bot.Map().mapMax().y);
+	const int width = m_maxX - m_minX;
+	const int height = m_maxY - m_minY;
+	m_clustersX = (width + HPA_CLUSTER_SIZE - 1) / HPA_CLUSTER_SIZE;
+	m_clustersY = (height + HPA_CLUSTER_SIZE - 1) / HPA_CLUSTER_SIZE;
+
+	m_nodes.clear();
+	m_freeNodes.clear();
+	m_clusterNodes.assign(m_clustersX * m_clustersY, std::vector<int>());
+	m_borderNodes.assign(m_clustersX * m_clustersY * 2, std::vector<int>());
+	m_passable.resize(width * height);
+	for (int y = m_minY; y < m_maxY; ++y)
+	{
+		for (int x = m_minX; x < m_maxX; ++x)
+		{
+			m_passable[(x - m_minX) + (y - m_minY) * width] = computePassable(x, y);
+		}
+	}
+
+	rebuild(std::vector<bool>(m_clusterNodes.size(), true));
+	m_lastUpdateFrame = m_bot.GetGameLoop();
+}
+
+void HierarchicalPathfinding::onFrame()
+{
+	if (m_bot.GetGameLoop() - m_lastUpdateFrame < HPA_UPDATE_FREQUENCY)
+		return;
+	m_lastUpdateFrame = m_bot.GetGameLoop();
+
+	// Only the clusters containing a tile that changed are rebuilt (with the entrances they share with their neighbors)
+	const int width = m_maxX - m_minX;
+	std::vector<bool> dirtyClusters(m_clusterNodes.size(), false);
+	bool dirty = false;
+	for (int y = m_minY; y < m_maxY; ++y)
+	{
+		for (int x = m_minX; x < m_maxX; ++x)
+		{
+			const char passable = computePassable(x, y);
+			auto & previous = m_passable[(x - m_minX) + (y - m_minY) * width];
+			if (previous != passable)
+			{
+				previous = passable;
+				dirtyClusters[getClusterIndex(x, y)] = true;
+				dirty = true;
+			}
+		}
+	}
+	if (dirty)
+		rebuild(dirtyClusters);
+
+	draw();
+}
+
+void HierarchicalPathfinding::draw() const
+{
+#ifdef PUBLIC_RELEASE
+	return;
+#endif
+	if (!m_bot.Config().DrawWalkableSectors)
+		return;
+
+	for (const auto & node : m_nodes)
+	{
+		if (node.cluster < 0)
+			continue;
+		m_bot.Map().drawTile(node.tile, CCColor(255, 128, 0), 0.5f);
+	}
+}
+
+bool HierarchicalPathfinding::computePassable(int x, int y) const
+{
+	return m_bot.Map().isWalkable(x, y) && !m_bot.Commander().Combat().isTileBlocked(x, y);
+}
+
+bool HierarchicalPathfinding::isPassable(int x, int y) const
+{
+	if (x < m_minX || y < m_minY || x >= m_maxX || y >= m_maxY)
+		return false;
+	return m_passable[(x - m_minX) + (y - m_minY) * (m_maxX - m_minX)] != 0;
+}
+
+int HierarchicalPathfinding::getClusterIndex(int x, int y) const
+{
+	return (x - m_minX) / HPA_CLUSTER_SIZE + (y - m_minY) / HPA_CLUSTER_SIZE * m_clustersX;
+}
+
+void HierarchicalPathfinding::getClusterBounds(int cluster, int & minX, int & minY, int & maxX, int & maxY) const
+{
+	minX = m_minX + (cluster % m_clustersX) * HPA_CLUSTER_SIZE;
+	minY = m_minY + (cluster / m_clustersX) * HPA_CLUSTER_SIZE;
+	maxX = std::min(minX + HPA_CLUSTER_SIZE, m_maxX);
+	maxY = std::min(minY + HPA_CLUSTER_SIZE, m_maxY);
+}
+
+int HierarchicalPathfinding::createNode(const CCTilePosition & tile, int border)
+{
+	int index;
+	if (!m_freeNodes.empty())
+	{
+		index = m_freeNodes.back();
+		m_freeNodes.pop_back();
+	}
+	else
+	{
+		index = int(m_nodes.size());
+		m_nodes.emplace_back();
+	}
+	auto & node = m_nodes[index];
+	node.tile = tile;
+	node.cluster = getClusterIndex(tile.x, tile.y);
+	node.twin = -1;
+	node.edges.clear();
+	m_clusterNodes[node.cluster].push_back(index);
+	m_borderNodes[border].push_back(index);
+	return index;
+}
+
+void HierarchicalPathfinding::clearBorder(int border)
+{
+	for (const int index : m_borderNodes[border])
+	{
+		auto & node = m_nodes[index];
+		auto & clusterNodes = m_clusterNodes[node.cluster];
+		clusterNodes.erase(std::remove(clusterNodes.begin(), clusterNodes.end(), index), clusterNodes.end());
+		node.cluster = -1;
+		node.twin = -1;
+		node.edges.clear();
+		m_freeNodes.push_back(index);
+	}
+	m_borderNodes[border].clear();
+}
+
+void HierarchicalPathfinding::buildBorder(int border)
+{
+	const int cluster = border / 2;
+	const bool east = border % 2 == 0;
+	const int clusterX = cluster % m_clustersX;
+	const int clusterY = cluster / m_clustersX;
+	if ((east && clusterX + 1 >= m_clustersX) || (!east && clusterY + 1 >= m_clustersY))
+		return;	// no neighbor on that side
+
+	int minX, minY, maxX, maxY;
+	getClusterBounds(cluster, minX, minY, maxX, maxY);
+	// The border is a line of tiles in this cluster facing a line of tiles in the neighbor cluster
+	const int length = east ? maxY - minY : maxX - minX;
+	const auto insideTile = [&](int i) { return east ? CCTilePosition(maxX - 1, minY + i) : CCTilePosition(minX + i, maxY - 1); };
+	const auto outsideTile = [&](int i) { return east ? CCTilePosition(maxX, minY + i) : CCTilePosition(minX + i, maxY); };
+	const auto addEntrance = [&](int i)
+	{
+		const int inside = createNode(insideTile(i), border);
+		const int outside = createNode(outsideTile(i), border);
+		m_nodes[inside].twin = outside;
+		m_nodes[outside].twin = inside;
+	};
+
+	int runStart = -1;
+	for (int i = 0; i <= length; ++i)
+	{
+		bool open = false;
+		if (i < length)
+		{
+			const auto inside = insideTile(i);
+			const auto outside = outsideTile(i);
+			open = isPassable(inside.x, inside.y) && isPassable(outside.x, outside.y);
+		}
+		if (open && runStart < 0)
+		{
+			runStart = i;
+		}
+		else if (!open && runStart >= 0)
+		{
+			const int runEnd = i - 1;
+			if (runEnd - runStart + 1 < HPA_MAX_SINGLE_ENTRANCE_WIDTH)
+			{
+				addEntrance((runStart + runEnd) / 2);
+			}
+			else
+			{
+				addEntrance(runStart);
+				addEntrance(runEnd);
+			}
+			runStart = -1;
+		}
+	}
+}
+
+void HierarchicalPathfinding::computeClusterCosts(int cluster, const CCTilePosition & source, std::vector<float> & costs) const
+{
+	int minX, minY, maxX, maxY;
+	getClusterBounds(cluster, minX, minY, maxX, maxY);
+	const int width = maxX - minX;
+	std::fill(costs.begin(), costs.end(), HPA_INFINITE_COST);
+
+	// Dijkstra restricted to the cluster, diagonal moves cannot cut the corner of an impassable tile
+	MinQueue queue;
+	const int sourceIndex = (source.x - minX) + (source.y - minY) * width;
+	costs[sourceIndex] = 0.f;
+	queue.push({ 0.f, sourceIndex });
+	while (!queue.empty())
+	{
+		const auto current = queue.top();
+		queue.pop();
+		if (current.first > costs[current.second])
+			continue;
+		const int x = minX + current.second % width;
+		const int y = minY + current.second / width;
+		for (int dx = -1; dx <= 1; ++dx)
+		{
+			for (int dy = -1; dy <= 1; ++dy)
+			{
+				if (dx == 0 && dy == 0)
+					continue;
+				const int nextX = x + dx;
+				const int nextY = y + dy;
+				if (nextX < minX || nextY < minY || nextX >= maxX || nextY >= maxY || !isPassable(nextX, nextY))
+					continue;
+				const bool diagonal = dx != 0 && dy != 0;
+				if (diagonal && (!isPassable(x + dx, y) || !isPassable(x, y + dy)))
+					continue;
+				const float cost = current.first + (diagonal ? HPA_DIAGONAL_COST : 1.f);
+				const int nextIndex = (nextX - minX) + (nextY - minY) * width;
+				if (cost < costs[nextIndex])
+				{
+					costs[nextIndex] = cost;
+					queue.push({ cost, nextIndex });
+				}
+			}
+		}
+	}
+}
+
+void HierarchicalPathfinding::buildIntraEdges(int cluster)
+{
+	int minX, minY, maxX, maxY;
+	getClusterBounds(cluster, minX, minY, maxX, maxY);
+	const int width = maxX - minX;
+	const auto & clusterNodes = m_clusterNodes[cluster];
+	for (const int index : clusterNodes)
+		m_nodes[index].edges.clear();
+
+	std::vector<float> costs(HPA_CLUSTER_SIZE * HPA_CLUSTER_SIZE);
+	for (size_t i = 0; i < clusterNodes.size(); ++i)
+	{
+		auto & node = m_nodes[clusterNodes[i]];
+		computeClusterCosts(cluster, node.tile, costs);
+		for (size_t j = i + 1; j < clusterNodes.size(); ++j)
+		{
+			auto & other = m_nodes[clusterNodes[j]];
+			const float cost = costs[(other.tile.x - minX) + (other.tile.y - minY) * width];
+			if (cost == HPA_INFINITE_COST)
+				continue;
+			node.edges.push_back({ clusterNodes[j], cost });
+			other.edges.push_back({ clusterNodes[i], cost });
+		}
+	}
+}
+
+void HierarchicalPathfinding::rebuild(const std::vector<bool> & dirtyClusters)
+{
+	// The entrances on the 4 sides of a dirty cluster are rebuilt, so the intra edges of its neighbors must be as well
+	std::vector<bool> dirtyBorders(m_borderNodes.size(), false);
+	std::vector<bool> clustersToLink(m_clusterNodes.size(), false);
+	for (int cluster = 0; cluster < int(dirtyClusters.size()); ++cluster)
+	{
+		if (!dirtyClusters[cluster])
+			continue;
+		const int clusterX = cluster % m_clustersX;
+		const int clusterY = cluster / m_clustersX;
+		clustersToLink[cluster] = true;
+		dirtyBorders[cluster * 2] = true;
+		dirtyBorders[cluster * 2 + 1] = true;
+		if (clusterX + 1 < m_clustersX)
+			clustersToLink[cluster + 1] = true;
+		if (clusterY + 1 < m_clustersY)
+			clustersToLink[cluster + m_clustersX] = true;
+		if (clusterX > 0)
+		{
+			dirtyBorders[(cluster - 1) * 2] = true;
+			clustersToLink[cluster - 1] = true;
+		}
+		if (clusterY > 0)
+		{
+			dirtyBorders[(cluster - m_clustersX) * 2 + 1] = true;
+			clustersToLink[cluster - m_clustersX] = true;
+		}
+	}
+
+	for (int border = 0; border < int(dirtyBorders.size()); ++border)
+	{
+		if (!dirtyBorders[border])
+			continue;
+		clearBorder(border);
+		buildBorder(border);
+	}
+
+	for (int cluster = 0; cluster < int(clustersToLink.size()); ++cluster)
+	{
+		if (clustersToLink[cluster])
+			buildIntraEdges(cluster);
+	}
+}
+
+bool HierarchicalPathfinding::getNearestPassableTile(const CCTilePosition & tile, CCTilePosition & passableTile) const
+{
+	if (isPassable(tile.x, tile.y))
+	{
+		passableTile = tile;
+		return true;
+	}
+	// The goal is often a unit or a building, look for the closest passable tile of the same cluster
+	int minX, minY, maxX, maxY;
+	getClusterBounds(getClusterIndex(tile.x, tile.y), minX, minY, maxX, maxY);
+	float bestDistance = HPA_INFINITE_COST;
+	for (int x = minX; x < maxX; ++x)
+	{
+		for (int y = minY; y < maxY; ++y)
+		{
+			if (!isPassable(x, y))
+				continue;
+			const float distance = Util::DistSq(tile, CCTilePosition(x, y));
+			if (distance < bestDistance)
+			{
+				bestDistance = distance;
+				passableTile = CCTilePosition(x, y);
+			}
+		}
+	}
+	return bestDistance != HPA_INFINITE_COST;
+}
+
+bool HierarchicalPathfinding::findCorridor(const CCTilePosition & from, const CCTilePosition & to, Corridor & corridor) const
+{
+	if (m_clusterNodes.empty())
+		return false;
+	if (from.x < m_minX || from.y < m_minY || from.x >= m_maxX || from.y >= m_maxY)
+		return false;
+	if (to.x < m_minX || to.y < m_minY || to.x >= m_maxX || to.y >= m_maxY)
+		return false;
+	const int startCluster = getClusterIndex(from.x, from.y);
+	const int goalCluster = getClusterIndex(to.x, to.y);
+	if (startCluster == goalCluster)
+		return false;
+
+	CCTilePosition start, goal;
+	if (!getNearestPassableTile(from, start) || !getNearestPassableTile(to, goal))
+		return false;
+
+	// Cost from each node of the goal cluster to the goal tile (the grid is symmetric)
+	int goalMinX, goalMinY, goalMaxX, goalMaxY;
+	getClusterBounds(goalCluster, goalMinX, goalMinY, goalMaxX, goalMaxY);
+	// Local buffer, several micro threads can look for a corridor at the same time
+	std::vector<float> clusterCosts(HPA_CLUSTER_SIZE * HPA_CLUSTER_SIZE);
+	computeClusterCosts(goalCluster, goal, clusterCosts);
+	std::map<int, float> goalCosts;
+	for (const int index : m_clusterNodes[goalCluster])
+	{
+		const auto & tile = m_nodes[index].tile;
+		const float cost = clusterCosts[(tile.x - goalMinX) + (tile.y - goalMinY) * (goalMaxX - goalMinX)];
+		if (cost != HPA_INFINITE_COST)
+			goalCosts[index] = cost;
+	}
+	if (goalCosts.empty())
+		return false;
+
+	// A* on the abstract graph, the virtual goal node is at index m_nodes.size()
+	const int goalNode = int(m_nodes.size());
+	std::vector<float> costs(m_nodes.size() + 1, HPA_INFINITE_COST);
+	std::vector<int> parents(m_nodes.size() + 1, -1);
+	MinQueue opened;
+	const auto push = [&](int index, int parent, float cost)
+	{
+		if (cost >= costs[index])
+			return;
+		costs[index] = cost;
+		parents[index] = parent;
+		const float heuristic = index == goalNode ? 0.f : Util::Dist(m_nodes[index].tile, goal);
+		opened.push({ cost + heuristic, index });
+	};
+
+	int startMinX, startMinY, startMaxX, startMaxY;
+	getClusterBounds(startCluster, startMinX, startMinY, startMaxX, startMaxY);
+	computeClusterCosts(startCluster, start, clusterCosts);
+	for (const int index : m_clusterNodes[startCluster])
+	{
+		const auto & tile = m_nodes[index].tile;
+		const float cost = clusterCosts[(tile.x - startMinX) + (tile.y - startMinY) * (startMaxX - startMinX)];
+		if (cost != HPA_INFINITE_COST)
+			push(index, -1, cost);
+	}
+
+	bool found = false;
+	while (!opened.empty())
+	{
+		const auto current = opened.top();
+		opened.pop();
+		const int index = current.second;
+		if (index == goalNode)
+		{
+			found = true;
+			break;
+		}
+		const float cost = costs[index];
+		const float heuristic = Util::Dist(m_nodes[index].tile, goal);
+		if (current.first > cost + heuristic)
+			continue;	// outdated entry
+
+		const auto & node = m_nodes[index];
+		if (node.twin >= 0)
+			push(node.twin, index, cost + 1.f);
+		for (const auto & edge : node.edges)
+			push(edge.first, index, cost + edge.second);
+		if (node.cluster == goalCluster)
+		{
+			const auto it = goalCosts.find(index);
+			if (it != goalCosts.end())
+				push(goalNode, index, cost + it->second);
+		}
+	}
+	if (!found)
+		return false;
+
+	std::vector<int> path;
+	for (int index = parents[goalNode]; index >= 0; index = parents[index])
+		path.push_back(index);
+	std::reverse(path.begin(), path.end());
+
+	const float totalCost = costs[goalNode];
+	corridor.m_minX = m_minX;
+	corridor.m_minY = m_minY;
+	corridor.m_clustersX = m_clustersX;
+	corridor.m_clustersY = m_clustersY;
+	corridor.m_steps.assign(m_clusterNodes.size(), CorridorStep());
+	corridor.m_waypoints.clear();
+	for (const int index : path)
+	{
+		// When the path enters then leaves a cluster, the leaving node overwrites the entering one
+		const auto & node = m_nodes[index];
+		auto & step = corridor.m_steps[node.cluster];
+		step.exit = node.tile;
+		step.remainingCost = totalCost - costs[index];
+		step.valid = true;
+		corridor.m_waypoints.push_back(node.tile);
+	}
+	auto & goalStep = corridor.m_steps[goalCluster];
+	goalStep.exit = goal;
+	goalStep.remainingCost = 0.f;
+	goalStep.valid = true;
+	corridor.m_waypoints.push_back(goal);
+	return true;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Common.h"
+
+class CCBot;
+
+// Hierarchical (HPA*) abstraction of the ground pathing grid.
+// The playable area is cut in square clusters, the walkable openings on the border between two clusters become
+// pairs of abstract nodes (entrances) and the nodes of a cluster are linked with their ground cost inside that cluster.
+// A long query then runs on a few hundred abstract nodes instead of the whole tile grid. The abstraction follows the
+// blocked tiles of the CombatCommander: only the clusters where a tile changed are rebuilt.
+class HierarchicalPathfinding
+{
+public:
+
+	struct CorridorStep
+	{
+		CCTilePosition exit;		// tile through which the abstract path leaves the cluster (the goal for the last cluster)
+		float remainingCost = 0.f;	// abstract cost from the exit to the goal
+		bool valid = false;
+	};
+
+	// Clusters crossed by an abstract path, used to guide and restrict a tile level search
+	class Corridor
+	{
+		friend class HierarchicalPathfinding;
+
+		int m_minX = 0;
+		int m_minY = 0;
+		int m_clustersX = 0;
+		int m_clustersY = 0;
+		std::vector<CorridorStep> m_steps;			// indexed by cluster
+		std::vector<CCTilePosition> m_waypoints;	// abstract nodes of the path, ending with the goal
+
+	public:
+
+		const CorridorStep * getStep(const CCTilePosition & tile) const;
+		const std::vector<CCTilePosition> & getWaypoints() const { return m_waypoints; }
+		// Estimated remaining cost from the tile to the goal following the corridor, negative if the tile is outside of it
+		float getHeuristic(const CCTilePosition & tile) const;
+	};
+
+private:
+
+	struct AbstractNode
+	{
+		CCTilePosition tile;
+		int cluster = -1;	// -1 when the node is free
+		int twin = -1;		// node on the other side of the entrance
+		std::vector<std::pair<int, float>> edges;	// intra cluster edges (node, cost)
+	};
+
+	CCBot & m_bot;
+	int m_minX = 0;
+	int m_minY = 0;
+	int m_maxX = 0;
+	int m_maxY = 0;
+	int m_clustersX = 0;
+	int m_clustersY = 0;
+	uint32_t m_lastUpdateFrame = 0;
+
+	std::vector<char> m_passable;					// indexed by (x - minX) + (y - minY) * width
+	std::vector<AbstractNode> m_nodes;
+	std::vector<int> m_freeNodes;
+	std::vector<std::vector<int>> m_clusterNodes;	// nodes of each cluster
+	std::vector<std::vector<int>> m_borderNodes;	// nodes created by each border, 2 borders per cluster (east and north)
+
+	bool computePassable(int x, int y) const;
+	bool isPassable(int x, int y) const;
+	int getClusterIndex(int x, int y) const;
+	void getClusterBounds(int cluster, int & minX, int & minY, int & maxX, int & maxY) const;
+	int createNode(const CCTilePosition & tile, int border);
+	void clearBorder(int border);
+	void buildBorder(int border);
+	void buildIntraEdges(int cluster);
+	void rebuild(const std::vector<bool> & dirtyClusters);
+	// costs must hold HPA_CLUSTER_SIZE * HPA_CLUSTER_SIZE values, it is indexed like the tiles of the cluster
+	void computeClusterCosts(int cluster, const CCTilePosition & source, std::vector<float> & costs) const;
+	bool getNearestPassableTile(const CCTilePosition & tile, CCTilePosition & passableTile) const;
+
+public:
+
+	HierarchicalPathfinding(CCBot & bot);
+
+	void onStart();
+	void onFrame();
+	void draw() const;
+
+	// Returns false when both tiles are in the same cluster or when no abstract path exists.
+	// Only reads the abstraction, so the micro threads can call it concurrently between two onFrame.
+	bool findCorridor(const CCTilePosition & from, const CCTilePosition & to, Corridor & corridor) const;
+	size_t getNodeCount() const { return m_nodes.size() - m_freeNodes.size(); }
+};
@@ -0,0 +1,120 @@
+#include "LatencyGovernor.h"
+#include "CCBot.h"
+#include "Util.h"
+
+namespace
+{
+	const size_t WINDOW_STEPS = 112;				// about 5 seconds in realtime
+	const size_t MIN_STEPS_BEFORE_ESCALATION = 44;	// the next tier gets at least two seconds to show its effect
+	const float ESCALATION_PERCENTILE = 0.95f;		// with the shortest window, a single slow step is not enough to escalate
+	const float RESTORATION_BUDGET_RATIO = 0.5f;	// headroom needed to restore the previous tier
+	const float REDUCED_PATHFINDING_NODE_RATIO = 0.5f;
+	const int LONGER_CLUSTERING_COOLDOWN_MULTIPLIER = 3;
+	const int SKIPPED_LOW_PRIORITY_CHECKS_MULTIPLIER = 3;
+	const float DISTANT_UNIT_MIN_DISTANCE = 15.f;	// from the closest enemy
+	const char * TIER_NAMES[LatencyTier::Num] = { "Normal", "ReducedPathfinding", "DecimatedMicro", "LongerClustering", "SkippedLowPriorityChecks" };
+}
+
+LatencyGovernor::LatencyGovernor(CCBot & bot)
+	: m_bot(bot)
+	, m_stepTimes(WINDOW_STEPS, 0)
+	, m_budget(0)
+{
+}
+
+void LatencyGovernor::onStart()
+{
+	m_budget = m_bot.Config().StepLatencyBudget * 1000;
+}
+
+long long LatencyGovernor::getPercentile(float percentile)
+{
+	const size_t count = std::min(m_stepCount, WINDOW_STEPS);
+	m_sortedStepTimes.assign(m_stepTimes.begin(), m_stepTimes.begin() + count);
+	const size_t index = std::min(count - 1, size_t(percentile * count));
+	std::nth_element(m_sortedStepTimes.begin(), m_sortedStepTimes.begin() + index, m_sortedStepTimes.end());
+	return m_sortedStepTimes[index];
+}
+
+void LatencyGovernor::onStep(long long stepTime)
+{
+	++m_microStep;
+	if (!m_bot.Config().IsRealTime || m_budget <= 0)
+		return;
+
+	m_stepTimes[m_nextStepTime] = stepTime;
+	m_nextStepTime = (m_nextStepTime + 1) % WINDOW_STEPS;
+	++m_stepCount;
+	++m_stepsInTier[m_tier];
+	PROFILE_COUNT("latencyTier", m_tier);
+
+	if (m_stepCount < MIN_STEPS_BEFORE_ESCALATION)
+		return;
+	const long long p99 = getPercentile(0.99f);
+	if (getPercentile(ESCALATION_PERCENTILE) > m_budget && m_tier + 1 < LatencyTier::Num)
+	{
+		setTier(m_tier + 1, getPercentile(0.5f), p99, getPercentile(1.f));
+	}
+	else if (m_stepCount >= WINDOW_STEPS && p99 < m_budget * RESTORATION_BUDGET_RATIO && m_tier > LatencyTier::Normal)
+	{
+		setTier(m_tier - 1, getPercentile(0.5f), p99, getPercentile(1.f));
+	}
+}
+
+void LatencyGovernor::setTier(int tier, long long p50, long long p99, long long max)
+{
+	if (tier > m_tier)
+		++m_escalationCount;
+	else
+		++m_restorationCount;
+
+	std::stringstream ss;
+	ss << TIER_NAMES[m_tier] << " -> " << TIER_NAMES[tier] << " (p50 " << 0.001f * p50 << "ms, p99 " << 0.001f * p99 << "ms, max " << 0.001f * max << "ms, budget " << 0.001f * m_budget << "ms)";
+	Util::Log(__FUNCTION__, ss.str(), m_bot);
+
+	m_tier = tier;
+	m_stepCount = 0;
+	m_nextStepTime = 0;
+}
+
+void LatencyGovernor::onEnd()
+{
+	if (m_escalationCount == 0)
+		return;
+	std::stringstream ss;
+	ss << m_escalationCount << " escalations, " << m_restorationCount << " restorations, steps per tier:";
+	for (int tier = 0; tier < LatencyTier::Num; ++tier)
+		ss << " " << TIER_NAMES[tier] << " " << m_stepsInTier[tier];
+	Util::Log(__FUNCTION__, ss.str(), m_bot);
+}
+
+float LatencyGovernor::getPathfindingNodeRatio() const
+{
+	return m_tier >= LatencyTier::ReducedPathfinding ? REDUCED_PATHFINDING_NODE_RATIO : 1.f;
+}
+
+int LatencyGovernor::getClusteringCooldownMultiplier() const
+{
+	return m_tier >= LatencyTier::LongerClustering ? LONGER_CLUSTERING_COOLDOWN_MULTIPLIER : 1;
+}
+
+int LatencyGovernor::getLowPriorityChecksMultiplier() const
+{
+	return m_tier >= LatencyTier::SkippedLowPriorityChecks ? SKIPPED_LOW_PRIORITY_CHECKS_MULTIPLIER : 1;
+}
+
+bool LatencyGovernor::shouldSkipMicro(const sc2::Unit * unit) const
+{
+	if (m_tier < LatencyTier::DecimatedMicro)
+		return false;
+	// Half of the units on even steps, the other half on odd ones
+	if ((m_microStep + unit->tag) % 2 == 0)
+		return false;
+	// Any known enemy counts, not only the targets of the squad, since a threat that is not a target still needs a reaction
+	for (const auto & enemy : m_bot.GetKnownEnemyUnits())
+	{
+		if (Util::DistSq(unit->pos, enemy.getPosition()) < DISTANT_UNIT_MIN_DISTANCE * DISTANT_UNIT_MIN_DISTANCE)
+			return false;
+	}
+	return true;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Common.h"
+
+class CCBot;
+
+namespace LatencyTier
+{
+	// Each tier keeps the load shedding of the previous ones
+	enum { Normal, ReducedPathfinding, DecimatedMicro, LongerClustering, SkippedLowPriorityChecks, Num };
+}
+
+// Keeps the duration of our steps under the realtime budget (a step longer than a game loop makes us skip frames).
+// The duration of the OnStep probe is tracked over a sliding window, when its 95th percentile goes over the budget the
+// governor moves to the next tier of load shedding, and when the 99th percentile goes back well under the budget it restores
+// the previous tier. The window is restarted at each transition so every decision is taken on steps played with the current tier.
+class LatencyGovernor
+{
+	CCBot & m_bot;
+	std::vector<long long> m_stepTimes;		// in microseconds, ring buffer of the window
+	std::vector<long long> m_sortedStepTimes;
+	size_t m_nextStepTime = 0;
+	size_t m_stepCount = 0;					// since the last transition
+	int m_tier = LatencyTier::Normal;
+	long long m_budget;						// in microseconds
+	int m_escalationCount = 0;
+	int m_restorationCount = 0;
+	int m_stepsInTier[LatencyTier::Num] = {};
+	uint32_t m_microStep = 0;				// counts our steps, the game loop can advance by an even number of frames per step
+
+	long long getPercentile(float percentile);
+	void setTier(int tier, long long p50, long long p99, long long max);
+
+public:
+
+	LatencyGovernor(CCBot & bot);
+
+	void onStart();
+	// Called once per step with the duration of the step, only acts in realtime
+	void onStep(long long stepTime);
+	void onEnd();
+
+	int getTier() const { return m_tier; }
+	// Multiplier of the maximum number of nodes a pathfinding query can explore
+	float getPathfindingNodeRatio() const;
+	// Multiplier of the duration during which the unit clusters are reused
+	int getClusteringCooldownMultiplier() const;
+	int getLowPriorityChecksMultiplier() const;
+	// Units far from all the known enemies get their micro only every other step, the others keep their current action
+	bool shouldSkipMicro(const sc2::Unit * unit) const;
+};
@@ -0,0 +1,353 @@
+#include "Logger.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#ifdef _WINDOWS
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	const size_t LOG_BUFFER_CAPACITY = 4096;		// power of two, with the slot size it caps the buffer to 2 MB
+	const size_t LOG_RECORD_TEXT_SIZE = 500;
+	const size_t LOG_WAKE_UP_RECORDS = LOG_BUFFER_CAPACITY / 4;	// the writer is woken up early when that many records are pending
+	const int LOG_WRITE_INTERVAL_MS = 20;
+	const int FLUSH_MAX_WAIT_MS = 200;				// a crashing thread does not wait forever for a stuck writer
+	const char TRUNCATED_SUFFIX[] = "...";
+	const size_t TRUNCATED_SUFFIX_LENGTH = sizeof(TRUNCATED_SUFFIX) - 1;
+	const size_t LOG_OUTPUT_BUFFER_SIZE = 64 * 1024;
+	const int STDOUT_DESCRIPTOR = 1;
+	const char * SEVERITY_TAGS[] = { "[DEBUG] ", "[INFO] ", "[WARNING] ", "[ERROR] ", "" };
+
+	struct LogRecord
+	{
+		std::atomic<size_t> sequence;	// equal to the position when the slot is free, to the position + 1 when it holds a record
+		uint32_t loop;
+		int severity;
+		size_t length;
+		char text[LOG_RECORD_TEXT_SIZE];
+	};
+
+	// Bounded multi producer single consumer queue (Dmitry Vyukov's), the producers never wait for the consumer
+	LogRecord records[LOG_BUFFER_CAPACITY];
+	std::atomic<size_t> enqueuePosition(0);
+	size_t dequeuePosition = 0;					// only touched by the thread owning the consumer flag
+	std::atomic_flag consuming = ATOMIC_FLAG_INIT;
+	std::atomic<size_t> droppedCount(0);
+	size_t reportedDroppedCount = 0;
+
+	std::atomic<bool> running(false);
+	std::thread * writerThread = nullptr;		// never destroyed while running, a joinable std::thread would terminate the process at exit
+	std::mutex wakeUpMutex;
+	std::condition_variable wakeUp;
+	int fileDescriptor = -1;
+	// The records are formatted in a static buffer and written with write(2), so the drain neither allocates nor goes through
+	// the streams and can run in a signal handler. Only touched by the owner of the consumer flag.
+	char outputBuffer[LOG_OUTPUT_BUFFER_SIZE];
+	size_t outputLength = 0;
+
+	int defaultLevel = LogSeverity::Debug;
+	std::unordered_map<std::string, int> categoryLevels;
+
+	void InitRecords()
+	{
+		static bool initialized = false;
+		if (initialized)
+			return;
+		for (size_t i = 0; i < LOG_BUFFER_CAPACITY; ++i)
+			records[i].sequence.store(i, std::memory_order_relaxed);
+		initialized = true;
+	}
+
+	void AppendText(LogRecord & record, const char * text, size_t length)
+	{
+		const size_t available = LOG_RECORD_TEXT_SIZE - record.length;
+		if (length > available)
+		{
+			const size_t kept = available > TRUNCATED_SUFFIX_LENGTH ? available - TRUNCATED_SUFFIX_LENGTH : 0;
+			memcpy(record.text + record.length, text, kept);
+			memcpy(record.text + LOG_RECORD_TEXT_SIZE - TRUNCATED_SUFFIX_LENGTH, TRUNCATED_SUFFIX, TRUNCATED_SUFFIX_LENGTH);
+			record.length = LOG_RECORD_TEXT_SIZE;
+		}
+		else
+		{
+			memcpy(record.text + record.length, text, length);
+			record.length += length;
+		}
+	}
+
+	void WriteFully(int descriptor, const char * data, size_t size)
+	{
+		while (size > 0)
+		{
+#ifdef _WINDOWS
+			const int written = _write(descriptor, data, unsigned(size));
+#else
+			const ssize_t written = write(descriptor, data, size);
+#endif
+			if (written <= 0)
+				return;		// nowhere else to report it
+			data += written;
+			size -= size_t(written);
+		}
+	}
+
+	void WriteOutput(const char * data, size_t size)
+	{
+		if (size == 0)
+			return;
+		if (fileDescriptor >= 0)
+			WriteFully(fileDescriptor, data, size);
+		WriteFully(STDOUT_DESCRIPTOR, data, size);
+	}
+
+	void FlushOutput()
+	{
+		WriteOutput(outputBuffer, outputLength);
+		outputLength = 0;
+	}
+
+	void AppendOutput(const char * text, size_t length)
+	{
+		if (outputLength + length > LOG_OUTPUT_BUFFER_SIZE)
+			FlushOutput();
+		memcpy(outputBuffer + outputLength, text, length);
+		outputLength += length;
+	}
+
+	void AppendOutput(const char * text)
+	{
+		AppendOutput(text, strlen(text));
+	}
+
+	void AppendNumber(size_t value)
+	{
+		char digits[20];
+		size_t count = 0;
+		do
+		{
+			digits[sizeof(digits) - 1 - count++] = char('0' + value % 10);
+			value /= 10;
+		} while (value > 0);
+		AppendOutput(digits + sizeof(digits) - count, count);
+	}
+
+	const char * GetSeverityTag(int severity)
+	{
+		return severity >= LogSeverity::Debug && severity < LogSeverity::None ? SEVERITY_TAGS[severity] : "";
+	}
+
+	void AppendRecord(const LogRecord & record)
+	{
+		if (record.loop != Logger::NO_LOOP)
+		{
+			AppendNumber(record.loop);
+			AppendOutput(": ", 2);
+		}
+		AppendOutput(GetSeverityTag(record.severity));
+		AppendOutput(record.text, record.length);
+		AppendOutput("\n", 1);
+	}
+
+	// Must be called by the owner of the consumer flag, async-signal-safe
+	void Drain()
+	{
+		for (;;)
+		{
+			LogRecord & record = records[dequeuePosition & (LOG_BUFFER_CAPACITY - 1)];
+			if (record.sequence.load(std::memory_order_acquire) != dequeuePosition + 1)
+				break;
+			AppendRecord(record);
+			record.sequence.store(dequeuePosition + LOG_BUFFER_CAPACITY, std::memory_order_release);
+			++dequeuePosition;
+		}
+
+		const size_t dropped = droppedCount.load(std::memory_order_relaxed);
+		if (dropped != reportedDroppedCount)
+		{
+			AppendNumber(dropped - reportedDroppedCount);
+			AppendOutput(" log records dropped, the log buffer was full\n");
+			reportedDroppedCount = dropped;
+		}
+		FlushOutput();
+	}
+
+	int OpenLogFile(const std::string & path)
+	{
+#ifdef _WINDOWS
+		return _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+		return open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+	}
+
+	void CloseLogFile()
+	{
+		if (fileDescriptor < 0)
+			return;
+#ifdef _WINDOWS
+		_close(fileDescriptor);
+#else
+		close(fileDescriptor);
+#endif
+		fileDescriptor = -1;
+	}
+
+	void WriterLoop()
+	{
+		while (running.load(std::memory_order_acquire))
+		{
+			{
+				std::unique_lock<std::mutex> lock(wakeUpMutex);
+				wakeUp.wait_for(lock, std::chrono::milliseconds(LOG_WRITE_INTERVAL_MS));
+			}
+			if (consuming.test_and_set(std::memory_order_acquire))
+				continue;	// a crashing thread is flushing
+			Drain();
+			consuming.clear(std::memory_order_release);
+		}
+	}
+}
+
+void Logger::Start(const std::string & path)
+{
+	Stop();
+	InitRecords();
+	fileDescriptor = OpenLogFile(path);
+	running.store(true, std::memory_order_release);
+	writerThread = new std::thread(WriterLoop);
+}
+
+void Logger::Stop()
+{
+	if (writerThread)
+	{
+		running.store(false, std::memory_order_release);
+		wakeUp.notify_one();
+		writerThread->join();
+		delete writerThread;
+		writerThread = nullptr;
+	}
+	Flush();
+	CloseLogFile();
+}
+
+void Logger::Flush()
+{
+	// The writer thread might be in the middle of a batch, or be the one crashing
+	const auto start = std::chrono::steady_clock::now();
+	while (consuming.test_and_set(std::memory_order_acquire))
+	{
+		if (std::chrono::steady_clock::now() - start > std::chrono::milliseconds(FLUSH_MAX_WAIT_MS))
+			return;
+		std::this_thread::yield();
+	}
+	Drain();
+	consuming.clear(std::memory_order_release);
+}
+
+void Logger::SetDefaultLevel(int severity)
+{
+	defaultLevel = severity;
+}
+
+void Logger::SetCategoryLevel(const std::string & category, int severity)
+{
+	categoryLevels[category] = severity;
+}
+
+int Logger::GetSeverityFromString(const std::string & str)
+{
+	if (str == "Debug")
+		return LogSeverity::Debug;
+	if (str == "Info")
+		return LogSeverity::Info;
+	if (str == "Warning")
+		return LogSeverity::Warning;
+	if (str == "Error")
+		return LogSeverity::Error;
+	return LogSeverity::None;
+}
+
+bool Logger::IsEnabled(const std::string & category, int severity)
+{
+	if (!categoryLevels.empty())
+	{
+		const auto it = categoryLevels.find(category);
+		if (it != categoryLevels.end())
+			return severity >= it->second;
+	}
+	return severity >= defaultLevel;
+}
+
+void Logger::Push(uint32_t loop, int severity, const std::string & category, const std::string & message)
+{
+	if (!IsEnabled(category, severity))
+		return;
+
+	if (!running.load(std::memory_order_acquire))
+	{
+		// Before the start or after the stop, there is no writer to wait for
+		std::string output;
+		if (loop != NO_LOOP)
+			output = std::to_string(loop) + ": ";
+		output += GetSeverityTag(severity);
+		output += message.empty() ? category : category + " | " + message;
+		output += '\n';
+		WriteOutput(output.data(), output.size());
+		return;
+	}
+
+	size_t position = enqueuePosition.load(std::memory_order_relaxed);
+	LogRecord * record;
+	for (;;)
+	{
+		record = &records[position & (LOG_BUFFER_CAPACITY - 1)];
+		const size_t sequence = record->sequence.load(std::memory_order_acquire);
+		const intptr_t difference = intptr_t(sequence) - intptr_t(position);
+		if (difference == 0)
+		{
+			if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (difference < 0)
+		{
+			// The slot still holds a record from the previous lap, the buffer is full
+			droppedCount.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		else
+		{
+			position = enqueuePosition.load(std::memory_order_relaxed);
+		}
+	}
+
+	record->loop = loop;
+	record->severity = severity;
+	record->length = 0;
+	AppendText(*record, category.data(), category.size());
+	if (!message.empty())
+	{
+		AppendText(*record, " | ", 3);
+		AppendText(*record, message.data(), message.size());
+	}
+	record->sequence.store(position + 1, std::memory_order_release);
+
+	if ((position & (LOG_WAKE_UP_RECORDS - 1)) == LOG_WAKE_UP_RECORDS - 1)
+		wakeUp.notify_one();
+}
+
+size_t Logger::GetDroppedCount()
+{
+	return droppedCount.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Common.h"
+
+namespace LogSeverity
+{
+	enum { Debug, Info, Warning, Error, None };
+}
+
+// Asynchronous logging backend used by Util::Log and Util::DebugLog.
+// The game thread only copies a preformatted record (game loop, severity and text) in a fixed size slot of a lock-free ring
+// buffer, a background thread drains the buffer every few milliseconds and writes the records to the log file and to the console
+// in batches. The ring buffer has a fixed capacity, when the writer falls behind the new records are dropped and counted instead
+// of blocking the game thread or growing the memory. Records longer than a slot are truncated.
+namespace Logger
+{
+	const uint32_t NO_LOOP = uint32_t(-1);	// for the records that are not attached to a game loop
+
+	// Opens the log file and starts the writer thread, the records pushed before are written directly
+	void	Start(const std::string & path);
+	// Writes every pending record and stops the writer thread
+	void	Stop();
+	// Writes every pending record from the calling thread. It does not allocate and only writes with write(2), so it can be
+	// called from a signal handler before the process exits.
+	void	Flush();
+
+	// The level of a category (the function name given to Util::Log) is the lowest severity it logs, the other categories use the default level
+	void	SetDefaultLevel(int severity);
+	void	SetCategoryLevel(const std::string & category, int severity);
+	int		GetSeverityFromString(const std::string & str);
+	bool	IsEnabled(const std::string & category, int severity);
+
+	// The message is optional, the record is written as "loop: [SEVERITY] category | message"
+	void	Push(uint32_t loop, int severity, const std::string & category, const std::string & message = "");
+	// Number of records dropped because the ring buffer was full
+	size_t	GetDroppedCount();
+}
@@ -1,12 +1,16 @@
 #include "MapTools.h"
 #include "Util.h"
 #include "CCBot.h"
+#include "libvoxelbot/utilities/thread_pool.h"
 
 #include <iostream>
 #include <sstream>
 #include <fstream>
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <string>
+#include <cstring>
 
 const size_t LegalActions = 4;
 const int actionX[LegalActions] ={1, -1, 0, 0};
@@ -16,6 +20,20 @@ typedef std::vector<std::vector<bool>> vvb;
 typedef std::vector<std::vector<int>>  vvi;
 typedef std::vector<std::vector<float>>  vvf;
 
+namespace
+{
+	const char STARTUP_CACHE_MAGIC[] = "MMSTARTUP";
+	const uint32_t STARTUP_CACHE_VERSION = 1;	// to increase when the distance maps change, the caches of the previous version are ignored
+	const uint32_t STARTUP_CACHE_MAX_MAPS = 500;
+
+	void HashValue(uint64_t & hash, uint64_t value)
+	{
+		// FNV-1a
+		hash ^= value;
+		hash *= 1099511628211ull;
+	}
+}
+
 #ifdef SC2API
     #define HALF_TILE 0.5f
 #else
@@ -29,11 +47,16 @@ MapTools::MapTools(CCBot & bot)
     , m_height  (0)
     , m_maxZ    (0.0f)
     , m_frame   (0)
+    , m_mapHash (0)
+    , m_startupCacheHash(0)
+    , m_startupCacheLoaded(false)
+    , m_hierarchicalPathfinding(bot)
+    , m_terrainAnalysis(bot)
 {
 
 }
 
-void MapTools::onStart()
+void MapTools::onStart(ThreadPool & pool)
 {
 #ifdef SC2API
 	m_totalWidth = m_bot.Observation()->GetGameInfo().width;
@@ -52,17 +75,17 @@ void MapTools::onStart()
     m_depotBuildable = vvb(m_totalWidth, std::vector<bool>(m_totalHeight, false));
     m_sectorNumber   = vvi(m_totalWidth, std::vector<int>(m_totalHeight, 0));
 
-	auto & info = m_bot.Observation()->GetGameInfo();
-    // Set the boolean grid data from the Map
-    for (int x = m_min.x; x < m_max.x; ++x)
+    // Set the boolean grid data from the Map, the columns are independent
+    pool.parallelFor(int(m_max.x - m_min.x), [&](int column)
     {
+        const int x = int(m_min.x) + column;
         for (int y = m_min.y; y < m_max.y; ++y)
         {
             m_buildable[x][y]       = canBuild(x, y);
             m_depotBuildable[x][y]  = canBuild(x, y);
             m_walkable[x][y]        = m_buildable[x][y] || canWalk(x, y);
         }
-    }
+    });
 
 #ifdef SC2API
     for (auto & unit : m_bot.Observation()->GetUnits())
@@ -147,12 +170,26 @@ void MapTools::onStart()
 #endif
 
     computeConnectivity();
+    m_mapHash = computeMapHash();
+    m_startupCacheHash = computeStartupCacheHash();
+    m_startupCacheLoaded = loadStartupCache();
+
+    // Both only read the grids
+    pool.parallelFor(2, [&](int task)
+    {
+        if (task == 0)
+            m_hierarchicalPathfinding.onStart();
+        else
+            m_terrainAnalysis.onStart();
+    });
 }
 
 void MapTools::onFrame()
 {
     m_frame++;
 
+    m_hierarchicalPathfinding.onFrame();
+
     draw();
 }
 
@@ -311,6 +348,124 @@ int MapTools::getGroundDistance(const CCPosition & src, const CCPosition & dest)
     return getDistanceMap(dest).getDistance(src);
 }
 
+uint64_t MapTools::computeMapHash() const
+{
+	uint64_t hash = 14695981039346656037ull;
+	HashValue(hash, int(m_min.x));
+	HashValue(hash, int(m_min.y));
+	HashValue(hash, int(m_max.x));
+	HashValue(hash, int(m_max.y));
+	for (int y = m_min.y; y < m_max.y; ++y)
+	{
+		for (int x = m_min.x; x < m_max.x; ++x)
+		{
+			const int height = int(std::round(terrainHeight(CCTilePosition(x, y)) * 100));
+			HashValue(hash, uint64_t(isWalkable(x, y)) | uint64_t(isBuildable(x, y)) << 1 | uint64_t(uint32_t(height)) << 2);
+		}
+	}
+	return hash;
+}
+
+uint64_t MapTools::computeStartupCacheHash() const
+{
+	// The distance maps avoid the tiles blocked by the neutral units and not the ones around our start location
+	std::vector<std::array<int, 3>> neutralUnits;
+	for (const auto & neutralUnit : m_bot.GetNeutralUnits())
+	{
+		const auto & position = neutralUnit.second.getPosition();
+		neutralUnits.push_back({ int(neutralUnit.second.getAPIUnitType().ToType()), int(position.x * 2), int(position.y * 2) });
+	}
+	std::sort(neutralUnits.begin(), neutralUnits.end());
+
+	uint64_t hash = m_mapHash;
+	HashValue(hash, STARTUP_CACHE_VERSION);
+	HashValue(hash, int(m_bot.GetStartLocation().x * 2));
+	HashValue(hash, int(m_bot.GetStartLocation().y * 2));
+	for (const auto & neutralUnit : neutralUnits)
+	{
+		for (const int value : neutralUnit)
+			HashValue(hash, uint32_t(value));
+	}
+	return hash;
+}
+
+std::string MapTools::getStartupCachePath() const
+{
+	std::stringstream ss;
+	ss << "data/startup_" << std::hex << m_startupCacheHash << ".bin";
+	return ss.str();
+}
+
+bool MapTools::loadStartupCache()
+{
+	std::ifstream file(getStartupCachePath(), std::ios::binary);
+	if (!file.good())
+		return false;
+
+	char magic[sizeof(STARTUP_CACHE_MAGIC)];
+	uint32_t version;
+	uint64_t hash;
+	uint32_t mapCount;
+	if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, STARTUP_CACHE_MAGIC, sizeof(magic)) != 0
+		|| !file.read(reinterpret_cast<char *>(&version), sizeof(version)) || version != STARTUP_CACHE_VERSION
+		|| !file.read(reinterpret_cast<char *>(&hash), sizeof(hash)) || hash != m_startupCacheHash
+		|| !file.read(reinterpret_cast<char *>(&mapCount), sizeof(mapCount)) || mapCount > STARTUP_CACHE_MAX_MAPS)
+		return false;
+
+	std::map<std::pair<int, int>, DistanceMap> maps;
+	for (uint32_t i = 0; i < mapCount; ++i)
+	{
+		DistanceMap map;
+		if (!map.load(file, m_totalWidth, m_totalHeight))
+			return false;
+		maps[std::make_pair(map.getStartTile().x, map.getStartTile().y)] = std::move(map);
+	}
+	m_allMaps.insert(maps.begin(), maps.end());
+
+	std::stringstream ss;
+	ss << mapCount << " distance maps loaded from " << getStartupCachePath();
+	Util::Log(__FUNCTION__, ss.str(), m_bot);
+	return true;
+}
+
+void MapTools::saveStartupCache() const
+{
+	if (m_startupCacheLoaded)
+		return;
+
+	const auto path = getStartupCachePath();
+	std::ofstream file(path, std::ios::binary);
+	const uint32_t mapCount = uint32_t(std::min<size_t>(m_allMaps.size(), STARTUP_CACHE_MAX_MAPS));
+	file.write(STARTUP_CACHE_MAGIC, sizeof(STARTUP_CACHE_MAGIC));
+	file.write(reinterpret_cast<const char *>(&STARTUP_CACHE_VERSION), sizeof(STARTUP_CACHE_VERSION));
+	file.write(reinterpret_cast<const char *>(&m_startupCacheHash), sizeof(m_startupCacheHash));
+	file.write(reinterpret_cast<const char *>(&mapCount), sizeof(mapCount));
+	uint32_t written = 0;
+	for (auto it = m_allMaps.begin(); it != m_allMaps.end() && written < mapCount; ++it, ++written)
+		it->second.save(file);
+	if (!file.good())
+		Util::Log(__FUNCTION__, "Could not write the startup cache " + path, m_bot);
+}
+
+void MapTools::precomputeDistanceMaps(const std::vector<CCTilePosition> & tiles, ThreadPool & pool)
+{
+	// The searches are independent, they are added to the cache once they are all done
+	std::vector<CCTilePosition> missingTiles;
+	for (const auto & tile : tiles)
+	{
+		if (m_allMaps.find(std::make_pair(tile.x, tile.y)) == m_allMaps.end() && std::find(missingTiles.begin(), missingTiles.end(), tile) == missingTiles.end())
+			missingTiles.push_back(tile);
+	}
+
+	std::vector<DistanceMap> maps(missingTiles.size());
+	pool.parallelFor(int(missingTiles.size()), [&](int i)
+	{
+		maps[i].computeDistanceMap(m_bot, missingTiles[i]);
+	});
+	for (size_t i = 0; i < missingTiles.size(); ++i)
+		m_allMaps[std::make_pair(missingTiles[i].x, missingTiles[i].y)] = std::move(maps[i]);
+}
+
 const DistanceMap & MapTools::getDistanceMap(const CCPosition & pos) const
 {
     return getDistanceMap(Util::GetTilePosition(pos));
@@ -544,7 +699,6 @@ const std::vector<CCTilePosition> & MapTools::getClosestTilesTo(const CCTilePosi
 
 bool MapTools::canWalk(int tileX, int tileY) 
 {
-    auto & info = m_bot.Observation()->GetGameInfo();
     sc2::Point2DI pointI(tileX, tileY);
     if (pointI.x < m_min.x || pointI.x >= m_max.x || pointI.y < m_min.y || pointI.y >= m_max.y)
     {
@@ -563,7 +717,6 @@ bool MapTools::isInCameraFrustum(int x, int y) const
 
 bool MapTools::canBuild(int tileX, int tileY) 
 {
-    auto & info = m_bot.Observation()->GetGameInfo();
     sc2::Point2DI pointI(tileX, tileY);
     if (pointI.x < m_min.x || pointI.x >= m_max.x || pointI.y < m_min.y || pointI.y >= m_max.y)
     {
@@ -3,8 +3,11 @@
 #include <vector>
 #include "DistanceMap.h"
 #include "UnitType.h"
+#include "HierarchicalPathfinding.h"
+#include "TerrainAnalysis.h"
 
 class CCBot;
+struct ThreadPool;
 
 class MapTools
 {
@@ -17,6 +20,9 @@ class MapTools
 	CCPosition m_max;
     float   m_maxZ;
     int     m_frame;
+    uint64_t m_mapHash;             // hash of the terrain grids, the key of the per map caches
+    uint64_t m_startupCacheHash;    // also covers what else the cached distance maps depend on
+    bool    m_startupCacheLoaded;
     
 
     // a cache of already computed distance maps, which is mutable since it only acts as a cache
@@ -26,8 +32,14 @@ class MapTools
     std::vector<std::vector<bool>>  m_buildable;        // whether a tile is buildable (includes static resources)
     std::vector<std::vector<bool>>  m_depotBuildable;   // whether a depot is buildable on a tile (illegal within 3 tiles of static resource)
     std::vector<std::vector<int>>   m_sectorNumber;     // connectivity sector number, two tiles are ground connected if they have the same number
+    HierarchicalPathfinding         m_hierarchicalPathfinding;  // cluster abstraction used to guide long ground paths
+    TerrainAnalysis                 m_terrainAnalysis;          // regions, chokes and ramps of the map
     
     void computeConnectivity();
+    uint64_t computeMapHash() const;
+    uint64_t computeStartupCacheHash() const;
+    std::string getStartupCachePath() const;
+    bool loadStartupCache();
 
     int getSectorNumber(int x, int y) const;
         
@@ -41,9 +53,11 @@ public:
 
     MapTools(CCBot & bot);
 
-    void    onStart();
+    void    onStart(ThreadPool & pool);
     void    onFrame();
     void    draw() const;
+    // Writes the distance maps computed during the start to the cache of the map, unless they were loaded from it
+    void    saveStartupCache() const;
 
 	int     totalWidth() const { return m_totalWidth; }
 	int     totalHeight() const { return m_totalHeight; }
@@ -53,6 +67,7 @@ public:
 	CCPosition mapMax() const { return m_max; }
 	float	maxZ() const { return m_maxZ; }
 	CCPosition center() const { return CCPosition(m_totalWidth / 2.f, m_totalHeight / 2.f); }
+	uint64_t getMapHash() const { return m_mapHash; }
 	float   terrainHeight(const CCPosition & point) const;
 	float	terrainHeight(CCTilePosition tile) const;
     float   terrainHeight(float x, float y) const;
@@ -82,6 +97,8 @@ public:
 
     const   DistanceMap & getDistanceMap(const CCTilePosition & tile) const;
     const   DistanceMap & getDistanceMap(const CCPosition & tile) const;
+    // Computes the missing distance maps of the tiles in parallel
+    void    precomputeDistanceMaps(const std::vector<CCTilePosition> & tiles, ThreadPool & pool);
     int     getGroundDistance(const CCPosition & src, const CCPosition & dest) const;
     bool    isConnected(int x1, int y1, int x2, int y2) const;
     bool    isConnected(const CCTilePosition & from, const CCTilePosition & to) const;
@@ -94,6 +111,9 @@ public:
 	bool	isBuildable(const CCTilePosition & tile) const;
     bool    isDepotBuildableTile(int tileX, int tileY) const;
 
+    HierarchicalPathfinding & getHierarchicalPathfinding() { return m_hierarchicalPathfinding; }
+    const TerrainAnalysis & getTerrainAnalysis() const { return m_terrainAnalysis; }
+
     // returns a list of all tiles on the map, sorted by 4-direcitonal walk distance from the given position
     const std::vector<CCTilePosition> & getClosestTilesTo(const CCTilePosition & pos) const;
 };
@@ -27,29 +27,29 @@ void MeleeManager::executeMicro()
 {
 	if (!m_stackingMineral.isValid())
 	{
-		m_bot.StartProfiling("0.10.4.1.4.1        identifyStackingMinerals");
+		PROFILE_BEGIN("identifyStackingMinerals");
 		identifyStackingMinerals();
-		m_bot.StopProfiling("0.10.4.1.4.1        identifyStackingMinerals");
+		PROFILE_END("identifyStackingMinerals");
 	}
 
 	const bool workerRushed = m_bot.Strategy().isWorkerRushed();
 	if (workerRushed && m_order.getType() == SquadOrderTypes::Defend && shouldStackWorkers())
 	{
 		// The stacked workers cannot one shot enemies because they push each other out of range of their target when they attack
-		m_bot.StartProfiling("0.10.4.1.4.2        areUnitsStackedUp");
+		PROFILE_BEGIN("areUnitsStackedUp");
 		bool stacked = areUnitsStackedUp();
-		m_bot.StopProfiling("0.10.4.1.4.2        areUnitsStackedUp");
+		PROFILE_END("areUnitsStackedUp");
 		if (!stacked)
 		{
-			m_bot.StartProfiling("0.10.4.1.4.3        stackUnits");
+			PROFILE_BEGIN("stackUnits");
 			stackUnits();
-			m_bot.StopProfiling("0.10.4.1.4.3        stackUnits");
+			PROFILE_END("stackUnits");
 		}
 		else
 		{
-			m_bot.StartProfiling("0.10.4.1.4.4        microStack");
+			PROFILE_BEGIN("microStack");
 			microStack();
-			m_bot.StopProfiling("0.10.4.1.4.4        microStack");
+			PROFILE_END("microStack");
 		}
 
 		// Not working well enough, backstabers get killed way too fast
@@ -60,7 +60,7 @@ void MeleeManager::executeMicro()
 	const bool workerRushStrat = m_bot.Strategy().getStartingStrategy() == WORKER_RUSH;
 	if (workerRushStrat)
 	{
-		m_bot.StartProfiling("0.10.4.1.4.5        waitForProbesHealed");
+		PROFILE_BEGIN("waitForProbesHealed");
 		for (auto it = m_healingProbes.begin(); it != m_healingProbes.end();)
 		{
 			auto unit = m_bot.GetUnit(*it);
@@ -80,16 +80,16 @@ void MeleeManager::executeMicro()
 		{
 			m_waitForProbesHealed = false;
 		}
-		m_bot.StopProfiling("0.10.4.1.4.5        waitForProbesHealed");
+		PROFILE_END("waitForProbesHealed");
 	}
 
-	m_bot.StartProfiling("0.10.4.1.4.6        microUnit");
+	PROFILE_BEGIN("microUnit");
     // for each meleeUnit
     for (auto & meleeUnit : meleeUnits)
     {
 		microUnit(meleeUnit);
     }
-	m_bot.StopProfiling("0.10.4.1.4.6        microUnit");
+	PROFILE_END("microUnit");
 }
 
 void MeleeManager::microUnit(const Unit & meleeUnit)
@@ -107,7 +107,7 @@ void MeleeManager::microUnit(const Unit & meleeUnit)
 	bool isHealing = false;
 	if (isProbe)
 	{
-		m_bot.StartProfiling("0.10.4.1.4.6.1         probeChecks");
+		PROFILE_BEGIN("probeChecks");
 		if (meleeUnit.getShields() <= 5)
 		{
 			m_healingProbes.emplace(meleeUnit.getTag());
@@ -125,7 +125,7 @@ void MeleeManager::microUnit(const Unit & meleeUnit)
 		{
 			isHealing = true;
 		}
-		m_bot.StopProfiling("0.10.4.1.4.6.1         probeChecks");
+		PROFILE_END("probeChecks");
 	}
 
 	bool flee = false;
@@ -142,10 +142,10 @@ void MeleeManager::microUnit(const Unit & meleeUnit)
 		}
 		else
 		{
-			m_bot.StartProfiling("0.10.4.1.4.6.2         getTarget");
+			PROFILE_BEGIN("getTarget");
 			// find the best target for this meleeUnit
 			Unit target = getTarget(meleeUnit, m_targets);
-			m_bot.StopProfiling("0.10.4.1.4.6.2         getTarget");
+			PROFILE_END("getTarget");
 			if (!target.isValid())
 			{
 				noTarget = true;
@@ -158,7 +158,7 @@ void MeleeManager::microUnit(const Unit & meleeUnit)
 				bool injuredUnitInDanger = false;
 				if (!isBackstabber && (isProbe ? isHealing : (meleeUnit.getHitPointsPercentage() <= 25)))
 				{
-					m_bot.StartProfiling("0.10.4.1.4.6.3         injured");
+					PROFILE_BEGIN("injured");
 					injured = true;
 					for (const auto & threat : m_targets)
 					{
@@ -169,29 +169,29 @@ void MeleeManager::microUnit(const Unit & meleeUnit)
 							break;
 						}
 					}
-					m_bot.StopProfiling("0.10.4.1.4.6.3         injured");
+					PROFILE_END("injured");
 				}
 
 				bool closeToTarget = Util::Dist(meleeUnit, target) <= Util::GetAttackRangeForTarget(meleeUnit.getUnitPtr(), target.getUnitPtr(), m_bot) + 0.5f;
 				float minWeaponCooldownToMineralWalk = closeToTarget ? (isBackstabber ? 0.f : 5.f) : 10.f;
 				// If it is a worker that just attacked a non building unit, we want it to mineral walk back (or forward when it's a backstabber)
-				m_bot.StartProfiling("0.10.4.1.4.6.4         shouldMineralWalk");
+				PROFILE_BEGIN("shouldMineralWalk");
 				bool shouldMineralWalk = meleeUnit.getType().isWorker() && (meleeUnit.getUnitPtr()->weapon_cooldown > minWeaponCooldownToMineralWalk || injuredUnitInDanger) && Util::getSpeedOfUnit(target.getUnitPtr(), m_bot) > 0.f && m_squad->getName() != "ScoutDefense";
-				m_bot.StopProfiling("0.10.4.1.4.6.4         shouldMineralWalk");
+				PROFILE_END("shouldMineralWalk");
 				if (shouldMineralWalk)
 				{
-					m_bot.StartProfiling("0.10.4.1.4.6.5         mineralWalk");
+					PROFILE_BEGIN("mineralWalk");
 					auto & mineral = isBackstabber ? m_enemyMineral : m_stackingMineral;
 					if (mineral.isValid())
 					{
 						const auto action = UnitAction(MicroActionType::RightClick, mineral.getUnitPtr(), false, 0, "mineral walk", m_squad->getName());
 						m_bot.Commander().Combat().PlanAction(meleeUnit.getUnitPtr(), action);
 					}
-					m_bot.StopProfiling("0.10.4.1.4.6.5         mineralWalk");
+					PROFILE_END("mineralWalk");
 				}
 				else
 				{
-					m_bot.StartProfiling("0.10.4.1.4.6.6         getRepairTarget");
+					PROFILE_BEGIN("getRepairTarget");
 					const sc2::Unit* repairTarget = nullptr;
 					const sc2::Unit* closestRepairTarget = nullptr;
 					float distanceToClosestRepairTarget = 0;
@@ -227,35 +227,35 @@ void MeleeManager::microUnit(const Unit & meleeUnit)
 							}
 						}
 					}
-					m_bot.StopProfiling("0.10.4.1.4.6.6         getRepairTarget");
+					PROFILE_END("getRepairTarget");
 
 					if (repairTarget || (injured && closestRepairTarget))
 					{
-						m_bot.StartProfiling("0.10.4.1.4.6.7         repair");
+						PROFILE_BEGIN("repair");
 						if (!repairTarget)
 							repairTarget = closestRepairTarget;
 						const auto action = UnitAction(MicroActionType::RightClick, repairTarget, false, 0, "repair", m_squad->getName());
 						m_bot.Commander().Combat().PlanAction(meleeUnit.getUnitPtr(), action);
-						m_bot.StopProfiling("0.10.4.1.4.6.7         repair");
+						PROFILE_END("repair");
 					}
 					else if (!injured || workerRushStrat)
 					{
 						// attack the target if we can see it, otherwise move towards it
 						if (target.getUnitPtr()->last_seen_game_loop == m_bot.GetCurrentFrame())
 						{
-							m_bot.StartProfiling("0.10.4.1.4.6.8         attack");
+							PROFILE_BEGIN("attack");
 							const auto action = UnitAction(MicroActionType::AttackUnit, target.getUnitPtr(), false, 0, "attack target", m_squad->getName());
 							m_bot.Commander().Combat().PlanAction(meleeUnit.getUnitPtr(), action);
-							m_bot.StopProfiling("0.10.4.1.4.6.8         attack");
+							PROFILE_END("attack");
 						}
 						else
 						{
-							m_bot.StartProfiling("0.10.4.1.4.6.9         move");
+							PROFILE_BEGIN("move");
 							auto movePosition = target.getPosition();
 							// If there is an enemy worker hidding in our base, explore the tiles of the base
 							if (m_bot.Strategy().enemyHasWorkerHiddingInOurMain())
 							{
-								m_bot.StartProfiling("0.10.4.1.4.6.9.1          exploreBaseTiles");
+								PROFILE_BEGIN("exploreBaseTiles");
 								CCTilePosition closestUnexploredTile;
 								float closestDistance = -1;
 								const auto & baseTiles = m_bot.Bases().getPlayerStartingBaseLocation(Players::Self)->getBaseTiles();
@@ -276,11 +276,11 @@ void MeleeManager::microUnit(const Unit & meleeUnit)
 								{
 									movePosition = Util::GetPosition(closestUnexploredTile);
 								}
-								m_bot.StopProfiling("0.10.4.1.4.6.9.1          exploreBaseTiles");
+								PROFILE_END("exploreBaseTiles");
 							}
 							const auto action = UnitAction(MicroActionType::Move, movePosition, false, 0, "move towards target", m_squad->getName());
 							m_bot.Commander().Combat().PlanAction(meleeUnit.getUnitPtr(), action);
-							m_bot.StopProfiling("0.10.4.1.4.6.9         move");
+							PROFILE_END("move");
 						}
 					}
 				}
@@ -302,7 +302,7 @@ void MeleeManager::microUnit(const Unit & meleeUnit)
 		}
 		if (Util::PathFinding::GetTotalInfluenceOnTile(Util::GetTilePosition(meleeUnit.getPosition()), meleeUnit.getUnitPtr(), m_bot) > 0)
 		{
-			m_bot.StartProfiling("0.10.4.1.4.6.10         flee");
+			PROFILE_BEGIN("flee");
 			CCPosition goal = m_order.getPosition();
 			if (m_bot.Workers().getWorkerData().isProxyWorker(meleeUnit))
 				goal = m_bot.GetEnemyStartLocations().empty() ? m_bot.Map().center() : m_bot.GetEnemyStartLocations()[0];
@@ -313,23 +313,23 @@ void MeleeManager::microUnit(const Unit & meleeUnit)
 				m_bot.Commander().Combat().PlanAction(meleeUnit.getUnitPtr(), action);
 				flee = false;
 			}
-			m_bot.StopProfiling("0.10.4.1.4.6.10         flee");
+			PROFILE_END("flee");
 		}
 		auto enemyBase = m_bot.Bases().getPlayerStartingBaseLocation(Players::Enemy);
 		if (noTarget && workerRushStrat && enemyBase && enemyBase->containsPositionApproximative(m_order.getPosition()))
 		{
-			m_bot.StartProfiling("0.10.4.1.4.6.11         mineralWalkEnemyBase");
+			PROFILE_BEGIN("mineralWalkEnemyBase");
 			auto enemyMineral = enemyBase->getMinerals()[0].getUnitPtr();
 			const auto action = UnitAction(MicroActionType::RightClick, enemyMineral, false, 0, "mineral walk", m_squad->getName());
 			m_bot.Commander().Combat().PlanAction(meleeUnit.getUnitPtr(), action);
-			m_bot.StopProfiling("0.10.4.1.4.6.11         mineralWalkEnemyBase");
+			PROFILE_END("mineralWalkEnemyBase");
 		}
 		else if (flee || noTarget)
 		{
-			m_bot.StartProfiling("0.10.4.1.4.6.12         moveBack");
+			PROFILE_BEGIN("moveBack");
 			const auto action = UnitAction(MicroActionType::Move, m_order.getPosition(), false, 0, "flee", m_squad->getName());
 			m_bot.Commander().Combat().PlanAction(meleeUnit.getUnitPtr(), action);
-			m_bot.StopProfiling("0.10.4.1.4.6.12         moveBack");
+			PROFILE_END("moveBack");
 		}
 	}
 
@@ -0,0 +1,131 @@
+#include "MineralAssignmentSolver.h"
+#include "Util.h"
+
+namespace
+{
+	const float TRIP_WEIGHT = 10.f;					// a worker walks its mining trip many times, but walks to its patch only once
+	const float FAR_PATCH_EXTRA_DISTANCE = 0.5f;	// far patches need a detour around the close ones
+	const float CURRENT_PATCH_BONUS = 2.f;			// a worker moved to another patch loses the progress of its current trip
+	const float NO_SLOT_COST = 100000.f;			// above any real cost
+	const int SATURATED_PATCH_WORKERS = 2;
+}
+
+void MineralAssignmentSolver::clear()
+{
+	m_patches.clear();
+	m_workers.clear();
+}
+
+void MineralAssignmentSolver::addPatch(const CCPosition & position, float depotDistance, bool farPatch, int freeSlots)
+{
+	const float tripDistance = depotDistance + (farPatch ? FAR_PATCH_EXTRA_DISTANCE : 0.f);
+	m_patches.push_back({ position, tripDistance * TRIP_WEIGHT, std::min(freeSlots, SATURATED_PATCH_WORKERS) });
+}
+
+void MineralAssignmentSolver::addWorker(const CCPosition & position, int currentPatch)
+{
+	m_workers.push_back({ position, currentPatch });
+}
+
+float MineralAssignmentSolver::getCost(int worker, int slot) const
+{
+	// The last columns are the "no slot" of each worker, so there is always a complete assignment
+	if (slot >= int(m_slotPatches.size()))
+		return NO_SLOT_COST;
+
+	const int patchIndex = m_slotPatches[slot];
+	const auto & patch = m_patches[patchIndex];
+	const auto & workerInfo = m_workers[worker];
+	float cost = Util::Dist(workerInfo.position, patch.position) + patch.tripCost;
+	if (workerInfo.currentPatch == patchIndex)
+		cost -= CURRENT_PATCH_BONUS;
+	return cost;
+}
+
+const std::vector<int> & MineralAssignmentSolver::solve()
+{
+	const int rows = int(m_workers.size());
+	m_result.assign(rows, -1);
+	if (rows == 0)
+		return m_result;
+
+	m_slotPatches.clear();
+	for (size_t i = 0; i < m_patches.size(); ++i)
+	{
+		for (int slot = 0; slot < m_patches[i].freeSlots; ++slot)
+			m_slotPatches.push_back(int(i));
+	}
+	const int columns = int(m_slotPatches.size()) + rows;
+
+	m_costs.resize(rows * columns);
+	for (int row = 0; row < rows; ++row)
+	{
+		for (int column = 0; column < columns; ++column)
+			m_costs[row * columns + column] = getCost(row, column);
+	}
+
+	// Hungarian algorithm with potentials, rows and columns are 1-based and column 0 is the virtual start of the augmenting paths
+	const float infinity = std::numeric_limits<float>::max();
+	m_rowPotentials.assign(rows + 1, 0.f);
+	m_columnPotentials.assign(columns + 1, 0.f);
+	m_columnRows.assign(columns + 1, 0);
+	m_previousColumns.assign(columns + 1, 0);
+	for (int row = 1; row <= rows; ++row)
+	{
+		m_columnRows[0] = row;
+		int column = 0;
+		m_minSlack.assign(columns + 1, infinity);
+		m_usedColumns.assign(columns + 1, false);
+		do
+		{
+			m_usedColumns[column] = true;
+			const int currentRow = m_columnRows[column];
+			float delta = infinity;
+			int nextColumn = 0;
+			for (int j = 1; j <= columns; ++j)
+			{
+				if (m_usedColumns[j])
+					continue;
+				const float slack = m_costs[(currentRow - 1) * columns + j - 1] - m_rowPotentials[currentRow] - m_columnPotentials[j];
+				if (slack < m_minSlack[j])
+				{
+					m_minSlack[j] = slack;
+					m_previousColumns[j] = column;
+				}
+				if (m_minSlack[j] < delta)
+				{
+					delta = m_minSlack[j];
+					nextColumn = j;
+				}
+			}
+			for (int j = 0; j <= columns; ++j)
+			{
+				if (m_usedColumns[j])
+				{
+					m_rowPotentials[m_columnRows[j]] += delta;
+					m_columnPotentials[j] -= delta;
+				}
+				else
+				{
+					m_minSlack[j] -= delta;
+				}
+			}
+			column = nextColumn;
+		} while (m_columnRows[column] != 0);
+
+		// Flip the augmenting path
+		do
+		{
+			const int previousColumn = m_previousColumns[column];
+			m_columnRows[column] = m_columnRows[previousColumn];
+			column = previousColumn;
+		} while (column != 0);
+	}
+
+	for (int column = 1; column <= int(m_slotPatches.size()); ++column)
+	{
+		if (m_columnRows[column] != 0)
+			m_result[m_columnRows[column] - 1] = m_slotPatches[column - 1];
+	}
+	return m_result;
+}
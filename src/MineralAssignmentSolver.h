@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Common.h"
+
+// Batched assignment of workers to the mineral patches of a base.
+// Each patch offers a slot for every worker it can take without losing income (two), the cost of a slot is the distance
+// the worker has to walk to reach the patch plus the length of the mining trip weighted by the number of trips it will do,
+// so close patches are filled before far ones. The Hungarian algorithm finds the assignment with the lowest total cost,
+// which spreads the whole batch at once instead of each worker taking the best patch left by the previous ones.
+class MineralAssignmentSolver
+{
+	struct Patch
+	{
+		CCPosition position;
+		float tripCost;
+		int freeSlots;
+	};
+
+	struct Worker
+	{
+		CCPosition position;
+		int currentPatch;
+	};
+
+	std::vector<Patch> m_patches;
+	std::vector<Worker> m_workers;
+	std::vector<int> m_slotPatches;		// patch of each slot, the columns of the cost matrix
+	std::vector<float> m_costs;
+	std::vector<float> m_rowPotentials;
+	std::vector<float> m_columnPotentials;
+	std::vector<float> m_minSlack;
+	std::vector<int> m_columnRows;
+	std::vector<int> m_previousColumns;
+	std::vector<char> m_usedColumns;
+	std::vector<int> m_result;
+
+	float getCost(int worker, int slot) const;
+
+public:
+
+	void clear();
+	// The depot distance is the length of a mining trip, far patches take a bit longer to mine from at the same distance
+	void addPatch(const CCPosition & position, float depotDistance, bool farPatch, int freeSlots);
+	// currentPatch is the patch the worker already mines from, if any, keeping it avoids useless reassignments
+	void addWorker(const CCPosition & position, int currentPatch = -1);
+	// Returns the patch assigned to each worker, in the order they were added, or -1 for the workers left without a slot
+	const std::vector<int> & solve();
+};
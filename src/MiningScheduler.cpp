@@ -0,0 +1,169 @@
+#include "MiningScheduler.h"
+#include "CCBot.h"
+#include "Util.h"
+
+namespace
+{
+	const float WORKER_SPEED_PER_FRAME = 2.8125f / 16.f;	// always the same for workers
+	// Distances from the point where the worker stops (beyond gatherDistance or dropDistance) between which the command is useful.
+	// Issued earlier, the worker stops at the move point before reaching the target, issued later, the worker already slowed down.
+	const float MINERAL_COMMAND_MIN_DISTANCE = 0.7f;
+	const float MINERAL_COMMAND_MAX_DISTANCE = 1.2f;
+	const float DEPOT_COMMAND_MIN_DISTANCE = 0.5f;
+	const float DEPOT_COMMAND_MAX_DISTANCE = 2.f;
+	// Initial model, close to an average patch until the first trips are observed
+	const float DEFAULT_GATHER_DISTANCE = 1.3f;
+	const float DEFAULT_DROP_DISTANCE = 3.f;
+	const float DEFAULT_GATHER_TRIP_FRAMES = 80.f;
+	const float DEFAULT_RETURN_TRIP_FRAMES = 20.f;
+	const float MODEL_LEARNING_RATE = 0.2f;
+	const uint32_t CARGO_CHECK_MARGIN = 6;		// the cargo is checked a few frames before the model expects it to change
+	const uint32_t CARGO_CHECK_INTERVAL = 2;
+}
+
+MiningScheduler::MiningScheduler(CCBot & bot)
+	: m_bot(bot)
+{
+}
+
+MiningScheduler::PatchModel & MiningScheduler::getPatchModel(const Unit & mineral)
+{
+	auto it = m_patchModels.find(mineral.getUnitPtr());
+	if (it == m_patchModels.end())
+	{
+		PatchModel model;
+		model.gatherDistance = DEFAULT_GATHER_DISTANCE;
+		model.dropDistance = DEFAULT_DROP_DISTANCE;
+		model.gatherTripFrames = DEFAULT_GATHER_TRIP_FRAMES;
+		model.returnTripFrames = DEFAULT_RETURN_TRIP_FRAMES;
+		it = m_patchModels.emplace(mineral.getUnitPtr(), model).first;
+	}
+	return it->second;
+}
+
+void MiningScheduler::track(const Unit & worker, const Unit & mineral, const Unit & depot)
+{
+	auto it = m_workers.find(worker.getUnitPtr());
+	if (it != m_workers.end() && it->second.mineral == mineral && it->second.depot == depot)
+		return;
+
+	MiningWorker miningWorker;
+	miningWorker.worker = worker;
+	miningWorker.mineral = mineral;
+	miningWorker.depot = depot;
+	miningWorker.carrying = worker.isReturningCargo();
+	miningWorker.commandIssued = false;
+	miningWorker.tripStartObserved = false;
+	miningWorker.polling = false;
+	miningWorker.tripStartLoop = m_bot.GetGameLoop();
+	miningWorker.generation = m_nextGeneration++;
+	m_workers[worker.getUnitPtr()] = miningWorker;
+	schedule(miningWorker, miningWorker.tripStartLoop);
+}
+
+void MiningScheduler::schedule(const MiningWorker & miningWorker, uint32_t loop)
+{
+	m_events.push({ loop, miningWorker.worker.getUnitPtr(), miningWorker.generation });
+}
+
+void MiningScheduler::onFrame()
+{
+	const uint32_t loop = m_bot.GetGameLoop();
+	if (m_lastLoop > 0 && loop > m_lastLoop)
+		m_stepLoops += (float(loop - m_lastLoop) - m_stepLoops) * MODEL_LEARNING_RATE;
+	m_lastLoop = loop;
+
+	while (!m_events.empty() && m_events.top().loop <= loop)
+	{
+		const MiningEvent event = m_events.top();
+		m_events.pop();
+
+		auto it = m_workers.find(event.worker);
+		if (it == m_workers.end() || it->second.generation != event.generation)
+			continue;	// the worker changed of mineral or depot since the event was scheduled
+
+		if (!handleEvent(it->second, loop))
+			m_workers.erase(it);
+	}
+}
+
+void MiningScheduler::learnTrip(MiningWorker & miningWorker, uint32_t loop)
+{
+	auto & model = getPatchModel(miningWorker.mineral);
+	if (miningWorker.tripStartObserved)
+	{
+		// An early check or a late one is still an upper bound of the trip, which brings the next checks earlier until they are in time
+		float & tripFrames = miningWorker.carrying ? model.gatherTripFrames : model.returnTripFrames;
+		tripFrames += (float(loop - miningWorker.tripStartLoop) - tripFrames) * MODEL_LEARNING_RATE;
+	}
+	// The worker is where the cargo changed only if it was checked often enough
+	if (miningWorker.polling)
+	{
+		if (miningWorker.carrying)
+			model.gatherDistance += (Util::Dist(miningWorker.worker, miningWorker.mineral) - model.gatherDistance) * MODEL_LEARNING_RATE;
+		else
+			model.dropDistance += (Util::Dist(miningWorker.worker, miningWorker.depot) - model.dropDistance) * MODEL_LEARNING_RATE;
+		++model.samples;
+	}
+	miningWorker.tripStartLoop = loop;
+	miningWorker.tripStartObserved = true;
+	miningWorker.commandIssued = false;
+	miningWorker.polling = false;
+}
+
+bool MiningScheduler::handleEvent(MiningWorker & miningWorker, uint32_t loop)
+{
+	const Unit & worker = miningWorker.worker;
+	if (!worker.isValid() || !worker.isAlive() || !miningWorker.mineral.isValid() || !miningWorker.mineral.isAlive() || !miningWorker.depot.isValid() || !miningWorker.depot.isAlive())
+		return false;
+	if (m_bot.Workers().getWorkerData().getWorkerJob(worker) != WorkerJobs::Minerals)
+		return false;
+
+	const bool carrying = worker.isReturningCargo();
+	if (carrying != miningWorker.carrying)
+	{
+		miningWorker.carrying = carrying;
+		learnTrip(miningWorker, loop);
+	}
+
+	const auto & model = getPatchModel(miningWorker.mineral);
+	const Unit & target = carrying ? miningWorker.depot : miningWorker.mineral;
+	const float stopDistance = carrying ? model.dropDistance : model.gatherDistance;
+	if (!miningWorker.commandIssued)
+	{
+		const float distance = Util::Dist(worker, target);
+		const float commandDistance = stopDistance + (carrying ? DEPOT_COMMAND_MAX_DISTANCE : MINERAL_COMMAND_MAX_DISTANCE);
+		// The command is issued at the step before the worker enters the window, so it is applied when the worker gets there
+		const float framesToCommand = (distance - commandDistance) / WORKER_SPEED_PER_FRAME - m_stepLoops;
+		if (framesToCommand >= 1.f)
+		{
+			schedule(miningWorker, loop + uint32_t(framesToCommand));
+			return true;
+		}
+
+		const auto & orders = worker.getUnitPtr()->orders;
+		const bool harvesting = !orders.empty() && orders.size() < 2 && (orders[0].ability_id == sc2::ABILITY_ID::HARVEST_GATHER || orders[0].ability_id == sc2::ABILITY_ID::HARVEST_RETURN);
+		if (harvesting && distance > stopDistance + (carrying ? DEPOT_COMMAND_MIN_DISTANCE : MINERAL_COMMAND_MIN_DISTANCE))
+		{
+			worker.move(target.getPosition() + Util::Normalized(worker.getPosition() - target.getPosition()) * stopDistance);
+			worker.shiftRightClick(target);
+			m_commandCount += 2;
+		}
+		// Otherwise the window is missed, the worker finishes this half of the trip by itself
+		miningWorker.commandIssued = true;
+	}
+
+	// Wait for the cargo to change
+	const float tripFrames = carrying ? model.returnTripFrames : model.gatherTripFrames;
+	const uint32_t expectedLoop = miningWorker.tripStartLoop + uint32_t(std::max(0.f, tripFrames - CARGO_CHECK_MARGIN));
+	if (expectedLoop > loop)
+	{
+		schedule(miningWorker, expectedLoop);
+	}
+	else
+	{
+		miningWorker.polling = true;
+		schedule(miningWorker, loop + std::max(CARGO_CHECK_INTERVAL, uint32_t(m_stepLoops)));
+	}
+	return true;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "Common.h"
+#include "Unit.h"
+#include <queue>
+#include <unordered_map>
+
+class CCBot;
+
+// Speed mining micro (move next to the mineral or the depot, then shift click it so the worker does not slow down) driven by events.
+// Each patch has a trip model learned from the workers mining it: the distance at which they pick up their cargo, the distance
+// from the depot at which they drop it and the duration of both halves of the trip. The model predicts the game loop at which a
+// worker reaches the point where the command must be issued and the loop at which its cargo changes, so a worker is only looked
+// at when it needs a command instead of every frame. In realtime, the commands are issued earlier by the average step length.
+class MiningScheduler
+{
+	struct PatchModel
+	{
+		float gatherDistance;		// from the center of the mineral when the cargo is picked up
+		float dropDistance;			// from the center of the depot when the cargo is dropped
+		float gatherTripFrames;		// from the drop of the cargo to the next pickup, walking and mining
+		float returnTripFrames;		// from the pickup of the cargo to its drop
+		int samples = 0;
+	};
+
+	struct MiningWorker
+	{
+		Unit worker;
+		Unit mineral;
+		Unit depot;
+		bool carrying;
+		bool commandIssued;			// the speed mining command of the current half of the trip was issued (or its window was missed)
+		bool tripStartObserved;		// the current half of the trip started with an observed cargo change
+		bool polling;				// the cargo change is late compared to the model, so the worker is checked every few frames
+		uint32_t tripStartLoop;
+		int generation;
+	};
+
+	struct MiningEvent
+	{
+		uint32_t loop;
+		const sc2::Unit * worker;
+		int generation;
+
+		bool operator>(const MiningEvent & rhs) const { return loop > rhs.loop; }
+	};
+
+	CCBot & m_bot;
+	std::unordered_map<const sc2::Unit *, PatchModel> m_patchModels;
+	std::unordered_map<const sc2::Unit *, MiningWorker> m_workers;
+	std::priority_queue<MiningEvent, std::vector<MiningEvent>, std::greater<MiningEvent>> m_events;
+	float m_stepLoops = 1.f;		// average number of game loops between two steps of the bot, more than 1 in realtime
+	uint32_t m_lastLoop = 0;
+	int m_nextGeneration = 0;
+	int m_commandCount = 0;
+
+	PatchModel & getPatchModel(const Unit & mineral);
+	void schedule(const MiningWorker & miningWorker, uint32_t loop);
+	bool handleEvent(MiningWorker & miningWorker, uint32_t loop);
+	void learnTrip(MiningWorker & miningWorker, uint32_t loop);
+
+public:
+
+	MiningScheduler(CCBot & bot);
+
+	// Called for the mineral workers with a valid depot, starts following the worker or updates its mineral and depot
+	void track(const Unit & worker, const Unit & mineral, const Unit & depot);
+	// Handles the events due at the current game loop
+	void onFrame();
+
+	size_t getTrackedWorkerCount() const { return m_workers.size(); }
+	// Number of speed mining commands issued since the start of the game
+	int getCommandCount() const { return m_commandCount; }
+};
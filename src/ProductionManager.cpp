@@ -7,6 +7,8 @@ const int MIN_VIKING_COUNT = 2;
 ProductionManager::ProductionManager(CCBot & bot)
     : m_bot             (bot)
     , m_queue           (bot)
+	, m_buildOrderOptimizer(bot)
+	, m_resourceForecast(bot)
 	, m_initialBuildOrderFinished(false)
 {
 
@@ -47,6 +49,9 @@ void ProductionManager::onStart()
 	supplyProviderType = MetaType(supplyProvider, m_bot);
 
 	workerMetatype = MetaType(Util::GetWorkerType(), m_bot);
+
+	if (m_bot.Config().OptimizeBuildOrder)
+		m_buildOrderOptimizer.onStart();
 	
 	switch (m_bot.GetSelfRace())
 	{
@@ -175,16 +180,19 @@ void ProductionManager::onFrame(bool executeMacro)
 {
 	if (executeMacro)
 	{
-		m_bot.StartProfiling("0.10.2.1    lowPriorityChecks");
+		PROFILE_BEGIN("updateResourceForecast");
+		m_resourceForecast.update();
+		PROFILE_END("updateResourceForecast");
+		PROFILE_BEGIN("lowPriorityChecks");
 		lowPriorityChecks();
 		validateUpgradesProgress();
-		m_bot.StopProfiling("0.10.2.1    lowPriorityChecks");
-		m_bot.StartProfiling("0.10.2.2    manageBuildOrderQueue");
+		PROFILE_END("lowPriorityChecks");
+		PROFILE_BEGIN("manageBuildOrderQueue");
 		manageBuildOrderQueue();
-		m_bot.StopProfiling("0.10.2.2    manageBuildOrderQueue");
-		/*m_bot.StartProfiling("3.0 QueueDeadBuildings");
+		PROFILE_END("manageBuildOrderQueue");
+		/*PROFILE_BEGIN("QueueDeadBuildings");
 		QueueDeadBuildings();
-		m_bot.StopProfiling("3.0 QueueDeadBuildings");*/
+		PROFILE_END("QueueDeadBuildings");*/
 
 		// TODO: if nothing is currently building, get a new goal from the strategy manager
 		// TODO: triggers for game things like cloaked units etc
@@ -212,20 +220,28 @@ void ProductionManager::manageBuildOrderQueue()
 		m_queue.clearAll();
 	}
 
-	m_bot.StartProfiling("0.10.2.2.1     putImportantBuildOrderItemsInQueue");
+	PROFILE_BEGIN("putImportantBuildOrderItemsInQueue");
 	if(m_initialBuildOrderFinished && m_bot.Config().AutoCompleteBuildOrder)
     {
 		putImportantBuildOrderItemsInQueue();
     }
-	m_bot.StopProfiling("0.10.2.2.1     putImportantBuildOrderItemsInQueue");
+	PROFILE_END("putImportantBuildOrderItemsInQueue");
+
+	PROFILE_BEGIN("applyOptimizedBuildOrder");
+	if (m_initialBuildOrderFinished && m_bot.Config().OptimizeBuildOrder)
+	{
+		applyOptimizedBuildOrder();
+	}
+	PROFILE_END("applyOptimizedBuildOrder");
 
 	if (m_queue.isEmpty())
 		return;
 
-	m_bot.StartProfiling("0.10.2.2.2     checkQueue");
+	PROFILE_BEGIN("checkQueue");
     // the current item to be used
-    MM::BuildOrderItem currentItem = m_queue.getHighestPriorityItem();
-	int highestPriority = currentItem.priority;
+    // the items are used in place, the queue keeps them at the same address until they are removed
+    const MM::BuildOrderItem * currentItem = &m_queue.getHighestPriorityItem();
+	int highestPriority = currentItem->priority;
 	int additionalReservedMineral = 0;
 	int additionalReservedGas = 0;
 	bool isSupplyCap = false;
@@ -234,53 +250,57 @@ void ProductionManager::manageBuildOrderQueue()
     while (!m_queue.isEmpty())
     {
 #ifdef NO_BUILDING
-		if (currentItem.type.isBuilding())
+		if (currentItem->type.isBuilding())
 		{
 			m_queue.removeCurrentHighestPriorityItem();
+			if (!m_queue.canSkipItem())
+				break;
+			m_queue.skipItem();
+			currentItem = &m_queue.getNextHighestPriorityItem();
 			continue;
 		}
 #endif
 
-		if (!ShouldSkipQueueItem(currentItem))	// Checking the initial BO first makes it so that in realtime we start the refinery before the barracks...
+		if (!ShouldSkipQueueItem(*currentItem))	// Checking the initial BO first makes it so that in realtime we start the refinery before the barracks...
 		{
 			//check if we have the prerequirements.
-			if (!hasRequired(currentItem.type, true) || !hasProducer(currentItem.type, true))
+			if (!hasRequired(currentItem->type, true) || !hasProducer(currentItem->type, true))
 			{
-				m_bot.StartProfiling("0.10.2.2.2.1      fixBuildOrderDeadlock");
-				fixBuildOrderDeadlock(currentItem);
-				//currentItem = m_queue.getHighestPriorityItem();
-				m_bot.StopProfiling("0.10.2.2.2.1      fixBuildOrderDeadlock");
+				PROFILE_BEGIN("fixBuildOrderDeadlock");
+				fixBuildOrderDeadlock(*currentItem);
+				//currentItem = &m_queue.getHighestPriorityItem();
+				PROFILE_END("fixBuildOrderDeadlock");
 			}
 			else
 			{
 				const auto barracksCount = m_bot.UnitInfo().getUnitTypeCount(Players::Self, MetaTypeEnum::Barracks.getUnitType(), false, true);
 				const auto factoryCount = m_bot.UnitInfo().getUnitTypeCount(Players::Self, MetaTypeEnum::Factory.getUnitType(), true, true);
 				// Proxy buildings
-				const bool proxyBarracks = currentItem.type == MetaTypeEnum::Barracks && m_bot.Strategy().isProxyStartingStrategy() && barracksCount < 2 && (m_bot.Strategy().getStartingStrategy() != PROXY_MARAUDERS || barracksCount > 0);
-				const bool proxyFactory = currentItem.type == MetaTypeEnum::Factory && m_bot.Strategy().isProxyFactoryStartingStrategy() && factoryCount == 0;
+				const bool proxyBarracks = currentItem->type == MetaTypeEnum::Barracks && m_bot.Strategy().isProxyStartingStrategy() && barracksCount < 2 && (m_bot.Strategy().getStartingStrategy() != PROXY_MARAUDERS || barracksCount > 0);
+				const bool proxyFactory = currentItem->type == MetaTypeEnum::Factory && m_bot.Strategy().isProxyFactoryStartingStrategy() && factoryCount == 0;
 				if (m_bot.GetCurrentFrame() < 4032 /* 3 min */ && (proxyBarracks || proxyFactory))
 				{
 					const auto proxyLocation = Util::GetPosition(m_bot.Buildings().getProxyLocation());
-					Unit producer = getProducer(currentItem.type, false, proxyLocation, true, true);
-					Building b(currentItem.type.getUnitType(), proxyLocation);
+					Unit producer = getProducer(currentItem->type, false, proxyLocation, true, true);
+					Building b(currentItem->type.getUnitType(), proxyLocation);
 					b.finalPosition = proxyLocation;
 					if (canMakeAtArrival(b, producer, additionalReservedMineral, additionalReservedGas))
 					{
 						const bool includeAddonTiles = proxyBarracks;
-						if (create(producer, currentItem, proxyLocation, false, false, true, includeAddonTiles, true, true))
+						if (create(producer, *currentItem, proxyLocation, false, false, true, includeAddonTiles, true, true))
 						{
 							m_queue.removeCurrentHighestPriorityItem();
 							break;
 						}
 					}
 				}
-				else if (currentlyHasRequirement(currentItem.type))
+				else if (currentlyHasRequirement(currentItem->type))
 				{
 					//Check if we already have an idle production building of that type
 					bool idleProductionBuilding = false;
 #ifndef NO_UNITS
-					auto unitTypeID = currentItem.type.getUnitType().getAPIUnitType();
-					if (currentItem.type.isBuilding() && (unitTypeID == sc2::UNIT_TYPEID::TERRAN_ARMORY || Util::Contains(unitTypeID, getProductionBuildingTypes())))
+					auto unitTypeID = currentItem->type.getUnitType().getAPIUnitType();
+					if (currentItem->type.isBuilding() && (unitTypeID == sc2::UNIT_TYPEID::TERRAN_ARMORY || Util::Contains(unitTypeID, getProductionBuildingTypes())))
 					{
 						bool laxIdleRules = unitTypeID != sc2::UNIT_TYPEID::TERRAN_BARRACKS;
 						auto idleTypes = getIdleImportantProductionBuildingTypes(laxIdleRules, laxIdleRules);
@@ -295,78 +315,78 @@ void ProductionManager::manageBuildOrderQueue()
 
 					if (!idleProductionBuilding)
 					{
-						auto data = m_bot.Data(currentItem.type);
+						auto data = m_bot.Data(currentItem->type);
 						// if we can make the current item
-						m_bot.StartProfiling("0.10.2.2.2.2      tryingToBuild");
+						PROFILE_BEGIN("tryingToBuild");
 						bool needsCancellation = false;//Required because the morph/addon abilities are not available while training/producing.
 						bool isLastSupplyDepotOfEarlyWall = m_bot.Strategy().shouldFinishWallEarly() &&
-							currentItem.type == MetaTypeEnum::SupplyDepot &&
+							currentItem->type == MetaTypeEnum::SupplyDepot &&
 							m_bot.UnitInfo().getUnitTypeCount(Players::Self, MetaTypeEnum::SupplyDepot.getUnitType(), false, true) == 1;
 						Unit producer;
-						if (meetsReservedResources(currentItem.type, additionalReservedMineral, additionalReservedGas))//Get the producer if we have enough resources
+						if (meetsReservedResources(currentItem->type, additionalReservedMineral, additionalReservedGas))//Get the producer if we have enough resources
 						{
-							producer = getProducer(currentItem.type);
+							producer = getProducer(currentItem->type);
 						}
 						else//Try to get a producer that would have enough resources if we cancel what it is currently producing.
 						{
 							bool startedBarracks = m_bot.UnitInfo().getUnitTypeCount(Players::Self, MetaTypeEnum::Barracks.getUnitType(), false, true, true) == 1;
 							// Cancel any unit or building only when we need to finish our wall asap
-							producer = meetsReservedResourcesWithCancelUnit(currentItem.type, additionalReservedMineral, additionalReservedGas, isLastSupplyDepotOfEarlyWall && startedBarracks);
+							producer = meetsReservedResourcesWithCancelUnit(currentItem->type, additionalReservedMineral, additionalReservedGas, isLastSupplyDepotOfEarlyWall && startedBarracks);
 							needsCancellation = true;
 						}
 						if (producer.isValid())//If we found a producer, lets create it.
 						{
-							m_bot.StartProfiling("0.10.2.2.2.2.1      Build without premovement");
+							PROFILE_BEGIN("Build without premovement");
 							// build supply if we need some (SupplyBlock)
-							if (m_bot.Data(currentItem.type.getUnitType()).supplyCost > m_bot.GetMaxSupply() - m_bot.GetCurrentSupply())
+							if (m_bot.Data(currentItem->type.getUnitType()).supplyCost > m_bot.GetMaxSupply() - m_bot.GetCurrentSupply())
 							{
-								if (m_bot.GetMaxSupply() < 200 && m_bot.Data(currentItem.type.getUnitType()).supplyCost > m_bot.GetMaxSupply() - m_bot.GetCurrentSupply())
+								if (m_bot.GetMaxSupply() < 200 && m_bot.Data(currentItem->type.getUnitType()).supplyCost > m_bot.GetMaxSupply() - m_bot.GetCurrentSupply())
 								{
 									supplyBlockedFrames++;
 									Util::Log(__FUNCTION__, "Supply blocked | 0x00000007", m_bot);
 								}
 							}
-							m_bot.StartProfiling("0.10.2.2.2.2.1.1      canMakeNow");
-							const auto canProducerMakeItem = canMakeNow(producer, currentItem.type);
-							m_bot.StopProfiling("0.10.2.2.2.2.1.1      canMakeNow");
+							PROFILE_BEGIN("canMakeNow");
+							const auto canProducerMakeItem = canMakeNow(producer, currentItem->type);
+							PROFILE_END("canMakeNow");
 							if (needsCancellation || canProducerMakeItem)
 							{
 								// create it and remove it from the _queue
-								m_bot.StartProfiling("0.10.2.2.2.2.1.2      create");
-								const auto producerCreatedItem = create(producer, currentItem, m_bot.GetBuildingArea(currentItem.type));
-								m_bot.StopProfiling("0.10.2.2.2.2.1.2      create");
+								PROFILE_BEGIN("create");
+								const auto producerCreatedItem = create(producer, *currentItem, m_bot.GetBuildingArea(currentItem->type));
+								PROFILE_END("create");
 								if (producerCreatedItem)
 								{
 									m_queue.removeCurrentHighestPriorityItem();
 
 									// don't actually loop around in here
-									m_bot.StopProfiling("0.10.2.2.2.2.1      Build without premovement");
-									m_bot.StopProfiling("0.10.2.2.2.2      tryingToBuild");
+									PROFILE_END("Build without premovement");
+									PROFILE_END("tryingToBuild");
 									break;
 								}
 								else if (!m_initialBuildOrderFinished)
 								{
-									Util::DebugLog(__FUNCTION__, "Failed to place " + currentItem.type.getName() + " during initial build order. Skipping.", m_bot);
+									Util::DebugLog(__FUNCTION__, "Failed to place " + currentItem->type.getName() + " during initial build order. Skipping.", m_bot);
 									m_queue.removeCurrentHighestPriorityItem();
 								}
 							}
-							m_bot.StopProfiling("0.10.2.2.2.2.1      Build without premovement");
+							PROFILE_END("Build without premovement");
 						}
 						else if (data.isBuilding
 							&& !data.isAddon
-							&& !currentItem.type.getUnitType().isMorphedBuilding()
+							&& !currentItem->type.getUnitType().isMorphedBuilding()
 							&& !data.isResourceDepot	//If its a resource depot, we don't pre-move
 							&& !isLastSupplyDepotOfEarlyWall)
 						{
 							// is a building (doesn't include addons, because no travel time) and we can make it soon (canMakeSoon)
 
-							m_bot.StartProfiling("0.10.2.2.2.2.2      Build with premovement");
-							Building b(currentItem.type.getUnitType(), m_bot.GetBuildingArea(currentItem.type));
+							PROFILE_BEGIN("Build with premovement");
+							Building b(currentItem->type.getUnitType(), m_bot.GetBuildingArea(currentItem->type));
 							//Get building location
 
-							m_bot.StartProfiling("0.10.2.2.2.2.2.1       getNextBuildingLocation");
+							PROFILE_BEGIN("getNextBuildingLocation");
 							const CCTilePosition targetLocation = m_bot.Buildings().getNextBuildingLocation(b, true, true);
-							m_bot.StopProfiling("0.10.2.2.2.2.2.1       getNextBuildingLocation");
+							PROFILE_END("getNextBuildingLocation");
 							if (targetLocation != CCTilePosition())
 							{
 								Unit worker = m_bot.Workers().getClosestAvailableWorkerTo(Util::GetPosition(targetLocation));
@@ -383,23 +403,23 @@ void ProductionManager::manageBuildOrderQueue()
 										}
 
 										// don't actually loop around in here
-										m_bot.StopProfiling("0.10.2.2.2.2.2      Build with premovement");
-										m_bot.StopProfiling("0.10.2.2.2.2      tryingToBuild");
+										PROFILE_END("Build with premovement");
+										PROFILE_END("tryingToBuild");
 										break;
 									}
 								}
 							}
 							else
 							{
-								if (currentItem.type.getUnitType().getAPIUnitType() != Util::GetRefineryType().getAPIUnitType() &&
-									currentItem.type.getUnitType().getAPIUnitType() != Util::GetRichRefineryType().getAPIUnitType())//Supresses the refinery related errors
+								if (currentItem->type.getUnitType().getAPIUnitType() != Util::GetRefineryType().getAPIUnitType() &&
+									currentItem->type.getUnitType().getAPIUnitType() != Util::GetRichRefineryType().getAPIUnitType())//Supresses the refinery related errors
 								{
-									Util::DisplayError("Invalid build location for " + currentItem.type.getName(), "0x0000002", m_bot);
+									Util::DisplayError("Invalid build location for " + currentItem->type.getName(), "0x0000002", m_bot);
 								}
 							}
-							m_bot.StopProfiling("0.10.2.2.2.2.2      Build with premovement");
+							PROFILE_END("Build with premovement");
 						}
-						m_bot.StopProfiling("0.10.2.2.2.2      tryingToBuild");
+						PROFILE_END("tryingToBuild");
 					}
 				}
 			}
@@ -413,9 +433,9 @@ void ProductionManager::manageBuildOrderQueue()
         m_queue.skipItem();
 
         // and get the next one
-        currentItem = m_queue.getNextHighestPriorityItem();
+        currentItem = &m_queue.getNextHighestPriorityItem();
     }
-	m_bot.StopProfiling("0.10.2.2.2     checkQueue");
+	PROFILE_END("checkQueue");
 }
 
 bool ProductionManager::ShouldSkipQueueItem(const MM::BuildOrderItem & currentItem)
@@ -718,6 +738,34 @@ bool ProductionManager::ShouldSkipQueueItem(const MM::BuildOrderItem & currentIt
 	return shouldSkip;
 }
 
+void ProductionManager::applyOptimizedBuildOrder()
+{
+	std::vector<MetaType> suggestion;
+	if (m_buildOrderOptimizer.getSuggestion(suggestion))
+	{
+		// The optimized order can start with implicit steps we did not queue (workers, supply, requirements), we only take the first one
+		for (const auto & type : suggestion)
+		{
+			if (m_queue.contains(type))
+				break;
+			if (hasRequired(type, true) && hasProducer(type, true))
+			{
+				m_queue.queueAsHighestPriority(type, false);
+				break;
+			}
+		}
+		m_queue.reorder(suggestion);
+	}
+
+	// The queue snapshot is taken after the suggestion is applied so the next optimization starts from it
+	std::vector<MetaType> queue;
+	for (const auto & item : m_queue)
+	{
+		queue.push_back(item.type);
+	}
+	m_buildOrderOptimizer.update(queue);
+}
+
 void ProductionManager::putImportantBuildOrderItemsInQueue()
 {
 #ifdef NO_PRODUCTION
@@ -739,8 +787,8 @@ void ProductionManager::putImportantBuildOrderItemsInQueue()
 	const auto startingStrategy = m_bot.Strategy().getStartingStrategy();
 	const auto earlyRushed = m_bot.Strategy().isEarlyRushed();
 
-	// build supply if we need some
-	const int supplyWithAdditionalSupplyDepot = m_bot.GetMaxSupply() + m_bot.Buildings().countBeingBuilt(supplyProvider) * 8;
+	// build supply if we need some (the forecast includes the supply providers under construction)
+	const int supplyWithAdditionalSupplyDepot = m_resourceForecast.getFutureMaxSupply() + m_bot.Buildings().countBoughtButNotBeingBuilt(supplyProvider.getAPIUnitType()) * 8;
 	if(m_bot.GetCurrentSupply() + getSupplyNeedsFromProductionBuildings() + finishedBaseCount > supplyWithAdditionalSupplyDepot
 		&& !m_queue.contains(supplyProviderType)
 		&& supplyWithAdditionalSupplyDepot < 200
@@ -1672,7 +1720,7 @@ void ProductionManager::QueueDeadBuildings()
 	m_bot.Buildings().updatePreviousBaseBuildings();
 }
 
-void ProductionManager::fixBuildOrderDeadlock(MM::BuildOrderItem & item)
+void ProductionManager::fixBuildOrderDeadlock(const MM::BuildOrderItem & item)
 {
 	const TypeData& typeData = m_bot.Data(item.type);
 
@@ -1690,7 +1738,7 @@ void ProductionManager::fixBuildOrderDeadlock(MM::BuildOrderItem & item)
 				std::stringstream ss;
 				ss << item.type.getName() << " needs a requirement: " << required.getName();
 				Util::Log(__FUNCTION__, ss.str(), m_bot);
-				MM::BuildOrderItem requiredItem = m_queue.queueItem(MM::BuildOrderItem(MetaType(required, m_bot), 0, item.blocking));
+				const MM::BuildOrderItem & requiredItem = m_queue.queueItem(MM::BuildOrderItem(MetaType(required, m_bot), 0, item.blocking));
 				fixBuildOrderDeadlock(requiredItem);
 				break;
 			}
@@ -1703,7 +1751,7 @@ void ProductionManager::fixBuildOrderDeadlock(MM::BuildOrderItem & item)
     if (!hasProducer(item.type, true) && !m_queue.contains(builder))
     {
 		std::cout << item.type.getName() << " needs a producer: " << builder.getName() << "\n";
-		MM::BuildOrderItem producerItem = m_queue.queueItem(MM::BuildOrderItem(builder, 0, item.blocking));
+		const MM::BuildOrderItem & producerItem = m_queue.queueItem(MM::BuildOrderItem(builder, 0, item.blocking));
         fixBuildOrderDeadlock(producerItem);
     }
 
@@ -2628,7 +2676,7 @@ void ProductionManager::createSkipQueue(MetaType type, CCPosition location)
 
 // this function will check to see if all preconditions are met and then create a unit
 // Used to create unit/tech/buildings (when we have the ressources)
-bool ProductionManager::create(const Unit & producer, MM::BuildOrderItem & item, CCTilePosition desidredPosition, bool reserveResources, bool filterMovingWorker, bool canBePlacedElsewhere, bool includeAddonTiles, bool ignoreExtraBorder, bool forceSameHeight)
+bool ProductionManager::create(const Unit & producer, const MM::BuildOrderItem & item, CCTilePosition desidredPosition, bool reserveResources, bool filterMovingWorker, bool canBePlacedElsewhere, bool includeAddonTiles, bool ignoreExtraBorder, bool forceSameHeight)
 {
 	if (!producer.isValid())
 	{
@@ -2881,7 +2929,7 @@ bool ProductionManager::canMakeNow(const Unit & producer, const MetaType & type)
 int ProductionManager::getExtraMinerals()
 {
 	int extraMinerals = 0;
-	std::set<Unit> workers = m_bot.Workers().getWorkers();
+	const auto & workers = m_bot.Workers().getWorkers();
 	for (auto w : workers) {
 		if (m_bot.Workers().getWorkerData().getWorkerJob(w) == WorkerJobs::Minerals && m_bot.Workers().isReturningCargo(w))
 		{ 
@@ -2901,7 +2949,7 @@ int ProductionManager::getExtraMinerals()
 int ProductionManager::getExtraGas()
 {
 	int extraGas = 0;
-	std::set<Unit> workers = m_bot.Workers().getWorkers();
+	const auto & workers = m_bot.Workers().getWorkers();
 	for (auto w : workers) {
 		if (m_bot.Workers().getWorkerData().getWorkerJob(w) == WorkerJobs::Gas && m_bot.Workers().isReturningCargo(w))
 		{
@@ -3100,23 +3148,16 @@ bool ProductionManager::canMakeAtArrival(const Building & b, const Unit & worker
 		return false;
 	}
 
-	const float mineralRate = m_bot.Observation()->GetScore().score_details.collection_rate_minerals / 60.f / 16.f;
-	const float gasRate = m_bot.Observation()->GetScore().score_details.collection_rate_vespene / 60.f / 16.f;
+	// The travel is a lower bound from the distance maps of the bases and the income comes from the saturation of our bases
+	const int travelFrames = m_resourceForecast.getWorkerTravelFrames(worker.getPosition(), Util::GetPosition(b.finalPosition));
+	const float mineralGain = m_resourceForecast.getMineralsIn(travelFrames);
+	const float gasGain = m_resourceForecast.getGasIn(travelFrames);
 
-	if (mineralRate == 0 && gasRate == 0)
+	if (mineralGain == 0 && gasGain == 0)
 	{
 		return false;
 	}
 
-	//float distance = Util::PathFinding::FindOptimalPathDistance(worker.getUnitPtr(), Util::GetPosition(b.finalPosition), false, m_bot);
-	float distance = Util::Dist(worker.getPosition(), Util::GetPosition(b.finalPosition));
-	const float speed = 2.8125f;//Always the same for workers, Util::getSpeedOfUnit(worker.getUnitPtr(), m_bot);
-	const float speedPerFrame = speed / 16.f;
-
-	auto travelFrame = distance / speedPerFrame;
-	auto mineralGain = travelFrame * mineralRate;
-	auto gasGain = travelFrame * gasRate;
-
 	if (meetsReservedResourcesWithExtra(MetaType(b.type, m_bot), mineralGain, gasGain, additionalReservedMineral, additionalReservedGas))
 	{
 		return true;
@@ -3208,6 +3249,7 @@ void ProductionManager::drawProductionInformation()
 	ss << "Gas Worker Target:" << m_bot.Workers().getGasWorkersTarget() << "\n";
 	ss << "Mineral income:   " << m_bot.Observation()->GetScore().score_details.collection_rate_minerals << "\n";
 	ss << "Gas income:       " << m_bot.Observation()->GetScore().score_details.collection_rate_vespene << "\n";
+	ss << "Forecast (30s):   " << int(m_resourceForecast.getMineralsIn(672)) << " / " << int(m_resourceForecast.getGasIn(672)) << "\n";
 	if (draw)
 		m_bot.Map().drawTextScreen(0.75f, 0.05f, ss.str(), CCColor(255, 255, 0));
 	if (log)
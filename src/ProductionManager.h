@@ -5,6 +5,8 @@
 #include "BuildOrderQueue.h"
 #include "Unit.h"
 #include "Building.h"
+#include "BuildOrderOptimizer.h"
+#include "ResourceForecast.h"
 #include <list>
 
 class CCBot;
@@ -14,6 +16,8 @@ class ProductionManager
     CCBot &       m_bot;
 	uint32_t m_lastLowPriorityCheckFrame = 0;
     BuildOrderQueue m_queue;
+	BuildOrderOptimizer m_buildOrderOptimizer;
+	ResourceForecast m_resourceForecast;
 	bool m_initialBuildOrderFinished;
 	bool m_ccShouldBeInQueue = false;
 	Unit rampSupplyDepotWorker;
@@ -36,19 +40,20 @@ class ProductionManager
     Unit    getClosestUnitToPosition(const std::vector<Unit> & units, CCPosition closestTo) const;
     bool    canMakeNow(const Unit & producer, const MetaType & type);
     void    setBuildOrder(const MM::BuildOrder & buildOrder);
-    bool    create(const Unit & producer, MM::BuildOrderItem & item, CCTilePosition desidredPosition, bool reserveResources = true, bool filterMovingWorker = true, bool canBePlacedElsewhere = true, bool includeAddonTiles = true, bool ignoreExtraBorder = false, bool forceSameHeight = false);
+    bool    create(const Unit & producer, const MM::BuildOrderItem & item, CCTilePosition desidredPosition, bool reserveResources = true, bool filterMovingWorker = true, bool canBePlacedElsewhere = true, bool includeAddonTiles = true, bool ignoreExtraBorder = false, bool forceSameHeight = false);
 	bool    create(const Unit & producer, Building & b, bool filterMovingWorker = true);
 	bool	cancelNecessaryUnits(const MetaType & type);
 	std::vector<Unit> unitsToCancelForResources(const MetaType & type);
     void    manageBuildOrderQueue();
 	bool	ShouldSkipQueueItem(const MM::BuildOrderItem & currentItem);
 	void	putImportantBuildOrderItemsInQueue();
+	void	applyOptimizedBuildOrder();
 	bool	isImportantProductionBuildingIdle(bool underConstructionConsideredIdle, bool constructingAddonConsideredIdle);
 	std::vector<sc2::UNIT_TYPEID> getIdleImportantProductionBuildingTypes(bool underConstructionConsideredIdle, bool constructingAddonConsideredIdle);
 	bool	ProductionQueueContainsItemProduceableByUnit(const Unit & productionBuiding);
 	void	QueueDeadBuildings();
 
-	void	fixBuildOrderDeadlock(MM::BuildOrderItem & item);
+	void	fixBuildOrderDeadlock(const MM::BuildOrderItem & item);
 	void	lowPriorityChecks();
 	bool	currentlyHasRequirement(MetaType currentItem) const;
 	bool	hasRequiredUnit(const UnitType& unitType, bool checkInQueue) const;
@@ -84,6 +89,7 @@ public:
 	bool meetsReservedResourcesWithExtra(const MetaType & type, int additionalMineral, int additionalGas, int additionalReservedMineral, int additionalReservedGas);
 	Unit meetsReservedResourcesWithCancelUnit(const MetaType & type, int additionalReservedMineral, int additionalReservedGas, bool cancelAnything);
 	bool canMakeAtArrival(const Building & building, const Unit & worker, int additionalReservedMineral, int additionalReservedGas);
+	const ResourceForecast & getResourceForecast() const { return m_resourceForecast; }
 	std::vector<Unit> getUnitTrainingBuildings(CCRace race);
 	int getSupplyNeedsFromProductionBuildings() const;
 	void clearQueue();
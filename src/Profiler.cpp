@@ -0,0 +1,464 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define PROFILER_USE_TSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PROFILER_USE_TSC
+#endif
+
+namespace
+{
+	const int MAX_NODES = 2048;		// per thread, the probes seen after that are not recorded
+	const int MAX_DEPTH = 64;
+	const int MAX_COUNTERS = 1024;	// counters are indexed by their name id
+	const size_t TRACE_BUFFER_CAPACITY = 16384;	// events per thread, power of two
+	const int TRACE_WRITE_INTERVAL_MS = 50;
+
+	struct Node
+	{
+		int id;
+		int parent;
+		int firstChild = -1;
+		int nextSibling = -1;
+		std::atomic<long long> time;	// in ticks since the creation of the node, only written by the owner thread
+		std::atomic<int> calls;
+	};
+
+	struct OpenProbe
+	{
+		int id;
+		int node;
+		long long start;
+	};
+
+	struct TraceEvent
+	{
+		int id;
+		uint32_t loop;
+		int depth;				// -1 for a counter
+		long long start;
+		long long end;			// the value of a counter
+	};
+
+	struct ThreadProfile
+	{
+		Node nodes[MAX_NODES];
+		std::atomic<int> nodeCount;		// published after the node is initialized
+		int firstRoot = -1;
+		OpenProbe stack[MAX_DEPTH];
+		int depth = 0;
+		bool inUse = true;
+		int index;						// thread id in the trace
+
+		// Single producer single consumer queue of the trace events, allocated when the trace is started
+		std::atomic<TraceEvent *> traceEvents;
+		std::atomic<size_t> traceWritePosition;
+		std::atomic<size_t> traceReadPosition;
+
+		// Only used by the collector
+		std::vector<int> mergedNodes;
+		std::vector<long long> collectedTimes;
+		std::vector<int> collectedCalls;
+
+		ThreadProfile(int index) : nodeCount(0), index(index), traceEvents(nullptr), traceWritePosition(0), traceReadPosition(0) {}
+	};
+
+	struct MergedNode
+	{
+		int id;
+		std::vector<int> children;
+		long long frameTime = 0;
+		int frameCalls = 0;
+		long long history[Profiler::HISTORY_FRAMES] = {};
+		int historyCalls[Profiler::HISTORY_FRAMES] = {};
+		long long totalTime = 0;
+		int totalCalls = 0;
+	};
+
+	std::mutex registryMutex;				// for the names and the thread profiles, never taken by a probe after its first call
+	std::deque<std::string> names;			// references to the names stay valid
+	std::unordered_map<std::string, int> nameIds;
+	std::vector<ThreadProfile *> threadProfiles;	// released profiles are reused by the next threads, their counters keep going
+
+	std::vector<MergedNode> mergedNodes;
+	std::vector<int> mergedRoots;
+	std::unordered_map<long long, int> mergedNodeIndices;	// by parent merged node and probe id
+	int historyIndex = 0;
+	std::vector<Profiler::Entry> entries;
+
+	std::atomic<bool> tracing(false);
+	std::atomic<uint32_t> gameLoop(0);
+	std::atomic<long long> counters[MAX_COUNTERS];
+	std::atomic<bool> usedCounters[MAX_COUNTERS];
+	std::atomic<size_t> droppedTraceEvents(0);
+	std::thread * traceWriterThread = nullptr;
+	std::ofstream traceFile;
+	bool firstTraceEvent;
+	std::vector<std::string> traceNames;	// copy of the names used by the writer thread, so it does not hold the registry lock
+
+	long long ClockNanoseconds()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	// The time stamp counter is several times cheaper to read than the steady clock, its frequency is measured against the clock
+	long long Now()
+	{
+#ifdef PROFILER_USE_TSC
+		return static_cast<long long>(__rdtsc());
+#else
+		return ClockNanoseconds();
+#endif
+	}
+
+	const long long calibrationStartTicks = Now();
+	const long long calibrationStartNanoseconds = ClockNanoseconds();
+
+	double GetTicksPerMicrosecond()
+	{
+		const long long elapsedNanoseconds = ClockNanoseconds() - calibrationStartNanoseconds;
+		if (elapsedNanoseconds <= 0)
+			return 1000.0;
+		return 1000.0 * double(Now() - calibrationStartTicks) / double(elapsedNanoseconds);
+	}
+
+	ThreadProfile * AcquireThreadProfile()
+	{
+		std::lock_guard<std::mutex> lock(registryMutex);
+		for (auto profile : threadProfiles)
+		{
+			if (!profile->inUse)
+			{
+				profile->inUse = true;
+				profile->depth = 0;
+				return profile;
+			}
+		}
+		threadProfiles.push_back(new ThreadProfile(int(threadProfiles.size())));
+		if (tracing.load(std::memory_order_relaxed))
+			threadProfiles.back()->traceEvents.store(new TraceEvent[TRACE_BUFFER_CAPACITY], std::memory_order_release);
+		return threadProfiles.back();
+	}
+
+	// Gives the profile back when its thread exits, RangedManager starts new threads every frame
+	struct ThreadProfileHolder
+	{
+		ThreadProfile * profile = AcquireThreadProfile();
+
+		~ThreadProfileHolder()
+		{
+			std::lock_guard<std::mutex> lock(registryMutex);
+			profile->inUse = false;
+		}
+	};
+
+	thread_local ThreadProfile * threadProfile = nullptr;	// trivial, so reading it does not go through the thread_local initialization guard
+
+	ThreadProfile & GetThreadProfile()
+	{
+		if (!threadProfile)
+		{
+			thread_local ThreadProfileHolder holder;
+			threadProfile = holder.profile;
+		}
+		return *threadProfile;
+	}
+
+	int GetChildNode(ThreadProfile & profile, int parent, int id)
+	{
+		int & firstChild = parent < 0 ? profile.firstRoot : profile.nodes[parent].firstChild;
+		for (int child = firstChild; child >= 0; child = profile.nodes[child].nextSibling)
+		{
+			if (profile.nodes[child].id == id)
+				return child;
+		}
+
+		const int nodeCount = profile.nodeCount.load(std::memory_order_relaxed);
+		if (nodeCount >= MAX_NODES)
+			return -1;
+		Node & node = profile.nodes[nodeCount];
+		node.id = id;
+		node.parent = parent;
+		node.firstChild = -1;
+		node.nextSibling = firstChild;
+		node.time.store(0, std::memory_order_relaxed);
+		node.calls.store(0, std::memory_order_relaxed);
+		firstChild = nodeCount;
+		profile.nodeCount.store(nodeCount + 1, std::memory_order_release);
+		return nodeCount;
+	}
+
+	int GetMergedNode(int parent, int id)
+	{
+		const long long key = (static_cast<long long>(parent + 1) << 32) | static_cast<unsigned int>(id);
+		const auto it = mergedNodeIndices.find(key);
+		if (it != mergedNodeIndices.end())
+			return it->second;
+
+		const int index = int(mergedNodes.size());
+		mergedNodes.emplace_back();
+		mergedNodes.back().id = id;
+		(parent < 0 ? mergedRoots : mergedNodes[parent].children).push_back(index);
+		mergedNodeIndices[key] = index;
+		return index;
+	}
+
+	void PushTraceEvent(ThreadProfile & profile, const TraceEvent & event)
+	{
+		TraceEvent * events = profile.traceEvents.load(std::memory_order_acquire);
+		if (!events)
+			return;
+		const size_t writePosition = profile.traceWritePosition.load(std::memory_order_relaxed);
+		if (writePosition - profile.traceReadPosition.load(std::memory_order_acquire) >= TRACE_BUFFER_CAPACITY)
+		{
+			droppedTraceEvents.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		events[writePosition & (TRACE_BUFFER_CAPACITY - 1)] = event;
+		profile.traceWritePosition.store(writePosition + 1, std::memory_order_release);
+	}
+
+	void AppendEscaped(std::string & output, const std::string & str)
+	{
+		for (const char c : str)
+		{
+			if (c == '"' || c == '\\')
+				output += '\\';
+			output += c;
+		}
+	}
+
+	void WriteTraceEvents()
+	{
+		std::vector<ThreadProfile *> profiles;
+		{
+			std::lock_guard<std::mutex> lock(registryMutex);
+			profiles = threadProfiles;
+			for (size_t i = traceNames.size(); i < names.size(); ++i)
+				traceNames.push_back(names[i]);
+		}
+
+		const double ticksPerMicrosecond = GetTicksPerMicrosecond();
+		std::string batch;
+		char fields[256];
+		for (auto profile : profiles)
+		{
+			const TraceEvent * events = profile->traceEvents.load(std::memory_order_acquire);
+			if (!events)
+				continue;
+			const size_t writePosition = profile->traceWritePosition.load(std::memory_order_acquire);
+			size_t readPosition = profile->traceReadPosition.load(std::memory_order_relaxed);
+			for (; readPosition != writePosition; ++readPosition)
+			{
+				const TraceEvent & event = events[readPosition & (TRACE_BUFFER_CAPACITY - 1)];
+				batch += firstTraceEvent ? "\n" : ",\n";
+				firstTraceEvent = false;
+				batch += "{\"name\":\"";
+				AppendEscaped(batch, traceNames[event.id]);
+				const double timestamp = (event.start - calibrationStartTicks) / ticksPerMicrosecond;
+				if (event.depth < 0)
+					snprintf(fields, sizeof(fields), "\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"tid\":%d,\"args\":{\"value\":%lld}}", timestamp, profile->index, event.end);
+				else
+					snprintf(fields, sizeof(fields), "\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d,\"args\":{\"loop\":%u,\"depth\":%d}}",
+						timestamp, (event.end - event.start) / ticksPerMicrosecond, profile->index, event.loop, event.depth);
+				batch += fields;
+			}
+			profile->traceReadPosition.store(readPosition, std::memory_order_release);
+		}
+		if (!batch.empty())
+		{
+			traceFile.write(batch.data(), batch.size());
+			traceFile.flush();
+		}
+	}
+
+	void TraceWriterLoop()
+	{
+		while (tracing.load(std::memory_order_acquire))
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(TRACE_WRITE_INTERVAL_MS));
+			WriteTraceEvents();
+		}
+	}
+
+	void AddEntries(int mergedNode, int depth)
+	{
+		const auto & node = mergedNodes[mergedNode];
+		const long long maxFrameTime = *std::max_element(node.history, node.history + Profiler::HISTORY_FRAMES);
+		entries.push_back({ &names[node.id], depth, node.frameTime, node.frameCalls, node.totalTime / Profiler::HISTORY_FRAMES, maxFrameTime, node.totalCalls });
+		for (const int child : node.children)
+			AddEntries(child, depth + 1);
+	}
+}
+
+int Profiler::Intern(const char * name)
+{
+	std::lock_guard<std::mutex> lock(registryMutex);
+	const auto it = nameIds.find(name);
+	if (it != nameIds.end())
+		return it->second;
+	const int id = int(names.size());
+	names.push_back(name);
+	nameIds[name] = id;
+	return id;
+}
+
+void Profiler::Begin(int id)
+{
+	ThreadProfile & profile = GetThreadProfile();
+	if (profile.depth >= MAX_DEPTH)
+		return;
+	const int parent = profile.depth > 0 ? profile.stack[profile.depth - 1].node : -1;
+	// A probe under an unrecorded one is not recorded either
+	const int node = parent < 0 && profile.depth > 0 ? -1 : GetChildNode(profile, parent, id);
+	profile.stack[profile.depth++] = { id, node, Now() };
+}
+
+void Profiler::End(int id)
+{
+	ThreadProfile & profile = GetThreadProfile();
+	int depth = profile.depth;
+	while (depth > 0 && profile.stack[depth - 1].id != id)
+		--depth;
+	if (depth == 0)
+		return;
+
+	const long long now = Now();
+	for (int i = profile.depth - 1; i >= depth - 1; --i)
+	{
+		const OpenProbe & probe = profile.stack[i];
+		if (probe.node < 0)
+			continue;
+		Node & node = profile.nodes[probe.node];
+		// Single writer, the collector only reads
+		node.time.store(node.time.load(std::memory_order_relaxed) + now - probe.start, std::memory_order_relaxed);
+		node.calls.store(node.calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		if (tracing.load(std::memory_order_relaxed))
+			PushTraceEvent(profile, { probe.id, gameLoop.load(std::memory_order_relaxed), i, probe.start, now });
+	}
+	profile.depth = depth - 1;
+}
+
+const std::vector<Profiler::Entry> & Profiler::CollectFrame()
+{
+	historyIndex = (historyIndex + 1) % HISTORY_FRAMES;
+	for (auto & node : mergedNodes)
+	{
+		node.frameTime = 0;
+		node.frameCalls = 0;
+	}
+
+	if (tracing.load(std::memory_order_relaxed))
+	{
+		ThreadProfile & profile = GetThreadProfile();
+		const long long now = Now();
+		const uint32_t loop = gameLoop.load(std::memory_order_relaxed);
+		for (int id = 0; id < MAX_COUNTERS; ++id)
+		{
+			if (usedCounters[id].load(std::memory_order_relaxed))
+				PushTraceEvent(profile, { id, loop, -1, now, counters[id].exchange(0, std::memory_order_relaxed) });
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(registryMutex);
+	for (auto profile : threadProfiles)
+	{
+		const int nodeCount = profile->nodeCount.load(std::memory_order_acquire);
+		for (int i = int(profile->mergedNodes.size()); i < nodeCount; ++i)
+		{
+			const Node & node = profile->nodes[i];
+			// Parents are always created before their children
+			profile->mergedNodes.push_back(GetMergedNode(node.parent < 0 ? -1 : profile->mergedNodes[node.parent], node.id));
+			profile->collectedTimes.push_back(0);
+			profile->collectedCalls.push_back(0);
+		}
+		for (int i = 0; i < nodeCount; ++i)
+		{
+			const long long time = profile->nodes[i].time.load(std::memory_order_relaxed);
+			const int calls = profile->nodes[i].calls.load(std::memory_order_relaxed);
+			auto & mergedNode = mergedNodes[profile->mergedNodes[i]];
+			mergedNode.frameTime += time - profile->collectedTimes[i];
+			mergedNode.frameCalls += calls - profile->collectedCalls[i];
+			profile->collectedTimes[i] = time;
+			profile->collectedCalls[i] = calls;
+		}
+	}
+
+	entries.clear();
+	const double ticksPerMicrosecond = GetTicksPerMicrosecond();
+	for (auto & node : mergedNodes)
+	{
+		node.frameTime = static_cast<long long>(node.frameTime / ticksPerMicrosecond);
+		node.totalTime += node.frameTime - node.history[historyIndex];
+		node.totalCalls += node.frameCalls - node.historyCalls[historyIndex];
+		node.history[historyIndex] = node.frameTime;
+		node.historyCalls[historyIndex] = node.frameCalls;
+	}
+	for (const int root : mergedRoots)
+		AddEntries(root, 0);
+	return entries;
+}
+
+const std::vector<Profiler::Entry> & Profiler::LastFrame()
+{
+	return entries;
+}
+
+void Profiler::SetGameLoop(uint32_t loop)
+{
+	gameLoop.store(loop, std::memory_order_relaxed);
+}
+
+void Profiler::AddCount(int id, long long count)
+{
+	if (!tracing.load(std::memory_order_relaxed) || id >= MAX_COUNTERS)
+		return;
+	counters[id].fetch_add(count, std::memory_order_relaxed);
+	usedCounters[id].store(true, std::memory_order_relaxed);
+}
+
+void Profiler::StartTrace(const std::string & path)
+{
+	StopTrace();
+	traceFile.open(path);
+	if (!traceFile.is_open())
+		return;
+	// Array format, the closing bracket is optional so a trace cut by a crash still loads
+	traceFile << "[";
+	firstTraceEvent = true;
+	{
+		std::lock_guard<std::mutex> lock(registryMutex);
+		for (auto profile : threadProfiles)
+		{
+			if (!profile->traceEvents.load(std::memory_order_relaxed))
+				profile->traceEvents.store(new TraceEvent[TRACE_BUFFER_CAPACITY], std::memory_order_release);
+		}
+		tracing.store(true, std::memory_order_release);
+	}
+	traceWriterThread = new std::thread(TraceWriterLoop);
+}
+
+void Profiler::StopTrace()
+{
+	if (!traceWriterThread)
+		return;
+	tracing.store(false, std::memory_order_release);
+	traceWriterThread->join();
+	delete traceWriterThread;
+	traceWriterThread = nullptr;
+	WriteTraceEvents();
+	const size_t dropped = droppedTraceEvents.exchange(0, std::memory_order_relaxed);
+	traceFile << "\n]\n";
+	traceFile.close();
+	if (dropped > 0)
+		std::cout << dropped << " trace events dropped, the trace buffers were full" << std::endl;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Common.h"
+
+// Hierarchical profiler of the bot's code, usable from any thread.
+// A probe is identified by an id interned once per call site (the PROFILE_* macros keep it in a static), each thread records
+// its probes in its own tree of nodes (the parent of a probe is the probe open around it) with preallocated nodes and atomic
+// counters, so recording a probe neither allocates nor locks. Once per step, the game thread collects the time spent in each
+// node since the previous collection and merges the trees of all the threads.
+namespace Profiler
+{
+	const int HISTORY_FRAMES = 50;
+
+	struct Entry
+	{
+		const std::string * name;
+		int depth;					// 0 for the probes opened outside any other probe of their thread
+		long long frameTime;		// in microseconds, during the last collected frame
+		int frameCalls;
+		long long averageTime;		// per frame, over the last HISTORY_FRAMES frames
+		long long maxFrameTime;		// over the last HISTORY_FRAMES frames
+		int calls;					// over the last HISTORY_FRAMES frames
+	};
+
+	// Returns the id of a probe name, the same name always gets the same id
+	int		Intern(const char * name);
+	void	Begin(int id);
+	// Closes the innermost open probe with that id, the probes still open inside it (left by an early return) are closed too
+	void	End(int id);
+
+	// Called once per step from the game thread, returns every probe seen so far in depth first order
+	const std::vector<Entry> & CollectFrame();
+	// The entries returned by the last call to CollectFrame
+	const std::vector<Entry> & LastFrame();
+
+	// The trace records every probe with its thread, depth and game loop, and the counters once per frame, in the Chrome trace
+	// event format (chrome://tracing or ui.perfetto.dev). The events are written to the file by a background thread.
+	void	StartTrace(const std::string & path);
+	void	StopTrace();
+	void	SetGameLoop(uint32_t loop);
+	// Adds to a counter of the current frame, only recorded while tracing
+	void	AddCount(int id, long long count);
+}
+
+class ProfilerScope
+{
+	int m_id;
+
+public:
+
+	ProfilerScope(int id) : m_id(id) { Profiler::Begin(id); }
+	~ProfilerScope() { Profiler::End(m_id); }
+};
+
+#define PROFILER_CONCAT_IMPL(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_IMPL(a, b)
+
+// Times the rest of the enclosing scope
+#define PROFILE_SCOPE(name) \
+	static const int PROFILER_CONCAT(profilerId, __LINE__) = Profiler::Intern(name); \
+	ProfilerScope PROFILER_CONCAT(profilerScope, __LINE__)(PROFILER_CONCAT(profilerId, __LINE__))
+// For the probes that do not match a scope, PROFILE_END must be given the same name as PROFILE_BEGIN
+#define PROFILE_BEGIN(name) do { static const int profilerId = Profiler::Intern(name); Profiler::Begin(profilerId); } while (false)
+#define PROFILE_END(name) do { static const int profilerId = Profiler::Intern(name); Profiler::End(profilerId); } while (false)
+#define PROFILE_COUNT(name, count) do { static const int profilerId = Profiler::Intern(name); Profiler::AddCount(profilerId, count); } while (false)
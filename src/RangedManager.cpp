@@ -179,13 +179,15 @@ void RangedManager::HarassLogic(sc2::Units &rangedUnits, sc2::Units &rangedUnitT
 	m_dummyStimedUnits.clear();
 	cleanLastStimFrame();
 
-	m_bot.StartProfiling("0.10.4.1.5.1        HarassLogicForUnit");
+	PROFILE_BEGIN("HarassLogicForUnit");
 	if (m_bot.Config().EnableMultiThreading)
 	{
 		std::list<std::thread*> threads;
 		for (int i = 0; i < rangedUnits.size(); ++i)
 		{
 			auto rangedUnit = rangedUnits[i];
+			if (m_bot.Latency().shouldSkipMicro(rangedUnit))
+				continue;
 			sc2::AvailableAbilities unitAbilities;
 			m_bot.Commander().Combat().GetUnitAbilities(rangedUnit, unitAbilities);
 			std::thread* t = new std::thread(&RangedManager::HarassLogicForUnit, this, rangedUnit, std::ref(rangedUnits), std::ref(rangedUnitTargets), std::ref(unitAbilities), std::ref(otherSquadsUnits));
@@ -202,12 +204,14 @@ void RangedManager::HarassLogic(sc2::Units &rangedUnits, sc2::Units &rangedUnitT
 		for (int i = 0; i < rangedUnits.size(); ++i)
 		{
 			auto rangedUnit = rangedUnits[i];
+			if (m_bot.Latency().shouldSkipMicro(rangedUnit))
+				continue;
 			sc2::AvailableAbilities unitAbilities;
 			m_bot.Commander().Combat().GetUnitAbilities(rangedUnit, unitAbilities);
 			HarassLogicForUnit(rangedUnit, rangedUnits, rangedUnitTargets, unitAbilities, otherSquadsUnits);
 		}
 	}
-	m_bot.StopProfiling("0.10.4.1.5.1        HarassLogicForUnit");
+	PROFILE_END("HarassLogicForUnit");
 }
 
 void RangedManager::HarassLogicForUnit(const sc2::Unit* rangedUnit, sc2::Units &rangedUnits, sc2::Units &rangedUnitTargets, sc2::AvailableAbilities &rangedUnitAbilities, sc2::Units &otherSquadsUnits)
@@ -241,32 +245,32 @@ void RangedManager::HarassLogicForUnit(const sc2::Unit* rangedUnit, sc2::Units &
 	if (rangedUnit->is_selected)
 		int a = 0;
 
-	m_bot.StartProfiling("0.10.4.1.5.1.a          MonitorCyclone");
+	PROFILE_BEGIN("MonitorCyclone");
 	if (isCyclone && MonitorCyclone(rangedUnit, rangedUnitAbilities))
 	{
-		m_bot.StopProfiling("0.10.4.1.5.1.a          MonitorCyclone");
+		PROFILE_END("MonitorCyclone");
 		return;
 	}
-	m_bot.StopProfiling("0.10.4.1.5.1.a          MonitorCyclone");
+	PROFILE_END("MonitorCyclone");
 
 	sc2::Units allCombatAllies(rangedUnits);
 	allCombatAllies.insert(allCombatAllies.end(), otherSquadsUnits.begin(), otherSquadsUnits.end());
 	
-	m_bot.StartProfiling("0.10.4.1.5.1.0          getTarget");
+	PROFILE_BEGIN("getTarget");
 	//TODO Find if filtering higher units would solve problems without creating new ones
 	const sc2::Unit * target = getTarget(rangedUnit, rangedUnitTargets, true, true);
 	if (!target && (m_order.getType() != SquadOrderTypes::Harass || m_bot.Strategy().shouldFocusBuildings()))	// If no standard target is found, we check for a building that is not out of vision on higher ground
 		target = getTarget(rangedUnit, rangedUnitTargets, true, true, false, false);
-	m_bot.StopProfiling("0.10.4.1.5.1.0          getTarget");
-	m_bot.StartProfiling("0.10.4.1.5.1.1          getThreats");
+	PROFILE_END("getTarget");
+	PROFILE_BEGIN("getThreats");
 	sc2::Units & threats = getThreats(rangedUnit, rangedUnitTargets);
-	m_bot.StopProfiling("0.10.4.1.5.1.1          getThreats");
+	PROFILE_END("getThreats");
 
 	if (!target)
 	{
-		m_bot.StartProfiling("0.10.4.1.5.1.0.a          getTargetOnHighGround");
+		PROFILE_BEGIN("getTargetOnHighGround");
 		target = getTargetOnHighGround(rangedUnit, rangedUnitTargets, threats);
-		m_bot.StopProfiling("0.10.4.1.5.1.0.a          getTargetOnHighGround");
+		PROFILE_END("getTargetOnHighGround");
 	}
 
 	CCPosition goal = m_order.getPosition();
@@ -299,7 +303,7 @@ void RangedManager::HarassLogicForUnit(const sc2::Unit* rangedUnit, sc2::Units &
 	}
 
 	bool defendingAgainstCombatBuildings = false;	// Only computed for Tanks
-	m_bot.StartProfiling("0.10.4.1.5.1.2          ShouldUnitHeal");
+	PROFILE_BEGIN("ShouldUnitHeal");
 	bool unitShouldHeal = m_bot.Commander().Combat().ShouldUnitHeal(rangedUnit);
 	if (unitShouldHeal)
 	{
@@ -313,7 +317,7 @@ void RangedManager::HarassLogicForUnit(const sc2::Unit* rangedUnit, sc2::Units &
 			Util::DisplayError("RangedManager healGoal is (0, 0)", "", m_bot, false);
 		if (isBattlecruiser && Util::DistSq(rangedUnit->pos, goal) > 15.f * 15.f && TeleportBattlecruiser(rangedUnit, goal))
 		{
-			m_bot.StopProfiling("0.10.4.1.5.1.2          ShouldUnitHeal");
+			PROFILE_END("ShouldUnitHeal");
 			return;
 		}
 	}
@@ -496,7 +500,7 @@ void RangedManager::HarassLogicForUnit(const sc2::Unit* rangedUnit, sc2::Units &
 			m_tanksLastFrameFarFromRetreatGoal[rangedUnit] = 1;
 		}
 	}
-	m_bot.StopProfiling("0.10.4.1.5.1.2          ShouldUnitHeal");
+	PROFILE_END("ShouldUnitHeal");
 
 	if (ChangeBehaviorFromBuffs(rangedUnit, isUnitDisabled, allCombatAllies, goal, goalDescription, unitShouldHeal))
 	{
@@ -508,9 +512,9 @@ void RangedManager::HarassLogicForUnit(const sc2::Unit* rangedUnit, sc2::Units &
 	bool cycloneShouldStayCloseToTarget = false;
 	if (isCyclone)
 	{
-		m_bot.StartProfiling("0.10.4.1.5.1.b          ExecuteCycloneLogic");
+		PROFILE_BEGIN("ExecuteCycloneLogic");
 		ExecuteCycloneLogic(rangedUnit, isUnitDisabled, unitShouldHeal, shouldAttack, cycloneShouldUseLockOn, cycloneShouldStayCloseToTarget, rangedUnits, threats, rangedUnitTargets, target, goal, goalDescription, rangedUnitAbilities);
-		m_bot.StopProfiling("0.10.4.1.5.1.b          ExecuteCycloneLogic");
+		PROFILE_END("ExecuteCycloneLogic");
 	}
 
 	const auto distSqToTarget = target ? Util::DistSq(rangedUnit->pos, target->pos) : 0.f;
@@ -531,15 +535,15 @@ void RangedManager::HarassLogicForUnit(const sc2::Unit* rangedUnit, sc2::Units &
 		goalDescription = "FirstReaperGoThroughNatural";
 	}
 
-	m_bot.StartProfiling("0.10.4.1.5.1.c          ExecutePrioritizedUnitAbilitiesLogic");
+	PROFILE_BEGIN("ExecutePrioritizedUnitAbilitiesLogic");
 	if (!isUnitDisabled && ExecutePrioritizedUnitAbilitiesLogic(rangedUnit, target, threats, rangedUnitTargets, allCombatAllies, goal, unitShouldHeal, isCycloneHelper))
 	{
-		m_bot.StopProfiling("0.10.4.1.5.1.c          ExecutePrioritizedUnitAbilitiesLogic");
+		PROFILE_END("ExecutePrioritizedUnitAbilitiesLogic");
 		return;
 	}
-	m_bot.StopProfiling("0.10.4.1.5.1.c          ExecutePrioritizedUnitAbilitiesLogic");
+	PROFILE_END("ExecutePrioritizedUnitAbilitiesLogic");
 
-	m_bot.StartProfiling("0.10.4.1.5.1.d          targetInAttackRange");
+	PROFILE_BEGIN("targetInAttackRange");
 	bool targetInAttackRange = false;
 	float unitAttackRange = 0.f;
 	if (target)
@@ -563,7 +567,7 @@ void RangedManager::HarassLogicForUnit(const sc2::Unit* rangedUnit, sc2::Units &
 			m_bot.Map().drawLine(rangedUnit->pos, target->pos, targetInAttackRange ? sc2::Colors::Green : sc2::Colors::Yellow);
 #endif
 	}
-	m_bot.StopProfiling("0.10.4.1.5.1.d          targetInAttackRange");
+	PROFILE_END("targetInAttackRange");
 
 	if (cycloneShouldUseLockOn && targetInAttackRange)
 	{
@@ -571,37 +575,37 @@ void RangedManager::HarassLogicForUnit(const sc2::Unit* rangedUnit, sc2::Units &
 		return;
 	}
 
-	m_bot.StartProfiling("0.10.4.1.5.1.5          ThreatFighting");
+	PROFILE_BEGIN("ThreatFighting");
 	// Check if our units are powerful enough to exchange fire with the enemies
 	if (shouldAttack && ExecuteThreatFightingLogic(rangedUnit, unitShouldHeal, rangedUnits, threats, rangedUnitTargets, otherSquadsUnits))
 	{
-		m_bot.StopProfiling("0.10.4.1.5.1.5          ThreatFighting");
+		PROFILE_END("ThreatFighting");
 		return;
 	}
-	m_bot.StopProfiling("0.10.4.1.5.1.5          ThreatFighting");
+	PROFILE_END("ThreatFighting");
 
-	m_bot.StartProfiling("0.10.4.1.5.1.4          ShouldAttackTarget");
+	PROFILE_BEGIN("ShouldAttackTarget");
 	if (shouldAttack && targetInAttackRange && ShouldAttackTarget(rangedUnit, target, threats))
 	{
 		UnitAction action = UnitAction(MicroActionType::AttackUnit, target, unitShouldHeal, getAttackDuration(rangedUnit, target), "AttackTarget", m_squad->getName());
 		m_bot.Commander().Combat().PlanAction(rangedUnit, action);
-		m_bot.StopProfiling("0.10.4.1.5.1.4          ShouldAttackTarget");
+		PROFILE_END("ShouldAttackTarget");
 		const float damageDealt = isBattlecruiser ? Util::GetDpsForTarget(rangedUnit, target, m_bot) / 22.4f : Util::GetDamageForTarget(rangedUnit, target, m_bot);
 		m_bot.Analyzer().increaseTotalDamage(damageDealt, rangedUnit->unit_type);
 		return;
 	}
-	m_bot.StopProfiling("0.10.4.1.5.1.4          ShouldAttackTarget");
+	PROFILE_END("ShouldAttackTarget");
 
-	m_bot.StartProfiling("0.10.4.1.5.1.6          UnitAbilities");
+	PROFILE_BEGIN("UnitAbilities");
 	// Check if unit can use one of its abilities
 	if(!isUnitDisabled && ExecuteUnitAbilitiesLogic(rangedUnit, target, threats, rangedUnitTargets, allCombatAllies, goal, unitShouldHeal, isCycloneHelper, rangedUnitAbilities))
 	{
-		m_bot.StopProfiling("0.10.4.1.5.1.6          UnitAbilities");
+		PROFILE_END("UnitAbilities");
 		return;
 	}
-	m_bot.StopProfiling("0.10.4.1.5.1.6          UnitAbilities");
+	PROFILE_END("UnitAbilities");
 
-	m_bot.StartProfiling("0.10.4.1.5.1.e          summedFleeVec");
+	PROFILE_BEGIN("summedFleeVec");
 	bool enemyThreatIsClose = false;
 	bool enemyThreatIsAboutToHit = false;
 	bool fasterEnemyThreat = false;
@@ -626,7 +630,7 @@ void RangedManager::HarassLogicForUnit(const sc2::Unit* rangedUnit, sc2::Units &
 			enemyThreatIsAboutToHit = true;
 		summedFleeVec += GetFleeVectorFromThreat(rangedUnit, threat, fleeVec, dist, threatRange);
 	}
-	m_bot.StopProfiling("0.10.4.1.5.1.e          summedFleeVec");
+	PROFILE_END("summedFleeVec");
 
 	// Banshee is about to get hit, it should cloak itself
 	if (isBanshee && enemyThreatIsAboutToHit && ExecuteBansheeCloakLogic(rangedUnit, unitShouldHeal))
@@ -637,7 +641,7 @@ void RangedManager::HarassLogicForUnit(const sc2::Unit* rangedUnit, sc2::Units &
 	// Opportunistic attack (often on buildings)
 	if (goalDescription != "LockedOnStart" && (shouldAttack || cycloneShouldUseLockOn) && !fasterEnemyThreat && (!isCyclone || !Util::PathFinding::HasInfluenceOnTile(Util::GetTilePosition(rangedUnit->pos), rangedUnit->is_flying, m_bot)))
 	{
-		m_bot.StartProfiling("0.10.4.1.5.1.f          OpportunisticAttack");
+		PROFILE_BEGIN("OpportunisticAttack");
 		const auto closeTarget = getTarget(rangedUnit, rangedUnitTargets, true, true, true, false);
 		if (closeTarget && closeTarget->last_seen_game_loop == m_bot.GetGameLoop() && ShouldAttackTarget(rangedUnit, closeTarget, threats))
 		{
@@ -649,16 +653,15 @@ void RangedManager::HarassLogicForUnit(const sc2::Unit* rangedUnit, sc2::Units &
 			m_bot.Commander().Combat().PlanAction(rangedUnit, action);
 			const float damageDealt = isBattlecruiser ? Util::GetDpsForTarget(rangedUnit, closeTarget, m_bot) / 22.4f : Util::GetDamageForTarget(rangedUnit, closeTarget, m_bot);
 			m_bot.Analyzer().increaseTotalDamage(damageDealt, rangedUnit->unit_type);
-			m_bot.StopProfiling("0.10.4.1.5.1.f          OpportunisticAttack");
+			PROFILE_END("OpportunisticAttack");
 			return;
 		}
-		m_bot.StopProfiling("0.10.4.1.5.1.f          OpportunisticAttack");
+		PROFILE_END("OpportunisticAttack");
 	}
 
 	if (!unitShouldHeal && distSqToTarget < m_order.getRadius() * m_order.getRadius() && ((target && (target->last_seen_game_loop == m_bot.GetCurrentFrame() || m_order.getStatus() != "Retreat")) || (!threats.empty() && m_order.getStatus() != "Retreat")))
 	{
-		m_bot.StartProfiling("0.10.4.1.5.1.7          OffensivePathFinding");
-		m_bot.StartProfiling("0.10.4.1.5.1.7          OffensivePathFinding " + rangedUnit->unit_type.to_string());
+		PROFILE_BEGIN("OffensivePathFinding");
 		const bool checkInfluence = (!isCyclone || shouldAttack) && rangedUnit->weapon_cooldown > 0;
 		if ((!isCyclone || cycloneShouldUseLockOn || shouldAttack) && AllowUnitToPathFind(rangedUnit, checkInfluence, "Offensive"))
 		{
@@ -669,14 +672,18 @@ void RangedManager::HarassLogicForUnit(const sc2::Unit* rangedUnit, sc2::Units &
 			const auto maxInfluence = (cycloneShouldUseLockOn && target) ? CYCLONE_MAX_INFLUENCE_FOR_LOCKON : tolerateInfluenceToAttackTarget ? MAX_INFLUENCE_FOR_OFFENSIVE_KITING : 0.f;
 			const CCPosition secondaryGoal = (!cycloneShouldUseLockOn && !shouldAttack && !ignoreCombatInfluence) ? m_bot.GetStartLocation() : CCPosition();	// Only set for Cyclones with lock-on target (other than Tempest)
 			const float maxRange = target ? unitAttackRange : 3.f;
-			CCPosition closePositionInPath = Util::PathFinding::FindOptimalPathToTarget(rangedUnit, pathFindEndPos, secondaryGoal, target, maxRange, ignoreCombatInfluence, maxInfluence, m_bot);
+			CCPosition closePositionInPath;
+			// Without a target, every unit of the squad goes to the same goal so they can share a flow field instead of each running an A*
+			if (!target)
+				closePositionInPath = m_bot.Commander().Combat().getFlowFields().getMovePosition(rangedUnit, pathFindEndPos, maxRange, ignoreCombatInfluence);
+			if (closePositionInPath == CCPosition())
+				closePositionInPath = Util::PathFinding::FindOptimalPathToTarget(rangedUnit, pathFindEndPos, secondaryGoal, target, maxRange, ignoreCombatInfluence, maxInfluence, m_bot);
 			if (closePositionInPath != CCPosition())
 			{
 				const int actionDuration = rangedUnit->unit_type == sc2::UNIT_TYPEID::TERRAN_REAPER ? REAPER_MOVE_FRAME_COUNT : 0;
 				const auto action = UnitAction(MicroActionType::Move, closePositionInPath, unitShouldHeal, actionDuration, "PathfindOffensively", m_squad->getName());
 				m_bot.Commander().Combat().PlanAction(rangedUnit, action);
-				m_bot.StopProfiling("0.10.4.1.5.1.7          OffensivePathFinding");
-				m_bot.StopProfiling("0.10.4.1.5.1.7          OffensivePathFinding " + rangedUnit->unit_type.to_string());
+				PROFILE_END("OffensivePathFinding");
 				return;
 			}
 			PreventUnitToPathFind(rangedUnit, "Offensive", target);
@@ -688,14 +695,12 @@ void RangedManager::HarassLogicForUnit(const sc2::Unit* rangedUnit, sc2::Units &
 			{
 				const auto action = UnitAction(MicroActionType::Move, movePosition, unitShouldHeal, 0, "StayInRange", m_squad->getName());
 				m_bot.Commander().Combat().PlanAction(rangedUnit, action);
-				m_bot.StopProfiling("0.10.4.1.5.1.7          OffensivePathFinding");
-				m_bot.StopProfiling("0.10.4.1.5.1.7          OffensivePathFinding " + rangedUnit->unit_type.to_string());
+				PROFILE_END("OffensivePathFinding");
 				return;
 			}
 			PreventUnitToPathFind(rangedUnit, "SaferRange", target);
 		}
-		m_bot.StopProfiling("0.10.4.1.5.1.7          OffensivePathFinding");
-		m_bot.StopProfiling("0.10.4.1.5.1.7          OffensivePathFinding " + rangedUnit->unit_type.to_string());
+		PROFILE_END("OffensivePathFinding");
 	}
 
 	// if there is no potential target or threat, move to objective
@@ -711,21 +716,21 @@ void RangedManager::HarassLogicForUnit(const sc2::Unit* rangedUnit, sc2::Units &
 		// Only if our unit is not cloaked and safe
 		if (!Util::IsUnitCloakedAndSafe(rangedUnit, m_bot))
 		{
-			m_bot.StartProfiling("0.10.4.1.5.1.9          DefensivePathfinding");
+			PROFILE_BEGIN("DefensivePathfinding");
 			// If close to an unpathable position or in danger, use influence map to find safest path
 			CCPosition safeTile = Util::PathFinding::FindOptimalPathToSafety(rangedUnit, goal, unitShouldHeal, m_bot);
 			if (safeTile != CCPosition())
 			{
 				const auto action = UnitAction(MicroActionType::Move, safeTile, unitShouldHeal, isReaper ? REAPER_MOVE_FRAME_COUNT : 0, "PathfindFlee", m_squad->getName());
 				m_bot.Commander().Combat().PlanAction(rangedUnit, action);
-				m_bot.StopProfiling("0.10.4.1.5.1.9          DefensivePathfinding");
+				PROFILE_END("DefensivePathfinding");
 				return;
 			}
-			m_bot.StopProfiling("0.10.4.1.5.1.9          DefensivePathfinding");
+			PROFILE_END("DefensivePathfinding");
 		}
 	}
 
-	m_bot.StartProfiling("0.10.4.1.5.1.8          PotentialFields");
+	PROFILE_BEGIN("PotentialFields");
 	const bool unitShouldBack = unitShouldHeal || !m_bot.Commander().Combat().winAttackSimulation();
 	CCPosition dirVec = GetDirectionVectorTowardsGoal(rangedUnit, target, goal, targetInAttackRange, unitShouldBack);
 
@@ -755,7 +760,7 @@ void RangedManager::HarassLogicForUnit(const sc2::Unit* rangedUnit, sc2::Units &
 	const float vecLen = std::sqrt(std::pow(dirVec.x, 2) + std::pow(dirVec.y, 2));
 	if (vecLen < 0.5f)
 	{
-		m_bot.StopProfiling("0.10.4.1.5.1.8          PotentialFields");
+		PROFILE_END("PotentialFields");
 		return;
 	}
 
@@ -773,7 +778,7 @@ void RangedManager::HarassLogicForUnit(const sc2::Unit* rangedUnit, sc2::Units &
 
 		const auto action = UnitAction(Move, pathableTile, unitShouldHeal, isReaper ? REAPER_MOVE_FRAME_COUNT : 0, "PotentialFields", m_squad->getName());
 		m_bot.Commander().Combat().PlanAction(rangedUnit, action);
-		m_bot.StopProfiling("0.10.4.1.5.1.8          PotentialFields");
+		PROFILE_END("PotentialFields");
 		return;
 	}
 	
@@ -784,7 +789,7 @@ void RangedManager::HarassLogicForUnit(const sc2::Unit* rangedUnit, sc2::Units &
 	const auto actionType = m_bot.Data(rangedUnit->unit_type).isBuilding ? Move : AttackMove;
 	const auto action = UnitAction(actionType, rangedUnit->pos, false, 0, "LastResort", m_squad->getName());
 	m_bot.Commander().Combat().PlanAction(rangedUnit, action);
-	m_bot.StopProfiling("0.10.4.1.5.1.8          PotentialFields");
+	PROFILE_END("PotentialFields");
 }
 
 void RangedManager::GetInfiltrationGoalPosition(const sc2::Unit * rangedUnit, CCPosition & goal, std::string & goalDescription) const
@@ -1146,7 +1151,7 @@ bool RangedManager::TeleportBattlecruiser(const sc2::Unit * battlecruiser, CCPos
 		const auto action = UnitAction(MicroActionType::AbilityPosition, sc2::ABILITY_ID::EFFECT_TACTICALJUMP, location, true, BATTLECRUISER_TELEPORT_FRAME_COUNT, "TacticalJump", m_squad->getName());
 		m_bot.Commander().Combat().PlanAction(battlecruiser, action);
 		setNextFrameAbilityAvailable(sc2::ABILITY_ID::EFFECT_TACTICALJUMP, battlecruiser, m_bot.GetCurrentFrame() + BATTLECRUISER_TELEPORT_COOLDOWN_FRAME_COUNT);
-		m_bot.StopProfiling("0.10.4.1.5.1.2          ShouldUnitHeal");
+		PROFILE_END("ShouldUnitHeal");
 		return true;
 	}
 
@@ -1677,7 +1682,7 @@ CCPosition RangedManager::GetDirectionVectorTowardsGoal(const sc2::Unit * ranged
 
 const sc2::Unit * RangedManager::ExecuteLockOnLogic(const sc2::Unit * cyclone, bool shouldHeal, bool & shouldAttack, bool & shouldUseLockOn, bool & lockOnAvailable, const sc2::Units & rangedUnits, const sc2::Units & threats, const sc2::Units & rangedUnitTargets, const sc2::Unit * target, sc2::AvailableAbilities & abilities)
 {
-	m_bot.StartProfiling("0.10.4.1.5.1.b.1.1              CheckIfLockOnAvailable");
+	PROFILE_BEGIN("CheckIfLockOnAvailable");
 	const uint32_t currentFrame = m_bot.GetCurrentFrame();
 	auto & lockOnTargets = m_bot.Commander().Combat().getLockOnTargets();
 	auto & lockedOnTargets = m_bot.Commander().Combat().getLockedOnTargets();
@@ -1718,9 +1723,9 @@ const sc2::Unit * RangedManager::ExecuteLockOnLogic(const sc2::Unit * cyclone, b
 			m_bot.Map().drawCircle(cyclone->pos, float(nextAvailableAbility[sc2::ABILITY_ID::EFFECT_LOCKON][cyclone] - currentFrame) / CYCLONE_LOCKON_COOLDOWN_FRAME_COUNT, sc2::Colors::Red);
 		}
 	}
-	m_bot.StopProfiling("0.10.4.1.5.1.b.1.1              CheckIfLockOnAvailable");
+	PROFILE_END("CheckIfLockOnAvailable");
 
-	m_bot.StartProfiling("0.10.4.1.5.1.b.1.2              FindLockOnTarget");
+	PROFILE_BEGIN("FindLockOnTarget");
 	// Check if the Cyclone would have a better Lock-On target
 	if (shouldUseLockOn)
 	{
@@ -1818,7 +1823,7 @@ const sc2::Unit * RangedManager::ExecuteLockOnLogic(const sc2::Unit * cyclone, b
 			}
 		}
 	}
-	m_bot.StopProfiling("0.10.4.1.5.1.b.1.2              FindLockOnTarget");
+	PROFILE_END("FindLockOnTarget");
 
 	return target;
 }
@@ -1867,7 +1872,7 @@ bool RangedManager::ExecuteThreatFightingLogic(const sc2::Unit * rangedUnit, boo
 	const auto & cycloneFlyingHelpers = m_bot.Commander().Combat().getCycloneFlyingHelpers();
 	const auto vikingCount = m_bot.UnitInfo().getUnitTypeCount(Players::Self, MetaTypeEnum::Viking.getUnitType(), false, true);
 	// If the Viking that is not a flying helper has no target, we try to see if it would have one if it was landed
-	m_bot.StartProfiling("0.10.4.1.5.1.5.a          VikingMorph");
+	PROFILE_BEGIN("VikingMorph");
 	if (!target && rangedUnit->unit_type == sc2::UNIT_TYPEID::TERRAN_VIKINGFIGHTER)
 	{
 		if (!m_bot.Analyzer().enemyHasCombatAirUnit() || vikingCount >= 40)
@@ -1901,14 +1906,14 @@ bool RangedManager::ExecuteThreatFightingLogic(const sc2::Unit * rangedUnit, boo
 		}
 	}
 	
-	m_bot.StopProfiling("0.10.4.1.5.1.5.a          VikingMorph");
+	PROFILE_END("VikingMorph");
 	const float range = Util::GetAttackRangeForTarget(rangedUnit, target, m_bot);
 	if (!target || (!isTargetRanged(target) && !morphFlyingVikings))
 	{
 		return false;
 	}
 	
-	m_bot.StartProfiling("0.10.4.1.5.1.5.b          HighGroundCheck");
+	PROFILE_BEGIN("HighGroundCheck");
 	const float targetDist = Util::Dist(rangedUnit->pos, target->pos);
 	if (Util::IsEnemyHiddenOnHighGround(rangedUnit, target, m_bot))
 	{
@@ -1929,14 +1934,14 @@ bool RangedManager::ExecuteThreatFightingLogic(const sc2::Unit * rangedUnit, boo
 		}
 		if (!easilyWalkable)
 		{
-			m_bot.StopProfiling("0.10.4.1.5.1.5.b          HighGroundCheck");
+			PROFILE_END("HighGroundCheck");
 			return false;
 		}
 	}
-	m_bot.StopProfiling("0.10.4.1.5.1.5.b          HighGroundCheck");
+	PROFILE_END("HighGroundCheck");
 
 	// Check if unit can fight cloaked
-	m_bot.StartProfiling("0.10.4.1.5.1.5.c          CloakedAttack");
+	PROFILE_BEGIN("CloakedAttack");
 	if(rangedUnit->energy >= 5 && (rangedUnit->cloak == sc2::Unit::CloakedAllied || (rangedUnit->unit_type == sc2::UNIT_TYPEID::TERRAN_BANSHEE && ShouldBansheeCloak(rangedUnit, false))))
 	{
 		// If the unit is at an undetected position
@@ -1952,7 +1957,7 @@ bool RangedManager::ExecuteThreatFightingLogic(const sc2::Unit * rangedUnit, boo
 			{
 				if (Util::PathFinding::HasCombatInfluenceOnTile(Util::GetTilePosition(rangedUnit->pos), rangedUnit, m_bot) && ExecuteBansheeCloakLogic(rangedUnit, false))
 				{
-					m_bot.StopProfiling("0.10.4.1.5.1.5.c          CloakedAttack");
+					PROFILE_END("CloakedAttack");
 					return true;
 				}
 
@@ -1965,7 +1970,7 @@ bool RangedManager::ExecuteThreatFightingLogic(const sc2::Unit * rangedUnit, boo
 						const auto action = UnitAction(MicroActionType::Move, movePosition, true, 0, "DodgeEffect", m_squad->getName());
 						// Move away from the effect
 						m_bot.Commander().Combat().PlanAction(rangedUnit, action);
-						m_bot.StopProfiling("0.10.4.1.5.1.5.c          CloakedAttack");
+						PROFILE_END("CloakedAttack");
 						return true;
 					}
 				}
@@ -1997,16 +2002,16 @@ bool RangedManager::ExecuteThreatFightingLogic(const sc2::Unit * rangedUnit, boo
 				if (!skipAction)
 				{
 					m_bot.Commander().Combat().PlanAction(rangedUnit, action);
-					m_bot.StopProfiling("0.10.4.1.5.1.5.c          CloakedAttack");
+					PROFILE_END("CloakedAttack");
 					return true;
 				}
 			}
 		}
 	}
-	m_bot.StopProfiling("0.10.4.1.5.1.5.c          CloakedAttack");
+	PROFILE_END("CloakedAttack");
 
 	// Check for saved result
-	m_bot.StartProfiling("0.10.4.1.5.1.5.d          CheckSavedResult");
+	PROFILE_BEGIN("CheckSavedResult");
 	for (const auto & combatSimulationResultPair : m_combatSimulationResults)
 	{
 		const auto & allyUnits = combatSimulationResultPair.first;
@@ -2024,13 +2029,13 @@ bool RangedManager::ExecuteThreatFightingLogic(const sc2::Unit * rangedUnit, boo
 				ss << "ThreatFightingLogic was called again when all close units should have been given a prioritized action... Current unit of type " << sc2::UnitTypeToName(rangedUnit->unit_type) << " had a " << action.description << " action and is " << (Util::Contains(rangedUnit, allyUnits) ? "" : "not ") << "part of the set";
 				Util::Log(__FUNCTION__, ss.str(), m_bot);
 			}
-			m_bot.StopProfiling("0.10.4.1.5.1.5.d          CheckSavedResult");
+			PROFILE_END("CheckSavedResult");
 			return shouldFight;
 		}
 	}
-	m_bot.StopProfiling("0.10.4.1.5.1.5.d          CheckSavedResult");
+	PROFILE_END("CheckSavedResult");
 	
-	m_bot.StartProfiling("0.10.4.1.5.1.5.1          CalcCloseUnits");
+	PROFILE_BEGIN("CalcCloseUnits");
 	float minUnitRange = -1;
 	// We create a set because we need an ordered data structure for accurate and efficient comparison with data in memory
 	std::set<const sc2::Unit *> closeUnitsSet;
@@ -2040,7 +2045,7 @@ bool RangedManager::ExecuteThreatFightingLogic(const sc2::Unit * rangedUnit, boo
 	// We want to allow Cyclones to fight only if we are early rushed and they are in the defense squad
 	const bool ignoreCyclones = !m_bot.Strategy().isEarlyRushed() || m_order.getType() != SquadOrderTypes::Defend;
 	CalcCloseUnits(rangedUnit, target, allyCombatUnits, rangedUnitTargets, ignoreCyclones, closeUnitsSet, morphFlyingVikings, morphLandedVikings, simulatedStimedUnits, stimedUnitsPowerDifference, closeUnitsTarget, unitsPower, groundUnitsPower, airUnitsPower, minUnitRange);
-	m_bot.StopProfiling("0.10.4.1.5.1.5.1          CalcCloseUnits");
+	PROFILE_END("CalcCloseUnits");
 
 	if (closeUnitsSet.empty() || !Util::Contains(rangedUnit, closeUnitsSet))
 	{
@@ -2065,7 +2070,7 @@ bool RangedManager::ExecuteThreatFightingLogic(const sc2::Unit * rangedUnit, boo
 			closeGroundUnits.push_back(closeUnit);
 	}
 
-	m_bot.StartProfiling("0.10.4.1.5.1.5.2          CalcThreats");
+	PROFILE_BEGIN("CalcThreats");
 	// Calculate all the threats of all the ally units participating in the fight
 	std::set<const sc2::Unit *> allThreatsSet;
 	std::map<sc2::UnitTypeID, sc2::Units> allyUnitsByType;
@@ -2186,9 +2191,9 @@ bool RangedManager::ExecuteThreatFightingLogic(const sc2::Unit * rangedUnit, boo
 			}
 		}
 	}
-	m_bot.StopProfiling("0.10.4.1.5.1.5.2          CalcThreats");
+	PROFILE_END("CalcThreats");
 
-	m_bot.StartProfiling("0.10.4.1.5.1.5.3          CalcThreatsPower");
+	PROFILE_BEGIN("CalcThreatsPower");
 	float maxThreatSpeed = 0.f;
 	float maxThreatRange = 0.f;
 	sc2::Units threatsToKeep;
@@ -2257,7 +2262,7 @@ bool RangedManager::ExecuteThreatFightingLogic(const sc2::Unit * rangedUnit, boo
 			airAttackingThreats.push_back(threat);
 		}
 	}
-	m_bot.StopProfiling("0.10.4.1.5.1.5.3          CalcThreatsPower");
+	PROFILE_END("CalcThreatsPower");
 
 	// If our units have 2 more range, they should kite, not trade
 	if (!morphFlyingVikings && minUnitRange - maxThreatRange >= 2.f)
@@ -2292,7 +2297,7 @@ bool RangedManager::ExecuteThreatFightingLogic(const sc2::Unit * rangedUnit, boo
 	}*/
 
 	// If we can beat the enemy
-	m_bot.StartProfiling("0.10.4.1.5.1.5.4          SimulateCombat");
+	PROFILE_BEGIN("SimulateCombat");
 	auto simulationResult = Util::SimulateCombat(closeUnits, threatsToKeep, false, true, m_bot);
 	auto groundSimulationResult = Util::SimulateCombat(closeGroundUnits, groundAttackingThreats, false, true, m_bot);
 	auto airSimulationResult = Util::SimulateCombat(closeAirUnits, airAttackingThreats, false, true, m_bot);
@@ -2396,12 +2401,12 @@ bool RangedManager::ExecuteThreatFightingLogic(const sc2::Unit * rangedUnit, boo
 			}
 		}
 	}
-	m_bot.StopProfiling("0.10.4.1.5.1.5.4          SimulateCombat");
+	PROFILE_END("SimulateCombat");
 
 	// Save result
 	m_combatSimulationResults[closeUnitsSet] = { shouldGroundFight, shouldAirFight };
 
-	m_bot.StartProfiling("0.10.4.1.5.1.5.5          GiveActions");
+	PROFILE_BEGIN("GiveActions");
 	// Choose an action for each of our close units
 	for (auto & unitAndTarget : closeUnitsTarget)
 	{
@@ -2411,24 +2416,24 @@ bool RangedManager::ExecuteThreatFightingLogic(const sc2::Unit * rangedUnit, boo
 		bool shouldFight = unit->is_flying ? shouldAirFight : shouldGroundFight;
 
 		// Cloak Banshee if threatened
-		m_bot.StartProfiling("0.10.4.1.5.1.5.5.1            CloakBanshee");
+		PROFILE_BEGIN("CloakBanshee");
 		if (shouldFight && unit->unit_type == sc2::UNIT_TYPEID::TERRAN_BANSHEE && Util::PathFinding::HasCombatInfluenceOnTile(Util::GetTilePosition(unit->pos), unit->is_flying, m_bot) && ExecuteBansheeCloakLogic(unit, false))
 		{
-			m_bot.StopProfiling("0.10.4.1.5.1.5.5.1            CloakBanshee");
+			PROFILE_END("CloakBanshee");
 			continue;
 		}
-		m_bot.StopProfiling("0.10.4.1.5.1.5.5.1            CloakBanshee");
+		PROFILE_END("CloakBanshee");
 
 		// Make sure the unit pointer is the right one for the Vikings
-		m_bot.StartProfiling("0.10.4.1.5.1.5.5.2            GetRealViking");
+		PROFILE_BEGIN("GetRealViking");
 		if ((morphFlyingVikings && unit->unit_type == sc2::UNIT_TYPEID::TERRAN_VIKINGASSAULT) || (morphLandedVikings && unit->unit_type == sc2::UNIT_TYPEID::TERRAN_VIKINGFIGHTER))
 		{
 			simulatedUnit = unit;
 			unit = m_bot.GetUnitPtr(unit->tag);
 		}
-		m_bot.StopProfiling("0.10.4.1.5.1.5.5.2            GetRealViking");
+		PROFILE_END("GetRealViking");
 
-		m_bot.StartProfiling("0.10.4.1.5.1.5.5.3            CanAttackNow");
+		PROFILE_BEGIN("CanAttackNow");
 		const float unitRange = Util::GetAttackRangeForTarget(unit, unitTarget, m_bot);
 		bool canAttackNow = unit->weapon_cooldown <= 0.f && unitRange > 0;
 		if (canAttackNow)
@@ -2438,19 +2443,19 @@ bool RangedManager::ExecuteThreatFightingLogic(const sc2::Unit * rangedUnit, boo
 			else
 				canAttackNow = unitRange * unitRange >= Util::DistSq(unit->pos, unitTarget->pos);
 		}
-		m_bot.StopProfiling("0.10.4.1.5.1.5.5.3            CanAttackNow");
+		PROFILE_END("CanAttackNow");
 
-		m_bot.StartProfiling("0.10.4.1.5.1.5.5.4            ShouldAttackAnyway");
+		PROFILE_BEGIN("ShouldAttackAnyway");
 		// Even if the fight would be lost, should still attack if it can, but only if it is slower than the fastest enemy and its target is not on high ground
 		if (!shouldFight && (!canAttackNow || Util::getSpeedOfUnit(unit, m_bot) > maxThreatSpeed || Util::IsEnemyHiddenOnHighGround(unit, unitTarget, m_bot)))
 		{
-			m_bot.StopProfiling("0.10.4.1.5.1.5.5.4            ShouldAttackAnyway");
+			PROFILE_END("ShouldAttackAnyway");
 			continue;
 		}
-		m_bot.StopProfiling("0.10.4.1.5.1.5.5.4            ShouldAttackAnyway");
+		PROFILE_END("ShouldAttackAnyway");
 
 		// If the unit is standing on effect influence, get it out of it before fighting
-		m_bot.StartProfiling("0.10.4.1.5.1.5.5.5            DodgeEffect");
+		PROFILE_BEGIN("DodgeEffect");
 		if (Util::PathFinding::GetEffectInfluenceOnTile(Util::GetTilePosition(unit->pos), unit, m_bot) > 0.f)
 		{
 			CCPosition movePosition = Util::PathFinding::FindOptimalPathToDodgeEffectAwayFromGoal(unit, unitTarget->pos, unitRange, m_bot);
@@ -2459,7 +2464,7 @@ bool RangedManager::ExecuteThreatFightingLogic(const sc2::Unit * rangedUnit, boo
 				const int actionDuration = unit->unit_type == sc2::UNIT_TYPEID::TERRAN_REAPER ? REAPER_MOVE_FRAME_COUNT : 0;
 				const auto action = UnitAction(MicroActionType::Move, movePosition, true, actionDuration, ACTION_DESCRIPTION_THREAT_FIGHT_DODGE_EFFECT, m_squad->getName());
 				m_bot.Commander().Combat().PlanAction(unit, action);
-				m_bot.StopProfiling("0.10.4.1.5.1.5.5.5            DodgeEffect");
+				PROFILE_END("DodgeEffect");
 				continue;
 			}
 			else
@@ -2467,14 +2472,14 @@ bool RangedManager::ExecuteThreatFightingLogic(const sc2::Unit * rangedUnit, boo
 				Util::DisplayError("Could not find an escape path", "", m_bot);
 			}
 		}
-		m_bot.StopProfiling("0.10.4.1.5.1.5.5.5            DodgeEffect");
+		PROFILE_END("DodgeEffect");
 		
 		if (shouldFight)
 		{
 			// Morph the flying Viking
 			if (morphFlyingVikings && unit->unit_type == sc2::UNIT_TYPEID::TERRAN_VIKINGFIGHTER)
 			{
-				m_bot.StartProfiling("0.10.4.1.5.1.5.5.6            VikingFighterMoveOrMorph");
+				PROFILE_BEGIN("VikingFighterMoveOrMorph");
 				auto action = UnitAction();
 				const auto distSq = Util::DistSq(unit->pos, unitTarget->pos);
 				if (distSq > 8 * 8)
@@ -2496,7 +2501,7 @@ bool RangedManager::ExecuteThreatFightingLogic(const sc2::Unit * rangedUnit, boo
 							ss << " and it has no target";
 						}
 						Util::Log(__FUNCTION__, ss.str(), m_bot);
-						m_bot.StopProfiling("0.10.4.1.5.1.5.5.6            VikingFighterMoveOrMorph");
+						PROFILE_END("VikingFighterMoveOrMorph");
 						continue;
 					}
 					const float simulatedUnitRange = Util::GetAttackRangeForTarget(simulatedUnit, unitTarget, m_bot);
@@ -2512,7 +2517,7 @@ bool RangedManager::ExecuteThreatFightingLogic(const sc2::Unit * rangedUnit, boo
 					action = UnitAction(MicroActionType::Ability, sc2::ABILITY_ID::MORPH_VIKINGASSAULTMODE, true, VIKING_MORPH_FRAME_COUNT, ACTION_DESCRIPTION_THREAT_FIGHT_MORPH, m_squad->getName());
 				}
 				m_bot.Commander().Combat().PlanAction(unit, action);
-				m_bot.StopProfiling("0.10.4.1.5.1.5.5.6            VikingFighterMoveOrMorph");
+				PROFILE_END("VikingFighterMoveOrMorph");
 				continue;
 			}
 
@@ -2535,26 +2540,26 @@ bool RangedManager::ExecuteThreatFightingLogic(const sc2::Unit * rangedUnit, boo
 			// Micro the Medivac
 			if (unit->unit_type == sc2::UNIT_TYPEID::TERRAN_MEDIVAC)
 			{
-				m_bot.StartProfiling("0.10.4.1.5.1.5.5.8            ExecuteHealLogic");
+				PROFILE_BEGIN("ExecuteHealLogic");
 				ExecuteHealLogic(unit, allyCombatUnits, false, true);
-				m_bot.StopProfiling("0.10.4.1.5.1.5.5.8            ExecuteHealLogic");
+				PROFILE_END("ExecuteHealLogic");
 				continue;
 			}
 
 			// Stim the Marine or Marauder if it is close enough to its target (to prevent using it from very far away)
 			if (useStim && Util::DistSq(unit->pos, unitTarget->pos) <= 10 * 10)
 			{
-				m_bot.StartProfiling("0.10.4.1.5.1.5.5.9            ExecuteStimLogic");
+				PROFILE_BEGIN("ExecuteStimLogic");
 				if (ExecuteStimLogic(unit))
 				{
-					m_bot.StopProfiling("0.10.4.1.5.1.5.5.9            ExecuteStimLogic");
+					PROFILE_END("ExecuteStimLogic");
 					continue;
 				}
-				m_bot.StopProfiling("0.10.4.1.5.1.5.5.9            ExecuteStimLogic");
+				PROFILE_END("ExecuteStimLogic");
 			}
 		}
 
-		m_bot.StartProfiling("0.10.4.1.5.1.5.5.10            CalcMovePosition");
+		PROFILE_BEGIN("CalcMovePosition");
 		auto movePosition = CCPosition();
 		const bool injured = unit->health / unit->health_max < 0.5f;
 		const auto enemyRange = Util::GetAttackRangeForTarget(unitTarget, unit, m_bot);
@@ -2595,7 +2600,7 @@ bool RangedManager::ExecuteThreatFightingLogic(const sc2::Unit * rangedUnit, boo
 				movePosition = unitTarget->pos;
 			}
 		}
-		m_bot.StopProfiling("0.10.4.1.5.1.5.5.10            CalcMovePosition");
+		PROFILE_END("CalcMovePosition");
 		if (movePosition != CCPosition())
 		{
 			// Flee but stay in range
@@ -2605,7 +2610,7 @@ bool RangedManager::ExecuteThreatFightingLogic(const sc2::Unit * rangedUnit, boo
 		}
 		else
 		{
-			m_bot.StartProfiling("0.10.4.1.5.1.5.5.11            AttackTarget");
+			PROFILE_BEGIN("AttackTarget");
 			// Attack the target
 			if (unit->unit_type == sc2::UNIT_TYPEID::TERRAN_BATTLECRUISER && unitRange < Util::Dist(unit->pos, unitTarget->pos) + 1)
 			{
@@ -2623,10 +2628,10 @@ bool RangedManager::ExecuteThreatFightingLogic(const sc2::Unit * rangedUnit, boo
 			// Keep track of damage dealt
 			const float damageDealt = Util::GetDpsForTarget(unit, unitTarget, m_bot) / 22.4f;
 			m_bot.Analyzer().increaseTotalDamage(damageDealt, unit->unit_type);
-			m_bot.StopProfiling("0.10.4.1.5.1.5.5.11            AttackTarget");
+			PROFILE_END("AttackTarget");
 		}
 	}
-	m_bot.StopProfiling("0.10.4.1.5.1.5.5          GiveActions");
+	PROFILE_END("GiveActions");
 	return rangedUnit->is_flying ? shouldAirFight : shouldGroundFight;
 }
 
@@ -2895,15 +2900,15 @@ bool RangedManager::ChangeBehaviorFromBuffs(const sc2::Unit * rangedUnit, bool i
 
 void RangedManager::ExecuteCycloneLogic(const sc2::Unit * cyclone, bool isUnitDisabled, bool & unitShouldHeal, bool & shouldAttack, bool & cycloneShouldUseLockOn, bool & cycloneShouldStayCloseToTarget, const sc2::Units & rangedUnits, const sc2::Units & threats, const sc2::Units & rangedUnitTargets, const sc2::Unit * & target, CCPosition & goal, std::string & goalDescription, sc2::AvailableAbilities & abilities)
 {
-	m_bot.StartProfiling("0.10.4.1.5.1.b.1            ExecuteLockOnLogic");
+	PROFILE_BEGIN("ExecuteLockOnLogic");
 	bool lockOnAvailable;
 	target = ExecuteLockOnLogic(cyclone, unitShouldHeal, shouldAttack, cycloneShouldUseLockOn, lockOnAvailable, rangedUnits, threats, rangedUnitTargets, target, abilities);
-	m_bot.StopProfiling("0.10.4.1.5.1.b.1            ExecuteLockOnLogic");
+	PROFILE_END("ExecuteLockOnLogic");
 
 	// If the Cyclone has a its Lock-On on a target with a big range (like a Tempest or Tank)
 	if (!shouldAttack && !cycloneShouldUseLockOn && !isUnitDisabled)
 	{
-		m_bot.StartProfiling("0.10.4.1.5.1.b.2            CheckIfNeedToStayClose");
+		PROFILE_BEGIN("CheckIfNeedToStayClose");
 		const auto & lockOnTargets = m_bot.Commander().Combat().getLockOnTargets();
 		const auto it = lockOnTargets.find(cyclone);
 		if (it != lockOnTargets.end())
@@ -2936,14 +2941,14 @@ void RangedManager::ExecuteCycloneLogic(const sc2::Unit * cyclone, bool isUnitDi
 				}
 			}
 		}
-		m_bot.StopProfiling("0.10.4.1.5.1.b.2            CheckIfNeedToStayClose");
+		PROFILE_END("CheckIfNeedToStayClose");
 	}
 
 	const auto cyclonesWithHelper = m_bot.Commander().Combat().getCyclonesWithHelper();
 	const auto cycloneWithHelperIt = cyclonesWithHelper.find(cyclone);
 	const bool hasFlyingHelper = cycloneWithHelperIt != cyclonesWithHelper.end();
 
-	m_bot.StartProfiling("0.10.4.1.5.1.b.3            DefineGoal");
+	PROFILE_BEGIN("DefineGoal");
 	if (!unitShouldHeal && !cycloneShouldStayCloseToTarget && m_order.getType() != SquadOrderTypes::Defend && m_order.getType() != SquadOrderTypes::Clear)
 	{
 		// If the Cyclone wants to use its lock-on ability, we make sure it stays close to its flying helper to keep a good vision
@@ -3025,40 +3030,40 @@ void RangedManager::ExecuteCycloneLogic(const sc2::Unit * cyclone, bool isUnitDi
 				goalDescription = "KeepTarget";
 		}
 	}
-	m_bot.StopProfiling("0.10.4.1.5.1.b.3            DefineGoal");
+	PROFILE_END("DefineGoal");
 }
 
 bool RangedManager::ExecutePrioritizedUnitAbilitiesLogic(const sc2::Unit * rangedUnit, const sc2::Unit * target, sc2::Units & threats, sc2::Units & targets, sc2::Units & allyUnits, CCPosition goal, bool unitShouldHeal, bool isCycloneHelper)
 {
 	if (rangedUnit->unit_type == sc2::UNIT_TYPEID::TERRAN_BANSHEE)
 	{
-		m_bot.StartProfiling("0.10.4.1.5.1.c.1           ExecuteBansheeUncloakLogic");
+		PROFILE_BEGIN("ExecuteBansheeUncloakLogic");
 		const bool bansheeUncloaked = ExecuteBansheeUncloakLogic(rangedUnit, goal, threats, unitShouldHeal);
-		m_bot.StopProfiling("0.10.4.1.5.1.c.1           ExecuteBansheeUncloakLogic");
+		PROFILE_END("ExecuteBansheeUncloakLogic");
 		if (bansheeUncloaked)
 			return true;
 	}
 
 	if (rangedUnit->unit_type == sc2::UNIT_TYPEID::TERRAN_BATTLECRUISER)
 	{
-		m_bot.StartProfiling("0.10.4.1.5.1.c.2           ExecuteOffensiveTeleportLogic");
+		PROFILE_BEGIN("ExecuteOffensiveTeleportLogic");
 		const bool battlecruiserTeleported = ExecuteOffensiveTeleportLogic(rangedUnit, threats, goal);
-		m_bot.StopProfiling("0.10.4.1.5.1.c.2           ExecuteOffensiveTeleportLogic");
+		PROFILE_END("ExecuteOffensiveTeleportLogic");
 		if (battlecruiserTeleported)
 			return true;
 
-		m_bot.StartProfiling("0.10.4.1.5.1.c.3           ExecuteYamatoCannonLogic");
+		PROFILE_BEGIN("ExecuteYamatoCannonLogic");
 		const bool battlecruiserUsedYamato = ExecuteYamatoCannonLogic(rangedUnit, targets);
-		m_bot.StopProfiling("0.10.4.1.5.1.c.3           ExecuteYamatoCannonLogic");
+		PROFILE_END("ExecuteYamatoCannonLogic");
 		if (battlecruiserUsedYamato)
 			return true;
 	}
 
 	if (rangedUnit->unit_type == sc2::UNIT_TYPEID::TERRAN_THOR || rangedUnit->unit_type == sc2::UNIT_TYPEID::TERRAN_THORAP)
 	{
-		m_bot.StartProfiling("0.10.4.1.5.1.c.4           ExecuteThorMorphLogic");
+		PROFILE_BEGIN("ExecuteThorMorphLogic");
 		const bool thorMorphed = ExecuteThorMorphLogic(rangedUnit);
-		m_bot.StopProfiling("0.10.4.1.5.1.c.4           ExecuteThorMorphLogic");
+		PROFILE_END("ExecuteThorMorphLogic");
 		if (thorMorphed)
 			return true;
 	}
@@ -0,0 +1,194 @@
+#include "ResourceForecast.h"
+#include "CCBot.h"
+#include "Util.h"
+
+namespace
+{
+	const int FORECAST_STEP_FRAMES = 16;
+	const int FORECAST_STEPS = 42;								// 30 seconds
+	// Income of a worker in frames (22.4 per second), the third worker of a mineral field mostly waits for the other two
+	const float MINERALS_PER_WORKER_PER_FRAME = 57.f / (60.f * 22.4f);
+	const float MINERALS_PER_THIRD_WORKER_PER_FRAME = 20.f / (60.f * 22.4f);
+	const float GAS_PER_WORKER_PER_FRAME = 53.f / (60.f * 22.4f);
+	const float MULE_MINERALS_PER_FRAME = 225.f / (64.f * 22.4f);
+	const float RICH_MINERALS_FACTOR = 1.4f;						// 7 minerals per trip instead of 5
+	const float RICH_GAS_FACTOR = 2.f;							// 8 gas per trip instead of 4
+	const float WORKER_SPEED_PER_FRAME = 2.8125f / 16.f;			// always the same for workers
+	const float SQRT_2 = 1.41421356f;
+	const int MAX_SUPPLY = 200;
+}
+
+ResourceForecast::ResourceForecast(CCBot & bot)
+	: m_bot(bot)
+{
+}
+
+float ResourceForecast::getMineralRate(const BaseSaturation & base) const
+{
+	const int workers = std::min(base.workers, 2 * base.patches);
+	const int thirdWorkers = std::min(base.workers - workers, base.patches);
+	return (workers * MINERALS_PER_WORKER_PER_FRAME + thirdWorkers * MINERALS_PER_THIRD_WORKER_PER_FRAME) * base.richFactor;
+}
+
+float ResourceForecast::addMiningWorker()
+{
+	// The new worker is sent to the base where it gathers the most, which is the least saturated one
+	BaseSaturation * bestBase = nullptr;
+	float bestGain = 0.f;
+	for (auto & base : m_bases)
+	{
+		BaseSaturation withWorker = base;
+		++withWorker.workers;
+		const float gain = getMineralRate(withWorker) - getMineralRate(base);
+		if (gain > bestGain)
+		{
+			bestGain = gain;
+			bestBase = &base;
+		}
+	}
+	if (bestBase != nullptr)
+		++bestBase->workers;
+	return bestGain;
+}
+
+void ResourceForecast::update()
+{
+	m_events.clear();
+	m_bases.clear();
+
+	auto & workerData = m_bot.Workers().getWorkerData();
+	const UnitType workerType = Util::GetWorkerType();
+	const auto & workerTypeData = m_bot.Data(workerType);
+	for (const auto base : m_bot.Bases().getOccupiedBaseLocations(Players::Self))
+	{
+		const auto & depot = base->getResourceDepot();
+		if (!depot.isValid() || !depot.isCompleted())
+			continue;
+		m_bases.push_back({ workerData.getCountWorkerAtDepot(depot), int(base->getMinerals().size()), base->isRich() ? RICH_MINERALS_FACTOR : 1.f });
+
+		// The worker in training will start mining once finished
+		const auto & orders = depot.getUnitPtr()->orders;
+		if (!orders.empty() && orders[0].ability_id == workerTypeData.buildAbility)
+			m_events.push_back({ int((1.f - orders[0].progress) * workerTypeData.buildTime), true, 0 });
+	}
+
+	m_gasRate = 0.f;
+	for (const auto & refineryType : { Util::GetRefineryType(), Util::GetRichRefineryType() })
+	{
+		const float richFactor = refineryType == Util::GetRichRefineryType() ? RICH_GAS_FACTOR : 1.f;
+		for (const auto & refinery : m_bot.GetAllyUnits(refineryType.getAPIUnitType()))
+		{
+			if (refinery.isCompleted())
+				m_gasRate += std::min(workerData.getNumAssignedWorkers(refinery), 3) * GAS_PER_WORKER_PER_FRAME * richFactor;
+		}
+	}
+
+	for (const auto & providerType : { Util::GetSupplyProvider(), Util::GetResourceDepotType() })
+	{
+		const int buildTime = m_bot.Data(providerType).buildTime;
+		for (const auto & provider : m_bot.GetAllyUnits(providerType.getAPIUnitType()))
+		{
+			if (provider.isBeingConstructed())
+				m_events.push_back({ int((1.f - provider.getBuildProgress()) * buildTime), false, providerType.supplyProvided() });
+		}
+	}
+	std::sort(m_events.begin(), m_events.end());
+
+	// MULEs are not counted as mining workers and their remaining lifetime is unknown, they are considered to mine during the whole forecast
+	m_mineralRate = m_bot.GetAllyUnits(sc2::UNIT_TYPEID::TERRAN_MULE).size() * MULE_MINERALS_PER_FRAME;
+	for (const auto & base : m_bases)
+		m_mineralRate += getMineralRate(base);
+
+	float minerals = 0.f;
+	float gas = 0.f;
+	int maxSupply = m_bot.GetMaxSupply();
+	int frame = 0;
+	size_t nextEvent = 0;
+	m_steps.resize(FORECAST_STEPS + 1);
+	m_steps[0] = { 0.f, 0.f, maxSupply };
+	for (int step = 1; step <= FORECAST_STEPS; ++step)
+	{
+		const int stepFrame = step * FORECAST_STEP_FRAMES;
+		for (; nextEvent < m_events.size() && m_events[nextEvent].frame <= stepFrame; ++nextEvent)
+		{
+			const auto & event = m_events[nextEvent];
+			minerals += m_mineralRate * (event.frame - frame);
+			gas += m_gasRate * (event.frame - frame);
+			frame = event.frame;
+			if (event.worker)
+				m_mineralRate += addMiningWorker();
+			else
+				maxSupply = std::min(maxSupply + event.supply, MAX_SUPPLY);
+		}
+		minerals += m_mineralRate * (stepFrame - frame);
+		gas += m_gasRate * (stepFrame - frame);
+		frame = stepFrame;
+		m_steps[step] = { minerals, gas, maxSupply };
+	}
+
+	// The supply providers that finish after the forecast horizon
+	for (; nextEvent < m_events.size(); ++nextEvent)
+	{
+		if (!m_events[nextEvent].worker)
+			maxSupply = std::min(maxSupply + m_events[nextEvent].supply, MAX_SUPPLY);
+	}
+	m_futureMaxSupply = maxSupply;
+}
+
+float ResourceForecast::getGatheredIn(int frames, bool gas) const
+{
+	if (frames <= 0 || m_steps.empty())
+		return 0.f;
+
+	const int horizon = FORECAST_STEPS * FORECAST_STEP_FRAMES;
+	if (frames >= horizon)
+	{
+		const auto & lastStep = m_steps.back();
+		return gas ? lastStep.gas + m_gasRate * (frames - horizon) : lastStep.minerals + m_mineralRate * (frames - horizon);
+	}
+
+	const auto & step = m_steps[frames / FORECAST_STEP_FRAMES];
+	const auto & nextStep = m_steps[frames / FORECAST_STEP_FRAMES + 1];
+	const float ratio = (frames % FORECAST_STEP_FRAMES) / float(FORECAST_STEP_FRAMES);
+	return gas ? step.gas + (nextStep.gas - step.gas) * ratio : step.minerals + (nextStep.minerals - step.minerals) * ratio;
+}
+
+float ResourceForecast::getMineralsIn(int frames) const
+{
+	return getGatheredIn(frames, false);
+}
+
+float ResourceForecast::getGasIn(int frames) const
+{
+	return getGatheredIn(frames, true);
+}
+
+int ResourceForecast::getMaxSupplyIn(int frames) const
+{
+	if (m_steps.empty())
+		return m_bot.GetMaxSupply();
+	// Only the supply providers finished at the start of the step are counted
+	return m_steps[std::min(std::max(frames, 0) / FORECAST_STEP_FRAMES, FORECAST_STEPS)].maxSupply;
+}
+
+int ResourceForecast::getWorkerTravelFrames(const CCPosition & from, const CCPosition & to) const
+{
+	// The travel must not be overestimated, that would count income that did not arrive yet when the worker is sent.
+	// It is the straight line within a base. Otherwise the distance map of the base containing one of the positions can show a detour,
+	// the difference of the ground distances of both positions is a lower bound of the ground distance between them. The distance maps
+	// are 4-connected, a diagonal step counts as 2 tiles, so the difference is divided by sqrt(2) to stay a lower bound of the real travel.
+	// Only the distance maps precomputed for the bases are used, a ground distance query could run a full BFS on the map.
+	float distance = Util::Dist(from, to);
+	const BaseLocation * toBase = m_bot.Bases().getBaseLocation(to);
+	const BaseLocation * fromBase = m_bot.Bases().getBaseLocation(from);
+	const BaseLocation * base = toBase ? toBase : fromBase;
+	if (base && fromBase != toBase)
+	{
+		const int fromDistance = base->getGroundDistance(from);
+		const int toDistance = base->getGroundDistance(to);
+		if (fromDistance >= 0 && toDistance >= 0)
+			distance = std::max(distance, std::abs(fromDistance - toDistance) / SQRT_2);
+	}
+	return int(distance / WORKER_SPEED_PER_FRAME);
+}
+
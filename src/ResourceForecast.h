@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Common.h"
+
+class CCBot;
+
+// Projection of our income and supply over the next seconds, computed once per frame.
+// The income comes from the saturation of each base and from the workers about to finish instead of the instantaneous
+// collection rate, and the travel time of the workers uses the ground distances cached by MapTools, so the production,
+// building and supply decisions can query it in constant time without any pathfinding.
+class ResourceForecast
+{
+	struct ForecastStep
+	{
+		float minerals = 0.f;	// gathered since the current frame
+		float gas = 0.f;
+		int maxSupply = 0;
+	};
+
+	struct ForecastEvent
+	{
+		int frame;
+		bool worker;			// a worker finishes and starts mining, otherwise a supply provider finishes
+		int supply;
+
+		bool operator<(const ForecastEvent & rhs) const { return frame < rhs.frame; }
+	};
+
+	struct BaseSaturation
+	{
+		int workers;
+		int patches;
+		float richFactor;
+	};
+
+	CCBot & m_bot;
+	std::vector<ForecastStep> m_steps;			// one step every FORECAST_STEP_FRAMES frames
+	std::vector<ForecastEvent> m_events;
+	std::vector<BaseSaturation> m_bases;
+	float m_mineralRate = 0.f;					// per frame, at the end of the forecast
+	float m_gasRate = 0.f;
+	int m_futureMaxSupply = 0;					// once every supply provider under construction is finished
+
+	float getMineralRate(const BaseSaturation & base) const;
+	float addMiningWorker();
+	float getGatheredIn(int frames, bool gas) const;
+
+public:
+
+	ResourceForecast(CCBot & bot);
+
+	void update();
+
+	// Resources we will have gathered in that many frames
+	float getMineralsIn(int frames) const;
+	float getGasIn(int frames) const;
+	// Max supply in that many frames, capped to the forecast horizon
+	int getMaxSupplyIn(int frames) const;
+	int getFutureMaxSupply() const { return m_futureMaxSupply; }
+	// Income per frame at the end of the forecast horizon
+	float getMineralRate() const { return m_mineralRate; }
+	float getGasRate() const { return m_gasRate; }
+	// Frames needed by a worker to walk from one position to the other
+	int getWorkerTravelFrames(const CCPosition & from, const CCPosition & to) const;
+};
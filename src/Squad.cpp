@@ -58,14 +58,14 @@ void Squad::onFrame()
 	m_meleeManager.setSquad(this);
 	m_rangedManager.setSquad(this);
 	
-	m_bot.StartProfiling("0.10.4.1.1      updateUnits");
+	PROFILE_BEGIN("updateUnits");
     // update all necessary unit information within this squad
     updateUnits();
-	m_bot.StopProfiling("0.10.4.1.1      updateUnits");
+	PROFILE_END("updateUnits");
 
     /*if (m_order.getType() == SquadOrderTypes::Retreat)
     {
-		m_bot.StartProfiling("0.10.4.1.2      SquadOrderTypes::Retreat");
+		PROFILE_BEGIN("SquadOrderTypes::Retreat");
         CCPosition retreatPosition = calcRetreatPosition();
 
 #ifndef PUBLIC_RELEASE
@@ -75,11 +75,11 @@ void Squad::onFrame()
 
         m_meleeManager.regroup(retreatPosition);
         m_rangedManager.regroup(retreatPosition);
-		m_bot.StopProfiling("0.10.4.1.2      SquadOrderTypes::Retreat");
+		PROFILE_END("SquadOrderTypes::Retreat");
     }
     else if (m_order.getType() == SquadOrderTypes::Regroup)
     {
-		m_bot.StartProfiling("0.10.4.1.2      SquadOrderTypes::Regroup");
+		PROFILE_BEGIN("SquadOrderTypes::Regroup");
         CCPosition regroupPosition = calcCenter();
 
 #ifndef PUBLIC_RELEASE
@@ -89,14 +89,14 @@ void Squad::onFrame()
 
         m_meleeManager.regroup(regroupPosition);
         m_rangedManager.regroup(regroupPosition);
-		m_bot.StopProfiling("0.10.4.1.2      SquadOrderTypes::Regroup");
+		PROFILE_END("SquadOrderTypes::Regroup");
     }
     else*/ // otherwise, execute micro
     {
         // Nothing to do if we have no units
 		if (!m_units.empty() && m_order.getType() != SquadOrderTypes::Idle)
 		{
-			m_bot.StartProfiling("0.10.4.1.3      SetSquadTargets");
+			PROFILE_BEGIN("SetSquadTargets");
             std::vector<Unit> targets = calcTargets();
 
             m_meleeManager.setTargets(targets);
@@ -107,18 +107,18 @@ void Squad::onFrame()
             //TODO remove the order dependancy
             m_meleeManager.setOrder(m_order);
             m_rangedManager.setOrder(m_order);
-			m_bot.StopProfiling("0.10.4.1.3      SetSquadTargets");
+			PROFILE_END("SetSquadTargets");
 
 #ifdef NO_MICRO
 			return;
 #endif
 			
-			m_bot.StartProfiling("0.10.4.1.4      ExecuteMeleeMicro");
+			PROFILE_BEGIN("ExecuteMeleeMicro");
             m_meleeManager.executeMicro();
-			m_bot.StopProfiling("0.10.4.1.4      ExecuteMeleeMicro");
-			m_bot.StartProfiling("0.10.4.1.5      ExecuteRangedMicro " + m_name);
+			PROFILE_END("ExecuteMeleeMicro");
+			PROFILE_BEGIN("ExecuteRangedMicro");
             m_rangedManager.executeMicro();
-			m_bot.StopProfiling("0.10.4.1.5      ExecuteRangedMicro " + m_name);
+			PROFILE_END("ExecuteRangedMicro");
         }
     }
 
@@ -14,6 +14,8 @@ void TechTree::onStart()
 {
     initUnitTypeData();
     initUpgradeData();
+	initDataTables();
+	initUnitTypeProperties();
 	initBuildingAbilitiesProductionTypes();
     outputJSON("TechTree.json");
 }
@@ -355,6 +357,72 @@ void TechTree::initUpgradeData()
     m_upgradeData[sc2::UPGRADE_ID::ZERGMISSILEWEAPONSLEVEL3] =          { sc2::Race::Zerg, 200, 200, 0, 3520, false, false, false, false, false, false, false, sc2::ABILITY_ID::RESEARCH_ZERGMISSILEWEAPONSLEVEL3, 0, { UnitType(sc2::UNIT_TYPEID::ZERG_EVOLUTIONCHAMBER, m_bot) }, { UnitType(sc2::UNIT_TYPEID::ZERG_HIVE, m_bot) }, {sc2::UPGRADE_ID::ZERGMISSILEWEAPONSLEVEL2} };
 }
 
+void TechTree::initDataTables()
+{
+	// The map nodes never move, so the tables can point directly into them
+	m_unitTypeDataTable.clear();
+	for (const auto & unitTypeData : m_unitTypeData)
+	{
+		const uint32_t typeId = unitTypeData.first.getAPIUnitType();
+		if (typeId >= m_unitTypeDataTable.size())
+			m_unitTypeDataTable.resize(typeId + 1, nullptr);
+		m_unitTypeDataTable[typeId] = &unitTypeData.second;
+	}
+
+	m_upgradeDataTable.clear();
+	for (const auto & upgradeData : m_upgradeData)
+	{
+		const uint32_t upgradeId = upgradeData.first;
+		if (upgradeId >= m_upgradeDataTable.size())
+			m_upgradeDataTable.resize(upgradeId + 1, nullptr);
+		m_upgradeDataTable[upgradeId] = &upgradeData.second;
+	}
+}
+
+void TechTree::initUnitTypeProperties()
+{
+	const auto & unitTypes = m_bot.Observation()->GetUnitTypeData();
+	const auto & abilities = m_bot.Observation()->GetAbilityData();
+	m_unitTypeProperties.assign(unitTypes.size(), UnitTypeProperties());
+	for (size_t typeId = 0; typeId < unitTypes.size(); ++typeId)
+	{
+		const auto & unitTypeData = unitTypes[typeId];
+		auto & properties = m_unitTypeProperties[typeId];
+		properties.race = unitTypeData.race;
+		properties.mineralPrice = (int)unitTypeData.mineral_cost;
+		properties.gasPrice = (int)unitTypeData.vespene_cost;
+		properties.supplyProvided = (int)unitTypeData.food_provided;
+		properties.supplyRequired = (int)unitTypeData.food_required;
+		properties.hasMinerals = unitTypeData.has_minerals;
+		properties.hasVespene = unitTypeData.has_vespene;
+		properties.movementSpeed = unitTypeData.movement_speed;
+		properties.sightRange = unitTypeData.sight_range;
+
+		float weaponRange = Util::GetSpecialCaseRange(sc2::UNIT_TYPEID(typeId));
+		if (weaponRange < 0.f)
+		{
+			for (const auto & weapon : unitTypeData.weapons)
+			{
+				if (weapon.range > weaponRange)
+					weaponRange = weapon.range;
+			}
+		}
+		properties.weaponRange = std::max(0.f, weaponRange);
+
+		// Types unknown to the tech tree behave like the default TypeData (no build ability)
+		sc2::AbilityID buildAbility = 0;
+		if (typeId < m_unitTypeDataTable.size() && m_unitTypeDataTable[typeId])
+		{
+			const auto & typeData = *m_unitTypeDataTable[typeId];
+			properties.isBuilding = typeData.isBuilding;
+			properties.isAddon = typeData.isAddon;
+			buildAbility = typeData.buildAbility;
+		}
+		if (buildAbility < abilities.size())
+			properties.footprintRadius = abilities[buildAbility].footprint_radius;
+	}
+}
+
 void TechTree::initBuildingAbilitiesProductionTypes()
 {
 	for (const auto & unitTypeData : m_unitTypeData)
@@ -371,25 +439,41 @@ void TechTree::initBuildingAbilitiesProductionTypes()
 
 const TypeData & TechTree::getData(const UnitType & type)
 {
-    if (m_unitTypeData.find(type) == m_unitTypeData.end())
-    {
-        std::cout << "WARNING: Unit type not found: " << sc2::UnitTypeToName(type.getAPIUnitType()) << " (" << type.getAPIUnitType() << ")" << "\n";
-		m_unitTypeData[UnitType(sc2::UNIT_TYPEID(type.getAPIUnitType()), m_bot)] = { sc2::Race::Random, 0, 0, 0, 0, true, false, false, false, false, false, false, 0, 0,{ UnitType() },{ UnitType() },{} };
-        return m_unitTypeData[UnitType(sc2::UNIT_TYPEID(type.getAPIUnitType()), m_bot)];
-    }
-
-    return m_unitTypeData.at(type);
+	const uint32_t typeId = type.getAPIUnitType();
+	if (typeId < m_unitTypeDataTable.size() && m_unitTypeDataTable[typeId])
+		return *m_unitTypeDataTable[typeId];
+
+	// The table is not built yet (during initUnitTypeData) or the type is unknown to the tech tree
+	const auto it = m_unitTypeData.find(type);
+	if (it != m_unitTypeData.end())
+		return it->second;
+
+    std::cout << "WARNING: Unit type not found: " << sc2::UnitTypeToName(type.getAPIUnitType()) << " (" << type.getAPIUnitType() << ")" << "\n";
+	auto & data = m_unitTypeData[UnitType(sc2::UNIT_TYPEID(type.getAPIUnitType()), m_bot)];
+	data = { sc2::Race::Random, 0, 0, 0, 0, true, false, false, false, false, false, false, 0, 0,{ UnitType() },{ UnitType() },{} };
+	if (!m_unitTypeDataTable.empty())
+	{
+		if (typeId >= m_unitTypeDataTable.size())
+			m_unitTypeDataTable.resize(typeId + 1, nullptr);
+		m_unitTypeDataTable[typeId] = &data;
+	}
+    return data;
 }
 
 const TypeData & TechTree::getData(const CCUpgrade & type)  const
 {
-    if (m_upgradeData.find(type) == m_upgradeData.end())
+	const uint32_t upgradeId = type;
+	if (upgradeId < m_upgradeDataTable.size() && m_upgradeDataTable[upgradeId])
+		return *m_upgradeDataTable[upgradeId];
+
+    const auto it = m_upgradeData.find(type);
+    if (it == m_upgradeData.end())
     {
         std::cout << "WARNING: Upgrade not found: " << sc2::UpgradeIDToName(type) << "\n";
         return m_unitTypeData.begin()->second;
     }
 
-    return m_upgradeData.at(type);
+    return it->second;
 }
 
 const TypeData & TechTree::getData(const MetaType & type)
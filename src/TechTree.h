@@ -29,15 +29,39 @@ struct TypeData
     std::vector<CCUpgrade>  requiredUpgrades; // having ALL of these is required to make
 };
 
+// Unit type properties read every frame by UnitType, gathered once at startup from the API data
+struct UnitTypeProperties
+{
+    CCRace                  race            = CCRace::Random;
+    int                     mineralPrice    = 0;        // API cost, cumulative for morphed buildings
+    int                     gasPrice        = 0;
+    int                     supplyProvided  = 0;
+    int                     supplyRequired  = 0;
+    bool                    hasMinerals     = false;
+    bool                    hasVespene      = false;
+    bool                    isBuilding      = false;
+    bool                    isAddon         = false;
+    float                   footprintRadius = 0.f;      // footprint of the build ability
+    float                   movementSpeed   = 0.f;
+    float                   sightRange      = 0.f;
+    float                   weaponRange     = 0.f;      // without the unit radius and the range upgrades
+};
+
 class TechTree
 {
     CCBot & m_bot;
     std::map<UnitType, TypeData>  m_unitTypeData;
     std::map<CCUpgrade, TypeData> m_upgradeData;
+	std::vector<const TypeData *> m_unitTypeDataTable;		// indexed by UNIT_TYPEID, points in m_unitTypeData
+	std::vector<const TypeData *> m_upgradeDataTable;		// indexed by UPGRADE_ID, points in m_upgradeData
+	std::vector<UnitTypeProperties> m_unitTypeProperties;	// indexed by UNIT_TYPEID
+	UnitTypeProperties m_defaultUnitTypeProperties;
 	std::map<sc2::UNIT_TYPEID, std::map<sc2::ABILITY_ID, UnitType>> m_buildingAbilitiesProductionTypes;	// <building type, <ability, unit type>>
 
     void initUnitTypeData();
     void initUpgradeData();
+	void initDataTables();
+	void initUnitTypeProperties();
 	void initBuildingAbilitiesProductionTypes();
 
     void outputJSON(const std::string & filename) const;
@@ -50,6 +74,11 @@ public:
     const TypeData & getData(const UnitType & type);
     const TypeData & getData(const CCUpgrade & type) const;
     const TypeData & getData(const MetaType & type);
+	const UnitTypeProperties & getProperties(const sc2::UnitTypeID & type) const
+	{
+		const uint32_t typeId = type;
+		return typeId < m_unitTypeProperties.size() ? m_unitTypeProperties[typeId] : m_defaultUnitTypeProperties;
+	}
 
 	const UnitType & getUnitTypeFromBuildingAbility(sc2::UNIT_TYPEID buildingType, sc2::ABILITY_ID ability);
 };
\ No newline at end of file
@@ -0,0 +1,674 @@
+#include "TerrainAnalysis.h"
+#include "CCBot.h"
+#include "Util.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <sstream>
+
+namespace
+{
+	const char TERRAIN_CACHE_MAGIC[] = "MMTERRAIN";
+	const uint32_t TERRAIN_CACHE_VERSION = 1;		// to increase when the analysis changes, the caches of the previous version are ignored
+	const int TERRAIN_MIN_REGION_TILES = 80;		// smaller basins are merged in their neighbor
+	const float TERRAIN_MIN_REGION_CLEARANCE = 4.f;
+	const float TERRAIN_CHOKE_CLEARANCE_RATIO = 0.7f;	// two regions stay apart where the ground is that much narrower than both of them
+	const float TERRAIN_MIN_SLOPE = 0.1f;
+	const float TERRAIN_MIN_RAMP_HEIGHT = 1.f;		// the levels are 2 apart
+	const int TERRAIN_MAX_CHOKE_GAP = 2;			// tiles farther apart belong to different chokes between the same regions
+	const float TERRAIN_DIAGONAL_DISTANCE = 1.41421356f;
+
+	typedef std::pair<std::pair<int, int>, CCTilePosition> FrontierTile;	// <<region, region>, tile>
+
+	// Largest distance between two tiles, plus the tile itself
+	float GetWidth(const std::vector<CCTilePosition> & tiles)
+	{
+		float width = 0.f;
+		for (size_t i = 0; i < tiles.size(); ++i)
+		{
+			for (size_t j = i + 1; j < tiles.size(); ++j)
+				width = std::max(width, Util::Dist(tiles[i], tiles[j]));
+		}
+		return tiles.empty() ? 0.f : width + 1.f;
+	}
+
+	CCPosition GetCenter(const std::vector<CCTilePosition> & tiles)
+	{
+		CCPosition center;
+		for (const auto & tile : tiles)
+			center += Util::GetPosition(tile);
+		if (!tiles.empty())
+			center /= tiles.size();
+		return center + CCPosition(0.5f, 0.5f);
+	}
+
+	template <class T>
+	void Write(std::ostream & file, const T & value)
+	{
+		file.write(reinterpret_cast<const char *>(&value), sizeof(T));
+	}
+
+	template <class T>
+	bool Read(std::istream & file, T & value)
+	{
+		return bool(file.read(reinterpret_cast<char *>(&value), sizeof(T)));
+	}
+
+	template <class T>
+	void WriteVector(std::ostream & file, const std::vector<T> & values)
+	{
+		Write(file, uint32_t(values.size()));
+		file.write(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+	}
+
+	template <class T>
+	bool ReadVector(std::istream & file, std::vector<T> & values, size_t maxSize)
+	{
+		uint32_t size;
+		if (!Read(file, size) || size > maxSize)
+			return false;
+		values.resize(size);
+		return bool(file.read(reinterpret_cast<char *>(values.data()), size * sizeof(T)));
+	}
+}
+
+TerrainAnalysis::TerrainAnalysis(CCBot & bot)
+	: m_bot(bot)
+{
+}
+
+void TerrainAnalysis::onStart()
+{
+	m_minX = int(m_bot.Map().mapMin().x);
+	m_minY = int(m_bot.Map().mapMin().y);
+	m_width = int(m_bot.Map().mapMax().x) - m_minX;
+	m_height = int(m_bot.Map().mapMax().y) - m_minY;
+	m_mapHash = m_bot.Map().getMapHash();
+
+	const auto path = getCachePath();
+	const bool cached = load(path);
+	if (!cached)
+	{
+		analyze();
+		save(path);
+	}
+
+	int ramps = 0;
+	for (const auto & choke : m_chokes)
+		ramps += choke.ramp;
+	std::stringstream ss;
+	ss << m_regions.size() << " regions, " << m_chokes.size() - ramps << " chokes and " << ramps << " ramps" << (cached ? " (cached)" : "");
+	Util::Log(__FUNCTION__, ss.str(), m_bot);
+}
+
+std::string TerrainAnalysis::getCachePath() const
+{
+	std::stringstream ss;
+	ss << "data/terrain_" << std::hex << m_mapHash << ".bin";
+	return ss.str();
+}
+
+bool TerrainAnalysis::load(const std::string & path)
+{
+	std::ifstream file(path, std::ios::binary);
+	if (!file.good())
+		return false;
+
+	char magic[sizeof(TERRAIN_CACHE_MAGIC)];
+	uint32_t version;
+	uint64_t mapHash;
+	int minX, minY, width, height;
+	if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, TERRAIN_CACHE_MAGIC, sizeof(magic)) != 0
+		|| !Read(file, version) || version != TERRAIN_CACHE_VERSION || !Read(file, mapHash) || mapHash != m_mapHash
+		|| !Read(file, minX) || !Read(file, minY) || !Read(file, width) || !Read(file, height)
+		|| minX != m_minX || minY != m_minY || width != m_width || height != m_height)
+		return false;
+
+	const size_t tileCount = m_width * m_height;
+	bool valid = ReadVector(file, m_tileRegions, tileCount) && ReadVector(file, m_tileRamps, tileCount);
+	uint32_t regionCount = 0;
+	valid = valid && Read(file, regionCount) && regionCount <= tileCount;
+	m_regions.assign(valid ? regionCount : 0, Region());
+	for (auto & region : m_regions)
+	{
+		valid = valid && Read(file, region.id) && Read(file, region.tileCount) && Read(file, region.center.x) && Read(file, region.center.y)
+			&& Read(file, region.clearance) && Read(file, region.height) && ReadVector(file, region.chokes, tileCount);
+	}
+	uint32_t chokeCount = 0;
+	valid = valid && Read(file, chokeCount) && chokeCount <= tileCount;
+	m_chokes.assign(valid ? chokeCount : 0, Choke());
+	for (auto & choke : m_chokes)
+	{
+		uint8_t ramp = 0;
+		valid = valid && Read(file, choke.id) && Read(file, choke.regions[0]) && Read(file, choke.regions[1]) && Read(file, ramp) && ramp <= 1
+			&& Read(file, choke.width) && Read(file, choke.center.x) && Read(file, choke.center.y)
+			&& ReadVector(file, choke.tiles, tileCount) && ReadVector(file, choke.topTiles, tileCount);
+		choke.ramp = ramp != 0;
+	}
+	// The accessors index the regions and the chokes with the stored ids without any check
+	if (!valid || m_tileRegions.size() != tileCount || m_tileRamps.size() != tileCount || !hasValidIds())
+	{
+		m_tileRegions.clear();
+		m_tileRamps.clear();
+		m_regions.clear();
+		m_chokes.clear();
+		return false;
+	}
+	return true;
+}
+
+bool TerrainAnalysis::hasValidIds() const
+{
+	const int regionCount = int(m_regions.size());
+	const int chokeCount = int(m_chokes.size());
+	for (size_t i = 0; i < m_tileRegions.size(); ++i)
+	{
+		if (m_tileRegions[i] < -1 || m_tileRegions[i] >= regionCount || m_tileRamps[i] < -1 || m_tileRamps[i] >= chokeCount)
+			return false;
+	}
+	for (int i = 0; i < regionCount; ++i)
+	{
+		if (m_regions[i].id != i)
+			return false;
+		for (const int chokeId : m_regions[i].chokes)
+		{
+			if (chokeId < 0 || chokeId >= chokeCount)
+				return false;
+		}
+	}
+	for (int i = 0; i < chokeCount; ++i)
+	{
+		const auto & choke = m_chokes[i];
+		if (choke.id != i)
+			return false;
+		for (const int region : choke.regions)
+		{
+			if (region < 0 || region >= regionCount)
+				return false;
+		}
+		for (const auto & tiles : { &choke.tiles, &choke.topTiles })
+		{
+			for (const auto & tile : *tiles)
+			{
+				if (!isInside(tile.x, tile.y))
+					return false;
+			}
+		}
+	}
+	return true;
+}
+
+void TerrainAnalysis::save(const std::string & path) const
+{
+	std::ofstream file(path, std::ios::binary);
+	file.write(TERRAIN_CACHE_MAGIC, sizeof(TERRAIN_CACHE_MAGIC));
+	Write(file, TERRAIN_CACHE_VERSION);
+	Write(file, m_mapHash);
+	Write(file, m_minX);
+	Write(file, m_minY);
+	Write(file, m_width);
+	Write(file, m_height);
+	WriteVector(file, m_tileRegions);
+	WriteVector(file, m_tileRamps);
+	Write(file, uint32_t(m_regions.size()));
+	for (const auto & region : m_regions)
+	{
+		Write(file, region.id);
+		Write(file, region.tileCount);
+		Write(file, region.center.x);
+		Write(file, region.center.y);
+		Write(file, region.clearance);
+		Write(file, region.height);
+		WriteVector(file, region.chokes);
+	}
+	Write(file, uint32_t(m_chokes.size()));
+	for (const auto & choke : m_chokes)
+	{
+		Write(file, choke.id);
+		Write(file, choke.regions[0]);
+		Write(file, choke.regions[1]);
+		Write(file, uint8_t(choke.ramp));
+		Write(file, choke.width);
+		Write(file, choke.center.x);
+		Write(file, choke.center.y);
+		WriteVector(file, choke.tiles);
+		WriteVector(file, choke.topTiles);
+	}
+	if (!file.good())
+		Util::Log(__FUNCTION__, "Could not write the terrain analysis cache " + path, m_bot);
+}
+
+void TerrainAnalysis::analyze()
+{
+	const int tileCount = m_width * m_height;
+	m_tileRegions.assign(tileCount, -1);
+	m_tileRamps.assign(tileCount, -1);
+	m_regions.clear();
+	m_chokes.clear();
+
+	// The ramps are left out of the regions, they become the links between the regions of their two levels
+	std::vector<std::vector<CCTilePosition>> ramps;
+	findRamps(ramps);
+	for (size_t i = 0; i < ramps.size(); ++i)
+	{
+		for (const auto & tile : ramps[i])
+			m_tileRamps[getIndex(tile.x, tile.y)] = int(i);
+	}
+	std::vector<float> clearance;
+	computeClearance(clearance);
+	std::vector<FrontierTile> frontiers;
+	growRegions(clearance, frontiers);
+	m_tileRamps.assign(tileCount, -1);
+
+	for (const auto & rampTiles : ramps)
+	{
+		// The upper region is the one of the highest tile around the ramp, the lower region the one of the lowest
+		int upperRegion = -1;
+		int lowerRegion = -1;
+		float upperHeight = std::numeric_limits<float>::lowest();
+		float lowerHeight = std::numeric_limits<float>::max();
+		for (const auto & tile : rampTiles)
+		{
+			for (int x = tile.x - 1; x <= tile.x + 1; ++x)
+			{
+				for (int y = tile.y - 1; y <= tile.y + 1; ++y)
+				{
+					if (!isInside(x, y) || m_tileRegions[getIndex(x, y)] < 0)
+						continue;
+					const float height = m_bot.Map().terrainHeight(CCTilePosition(x, y));
+					if (height > upperHeight)
+					{
+						upperHeight = height;
+						upperRegion = m_tileRegions[getIndex(x, y)];
+					}
+					if (height < lowerHeight)
+					{
+						lowerHeight = height;
+						lowerRegion = m_tileRegions[getIndex(x, y)];
+					}
+				}
+			}
+		}
+		if (upperRegion < 0 || upperRegion == lowerRegion)
+		{
+			// A slope that does not separate two regions is part of the region around it
+			for (const auto & tile : rampTiles)
+				m_tileRegions[getIndex(tile.x, tile.y)] = upperRegion;
+			if (upperRegion >= 0)
+				m_regions[upperRegion].tileCount += int(rampTiles.size());
+			continue;
+		}
+
+		Choke ramp;
+		ramp.ramp = true;
+		ramp.regions[0] = upperRegion;
+		ramp.regions[1] = lowerRegion;
+		ramp.tiles = rampTiles;
+		for (const auto & tile : rampTiles)
+		{
+			if (!isRampTopTile(tile))
+				continue;
+			for (int i = 0; i < 4; ++i)
+			{
+				const CCTilePosition neighbor(tile.x + (i == 0) - (i == 1), tile.y + (i == 2) - (i == 3));
+				if (isInside(neighbor.x, neighbor.y) && m_bot.Map().isBuildable(neighbor) && m_tileRegions[getIndex(neighbor.x, neighbor.y)] == upperRegion)
+				{
+					ramp.topTiles.push_back(tile);
+					break;
+				}
+			}
+		}
+		ramp.width = GetWidth(ramp.topTiles.empty() ? ramp.tiles : ramp.topTiles);
+		ramp.center = GetCenter(ramp.tiles);
+		addChoke(ramp);
+	}
+
+	// The tiles where two regions met become chokes, one for each group of close tiles
+	std::sort(frontiers.begin(), frontiers.end(), [](const FrontierTile & a, const FrontierTile & b)
+	{
+		if (a.first != b.first)
+			return a.first < b.first;
+		return a.second.y != b.second.y ? a.second.y < b.second.y : a.second.x < b.second.x;
+	});
+	for (size_t begin = 0; begin < frontiers.size();)
+	{
+		size_t end = begin;
+		while (end < frontiers.size() && frontiers[end].first == frontiers[begin].first)
+			++end;
+		std::vector<bool> grouped(end - begin, false);
+		for (size_t i = begin; i < end; ++i)
+		{
+			if (grouped[i - begin])
+				continue;
+			Choke choke;
+			choke.regions[0] = frontiers[i].first.first;
+			choke.regions[1] = frontiers[i].first.second;
+			choke.tiles.push_back(frontiers[i].second);
+			grouped[i - begin] = true;
+			for (size_t next = 0; next < choke.tiles.size(); ++next)
+			{
+				for (size_t j = begin; j < end; ++j)
+				{
+					const auto & tile = frontiers[j].second;
+					if (!grouped[j - begin] && std::abs(tile.x - choke.tiles[next].x) <= TERRAIN_MAX_CHOKE_GAP && std::abs(tile.y - choke.tiles[next].y) <= TERRAIN_MAX_CHOKE_GAP)
+					{
+						grouped[j - begin] = true;
+						choke.tiles.push_back(tile);
+					}
+				}
+			}
+			choke.width = GetWidth(choke.tiles);
+			choke.center = GetCenter(choke.tiles);
+			addChoke(choke);
+		}
+		begin = end;
+	}
+}
+
+void TerrainAnalysis::findRamps(std::vector<std::vector<CCTilePosition>> & ramps) const
+{
+	// The walkable tiles that cannot be built on and that are not at the same height as their neighbors
+	const auto isSlope = [this](int x, int y)
+	{
+		if (!isInside(x, y) || !m_bot.Map().isWalkable(x, y) || m_bot.Map().isBuildable(x, y))
+			return false;
+		const float height = m_bot.Map().terrainHeight(CCTilePosition(x, y));
+		for (int nx = x - 1; nx <= x + 1; ++nx)
+		{
+			for (int ny = y - 1; ny <= y + 1; ++ny)
+			{
+				if (isInside(nx, ny) && m_bot.Map().isWalkable(nx, ny) && std::abs(m_bot.Map().terrainHeight(CCTilePosition(nx, ny)) - height) >= TERRAIN_MIN_SLOPE)
+					return true;
+			}
+		}
+		return false;
+	};
+
+	std::vector<bool> visited(m_width * m_height, false);
+	std::vector<CCTilePosition> slope;
+	for (int y = m_minY; y < m_minY + m_height; ++y)
+	{
+		for (int x = m_minX; x < m_minX + m_width; ++x)
+		{
+			if (visited[getIndex(x, y)] || !isSlope(x, y))
+				continue;
+			slope.clear();
+			slope.push_back(CCTilePosition(x, y));
+			visited[getIndex(x, y)] = true;
+			for (size_t i = 0; i < slope.size(); ++i)
+			{
+				const auto tile = slope[i];
+				for (int nx = tile.x - 1; nx <= tile.x + 1; ++nx)
+				{
+					for (int ny = tile.y - 1; ny <= tile.y + 1; ++ny)
+					{
+						if (isInside(nx, ny) && !visited[getIndex(nx, ny)] && isSlope(nx, ny))
+						{
+							visited[getIndex(nx, ny)] = true;
+							slope.push_back(CCTilePosition(nx, ny));
+						}
+					}
+				}
+			}
+
+			// A ramp joins two levels, the other slopes are bumps of the ground
+			float minHeight = std::numeric_limits<float>::max();
+			float maxHeight = std::numeric_limits<float>::lowest();
+			for (const auto & tile : slope)
+			{
+				for (int nx = tile.x - 1; nx <= tile.x + 1; ++nx)
+				{
+					for (int ny = tile.y - 1; ny <= tile.y + 1; ++ny)
+					{
+						if (!isInside(nx, ny) || !m_bot.Map().isWalkable(nx, ny) || isSlope(nx, ny))
+							continue;
+						const float height = m_bot.Map().terrainHeight(CCTilePosition(nx, ny));
+						minHeight = std::min(minHeight, height);
+						maxHeight = std::max(maxHeight, height);
+					}
+				}
+			}
+			if (maxHeight - minHeight >= TERRAIN_MIN_RAMP_HEIGHT)
+				ramps.push_back(slope);
+		}
+	}
+}
+
+void TerrainAnalysis::computeClearance(std::vector<float> & clearance) const
+{
+	// Chamfer distance to the closest unwalkable tile or ramp, in two passes over the grid
+	clearance.assign(m_width * m_height, 0.f);
+	for (int y = m_minY; y < m_minY + m_height; ++y)
+	{
+		for (int x = m_minX; x < m_minX + m_width; ++x)
+		{
+			if (m_bot.Map().isWalkable(x, y) && m_tileRamps[getIndex(x, y)] < 0)
+				clearance[getIndex(x, y)] = std::numeric_limits<float>::max();
+		}
+	}
+	const auto get = [this, &clearance](int x, int y)
+	{
+		return isInside(x, y) ? clearance[getIndex(x, y)] : 0.f;
+	};
+	for (int y = m_minY; y < m_minY + m_height; ++y)
+	{
+		for (int x = m_minX; x < m_minX + m_width; ++x)
+		{
+			float & distance = clearance[getIndex(x, y)];
+			distance = std::min({ distance, get(x - 1, y) + 1.f, get(x, y - 1) + 1.f, get(x - 1, y - 1) + TERRAIN_DIAGONAL_DISTANCE, get(x + 1, y - 1) + TERRAIN_DIAGONAL_DISTANCE });
+		}
+	}
+	for (int y = m_minY + m_height - 1; y >= m_minY; --y)
+	{
+		for (int x = m_minX + m_width - 1; x >= m_minX; --x)
+		{
+			float & distance = clearance[getIndex(x, y)];
+			distance = std::min({ distance, get(x + 1, y) + 1.f, get(x, y + 1) + 1.f, get(x + 1, y + 1) + TERRAIN_DIAGONAL_DISTANCE, get(x - 1, y + 1) + TERRAIN_DIAGONAL_DISTANCE });
+		}
+	}
+}
+
+void TerrainAnalysis::growRegions(const std::vector<float> & clearance, std::vector<FrontierTile> & frontiers)
+{
+	struct Basin
+	{
+		int parent;
+		int tileCount;
+		float clearance;
+		int center;
+	};
+	std::vector<Basin> basins;
+	const auto find = [&basins](int basin)
+	{
+		while (basins[basin].parent != basin)
+		{
+			basins[basin].parent = basins[basins[basin].parent].parent;
+			basin = basins[basin].parent;
+		}
+		return basin;
+	};
+
+	// The tiles join the basins from the most open to the most narrow
+	std::vector<int> order;
+	for (int i = 0; i < int(clearance.size()); ++i)
+	{
+		if (clearance[i] > 0.f)
+			order.push_back(i);
+	}
+	std::stable_sort(order.begin(), order.end(), [&clearance](int a, int b) { return clearance[a] > clearance[b]; });
+
+	std::vector<int> tileBasins(clearance.size(), -1);
+	std::vector<std::pair<std::pair<int, int>, int>> basinFrontiers;	// <<basin, basin>, tile index>
+	for (const int index : order)
+	{
+		const int x = m_minX + index % m_width;
+		const int y = m_minY + index / m_width;
+		// The tile joins the basin of its most open neighbor, so the tiles where two basins met do not spread along the walls
+		int roots[8];
+		int rootCount = 0;
+		int primary = -1;
+		float primaryClearance = 0.f;
+		for (int nx = x - 1; nx <= x + 1; ++nx)
+		{
+			for (int ny = y - 1; ny <= y + 1; ++ny)
+			{
+				if (!isInside(nx, ny) || tileBasins[getIndex(nx, ny)] < 0)
+					continue;
+				const int root = find(tileBasins[getIndex(nx, ny)]);
+				if (std::find(roots, roots + rootCount, root) == roots + rootCount)
+					roots[rootCount++] = root;
+				if (clearance[getIndex(nx, ny)] > primaryClearance)
+				{
+					primaryClearance = clearance[getIndex(nx, ny)];
+					primary = root;
+				}
+			}
+		}
+		if (rootCount == 0)
+		{
+			tileBasins[index] = int(basins.size());
+			basins.push_back({ int(basins.size()), 1, clearance[index], index });
+			continue;
+		}
+
+		tileBasins[index] = primary;
+		++basins[primary].tileCount;
+		for (int i = 0; i < rootCount; ++i)
+		{
+			int a = find(primary);
+			int b = find(roots[i]);
+			if (a == b)
+				continue;
+			const bool bigBasins = basins[a].tileCount >= TERRAIN_MIN_REGION_TILES && basins[b].tileCount >= TERRAIN_MIN_REGION_TILES
+				&& std::min(basins[a].clearance, basins[b].clearance) >= TERRAIN_MIN_REGION_CLEARANCE;
+			if (bigBasins && clearance[index] < TERRAIN_CHOKE_CLEARANCE_RATIO * std::min(basins[a].clearance, basins[b].clearance))
+			{
+				basinFrontiers.push_back({ { a, b }, index });
+				continue;
+			}
+			if (basins[b].tileCount > basins[a].tileCount)
+				std::swap(a, b);
+			basins[b].parent = a;
+			basins[a].tileCount += basins[b].tileCount;
+			if (basins[b].clearance > basins[a].clearance)
+			{
+				basins[a].clearance = basins[b].clearance;
+				basins[a].center = basins[b].center;
+			}
+		}
+	}
+
+	std::vector<int> basinRegions(basins.size(), -1);
+	for (int index = 0; index < int(tileBasins.size()); ++index)
+	{
+		if (tileBasins[index] < 0)
+			continue;
+		const int root = find(tileBasins[index]);
+		if (basinRegions[root] < 0)
+		{
+			basinRegions[root] = int(m_regions.size());
+			Region region;
+			region.id = int(m_regions.size());
+			region.center = CCTilePosition(m_minX + basins[root].center % m_width, m_minY + basins[root].center / m_width);
+			region.clearance = basins[root].clearance;
+			region.height = m_bot.Map().terrainHeight(region.center);
+			m_regions.push_back(region);
+		}
+		m_tileRegions[index] = basinRegions[root];
+		++m_regions[basinRegions[root]].tileCount;
+	}
+
+	for (const auto & frontier : basinFrontiers)
+	{
+		const int a = basinRegions[find(frontier.first.first)];
+		const int b = basinRegions[find(frontier.first.second)];
+		if (a != b)
+			frontiers.push_back({ { std::min(a, b), std::max(a, b) }, CCTilePosition(m_minX + frontier.second % m_width, m_minY + frontier.second / m_width) });
+	}
+}
+
+void TerrainAnalysis::addChoke(Choke & choke)
+{
+	choke.id = int(m_chokes.size());
+	m_regions[choke.regions[0]].chokes.push_back(choke.id);
+	m_regions[choke.regions[1]].chokes.push_back(choke.id);
+	if (choke.ramp)
+	{
+		for (const auto & tile : choke.tiles)
+			m_tileRamps[getIndex(tile.x, tile.y)] = choke.id;
+	}
+	m_chokes.push_back(choke);
+}
+
+// The tiles at the top of the ramp have one lower diagonal neighbor or two lower adjacent neighbors
+bool TerrainAnalysis::isRampTopTile(const CCTilePosition & tile) const
+{
+	const float tileHeight = m_bot.Map().terrainHeight(tile);
+	int lowerDiagonalNeighbors = 0;
+	int lowerAdjacentNeighbors = 0;
+	for (int x = -1; x <= 1; ++x)
+	{
+		for (int y = -1; y <= 1; ++y)
+		{
+			if (x == 0 && y == 0)
+				continue;
+			const CCTilePosition neighbor(tile.x + x, tile.y + y);
+			if (!m_bot.Map().isWalkable(neighbor))
+				continue;
+			const float heightDiff = tileHeight - m_bot.Map().terrainHeight(neighbor);
+			if ((heightDiff >= 0.24f && heightDiff <= 0.26f) || (heightDiff >= 1.99f && heightDiff <= 2.01f))
+			{
+				if (x != 0 && y != 0)
+					++lowerDiagonalNeighbors;
+				else
+					++lowerAdjacentNeighbors;
+			}
+		}
+	}
+	return lowerDiagonalNeighbors == 1 || lowerAdjacentNeighbors == 2;
+}
+
+int TerrainAnalysis::getRegionId(const CCTilePosition & tile) const
+{
+	return isInside(tile.x, tile.y) && !m_tileRegions.empty() ? m_tileRegions[getIndex(tile.x, tile.y)] : -1;
+}
+
+const TerrainAnalysis::Region * TerrainAnalysis::getRegion(const CCTilePosition & tile) const
+{
+	const int region = getRegionId(tile);
+	return region >= 0 ? &m_regions[region] : nullptr;
+}
+
+const TerrainAnalysis::Choke * TerrainAnalysis::getRamp(const CCTilePosition & tile) const
+{
+	const int ramp = isInside(tile.x, tile.y) && !m_tileRamps.empty() ? m_tileRamps[getIndex(tile.x, tile.y)] : -1;
+	return ramp >= 0 ? &m_chokes[ramp] : nullptr;
+}
+
+std::vector<const TerrainAnalysis::Choke *> TerrainAnalysis::getRampsDown(const CCTilePosition & tile) const
+{
+	std::vector<const Choke *> ramps;
+	const auto region = getRegion(tile);
+	if (!region)
+		return ramps;
+	for (const int chokeId : region->chokes)
+	{
+		const auto & choke = m_chokes[chokeId];
+		if (choke.ramp && choke.regions[0] == region->id)
+			ramps.push_back(&choke);
+	}
+	const CCPosition mapCenter = m_bot.Map().center();
+	std::sort(ramps.begin(), ramps.end(), [&mapCenter](const Choke * a, const Choke * b)
+	{
+		return Util::DistSq(a->center, mapCenter) < Util::DistSq(b->center, mapCenter);
+	});
+	return ramps;
+}
+
+const TerrainAnalysis::Choke * TerrainAnalysis::getMainRamp(const CCTilePosition & baseTile) const
+{
+	const auto ramps = getRampsDown(baseTile);
+	return ramps.empty() ? nullptr : ramps.front();
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Common.h"
+
+class CCBot;
+
+// Decomposition of the ground of the map in regions separated by chokes and ramps, computed once per map.
+// The ramps are the slopes between two levels. The other chokes come from a watershed on the distance to the
+// unwalkable tiles: the regions grow from the widest open areas and two big regions that meet where the ground
+// is much narrower than both of them stay apart, the tiles where they meet being the choke.
+// The result only depends on the terrain so it is cached on disk, keyed by the hash of the terrain grids of the MapTools.
+class TerrainAnalysis
+{
+public:
+
+	struct Region
+	{
+		int id = -1;
+		int tileCount = 0;
+		CCTilePosition center;		// the tile the farthest from the unwalkable tiles
+		float clearance = 0.f;		// distance from the center to the closest unwalkable tile
+		float height = 0.f;			// terrain height at the center
+		std::vector<int> chokes;	// chokes and ramps leading to the neighbor regions
+	};
+
+	struct Choke
+	{
+		int id = -1;
+		int regions[2] = { -1, -1 };	// the upper region first for a ramp
+		bool ramp = false;
+		float width = 0.f;				// in tiles, across the opening
+		CCPosition center;
+		std::vector<CCTilePosition> tiles;		// the tiles of the ramp, or the tiles where the regions meet
+		std::vector<CCTilePosition> topTiles;	// tiles of the ramp next to the buildable tiles of its upper region
+
+		int getOtherRegion(int region) const { return regions[0] == region ? regions[1] : regions[0]; }
+	};
+
+private:
+
+	CCBot & m_bot;
+	int m_minX = 0;
+	int m_minY = 0;
+	int m_width = 0;
+	int m_height = 0;
+	uint64_t m_mapHash = 0;
+	std::vector<int> m_tileRegions;	// indexed by (x - minX) + (y - minY) * width, -1 for unwalkable tiles and ramps
+	std::vector<int> m_tileRamps;	// choke id of the ramp of the tile, else -1
+	std::vector<Region> m_regions;
+	std::vector<Choke> m_chokes;
+
+	int getIndex(int x, int y) const { return (x - m_minX) + (y - m_minY) * m_width; }
+	bool isInside(int x, int y) const { return x >= m_minX && y >= m_minY && x < m_minX + m_width && y < m_minY + m_height; }
+	std::string getCachePath() const;
+	bool load(const std::string & path);
+	// Every region and choke id of a loaded cache is in range
+	bool hasValidIds() const;
+	void save(const std::string & path) const;
+	void analyze();
+	void findRamps(std::vector<std::vector<CCTilePosition>> & ramps) const;
+	void computeClearance(std::vector<float> & clearance) const;
+	void growRegions(const std::vector<float> & clearance, std::vector<std::pair<std::pair<int, int>, CCTilePosition>> & frontiers);
+	void addChoke(Choke & choke);
+	bool isRampTopTile(const CCTilePosition & tile) const;
+
+public:
+
+	TerrainAnalysis(CCBot & bot);
+
+	void onStart();
+
+	const std::vector<Region> & getRegions() const { return m_regions; }
+	const std::vector<Choke> & getChokes() const { return m_chokes; }
+	// -1 for the unwalkable tiles and the tiles of a ramp
+	int getRegionId(const CCTilePosition & tile) const;
+	const Region * getRegion(const CCTilePosition & tile) const;
+	const Choke * getRamp(const CCTilePosition & tile) const;
+	// The ramps going down from the region of the tile, the closest to the center of the map first
+	std::vector<const Choke *> getRampsDown(const CCTilePosition & tile) const;
+	// The main ramp of a starting base, nullptr if its region has no ramp going down
+	const Choke * getMainRamp(const CCTilePosition & baseTile) const;
+};
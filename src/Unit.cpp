@@ -74,7 +74,8 @@ const UnitType & Unit::getType() const
 
 bool Unit::hasAttribute(sc2::Attribute attribute) const
 {
-	const auto & unitData = getUnitData(m_unit->unit_type);
+	// Not from the libvoxelbot mappings, they are initialized on another thread with the combat simulator
+	const auto & unitData = m_bot->Observation()->GetUnitTypeData()[m_unit->unit_type];
 	return Util::Contains(attribute, unitData.attributes);
 }
 
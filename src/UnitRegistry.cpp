@@ -0,0 +1,248 @@
+#include "UnitRegistry.h"
+
+const uint32_t UnitRegistry::INVALID_SLOT;
+
+namespace
+{
+	const size_t INITIAL_TABLE_SIZE = 256;	// must stay a power of 2
+}
+
+UnitRegistry::UnitRegistry()
+	: m_table(INITIAL_TABLE_SIZE, INVALID_SLOT)
+{
+}
+
+size_t UnitRegistry::hashTag(sc2::Tag tag)
+{
+	// Tags are sequential in their low bits, so mix them before masking (MurmurHash3 finalizer)
+	tag ^= tag >> 33;
+	tag *= 0xff51afd7ed558ccdULL;
+	tag ^= tag >> 33;
+	tag *= 0xc4ceb9fe1a85ec53ULL;
+	tag ^= tag >> 33;
+	return size_t(tag);
+}
+
+uint32_t UnitRegistry::getTypeId(const Unit & unit)
+{
+	const auto unitPtr = unit.getUnitPtr();
+	return unitPtr ? uint32_t(unitPtr->unit_type.ToType()) : uint32_t(sc2::UNIT_TYPEID::INVALID);
+}
+
+size_t UnitRegistry::findTableIndex(const sc2::Tag & tag) const
+{
+	const size_t mask = m_table.size() - 1;
+	for (size_t index = hashTag(tag) & mask; m_table[index] != INVALID_SLOT; index = (index + 1) & mask)
+	{
+		if (m_slots[m_table[index]].entry.first == tag)
+			return index;
+	}
+	return m_table.size();
+}
+
+void UnitRegistry::grow()
+{
+	m_table.assign(m_table.size() * 2, INVALID_SLOT);
+	const size_t mask = m_table.size() - 1;
+	for (uint32_t slot = 0; slot < m_slots.size(); ++slot)
+	{
+		if (!m_slots[slot].used)
+			continue;
+		size_t index = hashTag(m_slots[slot].entry.first) & mask;
+		while (m_table[index] != INVALID_SLOT)
+			index = (index + 1) & mask;
+		m_table[index] = slot;
+	}
+}
+
+void UnitRegistry::linkType(uint32_t slot, uint32_t typeId)
+{
+	if (typeId >= m_typeHeads.size())
+	{
+		m_typeHeads.resize(typeId + 1, INVALID_SLOT);
+		m_typeCounts.resize(typeId + 1, 0);
+	}
+	auto & slotData = m_slots[slot];
+	slotData.typeId = typeId;
+	slotData.previousOfType = INVALID_SLOT;
+	slotData.nextOfType = m_typeHeads[typeId];
+	if (slotData.nextOfType != INVALID_SLOT)
+		m_slots[slotData.nextOfType].previousOfType = slot;
+	m_typeHeads[typeId] = slot;
+	++m_typeCounts[typeId];
+}
+
+void UnitRegistry::unlinkType(uint32_t slot)
+{
+	auto & slotData = m_slots[slot];
+	if (slotData.previousOfType != INVALID_SLOT)
+		m_slots[slotData.previousOfType].nextOfType = slotData.nextOfType;
+	else
+		m_typeHeads[slotData.typeId] = slotData.nextOfType;
+	if (slotData.nextOfType != INVALID_SLOT)
+		m_slots[slotData.nextOfType].previousOfType = slotData.previousOfType;
+	slotData.previousOfType = INVALID_SLOT;
+	slotData.nextOfType = INVALID_SLOT;
+	--m_typeCounts[slotData.typeId];
+}
+
+void UnitRegistry::releaseSlot(uint32_t slot)
+{
+	auto & slotData = m_slots[slot];
+	unlinkType(slot);
+	slotData.used = false;
+	slotData.entry = Entry();
+	++slotData.generation;	// invalidates every handle on this slot
+	m_freeSlots.push_back(slot);
+	--m_size;
+}
+
+UnitRegistry::UnitHandle UnitRegistry::insert(const sc2::Tag & tag, const Unit & unit)
+{
+	const auto typeId = getTypeId(unit);
+	const size_t tableIndex = findTableIndex(tag);
+	if (tableIndex != m_table.size())
+	{
+		const uint32_t slot = m_table[tableIndex];
+		auto & slotData = m_slots[slot];
+		slotData.entry.second = unit;
+		if (slotData.typeId != typeId)
+		{
+			unlinkType(slot);
+			linkType(slot, typeId);
+		}
+		return { slot, slotData.generation };
+	}
+
+	// Keep the load factor under 50% so probe sequences stay short
+	if ((m_size + 1) * 2 > m_table.size())
+		grow();
+
+	uint32_t slot;
+	if (!m_freeSlots.empty())
+	{
+		slot = m_freeSlots.back();
+		m_freeSlots.pop_back();
+	}
+	else
+	{
+		slot = uint32_t(m_slots.size());
+		m_slots.emplace_back();
+	}
+	auto & slotData = m_slots[slot];
+	slotData.used = true;
+	slotData.entry.first = tag;
+	slotData.entry.second = unit;
+	linkType(slot, typeId);
+	++m_size;
+
+	const size_t mask = m_table.size() - 1;
+	size_t index = hashTag(tag) & mask;
+	while (m_table[index] != INVALID_SLOT)
+		index = (index + 1) & mask;
+	m_table[index] = slot;
+
+	return { slot, slotData.generation };
+}
+
+bool UnitRegistry::erase(const sc2::Tag & tag)
+{
+	size_t hole = findTableIndex(tag);
+	if (hole == m_table.size())
+		return false;
+
+	releaseSlot(m_table[hole]);
+	m_table[hole] = INVALID_SLOT;
+
+	// Backward shift deletion: move the following entries of the cluster into the hole when their
+	// ideal position is not between the hole and their current position, so no tombstone is needed
+	const size_t mask = m_table.size() - 1;
+	for (size_t index = (hole + 1) & mask; m_table[index] != INVALID_SLOT; index = (index + 1) & mask)
+	{
+		const size_t ideal = hashTag(m_slots[m_table[index]].entry.first) & mask;
+		const bool idealInRange = hole <= index ? (hole < ideal && ideal <= index) : (hole < ideal || ideal <= index);
+		if (!idealInRange)
+		{
+			m_table[hole] = m_table[index];
+			m_table[index] = INVALID_SLOT;
+			hole = index;
+		}
+	}
+	return true;
+}
+
+UnitRegistry::iterator UnitRegistry::erase(iterator it)
+{
+	const auto slot = it.getSlot();
+	erase(m_slots[slot].entry.first);
+	return iterator(&m_slots, slot + 1);
+}
+
+void UnitRegistry::clear()
+{
+	for (uint32_t slot = 0; slot < m_slots.size(); ++slot)
+	{
+		if (m_slots[slot].used)
+			releaseSlot(slot);
+	}
+	std::fill(m_table.begin(), m_table.end(), INVALID_SLOT);
+}
+
+UnitRegistry::iterator UnitRegistry::find(const sc2::Tag & tag)
+{
+	const size_t tableIndex = findTableIndex(tag);
+	return tableIndex == m_table.size() ? end() : iterator(&m_slots, m_table[tableIndex]);
+}
+
+UnitRegistry::const_iterator UnitRegistry::find(const sc2::Tag & tag) const
+{
+	const size_t tableIndex = findTableIndex(tag);
+	return tableIndex == m_table.size() ? end() : const_iterator(&m_slots, m_table[tableIndex]);
+}
+
+bool UnitRegistry::contains(const sc2::Tag & tag) const
+{
+	return findTableIndex(tag) != m_table.size();
+}
+
+Unit * UnitRegistry::getUnit(const sc2::Tag & tag)
+{
+	const size_t tableIndex = findTableIndex(tag);
+	return tableIndex == m_table.size() ? nullptr : &m_slots[m_table[tableIndex]].entry.second;
+}
+
+const Unit * UnitRegistry::getUnit(const sc2::Tag & tag) const
+{
+	const size_t tableIndex = findTableIndex(tag);
+	return tableIndex == m_table.size() ? nullptr : &m_slots[m_table[tableIndex]].entry.second;
+}
+
+UnitRegistry::UnitHandle UnitRegistry::getHandle(const sc2::Tag & tag) const
+{
+	const size_t tableIndex = findTableIndex(tag);
+	if (tableIndex == m_table.size())
+		return {};
+	const uint32_t slot = m_table[tableIndex];
+	return { slot, m_slots[slot].generation };
+}
+
+bool UnitRegistry::isAlive(const UnitHandle & handle) const
+{
+	return handle.slot < m_slots.size() && m_slots[handle.slot].used && m_slots[handle.slot].generation == handle.generation;
+}
+
+Unit * UnitRegistry::getUnit(const UnitHandle & handle)
+{
+	return isAlive(handle) ? &m_slots[handle.slot].entry.second : nullptr;
+}
+
+const Unit * UnitRegistry::getUnit(const UnitHandle & handle) const
+{
+	return isAlive(handle) ? &m_slots[handle.slot].entry.second : nullptr;
+}
+
+size_t UnitRegistry::countOfType(sc2::UNIT_TYPEID type) const
+{
+	const auto typeId = uint32_t(type);
+	return typeId < m_typeCounts.size() ? m_typeCounts[typeId] : 0;
+}
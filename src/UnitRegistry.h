@@ -0,0 +1,124 @@
+#pragma once
+
+#include "Common.h"
+#include "Unit.h"
+
+// Dense tag -> Unit storage used by CCBot for the ally, enemy and neutral units.
+// Units live in stable slots found through an open-addressing hash table on their tag.
+// Slots of the same unit type are chained in an intrusive list and each slot has a generation
+// counter, so a UnitHandle kept by a manager can detect that its unit died and the slot was reused.
+// Iteration gives entries with the same first (tag) / second (unit) members as the std::map it replaces.
+class UnitRegistry
+{
+public:
+
+	static const uint32_t INVALID_SLOT = 0xFFFFFFFF;
+
+	struct Entry
+	{
+		sc2::Tag first = 0;
+		Unit second;
+	};
+
+	struct UnitHandle
+	{
+		uint32_t slot = INVALID_SLOT;
+		uint32_t generation = 0;
+
+		bool isValid() const { return slot != INVALID_SLOT; }
+	};
+
+private:
+
+	struct Slot
+	{
+		Entry entry;
+		uint32_t generation = 0;
+		uint32_t typeId = 0;
+		uint32_t previousOfType = INVALID_SLOT;
+		uint32_t nextOfType = INVALID_SLOT;
+		bool used = false;
+	};
+
+	std::vector<Slot> m_slots;
+	std::vector<uint32_t> m_freeSlots;
+	std::vector<uint32_t> m_table;			// open-addressing (linear probing) table of slot indices
+	std::vector<uint32_t> m_typeHeads;		// first slot of each unit type, indexed by UNIT_TYPEID
+	std::vector<uint32_t> m_typeCounts;		// number of used slots of each unit type, indexed by UNIT_TYPEID
+	size_t m_size = 0;
+
+	static size_t hashTag(sc2::Tag tag);
+	static uint32_t getTypeId(const Unit & unit);
+	size_t findTableIndex(const sc2::Tag & tag) const;
+	void grow();
+	void linkType(uint32_t slot, uint32_t typeId);
+	void unlinkType(uint32_t slot);
+	void releaseSlot(uint32_t slot);
+
+	template <typename SlotsType, typename EntryType>
+	class IteratorBase
+	{
+		SlotsType * m_slots;
+		size_t m_index;
+
+		void skipUnused()
+		{
+			while (m_index < m_slots->size() && !(*m_slots)[m_index].used)
+				++m_index;
+		}
+
+	public:
+
+		IteratorBase(SlotsType * slots, size_t index) : m_slots(slots), m_index(index) { skipUnused(); }
+		EntryType & operator*() const { return (*m_slots)[m_index].entry; }
+		EntryType * operator->() const { return &(*m_slots)[m_index].entry; }
+		IteratorBase & operator++() { ++m_index; skipUnused(); return *this; }
+		bool operator==(const IteratorBase & rhs) const { return m_index == rhs.m_index; }
+		bool operator!=(const IteratorBase & rhs) const { return m_index != rhs.m_index; }
+		uint32_t getSlot() const { return uint32_t(m_index); }
+	};
+
+public:
+
+	typedef IteratorBase<std::vector<Slot>, Entry> iterator;
+	typedef IteratorBase<const std::vector<Slot>, const Entry> const_iterator;
+
+	UnitRegistry();
+
+	// Inserts the unit or replaces the one already stored for this tag (relinking it if its type changed)
+	UnitHandle insert(const sc2::Tag & tag, const Unit & unit);
+	bool erase(const sc2::Tag & tag);
+	iterator erase(iterator it);
+	void clear();
+
+	iterator find(const sc2::Tag & tag);
+	const_iterator find(const sc2::Tag & tag) const;
+	bool contains(const sc2::Tag & tag) const;
+	Unit * getUnit(const sc2::Tag & tag);
+	const Unit * getUnit(const sc2::Tag & tag) const;
+
+	// Handles stay valid until the unit is erased from the registry, a stale handle returns nullptr
+	UnitHandle getHandle(const sc2::Tag & tag) const;
+	bool isAlive(const UnitHandle & handle) const;
+	Unit * getUnit(const UnitHandle & handle);
+	const Unit * getUnit(const UnitHandle & handle) const;
+
+	size_t size() const { return m_size; }
+	bool empty() const { return m_size == 0; }
+	size_t countOfType(sc2::UNIT_TYPEID type) const;
+
+	iterator begin() { return iterator(&m_slots, 0); }
+	iterator end() { return iterator(&m_slots, m_slots.size()); }
+	const_iterator begin() const { return const_iterator(&m_slots, 0); }
+	const_iterator end() const { return const_iterator(&m_slots, m_slots.size()); }
+
+	template <typename Func>
+	void forEachOfType(sc2::UNIT_TYPEID type, Func func) const
+	{
+		const auto typeId = uint32_t(type);
+		if (typeId >= m_typeHeads.size())
+			return;
+		for (uint32_t slot = m_typeHeads[typeId]; slot != INVALID_SLOT; slot = m_slots[slot].nextOfType)
+			func(m_slots[slot].entry.second);
+	}
+};
@@ -56,7 +56,7 @@ std::string UnitType::getName() const
 
 CCRace UnitType::getRace() const
 {
-    return m_bot->Observation()->GetUnitTypeData()[m_type].race;
+    return m_bot->Tech().getProperties(m_type).race;
 }
 
 bool UnitType::isCombatUnit() const
@@ -232,8 +232,7 @@ bool UnitType::isDetector() const
 
 bool UnitType::isGeyser() const
 {
-	sc2::UnitTypeData unitTypeData(m_bot->Observation()->GetUnitTypeData()[m_type]);
-	if (unitTypeData.has_vespene)
+	if (m_bot->Tech().getProperties(m_type).hasVespene)
 		return true;
     switch (m_type.ToType()) 
     {
@@ -251,8 +250,7 @@ bool UnitType::isGeyser() const
 
 bool UnitType::isMineral() const
 {
-	sc2::UnitTypeData unitTypeData(m_bot->Observation()->GetUnitTypeData()[m_type]);
-	if (unitTypeData.has_minerals)
+	if (m_bot->Tech().getProperties(m_type).hasMinerals)
 		return true;
 	switch (m_type.ToType())
 	{
@@ -279,8 +277,7 @@ bool UnitType::isMineral() const
 
 bool UnitType::isStandardMineral() const
 {
-	sc2::UnitTypeData unitTypeData(m_bot->Observation()->GetUnitTypeData()[m_type]);
-	if (!unitTypeData.has_minerals)
+	if (!m_bot->Tech().getProperties(m_type).hasMinerals)
 		return false;
 	switch (m_type.ToType())
 	{
@@ -301,8 +298,7 @@ bool UnitType::isStandardMineral() const
 
 bool UnitType::isRichMineral() const
 {
-	sc2::UnitTypeData unitTypeData(m_bot->Observation()->GetUnitTypeData()[m_type]);
-	if (!unitTypeData.has_minerals)
+	if (!m_bot->Tech().getProperties(m_type).hasMinerals)
 		return false;
 	switch (m_type.ToType())
 	{
@@ -351,7 +347,11 @@ bool UnitType::isCreepTumor() const
  */
 CCPositionType UnitType::getAttackRange() const
 {
-    return Util::GetMaxAttackRange(m_bot->Observation()->GetUnitTypeData()[m_type], *m_bot);
+	// Same as Util::GetMaxAttackRange(sc2::UnitTypeData, CCBot) but without copying the type data
+	const float weaponRange = m_bot->Tech().getProperties(m_type).weaponRange;
+	if (weaponRange <= 0.f)
+		return 0.f;
+    return std::max(0.f, weaponRange + Util::GetAttackRangeBonus(m_type, *m_bot));
 }
 
 float UnitType::radius() const
@@ -360,7 +360,7 @@ float UnitType::radius() const
 	if (isGeyser()) { return 1.8125f; }//Same as a Barrack
 	if (isAddon()) { return 1.25f; }//Same as supply depot
 	if (m_type == sc2::UNIT_TYPEID::TERRAN_AUTOTURRET) { return 1; }
-	else { return m_bot->Observation()->GetAbilityData()[m_bot->Data(*this).buildAbility].footprint_radius; }
+	else { return m_bot->Tech().getProperties(m_type).footprintRadius; }
 }
 
 int UnitType::tileWidth() const
@@ -369,7 +369,7 @@ int UnitType::tileWidth() const
     if (isGeyser()) { return 3; }
 	if (isAddon()) { return 2; }
 	if (m_type == sc2::UNIT_TYPEID::TERRAN_AUTOTURRET) { return 2; }
-    else { return (int)(2 * m_bot->Observation()->GetAbilityData()[m_bot->Data(*this).buildAbility].footprint_radius); }
+    else { return (int)(2 * m_bot->Tech().getProperties(m_type).footprintRadius); }
 }
 
 int UnitType::tileHeight() const
@@ -378,39 +378,39 @@ int UnitType::tileHeight() const
     if (isGeyser()) { return 3; }
 	if (isAddon()) { return 2; }
 	if (m_type == sc2::UNIT_TYPEID::TERRAN_AUTOTURRET) { return 2; }
-    else { return (int)(2 * m_bot->Observation()->GetAbilityData()[m_bot->Data(*this).buildAbility].footprint_radius); }
+    else { return (int)(2 * m_bot->Tech().getProperties(m_type).footprintRadius); }
 }
 
 bool UnitType::isAddon() const
 {
-    return m_bot->Data(*this).isAddon;
+    return m_bot->Tech().getProperties(m_type).isAddon;
 }
 
 bool UnitType::isBuilding() const
 {
-	return m_bot->Data(*this).isBuilding;
+	return m_bot->Tech().getProperties(m_type).isBuilding;
 }
 
 int UnitType::supplyProvided() const
 {
-    return (int)m_bot->Observation()->GetUnitTypeData()[m_type].food_provided;
+    return m_bot->Tech().getProperties(m_type).supplyProvided;
 }
 
 int UnitType::supplyRequired() const
 {
-    return (int)m_bot->Observation()->GetUnitTypeData()[m_type].food_required;
+    return m_bot->Tech().getProperties(m_type).supplyRequired;
 }
 
 int UnitType::mineralPrice() const
 {
 	BOT_ASSERT(m_type != 0, "Invalid type id");
-    return (int)m_bot->Observation()->GetUnitTypeData()[m_type].mineral_cost;
+    return m_bot->Tech().getProperties(m_type).mineralPrice;
 }
 
 int UnitType::gasPrice() const
 {
 	BOT_ASSERT(m_type != 0, "Invalid type id");
-    return (int)m_bot->Observation()->GetUnitTypeData()[m_type].vespene_cost;
+    return m_bot->Tech().getProperties(m_type).gasPrice;
 }
 
 UnitType UnitType::GetUnitTypeFromName(const std::string & name, CCBot & bot)
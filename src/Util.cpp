@@ -1,16 +1,20 @@
 #include "Util.h"
 #include "CCBot.h"
+#include "Logger.h"
 #include "libvoxelbot/combat/combat_upgrades.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 const float EPSILON = 1e-5;
 const float CLIFF_MIN_HEIGHT_DIFFERENCE = 1.f;
 const float CLIFF_MAX_HEIGHT_DIFFERENCE = 2.5f;
 const int HARASS_PATHFINDING_MAX_EXPLORED_NODE = 500;
-const float HARASS_PATHFINDING_TILE_BASE_COST = 1.f;
-const float HARASS_PATHFINDING_TILE_CREEP_COST = 0.5f;
 const float PATHFINDING_TURN_COST = 3.f;
 const float PATHFINDING_SECONDARY_GOAL_HEURISTIC_MULTIPLIER = 5.f;	// Previously equal to 10, created problems with Cyclones that are kiting away from our main
 const float HARASS_PATHFINDING_HEURISTIC_MULTIPLIER = 1.f;
+const int JUMP_POINT_SEARCH_MAX_JUMP_DISTANCE = 20;
+const size_t PATHFINDING_BENCHMARK_MAX_QUERIES = 500;
 const uint32_t WORKER_PATHFINDING_CACHE_DURATION = 50;
 const uint32_t ARMY_UNIT_PATHFINDING_CACHE_DURATION = 1;
 const uint32_t OPTIMAL_PATH_DISTANCE_CACHE_DURATION = 50;
@@ -18,6 +22,8 @@ const uint32_t UNIT_CLUSTERING_COOLDOWN = 24;
 const float UNIT_CLUSTERING_MAX_DISTANCE = 5.f;
 
 int timeControlRatio = -1;
+std::atomic<bool> combatSimulatorStarted(false);
+std::atomic<bool> combatSimulatorReady(false);	// m_simulator and the libvoxelbot mappings can be used once it is set
 
 // Influence Map Node
 struct Util::PathFinding::IMNode
@@ -59,6 +65,7 @@ struct Util::PathFinding::IMNode
 	float cost;
 	float heuristic;
 	float influence;
+	bool jumped = false;	// the parent is more than one tile away (Jump Point Search)
 
 	float getTotalCost() const
 	{
@@ -183,10 +190,26 @@ void Util::Initialize(CCBot & bot, CCRace race, const sc2::GameInfo & _gameInfo)
 
 void Util::InitializeCombatSimulator()
 {
+	if (combatSimulatorReady.load(std::memory_order_acquire))
+		return;
 	initMappings();
 	m_simulator = new CombatPredictor();
 	m_simulator->init();
 	m_simulator->getCombatEnvironment({}, {});
+	combatSimulatorReady.store(true, std::memory_order_release);
+}
+
+void Util::StartCombatSimulatorInitialization()
+{
+	// Building the default combat environment takes long enough to stall a frame, nothing else touches the simulator until it is ready
+	if (combatSimulatorStarted.exchange(true))
+		return;
+	std::thread(&Util::InitializeCombatSimulator).detach();
+}
+
+bool Util::IsCombatSimulatorReady()
+{
+	return combatSimulatorReady.load(std::memory_order_acquire);
 }
 
 Util::PathFinding::IMNode* getLowestCostNode(std::set<Util::PathFinding::IMNode*> & set)
@@ -435,6 +458,244 @@ CCPosition Util::PathFinding::FindOptimalPathToDodgeEffectAwayFromGoal(const sc2
 	return GetCommandPositionFromPath(path, unit, true, bot);
 }
 
+namespace
+{
+	struct JumpContext
+	{
+		const sc2::Unit * unit;
+		CCBot * bot;
+		const HierarchicalPathfinding::Corridor * corridor;
+		CCPosition goal;
+		float goalRange;			// the exit conditions must be checked on every tile that close to the goal
+		bool considerInfluence;
+		CCPosition mapMin;
+		CCPosition mapMax;
+		std::map<int, bool> clearTiles;
+	};
+
+	// A recorded FindOptimalPath query, replayed by RunPathfindingBenchmark at the end of the frame it was recorded in
+	struct PathfindingBenchmarkQuery
+	{
+		sc2::Unit unit;
+		CCPosition goal;
+		CCPosition secondaryGoal;
+		float maxRange;
+		bool exitOnInfluence;
+		bool considerOnlyEffects;
+		bool getCloser;
+		bool ignoreInfluence;
+		float maxInfluence;
+		bool flee;
+		bool checkVisibility;
+		bool limitSearch;
+	};
+
+	// Totals of the replays, logged at the end of the game
+	struct PathfindingBenchmarkTotals
+	{
+		size_t queryCount = 0;
+		size_t exploredNodes[2] = { 0, 0 };
+		long long durations[2] = { 0, 0 };
+		float pathLengths[2] = { 0.f, 0.f };
+		size_t differentResults = 0;
+	};
+
+	bool useJumpPointSearch = true;
+	thread_local size_t exploredNodeCount = 0;		// per thread, the micro threads search concurrently
+	bool pathfindingBenchmarkRunning = false;
+	std::mutex pathfindingBenchmarkMutex;			// the micro threads record their queries concurrently
+	std::vector<PathfindingBenchmarkQuery> pathfindingBenchmarkQueries;	// of the current frame
+	PathfindingBenchmarkTotals pathfindingBenchmarkTotals;
+
+	// Same checks as GetNeighborNodePosition for units that cannot jump cliffs, with the hierarchical corridor acting as walls
+	bool IsJumpPassable(int x, int y, const JumpContext & context)
+	{
+		if (x < context.mapMin.x || y < context.mapMin.y || x >= context.mapMax.x || y >= context.mapMax.y)
+			return false;
+		const CCTilePosition tile(x, y);
+		if (!context.unit->is_flying && (context.bot->Commander().Combat().getBlockedTiles()[x][y] || !context.bot->Map().isWalkable(tile)))
+			return false;
+		return !context.corridor || context.corridor->getStep(tile) != nullptr;
+	}
+
+	bool IsUniformJumpTile(int x, int y, const JumpContext & context)
+	{
+		if (!IsJumpPassable(x, y, context))
+			return false;
+		const CCTilePosition tile(x, y);
+		if (!context.unit->is_flying && context.bot->Observation()->HasCreep(Util::GetPosition(tile)))
+			return false;
+		return !context.considerInfluence || Util::PathFinding::GetTotalInfluenceOnTile(tile, context.unit, *context.bot) == 0.f;
+	}
+
+	// A tile is clear when it is uniform, its neighbors are either uniform or impassable and it is not close to the goal
+	bool IsClearJumpTile(const CCTilePosition & tile, JumpContext & context)
+	{
+		const int tag = tile.x * 1000 + tile.y;
+		const auto it = context.clearTiles.find(tag);
+		if (it != context.clearTiles.end())
+			return it->second;
+
+		bool clear = Util::Dist(Util::GetPosition(tile) + CCPosition(0.5f, 0.5f), context.goal) >= context.goalRange;
+		for (int x = -1; clear && x <= 1; ++x)
+		{
+			for (int y = -1; clear && y <= 1; ++y)
+			{
+				const bool center = x == 0 && y == 0;
+				if (center ? !IsUniformJumpTile(tile.x, tile.y, context) : IsJumpPassable(tile.x + x, tile.y + y, context) && !IsUniformJumpTile(tile.x + x, tile.y + y, context))
+					clear = false;
+			}
+		}
+		context.clearTiles[tag] = clear;
+		return clear;
+	}
+
+	// Natural and forced neighbors of the Jump Point Search, every direction for the first node
+	void GetJumpPointSearchDirections(const Util::PathFinding::IMNode * node, const JumpContext & context, std::vector<std::pair<int, int>> & directions)
+	{
+		if (node->parent == nullptr)
+		{
+			for (int x = -1; x <= 1; ++x)
+			{
+				for (int y = -1; y <= 1; ++y)
+				{
+					if (x != 0 || y != 0)
+						directions.push_back({ x, y });
+				}
+			}
+			return;
+		}
+		const int x = node->position.x;
+		const int y = node->position.y;
+		const int dx = (x > node->parent->position.x) - (x < node->parent->position.x);
+		const int dy = (y > node->parent->position.y) - (y < node->parent->position.y);
+		if (dx != 0 && dy != 0)
+		{
+			directions.push_back({ dx, 0 });
+			directions.push_back({ 0, dy });
+			directions.push_back({ dx, dy });
+			if (!IsJumpPassable(x - dx, y, context))
+				directions.push_back({ -dx, dy });
+			if (!IsJumpPassable(x, y - dy, context))
+				directions.push_back({ dx, -dy });
+		}
+		else if (dx != 0)
+		{
+			directions.push_back({ dx, 0 });
+			if (!IsJumpPassable(x, y + 1, context))
+				directions.push_back({ dx, 1 });
+			if (!IsJumpPassable(x, y - 1, context))
+				directions.push_back({ dx, -1 });
+		}
+		else
+		{
+			directions.push_back({ 0, dy });
+			if (!IsJumpPassable(x + 1, y, context))
+				directions.push_back({ 1, dy });
+			if (!IsJumpPassable(x - 1, y, context))
+				directions.push_back({ -1, dy });
+		}
+	}
+
+	// Moves in the direction until a tile that is not clear, a tile with a forced neighbor or the maximum jump distance
+	bool FindJumpPoint(const CCTilePosition & from, int dx, int dy, JumpContext & context, CCTilePosition & jumpPoint, bool stopAtMaxDistance = true)
+	{
+		CCTilePosition current = from;
+		for (int distance = 0; distance < JUMP_POINT_SEARCH_MAX_JUMP_DISTANCE; ++distance)
+		{
+			const CCTilePosition next(current.x + dx, current.y + dy);
+			if (!IsJumpPassable(next.x, next.y, context))
+				return false;	// dead end
+			if (!IsClearJumpTile(next, context))
+			{
+				jumpPoint = next;	// the regular expansion takes over from there
+				return true;
+			}
+			bool forcedNeighbor;
+			if (dx != 0 && dy != 0)
+			{
+				forcedNeighbor = (!IsJumpPassable(next.x - dx, next.y, context) && IsJumpPassable(next.x - dx, next.y + dy, context))
+					|| (!IsJumpPassable(next.x, next.y - dy, context) && IsJumpPassable(next.x + dx, next.y - dy, context));
+				CCTilePosition straightJumpPoint;
+				forcedNeighbor = forcedNeighbor || FindJumpPoint(next, dx, 0, context, straightJumpPoint, false) || FindJumpPoint(next, 0, dy, context, straightJumpPoint, false);
+			}
+			else if (dx != 0)
+			{
+				forcedNeighbor = (!IsJumpPassable(next.x, next.y + 1, context) && IsJumpPassable(next.x + dx, next.y + 1, context))
+					|| (!IsJumpPassable(next.x, next.y - 1, context) && IsJumpPassable(next.x + dx, next.y - 1, context));
+			}
+			else
+			{
+				forcedNeighbor = (!IsJumpPassable(next.x + 1, next.y, context) && IsJumpPassable(next.x + 1, next.y + dy, context))
+					|| (!IsJumpPassable(next.x - 1, next.y, context) && IsJumpPassable(next.x - 1, next.y + dy, context));
+			}
+			if (forcedNeighbor)
+			{
+				jumpPoint = next;
+				return true;
+			}
+			current = next;
+		}
+		jumpPoint = current;
+		return stopAtMaxDistance;
+	}
+}
+
+void Util::PathFinding::RunPathfindingBenchmark(CCBot & bot)
+{
+	if (pathfindingBenchmarkQueries.empty())
+		return;
+
+	// Replay the queries recorded during this frame with and without the Jump Point Search, the influence maps are still the
+	// ones the queries were made with. The micro threads are done so the queries do not need the lock anymore.
+	pathfindingBenchmarkRunning = true;
+	auto & totals = pathfindingBenchmarkTotals;
+	auto & exploredNodes = totals.exploredNodes;
+	auto & durations = totals.durations;
+	auto & pathLengths = totals.pathLengths;
+	for (auto & query : pathfindingBenchmarkQueries)
+	{
+		size_t pathSizes[2];
+		for (int jps = 0; jps < 2; ++jps)
+		{
+			useJumpPointSearch = jps == 1;
+			exploredNodeCount = 0;
+			FailureReason failureReason;
+			const auto startTime = std::chrono::steady_clock::now();
+			const auto path = FindOptimalPath(&query.unit, query.goal, query.secondaryGoal, query.maxRange, query.exitOnInfluence, query.considerOnlyEffects, query.getCloser, query.ignoreInfluence, query.maxInfluence, query.flee, query.checkVisibility, query.limitSearch, failureReason, bot);
+			durations[jps] += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+			exploredNodes[jps] += exploredNodeCount;
+			pathSizes[jps] = path.size();
+			CCPosition lastPosition;
+			for (const auto & position : path)
+			{
+				if (lastPosition != CCPosition())
+					pathLengths[jps] += Dist(lastPosition, position);
+				lastPosition = position;
+			}
+		}
+		if ((pathSizes[0] == 0) != (pathSizes[1] == 0))
+			++totals.differentResults;
+	}
+	useJumpPointSearch = true;
+	pathfindingBenchmarkRunning = false;
+	totals.queryCount += pathfindingBenchmarkQueries.size();
+	pathfindingBenchmarkQueries.clear();
+}
+
+void Util::PathFinding::LogPathfindingBenchmark(CCBot & bot)
+{
+	const auto & totals = pathfindingBenchmarkTotals;
+	if (totals.queryCount == 0)
+		return;
+
+	std::stringstream ss;
+	ss << totals.queryCount << " queries on " << GetMapName() << ", regular search: " << totals.exploredNodes[0] << " explored nodes, " << totals.durations[0] << "us, path length " << totals.pathLengths[0]
+		<< " | jump point search: " << totals.exploredNodes[1] << " explored nodes, " << totals.durations[1] << "us, path length " << totals.pathLengths[1]
+		<< " | " << totals.differentResults << " queries found a path with only one of the searches";
+	Util::Log(__FUNCTION__, ss.str(), bot);
+}
+
 std::list<CCPosition> Util::PathFinding::FindOptimalPathWithoutLimit(const sc2::Unit * unit, CCPosition goal, CCBot & bot)
 {
 	FailureReason failureReason;
@@ -448,13 +709,44 @@ std::list<CCPosition> Util::PathFinding::FindOptimalPath(const sc2::Unit * unit,
 }
 
 std::list<CCPosition> Util::PathFinding::FindOptimalPath(const sc2::Unit * unit, CCPosition goal, CCPosition secondaryGoal, float maxRange, bool exitOnInfluence, bool considerOnlyEffects, bool getCloser, bool ignoreInfluence, float maxInfluence, bool flee, bool checkVisibility, bool limitSearch, FailureReason & failureReason, CCBot & bot)
+{
+	if (bot.Config().BenchmarkPathfinding && !pathfindingBenchmarkRunning)
+	{
+		std::lock_guard<std::mutex> lock(pathfindingBenchmarkMutex);
+		if (pathfindingBenchmarkTotals.queryCount + pathfindingBenchmarkQueries.size() < PATHFINDING_BENCHMARK_MAX_QUERIES)
+			pathfindingBenchmarkQueries.push_back({ *unit, goal, secondaryGoal, maxRange, exitOnInfluence, considerOnlyEffects, getCloser, ignoreInfluence, maxInfluence, flee, checkVisibility, limitSearch });
+	}
+
+	// Ground paths going to another cluster are guided by the hierarchical abstraction, so the tile search follows the abstract
+	// path instead of exploring every tile between the unit and the goal (reapers are excluded since they can jump cliffs)
+	if (!unit->is_flying && !flee && unit->unit_type != sc2::UNIT_TYPEID::TERRAN_REAPER)
+	{
+		HierarchicalPathfinding::Corridor corridor;
+		if (bot.Map().getHierarchicalPathfinding().findCorridor(GetTilePosition(unit->pos), GetTilePosition(goal), corridor))
+		{
+			FailureReason corridorFailureReason = TIMEOUT;
+			auto path = FindOptimalPath(unit, goal, secondaryGoal, maxRange, exitOnInfluence, considerOnlyEffects, getCloser, ignoreInfluence, maxInfluence, flee, checkVisibility, limitSearch, &corridor, corridorFailureReason, bot);
+			// Only the failures caused by the corridor itself go to the complete search: the search timed out in the corridor or could
+			// not reach a goal outside of it. Influence or a goal unreachable from inside the corridor fail the same way on the whole map.
+			const bool goalInCorridor = corridor.getHeuristic(GetTilePosition(goal)) >= 0.f;
+			if (!path.empty() || (corridorFailureReason != TIMEOUT && (corridorFailureReason != UNREACHABLE || goalInCorridor)))
+			{
+				failureReason = corridorFailureReason;
+				return path;
+			}
+		}
+	}
+	return FindOptimalPath(unit, goal, secondaryGoal, maxRange, exitOnInfluence, considerOnlyEffects, getCloser, ignoreInfluence, maxInfluence, flee, checkVisibility, limitSearch, nullptr, failureReason, bot);
+}
+
+std::list<CCPosition> Util::PathFinding::FindOptimalPath(const sc2::Unit * unit, CCPosition goal, CCPosition secondaryGoal, float maxRange, bool exitOnInfluence, bool considerOnlyEffects, bool getCloser, bool ignoreInfluence, float maxInfluence, bool flee, bool checkVisibility, bool limitSearch, const HierarchicalPathfinding::Corridor * corridor, FailureReason & failureReason, CCBot & bot)
 {
 	std::list<CCPosition> path;
 	std::set<IMNode*> opened;
 	std::set<IMNode*> closed;
 	std::map<int, float> bestCosts;
 
-	const auto maxExploredNode = HARASS_PATHFINDING_MAX_EXPLORED_NODE * (!limitSearch ? 20 : exitOnInfluence ? 5 : bot.Config().TournamentMode ? 3 : 1);
+	const auto maxExploredNode = size_t(HARASS_PATHFINDING_MAX_EXPLORED_NODE * (!limitSearch ? 20 : exitOnInfluence ? 5 : bot.Config().TournamentMode ? 3 : 1) * bot.Latency().getPathfindingNodeRatio());
 	int numberOfTilesExploredAfterPathFound = 0;	//only used when getCloser is true
 	IMNode* closestNode = nullptr;					//only used when getCloser is true
 	IMNode* exitNode = nullptr;						//only used when getCloser and maxInfluence are true
@@ -468,6 +760,46 @@ std::list<CCPosition> Util::PathFinding::FindOptimalPath(const sc2::Unit * unit,
 	bestCosts[start->getTag()] = 0;
 	opened.insert(start);
 
+	const auto getNodeFacingVector = [&](const IMNode * node) -> CCPosition
+	{
+		if (node->parent == nullptr)
+			return getFacingVector(unit);
+		const auto facingVector = GetPosition(node->position) - GetPosition(node->parent->position);
+		if (!node->jumped)
+			return facingVector;
+		// The parent of a jump point is far away, only the direction matters
+		return CCPosition(float((facingVector.x > 0) - (facingVector.x < 0)), float((facingVector.y > 0) - (facingVector.y < 0)));
+	};
+	const auto getStepCost = [&](const CCTilePosition & from, const CCPosition & facingVector, const CCTilePosition & to)
+	{
+		const float neighborDistance = Dist(from, to);
+		const float creepCost = !unit->is_flying && bot.Observation()->HasCreep(GetPosition(to)) ? HARASS_PATHFINDING_TILE_CREEP_COST : 0.f;
+		const float influenceOnTile = (exitOnInfluence || ignoreInfluence) ? 0.f : GetEffectInfluenceOnTile(to, unit, bot) + (considerOnlyEffects ? 0.f : GetCombatInfluenceOnTile(to, unit, bot));
+		// Consider turning cost to prevent our units from wiggling while fleeing, but not for workers that want to know if the path is safe
+		float turnCost = 0.f;
+		if (!exitOnInfluence)
+		{
+			const auto directionVector = GetPosition(to) - GetPosition(from);
+			const auto dotProduct = GetDotProduct(facingVector, directionVector);
+			const auto turnValue = std::min(1.f, 1 - dotProduct);
+			turnCost = turnValue * PATHFINDING_TURN_COST * neighborDistance;
+		}
+		return (influenceOnTile + creepCost + turnCost + HARASS_PATHFINDING_TILE_BASE_COST) * neighborDistance;
+	};
+
+	// Reapers can jump cliffs and fleeing units check the influence on every tile, so they always use the regular expansion
+	const bool jumpPointSearch = useJumpPointSearch && !flee && unit->unit_type != sc2::UNIT_TYPEID::TERRAN_REAPER;
+	JumpContext jumpContext;
+	jumpContext.unit = unit;
+	jumpContext.bot = &bot;
+	jumpContext.corridor = corridor;
+	jumpContext.goal = goal;
+	jumpContext.goalRange = maxRange + 1.5f;
+	jumpContext.considerInfluence = exitOnInfluence || !ignoreInfluence || maxInfluence > 0;
+	jumpContext.mapMin = bot.Map().mapMin();
+	jumpContext.mapMax = bot.Map().mapMax();
+
+	bool exitTriggered = false;
 	while (!opened.empty() && closed.size() < maxExploredNode)
 	{
 		IMNode* currentNode = getLowestCostNode(opened);
@@ -551,6 +883,7 @@ std::list<CCPosition> Util::PathFinding::FindOptimalPath(const sc2::Unit * unit,
 		}
 		if (shouldTriggerExit)
 		{
+			exitTriggered = true;
 			// If it exits on influence, we need to check if there is actually influence on the current tile. If so, we do not return a valid path
 			if(exitOnInfluence && HasInfluenceOnTile(GetPosition(currentNode->position), unit->is_flying, bot))
 			{
@@ -579,6 +912,45 @@ std::list<CCPosition> Util::PathFinding::FindOptimalPath(const sc2::Unit * unit,
 			break;
 		}
 
+		// In uniform regions (no influence, no creep), Jump Point Search skips the symmetric paths and only creates the nodes
+		// where the path could change direction. Close to influence, obstacles or the goal, the regular weighted expansion is used.
+		if (jumpPointSearch && IsClearJumpTile(currentNode->position, jumpContext))
+		{
+			std::vector<std::pair<int, int>> directions;
+			GetJumpPointSearchDirections(currentNode, jumpContext, directions);
+			for (const auto & direction : directions)
+			{
+				CCTilePosition jumpPoint;
+				if (!FindJumpPoint(currentNode->position, direction.first, direction.second, jumpContext, jumpPoint))
+					continue;
+
+				// Sum the cost of every tile between the node and the jump point, like the regular expansion would have done
+				float totalCost = currentNode->cost;
+				CCPosition facingVector = getNodeFacingVector(currentNode);
+				const CCPosition directionVector(float(direction.first), float(direction.second));
+				for (CCTilePosition position = currentNode->position; position != jumpPoint;)
+				{
+					const CCTilePosition nextPosition(position.x + direction.first, position.y + direction.second);
+					totalCost += getStepCost(position, facingVector, nextPosition);
+					facingVector = directionVector;
+					position = nextPosition;
+				}
+
+				const auto bestCostIt = bestCosts.find(jumpPoint.x * 1000 + jumpPoint.y);
+				if (bestCostIt != bestCosts.end() && bestCostIt->second <= totalCost)
+					continue;
+
+				const float corridorHeuristic = corridor ? corridor->getHeuristic(jumpPoint) : 0.f;
+				const float heuristic = corridor ? corridorHeuristic * HARASS_PATHFINDING_HEURISTIC_MULTIPLIER : CalcEuclidianDistanceHeuristic(jumpPoint, goalPosition, secondaryGoalPosition, bot);
+				const float influence = GetTotalInfluenceOnTile(jumpPoint, unit, bot) + currentNode->influence;
+				auto neighbor = new IMNode(jumpPoint, currentNode, totalCost, heuristic, influence);
+				neighbor->jumped = Dist(currentNode->position, jumpPoint) > 1.5f;
+				bestCosts[neighbor->getTag()] = totalCost;
+				opened.insert(neighbor);
+			}
+			continue;
+		}
+
 		// Find neighbors
 		for (int x = -1; x <= 1; ++x)
 		{
@@ -595,28 +967,15 @@ std::list<CCPosition> Util::PathFinding::FindOptimalPath(const sc2::Unit * unit,
 				if (neighborPosition.x < mapMin.x || neighborPosition.y < mapMin.y || neighborPosition.x >= mapMax.x || neighborPosition.y >= mapMax.y)
 					continue;	// out of bounds check
 
-				const float neighborDistance = Dist(currentNode->position, neighborPosition);
-				const float creepCost = !unit->is_flying && bot.Observation()->HasCreep(GetPosition(neighborPosition)) ? HARASS_PATHFINDING_TILE_CREEP_COST : 0.f;
-				const float influenceOnTile = (exitOnInfluence || ignoreInfluence) ? 0.f : GetEffectInfluenceOnTile(neighborPosition, unit, bot) + (considerOnlyEffects ? 0.f : GetCombatInfluenceOnTile(neighborPosition, unit, bot));
+				const float corridorHeuristic = corridor ? corridor->getHeuristic(neighborPosition) : 0.f;
+				if (corridorHeuristic < 0.f)
+					continue;	// outside of the hierarchical path
+
 				const float totalInfluenceOnTile = GetTotalInfluenceOnTile(neighborPosition, unit, bot);
-				// Consider turning cost to prevent our units from wiggling while fleeing, but not for workers that want to know if the path is safe
-				float turnCost = 0.f;
-				if (!exitOnInfluence)
-				{
-					CCPosition facingVector;
-					if (currentNode->parent == nullptr)
-						facingVector = getFacingVector(unit);
-					else
-						facingVector = GetPosition(currentNode->position) - GetPosition(currentNode->parent->position);
-					const auto directionVector = GetPosition(neighborPosition) - GetPosition(currentNode->position);
-					const auto dotProduct = GetDotProduct(facingVector, directionVector);
-					const auto turnValue = std::min(1.f, 1 - dotProduct);
-					turnCost = turnValue * PATHFINDING_TURN_COST * Dist(currentNode->position, neighborPosition);
-				}
-				const float nodeCost = (influenceOnTile + creepCost + turnCost + HARASS_PATHFINDING_TILE_BASE_COST) * neighborDistance;
+				const float nodeCost = getStepCost(currentNode->position, getNodeFacingVector(currentNode), neighborPosition);
 				totalCost += currentNode->cost + nodeCost;
 
-				const float heuristic = CalcEuclidianDistanceHeuristic(neighborPosition, goalPosition, secondaryGoalPosition, bot);
+				const float heuristic = corridor ? corridorHeuristic * HARASS_PATHFINDING_HEURISTIC_MULTIPLIER : CalcEuclidianDistanceHeuristic(neighborPosition, goalPosition, secondaryGoalPosition, bot);
 				const float influence = totalInfluenceOnTile + currentNode->influence;
 				auto neighbor = new IMNode(neighborPosition, currentNode, totalCost, heuristic, influence);
 
@@ -638,6 +997,12 @@ std::list<CCPosition> Util::PathFinding::FindOptimalPath(const sc2::Unit * unit,
 	{
 		failureReason = TIMEOUT;
 	}
+	else if (!exitTriggered)
+	{
+		failureReason = UNREACHABLE;
+	}
+	exploredNodeCount += closed.size();
+	PROFILE_COUNT("pathfindingExpansions", closed.size());
 	for (auto node : opened)
 		delete node;
 	for (auto node : closed)
@@ -738,6 +1103,14 @@ std::list<CCPosition> Util::PathFinding::GetPositionListFromPath(IMNode* current
 			bot.Map().drawTile(Util::GetTilePosition(currentPosition), sc2::Colors::Teal, 0.2f);
 #endif
 		returnPositions.push_front(currentPosition);
+		if (currentNode->jumped)
+		{
+			// Add the tiles skipped by the Jump Point Search, they are on a straight line
+			const int dx = (currentNode->parent->position.x > currentNode->position.x) - (currentNode->parent->position.x < currentNode->position.x);
+			const int dy = (currentNode->parent->position.y > currentNode->position.y) - (currentNode->parent->position.y < currentNode->position.y);
+			for (CCTilePosition tile(currentNode->position.x + dx, currentNode->position.y + dy); tile != currentNode->parent->position; tile = CCTilePosition(tile.x + dx, tile.y + dy))
+				returnPositions.push_front(Util::GetPosition(tile) + CCPosition(0.5f, 0.5f));
+		}
 		currentNode = currentNode->parent;
 	} while (currentNode != nullptr);
 	return returnPositions;
@@ -1161,7 +1534,7 @@ std::list<Util::UnitCluster> & Util::GetUnitClusters(const sc2::Units & units, c
 	auto & lastUnitClusterFrame = ignoreSpecialTypes ? m_lastUnitClusterFrame : m_lastSpecialUnitClusterFrame;
 	// Return the saved clusters if they were calculated not long ago
 	const auto currentFrame = bot.GetCurrentFrame();
-	if (!query.empty() && currentFrame - lastUnitClusterFrame < UNIT_CLUSTERING_COOLDOWN)
+	if (!query.empty() && currentFrame - lastUnitClusterFrame < UNIT_CLUSTERING_COOLDOWN * bot.Latency().getClusteringCooldownMultiplier())
 		return unitClusters;
 
 	unitClusters.clear();
@@ -2450,7 +2823,7 @@ float Util::getSpeedOfUnit(const sc2::Unit * unit, CCBot & bot)
 		if (unit->unit_type == sc2::UNIT_TYPEID::TERRAN_MEDIVAC && bot.Strategy().isUpgradeCompleted(sc2::UPGRADE_ID::MEDIVACINCREASESPEEDBOOST))
 			speedMultiplier *= 1.18f;
 	}
-	return GetUnitTypeDataFromUnitTypeId(unit->unit_type, bot).movement_speed * speedMultiplier;
+	return bot.Tech().getProperties(unit->unit_type).movementSpeed * speedMultiplier;
 }
 
 /*
@@ -2556,8 +2929,7 @@ bool Util::CanUnitSeeEnemyUnit(const sc2::Unit * unit, const sc2::Unit * enemyUn
 	const auto distSq = DistSq(unit->pos, enemyUnit->pos);
 	if (distSq > 20 * 20)
 		return false;	// Unit is just too far
-	const auto & unitTypeData = GetUnitTypeDataFromUnitTypeId(unit->unit_type, bot);
-	const auto sight = unitTypeData.sight_range + unit->radius + enemyUnit->radius - buffer;
+	const auto sight = bot.Tech().getProperties(unit->unit_type).sightRange + unit->radius + enemyUnit->radius - buffer;
 	if (distSq > sight * sight)
 		return false;	// Unit doesn't have enough sight range
 	if (!unit->is_flying && bot.Map().terrainHeight(unit->pos) < bot.Map().terrainHeight(enemyUnit->pos))
@@ -3050,7 +3422,8 @@ void Util::DisplayError(const std::string & error, const std::string & errorCode
 		bot.Actions()->SendChat(ss.str());
 	}
 
-	Util::Log(ss.str(), bot);
+	// The severity tag of the record replaces the prefix of the chat message
+	Logger::Push(bot.GetGameLoop(), isCritical ? LogSeverity::Error : LogSeverity::Warning, error, errorCode);
 	displayedError.push_back(errorCode);
 }
 
@@ -3066,7 +3439,17 @@ void Util::CreateLog(CCBot & bot)
 	strftime(buf, sizeof(buf), "./data/%Y-%m-%d--%H-%M-%S", localtime(&now));
 	std::stringstream ss;
 	ss << buf << "_" << bot.GetOpponentId() << ".log";
-	file.open(ss.str());
+
+	// Without debug, the debug logs are filtered out unless their category asks for them
+	const auto & logLevels = bot.Config().LogLevels;
+	const auto defaultLevel = logLevels.find("Default");
+	Logger::SetDefaultLevel(defaultLevel != logLevels.end() ? Logger::GetSeverityFromString(defaultLevel->second) : allowDebug ? LogSeverity::Debug : LogSeverity::Info);
+	for (const auto & logLevel : logLevels)
+	{
+		if (logLevel.first != "Default")
+			Logger::SetCategoryLevel(logLevel.first, Logger::GetSeverityFromString(logLevel.second));
+	}
+	Logger::Start(ss.str());
 
 	SetMapName(bot.Observation()->GetGameInfo().map_name);
 	std::stringstream races;
@@ -3076,38 +3459,27 @@ void Util::CreateLog(CCBot & bot)
 
 void Util::DebugLog(const std::string & function, CCBot & bot)
 {
-	if (allowDebug)
-	{
-		file << bot.GetGameLoop() << ": " << function << std::endl;
-		std::cout << bot.GetGameLoop() << ": " << function << std::endl;
-	}
+	Logger::Push(bot.GetGameLoop(), LogSeverity::Debug, function);
 }
 
 void Util::DebugLog(const std::string & function, const std::string & message, CCBot & bot)
 {
-	if (allowDebug)
-	{
-		file << bot.GetGameLoop() << ": " << function << " | " << message << std::endl;
-		std::cout << bot.GetGameLoop() << ": " << function << " | " << message << std::endl;
-	}
+	Logger::Push(bot.GetGameLoop(), LogSeverity::Debug, function, message);
 }
 
 void Util::LogNoFrame(const std::string & function, CCBot & bot)
 {
-	file << function << std::endl;
-	std::cout << function << std::endl;
+	Logger::Push(Logger::NO_LOOP, LogSeverity::Info, function);
 }
 
 void Util::Log(const std::string & function, CCBot & bot)
 {
-	file << bot.GetGameLoop() << ": " << function << std::endl;
-	std::cout << bot.GetGameLoop() << ": " << function << std::endl;
+	Logger::Push(bot.GetGameLoop(), LogSeverity::Info, function);
 }
 
 void Util::Log(const std::string & function, const std::string & message, const CCBot & bot)
 {
-	file << bot.GetGameLoop() << ": " << function << " | " << message << std::endl;
-	std::cout << bot.GetGameLoop() << ": " << function << " | " << message << std::endl;
+	Logger::Push(bot.GetGameLoop(), LogSeverity::Info, function, message);
 }
 
 void Util::AddStatistic(const std::string & statisticName, int value)
@@ -3200,6 +3572,56 @@ void Util::TimeControlDecreaseSpeed()
 	}
 }
 
+/**
+ * Cheap replacement of the combat simulator until it is initialized: Lanchester's square law on the damage and health of each side.
+ * The side with the biggest product of total dps and total health wins and keeps sqrt(1 - loserStrength / winnerStrength) of its army.
+ */
+Util::CombatSimulationResult Util::EstimateCombat(const sc2::Units & units, const sc2::Units & simulatedUnits, const sc2::Units & enemyUnits, CCBot & bot)
+{
+	float strengths[2] = { 0.f, 0.f };
+	float supplies[2] = { 0.f, 0.f };
+	for (int i = 0; i < 2; ++i)
+	{
+		const sc2::Units & fighters = i == 0 ? simulatedUnits : enemyUnits;
+		const sc2::Units & targets = i == 0 ? enemyUnits : simulatedUnits;
+		bool hasGroundTarget = false;
+		bool hasAirTarget = false;
+		for (const auto target : targets)
+		{
+			hasGroundTarget = hasGroundTarget || !target->is_flying;
+			hasAirTarget = hasAirTarget || target->is_flying;
+		}
+		const auto targetType = hasGroundTarget && hasAirTarget ? sc2::Weapon::TargetType::Any : hasAirTarget ? sc2::Weapon::TargetType::Air : sc2::Weapon::TargetType::Ground;
+		float dps = 0.f;
+		float health = 0.f;
+		for (const auto unit : fighters)
+		{
+			dps += GetDps(unit, targetType, bot);
+			health += unit->health + unit->shield;
+		}
+		strengths[i] = dps * health;
+		for (const auto unit : i == 0 ? units : enemyUnits)
+		{
+			const sc2::UnitTypeData & unitTypeData = bot.Observation()->GetUnitTypeData()[unit->unit_type];
+			supplies[i] += unitTypeData.food_required * (0.25f + 0.75f * unit->health / std::max(1.f, unit->health_max));
+		}
+	}
+
+	float remaining[2] = { 1.f, 1.f };	// nobody can hurt the other side when both strengths are 0
+	if (strengths[0] > 0.f || strengths[1] > 0.f)
+	{
+		const int winner = strengths[0] >= strengths[1] ? 0 : 1;
+		remaining[winner] = std::sqrt(1.f - strengths[1 - winner] / strengths[winner]);
+		remaining[1 - winner] = 0.f;
+	}
+	CombatSimulationResult combatSimulationResult;
+	combatSimulationResult.supplyLost = supplies[0] * (1.f - remaining[0]);
+	combatSimulationResult.supplyPercentageRemaining = remaining[0];
+	combatSimulationResult.enemySupplyLost = supplies[1] * (1.f - remaining[1]);
+	combatSimulationResult.enemySupplyPercentageRemaining = remaining[1];
+	return combatSimulationResult;
+}
+
 Util::CombatSimulationResult Util::SimulateCombat(const sc2::Units & units, const sc2::Units & enemyUnits, bool considerOurTanksUnsieged, bool stopSimulationWhenGroupHasNoTarget, CCBot & bot)
 {
 	return SimulateCombat(units, units, enemyUnits, considerOurTanksUnsieged, stopSimulationWhenGroupHasNoTarget, bot);
@@ -3243,7 +3665,12 @@ Util::CombatSimulationResult Util::SimulateCombat(const sc2::Units & units, cons
 			return combatSimulationResult;
 		}
 	}
-	bot.StartProfiling("s.0 PrepareForCombatSimulation");
+	if (!IsCombatSimulatorReady())
+	{
+		PROFILE_COUNT("combatEstimates", 1);
+		return EstimateCombat(units, simulatedUnits, enemyUnits, bot);
+	}
+	PROFILE_BEGIN("PrepareForCombatSimulation");
 	const int playerId = GetSelfPlayerId(bot);
 	CombatState state;
 	for(int i=0; i<2; ++i)
@@ -3314,13 +3741,13 @@ Util::CombatSimulationResult Util::SimulateCombat(const sc2::Units & units, cons
 	// TODO because it can take over 1s to generate a new one (happens when upgrades change)
 	/*for (const auto upgrade : bot.Strategy().getCompletedUpgrades())
 		(playerId == 1 ? player1upgrades : player2upgrades).add(upgrade);*/
-	bot.StopProfiling("s.0 PrepareForCombatSimulation");
+	PROFILE_END("PrepareForCombatSimulation");
 	
-	bot.StartProfiling("s.1 getCombatEnvironment");
+	PROFILE_BEGIN("getCombatEnvironment");
 	state.environment = &m_simulator->getCombatEnvironment(player1upgrades, player2upgrades);
-	bot.StopProfiling("s.1 getCombatEnvironment");
+	PROFILE_END("getCombatEnvironment");
 
-	bot.StartProfiling("s.2 predict_engage");
+	PROFILE_BEGIN("predict_engage");
 	CombatSettings settings;
 	
 	// Simulate for at most 100 *game* seconds
@@ -3329,12 +3756,13 @@ Util::CombatSimulationResult Util::SimulateCombat(const sc2::Units & units, cons
 	settings.enableTimingAdjustment = false;
 	settings.stopWhenNoTarget = stopSimulationWhenGroupHasNoTarget;
 	const CombatResult outcome = m_simulator->predict_engage(state, settings, nullptr, defenderPlayer, &bot);
-	bot.StopProfiling("s.2 predict_engage");
-	bot.StartProfiling("s.3 owner_with_best_outcome");
+	PROFILE_END("predict_engage");
+	PROFILE_COUNT("combatSimulations", 1);
+	PROFILE_BEGIN("owner_with_best_outcome");
 	const int winner = outcome.state.owner_with_best_outcome();
-	bot.StopProfiling("s.3 owner_with_best_outcome");
+	PROFILE_END("owner_with_best_outcome");
 
-	bot.StartProfiling("s.4 ComputeArmyRating");
+	PROFILE_BEGIN("ComputeArmyRating");
 	// Ally
 	float resultArmySupplyScore = 0.f;
 	float resultEnemyArmySupplyScore = 0.f;
@@ -3352,7 +3780,7 @@ Util::CombatSimulationResult Util::SimulateCombat(const sc2::Units & units, cons
 	}
 	const float armyRating = resultArmySupplyScore / std::max(1.f, armySupplyScore);
 	const float enemyArmyRating = resultEnemyArmySupplyScore / std::max(1.f, enemyArmySupplyScore);
-	bot.StopProfiling("s.4 ComputeArmyRating");
+	PROFILE_END("ComputeArmyRating");
 	combatSimulationResult.supplyLost = armySupplyScore - resultArmySupplyScore;
 	combatSimulationResult.supplyPercentageRemaining = armyRating;
 	combatSimulationResult.enemySupplyLost = enemyArmySupplyScore - resultEnemyArmySupplyScore;
@@ -2,6 +2,7 @@
 
 #include "Common.h"
 #include "UnitType.h"
+#include "HierarchicalPathfinding.h"
 #include <list>
 #include "libvoxelbot/combat/simulator.h"
 
@@ -15,7 +16,6 @@ namespace Util
 	static const int DELAY_BETWEEN_ERROR = 120;
 	static std::vector<std::string> displayedError;
 	static std::map<std::string, std::vector<int>> statistics;
-	static std::ofstream file;
 	static std::string mapName;
 	static CombatPredictor* m_simulator;
 
@@ -103,11 +103,16 @@ namespace Util
 
 	namespace PathFinding
 	{
+		// Cost of a tile before its influence, shared with the flow fields so both follow the same paths
+		const float HARASS_PATHFINDING_TILE_BASE_COST = 1.f;
+		const float HARASS_PATHFINDING_TILE_CREEP_COST = 0.5f;
+
 		enum FailureReason
 		{
 			TIMEOUT,
 			INFLUENCE,
-			NO_NEED_TO_MOVE
+			NO_NEED_TO_MOVE,
+			UNREACHABLE		// every reachable tile was explored without finding the goal area
 		};
 		
 		struct IMNode;
@@ -155,6 +160,11 @@ namespace Util
 
 		bool SetContainsNode(const std::set<IMNode*> & set, IMNode* node, bool mustHaveLowerCost);
 		void ClearExpiredPathFindingResults(long currentFrame);
+		// Replays the FindOptimalPath queries recorded during the frame with the BenchmarkPathfinding option, with and without
+		// the Jump Point Search, so it must be called at the end of the frame once the micro threads are done
+		void RunPathfindingBenchmark(CCBot & bot);
+		// Logs the totals of the replays of the game
+		void LogPathfindingBenchmark(CCBot & bot);
 		bool IsPathToGoalSafe(const sc2::Unit * unit, CCPosition goal, bool addBuffer, CCBot & bot);
 		CCPosition FindOptimalPathToTarget(const sc2::Unit * unit, CCPosition goal, CCPosition secondaryGoal, const sc2::Unit* target, float maxRange, bool considerOnlyEffects, float maxInfluence, CCBot & bot);
 		CCPosition FindEngagePosition(const sc2::Unit * unit, const sc2::Unit* target, float maxRange, CCBot & bot);
@@ -166,6 +176,7 @@ namespace Util
 		std::list<CCPosition> FindOptimalPathWithoutLimit(const sc2::Unit * unit, CCPosition goal, CCBot & bot);
 		std::list<CCPosition> FindOptimalPath(const sc2::Unit * unit, CCPosition goal, CCPosition secondaryGoal, float maxRange, bool exitOnInfluence, bool considerOnlyEffects, bool getCloser, bool ignoreInfluence, float maxInfluence, bool flee, bool checkVisibility, CCBot & bot);
 		std::list<CCPosition> FindOptimalPath(const sc2::Unit * unit, CCPosition goal, CCPosition secondaryGoal, float maxRange, bool exitOnInfluence, bool considerOnlyEffects, bool getCloser, bool ignoreInfluence, float maxInfluence, bool flee, bool checkVisibility, bool limitSearch, FailureReason & failureReason, CCBot & bot);
+		std::list<CCPosition> FindOptimalPath(const sc2::Unit * unit, CCPosition goal, CCPosition secondaryGoal, float maxRange, bool exitOnInfluence, bool considerOnlyEffects, bool getCloser, bool ignoreInfluence, float maxInfluence, bool flee, bool checkVisibility, bool limitSearch, const HierarchicalPathfinding::Corridor * corridor, FailureReason & failureReason, CCBot & bot);
 		CCTilePosition GetNeighborNodePosition(int x, int y, IMNode* currentNode, const sc2::Unit * rangedUnit, CCBot & bot);
 		CCPosition GetCommandPositionFromPath(std::list<CCPosition> & path, const sc2::Unit * rangedUnit, bool moveFarther, CCBot & bot);
 		std::list<CCPosition> GetPositionListFromPath(IMNode* currentNode, const sc2::Unit * rangedUnit, CCBot & bot);
@@ -194,6 +205,9 @@ namespace Util
 
 	void Initialize(CCBot & bot, CCRace race, const sc2::GameInfo & _gameInfo);
 	void InitializeCombatSimulator();
+	// Initializes the combat simulator on a background thread, SimulateCombat estimates the outcomes until it is ready
+	void StartCombatSimulatorInitialization();
+	bool IsCombatSimulatorReady();
 	void SetAllowDebug(bool _allowDebug);
 
 	void SetMapName(std::string _mapName);
@@ -368,6 +382,7 @@ namespace Util
     CCPositionType DistSq(const CCPosition & p1, const CCPosition & p2);
 	float DistBetweenLineAndPoint(const CCPosition & linePoint1, const CCPosition & linePoint2, const CCPosition & point);
 
+	CombatSimulationResult EstimateCombat(const sc2::Units & units, const sc2::Units & simulatedUnits, const sc2::Units & enemyUnits, CCBot & bot);
 	CombatSimulationResult SimulateCombat(const sc2::Units & units, const sc2::Units & enemyUnits, bool considerOurTanksUnsieged, bool stopSimulationWhenGroupHasNoTarget, CCBot & bot);
 	CombatSimulationResult SimulateCombat(const sc2::Units & units, const sc2::Units & simulatedUnits, const sc2::Units & enemyUnits, bool considerOurTanksUnsieged, bool stopSimulationWhenGroupHasNoTarget, CCBot & bot);
 	int GetSelfPlayerId(const CCBot & bot);
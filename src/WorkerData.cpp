@@ -8,10 +8,161 @@
 WorkerData::WorkerData(CCBot & bot)
     : m_bot(bot)
 {
-    for (int i=0; i < WorkerJobs::Num; ++i)
-    {
-        m_workerJobCount[i] = 0;
-    }
+}
+
+int WorkerData::ResourceTable::find(const Unit & unit) const
+{
+	auto it = slots.find(unit.getUnitPtr());
+	return it == slots.end() ? -1 : it->second;
+}
+
+int WorkerData::ResourceTable::insert(const Unit & unit)
+{
+	auto it = slots.find(unit.getUnitPtr());
+	if (it != slots.end())
+		return it->second;
+
+	const int slot = int(units.size());
+	slots[unit.getUnitPtr()] = slot;
+	units.push_back(unit);
+	workers.emplace_back();
+	return slot;
+}
+
+int WorkerData::getWorkerSlot(const Unit & unit) const
+{
+	auto it = m_workerSlots.find(unit.getUnitPtr());
+	return it == m_workerSlots.end() ? -1 : it->second;
+}
+
+int WorkerData::addWorker(const Unit & unit)
+{
+	const int slot = int(m_workers.size());
+	m_workerSlots[unit.getUnitPtr()] = slot;
+	m_workers.push_back(unit);
+	m_workerJobs.push_back(WorkerJobs::None);
+	m_workerJobIndices.push_back(int(m_jobWorkers[WorkerJobs::None].size()));
+	m_jobWorkers[WorkerJobs::None].push_back(unit);
+	m_workerMinerals.push_back(-1);
+	m_workerDepots.push_back(-1);
+	m_workerRefineries.push_back(-1);
+	return slot;
+}
+
+void WorkerData::removeWorker(int slot)
+{
+	unassignResource(m_minerals, m_workerMinerals, slot);
+	unassignResource(m_depots, m_workerDepots, slot);
+	unassignResource(m_refineries, m_workerRefineries, slot);
+	removeFromJob(slot);
+	m_workerSlots.erase(m_workers[slot].getUnitPtr());
+
+	// The last worker takes the freed slot so the table stays dense
+	const int last = int(m_workers.size()) - 1;
+	if (slot != last)
+	{
+		m_workers[slot] = m_workers[last];
+		m_workerJobs[slot] = m_workerJobs[last];
+		m_workerJobIndices[slot] = m_workerJobIndices[last];
+		m_workerMinerals[slot] = m_workerMinerals[last];
+		m_workerDepots[slot] = m_workerDepots[last];
+		m_workerRefineries[slot] = m_workerRefineries[last];
+		m_workerSlots[m_workers[slot].getUnitPtr()] = slot;
+
+		const std::pair<ResourceTable *, int> resources[] = { { &m_minerals, m_workerMinerals[slot] }, { &m_depots, m_workerDepots[slot] }, { &m_refineries, m_workerRefineries[slot] } };
+		for (const auto & resource : resources)
+		{
+			if (resource.second < 0)
+				continue;
+			auto & workers = resource.first->workers[resource.second];
+			std::replace(workers.begin(), workers.end(), last, slot);
+		}
+	}
+
+	m_workers.pop_back();
+	m_workerJobs.pop_back();
+	m_workerJobIndices.pop_back();
+	m_workerMinerals.pop_back();
+	m_workerDepots.pop_back();
+	m_workerRefineries.pop_back();
+}
+
+void WorkerData::removeFromJob(int slot)
+{
+	auto & jobWorkers = m_jobWorkers[m_workerJobs[slot]];
+	const int index = m_workerJobIndices[slot];
+	if (index != int(jobWorkers.size()) - 1)
+	{
+		jobWorkers[index] = jobWorkers.back();
+		m_workerJobIndices[getWorkerSlot(jobWorkers[index])] = index;
+	}
+	jobWorkers.pop_back();
+}
+
+void WorkerData::setJob(int slot, int job)
+{
+	if (m_workerJobs[slot] == job)
+		return;
+
+	removeFromJob(slot);
+	m_workerJobs[slot] = job;
+	m_workerJobIndices[slot] = int(m_jobWorkers[job].size());
+	m_jobWorkers[job].push_back(m_workers[slot]);
+}
+
+void WorkerData::assignResource(ResourceTable & table, std::vector<int> & column, int slot, const Unit & resource)
+{
+	const int resourceSlot = table.insert(resource);
+	if (column[slot] == resourceSlot)
+		return;
+
+	unassignResource(table, column, slot);
+	column[slot] = resourceSlot;
+	table.workers[resourceSlot].push_back(slot);
+}
+
+void WorkerData::unassignResource(ResourceTable & table, std::vector<int> & column, int slot)
+{
+	const int resourceSlot = column[slot];
+	if (resourceSlot < 0)
+		return;
+
+	auto & workers = table.workers[resourceSlot];
+	workers.erase(std::find(workers.begin(), workers.end(), slot));
+	column[slot] = -1;
+}
+
+void WorkerData::eraseResource(ResourceTable & table, std::vector<int> & column, int resourceSlot)
+{
+	for (const int slot : table.workers[resourceSlot])
+		column[slot] = -1;
+	table.slots.erase(table.units[resourceSlot].getUnitPtr());
+
+	const int last = int(table.units.size()) - 1;
+	if (resourceSlot != last)
+	{
+		table.units[resourceSlot] = table.units[last];
+		table.workers[resourceSlot] = std::move(table.workers[last]);
+		table.slots[table.units[resourceSlot].getUnitPtr()] = resourceSlot;
+		for (const int slot : table.workers[resourceSlot])
+			column[slot] = resourceSlot;
+	}
+	table.units.pop_back();
+	table.workers.pop_back();
+}
+
+Unit WorkerData::getAssignedResource(const ResourceTable & table, const std::vector<int> & column, const Unit & worker) const
+{
+	const int slot = getWorkerSlot(worker);
+	if (slot < 0 || column[slot] < 0)
+		return Unit();
+	return table.units[column[slot]];
+}
+
+int WorkerData::getResourceWorkerCount(const ResourceTable & table, const Unit & resource) const
+{
+	const int resourceSlot = table.find(resource);
+	return resourceSlot < 0 ? 0 : int(table.workers[resourceSlot].size());
 }
 
 void WorkerData::updateAllWorkerData()
@@ -19,9 +170,10 @@ void WorkerData::updateAllWorkerData()
 #ifndef PUBLIC_RELEASE
 	if(m_bot.Config().DrawWorkerInfo)
 	{
-		for (auto & unit : m_workerRefineryMap)
+		for (size_t slot = 0; slot < m_workers.size(); ++slot)
 		{
-			m_bot.Map().drawText(unit.first.getPosition(), "  Affected to refinery");
+			if (m_workerRefineries[slot] >= 0)
+				m_bot.Map().drawText(m_workers[slot].getPosition(), "  Affected to refinery");
 		}
 	}
 #endif
@@ -102,9 +254,7 @@ void WorkerData::updateIdleMineralTarget()
 void WorkerData::workerDestroyed(const Unit & unit)//deadWorker
 {
     clearPreviousJob(unit);
-    m_workers.erase(unit);
     m_proxyWorkers.erase(unit);
-	m_workerMineralMap.erase(unit);
 
 	for (auto & building : m_workerRepairing)
 	{
@@ -115,48 +265,50 @@ void WorkerData::workerDestroyed(const Unit & unit)//deadWorker
 		}
 	}
 
-	for (auto & mineralWorker : m_mineralWorkersMap)
-	{
-		mineralWorker.second.remove(unit.getTag());
-	}	
+	const int slot = getWorkerSlot(unit);
+	if (slot >= 0)
+		removeWorker(slot);
 }
 
 void WorkerData::updateWorker(const Unit & unit)
 {
-    if (m_workers.find(unit) == m_workers.end())
+    if (getWorkerSlot(unit) < 0)
     {
-        m_workers.insert(unit);
-        m_workerJobMap[unit] = WorkerJobs::None;
+        addWorker(unit);
     }
 }
 
-void WorkerData::setWorkerJob(const Unit & worker, int job, Unit jobUnit)
+void WorkerData::setWorkerJob(const Unit & worker, int job, Unit jobUnit, Unit mineral)
 {
 	clearPreviousJob(worker);
-    m_workerJobMap[worker] = job;
-    m_workerJobCount[job]++;
+	int slot = getWorkerSlot(worker);
+	if (slot < 0)
+		slot = addWorker(worker);
+	setJob(slot, job);
 
 	//Handle starting a job
     if (job == WorkerJobs::Minerals)
     {
-        // if we haven't assigned anything to this depot yet, set its worker count to 0
-        if (m_depotWorkerCount.find(jobUnit) == m_depotWorkerCount.end())
-        {
-            m_depotWorkerCount[jobUnit] = 0;
-        }
-
-        // add the worker to our set of depots
-        m_depots.insert(jobUnit);
-
-        // increase the worker count of this depot
-		if (worker.getAPIUnitType() != sc2::UNIT_TYPEID::TERRAN_MULE)
+        // add the depot to our set of depots and increase its worker count, MULEs are not counted
+		if (jobUnit.isValid())
 		{
-			m_workerDepotMap[worker] = jobUnit;
-			m_depotWorkerCount[jobUnit]++;
+			if (worker.getAPIUnitType() != sc2::UNIT_TYPEID::TERRAN_MULE)
+				assignResource(m_depots, m_workerDepots, slot, jobUnit);
+			else
+				m_depots.insert(jobUnit);
 		}
 
-        // find the mineral to mine and mine it
-		if (m_bot.GetCurrentFrame() == 0)
+        // mine the mineral chosen by the caller, otherwise find the mineral to mine and mine it
+		if (mineral.isValid())
+		{
+			worker.rightClick(mineral);
+
+			if (!worker.getType().isMule())
+			{
+				assignResource(m_minerals, m_workerMinerals, slot, mineral);
+			}
+		}
+		else if (m_bot.GetCurrentFrame() == 0)
 		{		
 		}
 		else
@@ -184,8 +336,7 @@ void WorkerData::setWorkerJob(const Unit & worker, int job, Unit jobUnit)
 
 				if (!worker.getType().isMule())
 				{
-					m_workerMineralMap[worker] = mineralToMine;
-					m_mineralWorkersMap[mineralToMine].push_back(worker.getTag());
+					assignResource(m_minerals, m_workerMinerals, slot, mineralToMine);
 				}
 			}
 			else
@@ -194,24 +345,14 @@ void WorkerData::setWorkerJob(const Unit & worker, int job, Unit jobUnit)
 				worker.attackMove(m_bot.Bases().getPlayerStartingBaseLocation(Players::Enemy)->getPosition());
 			}
 		}
-
-		m_mineralWorkers.insert(worker);
     }
     else if (job == WorkerJobs::Gas)
     {
 		BOT_ASSERT(jobUnit.getType().isRefinery(), "JobUnit should be refinery");
 		BOT_ASSERT(worker.getType().isWorker(), "Unit should be worker");
-        // if we haven't assigned any workers to this refinery yet set count to 0
-        if (m_refineryWorkerCount.find(jobUnit) == m_refineryWorkerCount.end())
-        {
-            m_refineryWorkerCount[jobUnit] = 0;
-        }
-
         // increase the count of workers assigned to this refinery
-        m_refineryWorkerCount[jobUnit] += 1;
-        m_workerRefineryMap[worker] = jobUnit;
-		m_refineryWorkerMap[jobUnit].push_back(worker);
-		
+		assignResource(m_refineries, m_workerRefineries, slot, jobUnit);
+
         // right click the refinery to start harvesting
         worker.rightClick(jobUnit);
     }
@@ -232,46 +373,25 @@ void WorkerData::setWorkerJob(const Unit & worker, int job, Unit jobUnit)
     }
 	else if (job == WorkerJobs::Idle)
 	{//Must not call stop().
-		if (!isProxyWorker(worker))
-		{
-			m_idleWorkers.insert(worker);
-		}
 	}
 }
 
 void WorkerData::clearPreviousJob(const Unit & unit)
 {
-    const int previousJob = getWorkerJob(unit);
-	m_workerJobCount[previousJob]--;
+	const int slot = getWorkerSlot(unit);
+	if (slot < 0)
+		return;
+    const int previousJob = m_workerJobs[slot];
 
     if (previousJob == WorkerJobs::Minerals)
     {
-        // remove one worker from the count of the depot this worker was assigned to
-		// increase the worker count of this depot
-		if (unit.getAPIUnitType() != sc2::UNIT_TYPEID::TERRAN_MULE)
-		{
-			m_depotWorkerCount[m_workerDepotMap[unit]]--;
-			m_workerDepotMap.erase(unit);
-
-			if (m_workerMineralMap.find(unit) != m_workerMineralMap.end())
-			{
-				m_mineralWorkersMap[m_workerMineralMap[unit]].remove(unit.getTag());
-			}
-			m_workerMineralMap.erase(unit);
-			m_mineralWorkers.erase(unit);
-		}
+        // remove the worker from the depot and the mineral it was assigned to
+		unassignResource(m_depots, m_workerDepots, slot);
+		unassignResource(m_minerals, m_workerMinerals, slot);
     }
     else if (previousJob == WorkerJobs::Gas)
     {
-        m_refineryWorkerCount[m_workerRefineryMap[unit]]--;
-        m_workerRefineryMap.erase(unit);
-		for (auto & refinery : m_refineryWorkerMap)
-		{
-			auto it = std::find(refinery.second.begin(), refinery.second.end(), unit);
-			if (it != refinery.second.end()) {
-				refinery.second.erase(it);
-			}
-		}
+		unassignResource(m_refineries, m_workerRefineries, slot);
     }
     else if (previousJob == WorkerJobs::Build)
     {
@@ -287,7 +407,7 @@ void WorkerData::clearPreviousJob(const Unit & unit)
     }
 	else if (previousJob == WorkerJobs::Idle)
 	{
-		m_idleWorkers.erase(unit);
+
 	}
     else if (previousJob == WorkerJobs::Move)
     {
@@ -298,7 +418,7 @@ void WorkerData::clearPreviousJob(const Unit & unit)
 
 	}
 
-    m_workerJobMap.erase(unit);
+	setJob(slot, WorkerJobs::None);
 }
 
 size_t WorkerData::getNumWorkers() const
@@ -308,29 +428,18 @@ size_t WorkerData::getNumWorkers() const
 
 int WorkerData::getWorkerJobCount(int job) const
 {
-    return m_workerJobCount.at(job);
+    return int(m_jobWorkers[job].size());
 }
 
 int WorkerData::getCountWorkerAtDepot(const Unit & depot) const
 {
-	auto it = m_depotWorkerCount.find(depot);
-	if (it == m_depotWorkerCount.end())
-	{
-		return 0;
-	}
-	return it->second;
+	return getResourceWorkerCount(m_depots, depot);
 }
 
 int WorkerData::getWorkerJob(const Unit & unit) const
 {
-    auto it = m_workerJobMap.find(unit);
-
-    if (it != m_workerJobMap.end())
-    {
-        return it->second;
-    }
-
-    return WorkerJobs::None;
+	const int slot = getWorkerSlot(unit);
+	return slot < 0 ? WorkerJobs::None : m_workerJobs[slot];
 }
 
 bool WorkerData::isReturningCargo(const Unit & unit) const
@@ -424,15 +533,7 @@ const Unit WorkerData::GetBestMineralWithLessWorkersInLists(const std::vector<Un
 		{
 			continue;
 		}
-		auto it = m_mineralWorkersMap.find(closeMineral);
-		if (it != m_mineralWorkersMap.end())
-		{
-			if (it->second.size() == 0)//Can be at 0 if a worker was removed
-			{
-				return closeMineral;
-			}
-		}
-		else//Should have 0 workers
+		if (getMineralWorkerCount(closeMineral) == 0)
 		{
 			return closeMineral;
 		}
@@ -443,8 +544,7 @@ const Unit WorkerData::GetBestMineralWithLessWorkersInLists(const std::vector<Un
 		{
 			continue;
 		}
-		auto it = m_mineralWorkersMap.find(closeMineral);
-		if (it->second.size() == 1)
+		if (getMineralWorkerCount(closeMineral) == 1)
 		{
 			return closeMineral;
 		}
@@ -465,15 +565,7 @@ const Unit WorkerData::GetBestMineralWithLessWorkersInLists(const std::vector<Un
 		{
 			continue;
 		}
-		auto it = m_mineralWorkersMap.find(farMineral);
-		if (it != m_mineralWorkersMap.end())
-		{
-			if (it->second.size() == 0)//Can be at 0 if a worker was removed
-			{
-				return farMineral;
-			}
-		}
-		else//Should have 0 workers
+		if (getMineralWorkerCount(farMineral) == 0)
 		{
 			return farMineral;
 		}
@@ -484,8 +576,7 @@ const Unit WorkerData::GetBestMineralWithLessWorkersInLists(const std::vector<Un
 		{
 			continue;
 		}
-		auto it = m_mineralWorkersMap.find(farMineral);
-		if (it->second.size() == 1)
+		if (getMineralWorkerCount(farMineral) == 1)
 		{
 			return farMineral;
 		}
@@ -495,6 +586,50 @@ const Unit WorkerData::GetBestMineralWithLessWorkersInLists(const std::vector<Un
 	return Unit();
 }
 
+std::vector<Unit> WorkerData::assignMineralWorkers(const Unit & depot, const std::vector<Unit> & workers)
+{
+	auto base = m_bot.Bases().getBaseForDepot(depot);
+	if (!base || workers.empty())
+		return workers;
+
+	std::vector<Unit> patches;
+	m_mineralAssignmentSolver.clear();
+	for (const auto & farPatches : { false, true })
+	{
+		for (const auto & mineral : farPatches ? base->getFarMinerals() : base->getCloseMinerals())
+		{
+			if (!mineral.isValid() || !mineral.isAlive() || mineral.getUnitPtr()->mineral_contents == 0)
+				continue;
+
+			// The workers of the batch free their slot
+			int assignedWorkers = getMineralWorkerCount(mineral);
+			for (const auto & worker : workers)
+			{
+				if (getWorkerMineral(worker) == mineral)
+					--assignedWorkers;
+			}
+			m_mineralAssignmentSolver.addPatch(mineral.getPosition(), Util::Dist(depot, mineral), farPatches, 2 - assignedWorkers);
+			patches.push_back(mineral);
+		}
+	}
+	for (const auto & worker : workers)
+	{
+		const auto currentPatch = std::find(patches.begin(), patches.end(), getWorkerMineral(worker));
+		m_mineralAssignmentSolver.addWorker(worker.getPosition(), currentPatch == patches.end() ? -1 : int(currentPatch - patches.begin()));
+	}
+
+	std::vector<Unit> unassignedWorkers;
+	const auto & assignment = m_mineralAssignmentSolver.solve();
+	for (size_t i = 0; i < workers.size(); ++i)
+	{
+		if (assignment[i] < 0)
+			unassignedWorkers.push_back(workers[i]);
+		else
+			setWorkerJob(workers[i], WorkerJobs::Minerals, depot, patches[assignment[i]]);
+	}
+	return unassignedWorkers;
+}
+
 bool WorkerData::isAnyMineralAvailable(CCPosition workerCurrentPosition) const
 {
 	auto & bases = m_bot.Bases().getOccupiedBaseLocations(Players::Self);
@@ -520,14 +655,7 @@ bool WorkerData::isAnyMineralAvailable(CCPosition workerCurrentPosition) const
 
 Unit WorkerData::getWorkerDepot(const Unit & unit) const
 {
-    auto it = m_workerDepotMap.find(unit);
-
-    if (it != m_workerDepotMap.end())
-    {
-        return it->second;
-    }
-
-    return Unit();
+	return getAssignedResource(m_depots, m_workerDepots, unit);
 }
 
 int WorkerData::getNumAssignedWorkers(const Unit & unit)
@@ -537,32 +665,16 @@ int WorkerData::getNumAssignedWorkers(const Unit & unit)
 	
     if (unit.getType().isResourceDepot())
     {
-        auto it = m_depotWorkerCount.find(unit);
-
-        // if there is an entry, return it
-        if (it != m_depotWorkerCount.end())
-        {
-            return it->second;
-        }
+		return getResourceWorkerCount(m_depots, unit);
     }
     else if (unit.getType().isRefinery())
     {
-        auto it = m_refineryWorkerCount.find(unit);
-
-        // if there is an entry, return it
-        if (it != m_refineryWorkerCount.end())
-        {
+		const int count = getResourceWorkerCount(m_refineries, unit);
 #ifndef PUBLIC_RELEASE
-			if(m_bot.Config().DrawWorkerInfo)
-				m_bot.Map().drawText(unit.getPosition(), "Workers affected: " + std::to_string(it->second));
+		if(m_bot.Config().DrawWorkerInfo)
+			m_bot.Map().drawText(unit.getPosition(), "Workers affected: " + std::to_string(count));
 #endif
-            return it->second;
-        }
-        // otherwise, we are only calling this on completed refineries, so set it
-        else
-        {
-            m_refineryWorkerCount[unit] = 0;
-        }
+		return count;
     }
 
     // when all else fails, return 0
@@ -571,28 +683,16 @@ int WorkerData::getNumAssignedWorkers(const Unit & unit)
 
 std::vector<Unit> WorkerData::getAssignedWorkersRefinery(const Unit & unit)
 {
-	if (unit.getType().isResourceDepot())
-	{
-		auto it = m_refineryWorkerMap.find(unit);
-		// if there is an entry, return it
-		if (it != m_refineryWorkerMap.end())
-		{
-			return it->second;
-		}
-	}
-	else if (unit.getType().isRefinery())
+	std::vector<Unit> workers;
+	const int refinerySlot = m_refineries.find(unit);
+	if (refinerySlot >= 0)
 	{
-		auto it = m_refineryWorkerMap.find(unit);
-
-		// if there is an entry, return it
-		if (it != m_refineryWorkerMap.end())
+		for (const int slot : m_refineries.workers[refinerySlot])
 		{
-			return it->second;
+			workers.push_back(m_workers[slot]);
 		}
 	}
-
-	// when all else fails, return 0
-	return std::vector<Unit>();
+	return workers;
 }
 
 const char * WorkerData::getJobCode(const Unit & unit)
@@ -620,7 +720,7 @@ void WorkerData::drawDepotDebugInfo()
 	if (!m_bot.Config().DrawWorkerInfo)
 		return;
 
-    for (auto depot: m_depots)
+    for (auto & depot : m_depots.units)
     {
         std::stringstream ss;
         ss << "Workers: " << getNumAssignedWorkers(depot);
@@ -634,7 +734,7 @@ void WorkerData::drawDepotDebugInfo()
 	}
 }
 
-const std::set<Unit> & WorkerData::getWorkers() const
+const std::vector<Unit> & WorkerData::getWorkers() const
 {
 	return m_workers;
 }
@@ -644,14 +744,62 @@ const std::set<Unit> & WorkerData::getProxyWorkers() const
 	return m_proxyWorkers;
 }
 
-const std::set<Unit> WorkerData::getIdleWorkers() const
+const std::vector<Unit> & WorkerData::getIdleWorkers() const
+{
+	return m_jobWorkers[WorkerJobs::Idle];
+}
+
+const std::vector<Unit> & WorkerData::getMineralWorkers() const
+{
+	return m_jobWorkers[WorkerJobs::Minerals];
+}
+
+Unit WorkerData::getWorkerMineral(const Unit & worker) const
+{
+	return getAssignedResource(m_minerals, m_workerMinerals, worker);
+}
+
+void WorkerData::setWorkerMineral(const Unit & worker, const Unit & mineral)
+{
+	int slot = getWorkerSlot(worker);
+	if (slot < 0)
+		slot = addWorker(worker);
+	if (mineral.isValid())
+		assignResource(m_minerals, m_workerMinerals, slot, mineral);
+	else
+		unassignResource(m_minerals, m_workerMinerals, slot);
+}
+
+void WorkerData::clearWorkerMineral(const Unit & worker)
+{
+	const int slot = getWorkerSlot(worker);
+	if (slot >= 0)
+		unassignResource(m_minerals, m_workerMinerals, slot);
+}
+
+int WorkerData::getMineralWorkerCount(const Unit & mineral) const
+{
+	return getResourceWorkerCount(m_minerals, mineral);
+}
+
+const std::vector<Unit> & WorkerData::getAssignedMinerals() const
 {
-	return m_idleWorkers;
+	return m_minerals.units;
 }
 
-const std::set<Unit> WorkerData::getMineralWorkers() const
+std::vector<Unit> WorkerData::releaseMineral(const Unit & mineral)
 {
-	return m_mineralWorkers;
+	std::vector<Unit> workers;
+	const int mineralSlot = m_minerals.find(mineral);
+	if (mineralSlot < 0)
+		return workers;
+
+	for (const int slot : m_minerals.workers[mineralSlot])
+	{
+		workers.push_back(m_workers[slot]);
+	}
+	eraseResource(m_minerals, m_workerMinerals, mineralSlot);
+	return workers;
 }
 
 void WorkerData::sendIdleWorkerToIdleSpot(const Unit & worker, bool force)
@@ -855,7 +1003,9 @@ Unit WorkerData::updateWorkerDepot(const Unit & worker, const Unit & mineral)
 		auto & depot = base->getResourceDepot();
 		if (depot.isValid() && depot.isCompleted() && !depot.isFlying())
 		{
-			m_workerDepotMap[worker] = depot;
+			const int slot = getWorkerSlot(worker);
+			if (slot >= 0)
+				assignResource(m_depots, m_workerDepots, slot, depot);
 			return depot;
 		}
 	}
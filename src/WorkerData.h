@@ -2,7 +2,9 @@
 #include "Common.h"
 #include "Unit.h"
 #include "BaseLocation.h"
+#include "MineralAssignmentSolver.h"
 #include <list>
+#include <unordered_map>
 
 class CCBot;
 
@@ -13,42 +15,63 @@ namespace WorkerJobs
 
 class WorkerData
 {
+	// Units the workers are assigned to (minerals, depots or refineries), each one in a dense slot holding the slots of its workers
+	struct ResourceTable
+	{
+		std::unordered_map<const sc2::Unit *, int> slots;
+		std::vector<Unit> units;
+		std::vector<std::vector<int>> workers;
+
+		int find(const Unit & unit) const;
+		int insert(const Unit & unit);
+	};
+
     CCBot & m_bot;
 
-    std::set<Unit>          m_workers;
+	// One dense slot per worker, the assignments are columns indexed by that slot (-1 when not assigned)
+	std::unordered_map<const sc2::Unit *, int> m_workerSlots;
+    std::vector<Unit>       m_workers;
+	std::vector<int>		m_workerJobs;
+	std::vector<int>		m_workerJobIndices;		// position of the worker in the list of its job
+	std::vector<int>		m_workerMinerals;
+	std::vector<int>		m_workerDepots;
+	std::vector<int>		m_workerRefineries;
+	std::vector<Unit>		m_jobWorkers[WorkerJobs::Num];
+	ResourceTable			m_minerals;
+	ResourceTable			m_depots;
+	ResourceTable			m_refineries;
     std::set<Unit>          m_proxyWorkers;
-    std::set<Unit>          m_depots;
-	std::set<Unit>			m_idleWorkers;
-	std::set<Unit>			m_mineralWorkers;
-    std::map<int, int>      m_workerJobCount;
-    std::map<Unit, int>     m_workerJobMap;
-    std::map<Unit, int>     m_refineryWorkerCount;
-    std::map<Unit, int>     m_depotWorkerCount;
-    std::map<Unit, Unit>    m_workerRefineryMap;
-	std::map<Unit, std::vector<Unit>> m_refineryWorkerMap;
     std::map<Unit, std::set<Unit>> m_workerRepairing;
 	std::map<const BaseLocation*, std::list<Unit>> m_repairStationWorkers;
     std::map<Unit, Unit>    m_workerRepairTarget;
 	Unit					m_idleMineralTarget;
+	MineralAssignmentSolver	m_mineralAssignmentSolver;
 
+	int getWorkerSlot(const Unit & unit) const;
+	int addWorker(const Unit & unit);
+	void removeWorker(int slot);
+	void removeFromJob(int slot);
+	void setJob(int slot, int job);
+	void assignResource(ResourceTable & table, std::vector<int> & column, int slot, const Unit & resource);
+	void unassignResource(ResourceTable & table, std::vector<int> & column, int slot);
+	void eraseResource(ResourceTable & table, std::vector<int> & column, int resourceSlot);
+	Unit getAssignedResource(const ResourceTable & table, const std::vector<int> & column, const Unit & worker) const;
+	int getResourceWorkerCount(const ResourceTable & table, const Unit & resource) const;
     void clearPreviousJob(const Unit & unit);
     std::set<Unit> getWorkerRepairingThatTarget(const Unit & unit);
 	const Unit GetBestMineralWithLessWorkersInLists(const std::vector<Unit> & closeMinerals, const std::vector<Unit> & farMinerals, const CCPosition location) const;
 
 public:
-	//Public variables for simplicity
-	std::map<Unit, Unit>	m_workerMineralMap;
-	std::map<Unit, std::list<sc2::Tag>> m_mineralWorkersMap;
-	std::map<Unit, Unit>	m_workerGeyserMap;
-	std::map<Unit, Unit>    m_workerDepotMap;	//<worker, depot>
-
     WorkerData(CCBot & bot);
 
     void    workerDestroyed(const Unit & unit);
     void    updateAllWorkerData();
 	void	updateIdleMineralTarget();
     void    updateWorker(const Unit & unit);
-    void    setWorkerJob(const Unit & unit, int job, Unit jobUnit = Unit());
+    void    setWorkerJob(const Unit & unit, int job, Unit jobUnit = Unit(), Unit mineral = Unit());
+	// Gives the workers the Minerals job at that depot, spread on its patches in a single batch. Returns the workers left
+	// without a patch because every patch of the base already has two workers.
+	std::vector<Unit> assignMineralWorkers(const Unit & depot, const std::vector<Unit> & workers);
     void    drawDepotDebugInfo();
     size_t  getNumWorkers() const;
     int     getWorkerJobCount(int job) const;
@@ -61,10 +84,18 @@ public:
     Unit    getMineralToMine(const Unit & unit, const CCPosition location) const;
     Unit    getWorkerDepot(const Unit & unit) const;
     const char * getJobCode(const Unit & unit);
-    const std::set<Unit> & getWorkers() const;
+    const std::vector<Unit> & getWorkers() const;
     const std::set<Unit> & getProxyWorkers() const;
-	const std::set<Unit> getIdleWorkers() const;
-	const std::set<Unit> getMineralWorkers() const;
+	// Workers with the Idle job, including the proxy workers waiting at the proxy location
+	const std::vector<Unit> & getIdleWorkers() const;
+	const std::vector<Unit> & getMineralWorkers() const;
+	Unit getWorkerMineral(const Unit & worker) const;
+	void setWorkerMineral(const Unit & worker, const Unit & mineral);
+	void clearWorkerMineral(const Unit & worker);
+	int getMineralWorkerCount(const Unit & mineral) const;
+	const std::vector<Unit> & getAssignedMinerals() const;
+	// Forgets the mineral and returns the workers that were mining it
+	std::vector<Unit> releaseMineral(const Unit & mineral);
 	void sendIdleWorkerToIdleSpot(const Unit & worker, bool force);
 	void sendIdleWorkerToMiningSpot(const Unit & worker, bool force);
 	bool isProxyWorker(const Unit & unit) const;
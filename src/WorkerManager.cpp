@@ -8,6 +8,7 @@
 WorkerManager::WorkerManager(CCBot & bot)
     : m_bot         (bot)
     , m_workerData  (bot)
+	, m_miningScheduler(bot)
 {
 
 }
@@ -42,37 +43,37 @@ void WorkerManager::onFrame(bool executeMacro)
 	//	}
 	//}
 
-	m_bot.StartProfiling("0.7.1   m_workerData.updateAllWorkerData");
+	PROFILE_BEGIN("m_workerData.updateAllWorkerData");
     m_workerData.updateAllWorkerData();
-	m_bot.StopProfiling("0.7.1   m_workerData.updateAllWorkerData");
+	PROFILE_END("m_workerData.updateAllWorkerData");
 
-	m_bot.StartProfiling("0.7.1.1   m_workerData.updateIdleMineralTarget");
+	PROFILE_BEGIN("m_workerData.updateIdleMineralTarget");
 	m_workerData.updateIdleMineralTarget();
-	m_bot.StopProfiling("0.7.1.1   m_workerData.updateIdleMineralTarget");
+	PROFILE_END("m_workerData.updateIdleMineralTarget");
 	if (executeMacro)
 	{
 		handleGeyserProtectWorkers();
-		m_bot.StartProfiling("0.7.2   handleMineralWorkers");
+		PROFILE_BEGIN("handleMineralWorkers");
 		handleMineralWorkers();
-		m_bot.StopProfiling("0.7.2   handleMineralWorkers");
-		m_bot.StartProfiling("0.7.3   handleGasWorkers");
+		PROFILE_END("handleMineralWorkers");
+		PROFILE_BEGIN("handleGasWorkers");
 		handleGasWorkers();
-		m_bot.StopProfiling("0.7.3   handleGasWorkers");
-		m_bot.StartProfiling("0.7.4   handleIdleWorkers");
+		PROFILE_END("handleGasWorkers");
+		PROFILE_BEGIN("handleIdleWorkers");
 		handleIdleWorkers();
-		m_bot.StopProfiling("0.7.4   handleIdleWorkers");
-		m_bot.StartProfiling("0.7.5   repairCombatBuildings");
+		PROFILE_END("handleIdleWorkers");
+		PROFILE_BEGIN("repairCombatBuildings");
 		repairCombatBuildings();
-		m_bot.StopProfiling("0.7.5   repairCombatBuildings");
-		m_bot.StartProfiling("0.7.6   lowPriorityChecks");
+		PROFILE_END("repairCombatBuildings");
+		PROFILE_BEGIN("lowPriorityChecks");
 		lowPriorityChecks();
-		m_bot.StopProfiling("0.7.6   lowPriorityChecks");
-		m_bot.StartProfiling("0.7.7   handleRepairWorkers");
+		PROFILE_END("lowPriorityChecks");
+		PROFILE_BEGIN("handleRepairWorkers");
 		handleRepairWorkers();
-		m_bot.StopProfiling("0.7.7   handleRepairWorkers");
-		m_bot.StartProfiling("0.7.8   handleBuildWorkers");
+		PROFILE_END("handleRepairWorkers");
+		PROFILE_BEGIN("handleBuildWorkers");
 		handleBuildWorkers();
-		m_bot.StopProfiling("0.7.8   handleBuildWorkers");
+		PROFILE_END("handleBuildWorkers");
 	}
     drawResourceDebugInfo();
     drawWorkerInformation();
@@ -89,7 +90,7 @@ void WorkerManager::lowPriorityChecks()
 	}
 	m_lastLowPriorityCheckFrame = currentFrame;
 
-	m_bot.StartProfiling("0.7.6.1     SalvageDepletedGeysers");
+	PROFILE_BEGIN("SalvageDepletedGeysers");
 	//Detect depleted geysers
 	for (auto & geyser : m_bot.GetAllyGeyserUnits())
 	{
@@ -108,25 +109,24 @@ void WorkerManager::lowPriorityChecks()
 			}
 		}
 	}
-	m_bot.StopProfiling("0.7.6.1     SalvageDepletedGeysers");
+	PROFILE_END("SalvageDepletedGeysers");
 
-	m_bot.StartProfiling("0.7.6.2     HandleWorkerTransfer");
+	PROFILE_BEGIN("HandleWorkerTransfer");
 	//No longer need to transfer workers since we limit the number of workers per base. Still can be used to send workers to gold bases in advance.
 	//HandleWorkerTransfer();
-	m_bot.StopProfiling("0.7.6.2     HandleWorkerTransfer");
+	PROFILE_END("HandleWorkerTransfer");
 
-	m_bot.StartProfiling("0.7.6.3     validateRepairStationWorkers");
+	PROFILE_BEGIN("validateRepairStationWorkers");
 	m_bot.Workers().getWorkerData().validateRepairStationWorkers();
-	m_bot.StopProfiling("0.7.6.3     validateRepairStationWorkers");
+	PROFILE_END("validateRepairStationWorkers");
 
-	m_bot.StartProfiling("0.7.6.4     clean mineral and workers association");
-	std::vector<Unit> mineralWorkerToRemove;
-	std::vector<Unit> workerMineralToRemove;
+	PROFILE_BEGIN("clean mineral and workers association");
+	std::vector<Unit> mineralsToRemove;
 	auto & bases = m_bot.Bases().getOccupiedBaseLocations(Players::Self);
-	for (auto & mineralWorkers : m_workerData.m_mineralWorkersMap)
+	for (auto & assignedMineral : m_workerData.getAssignedMinerals())
 	{
 		bool remove = true;
-		if (mineralWorkers.first.isValid() && mineralWorkers.first.isAlive() && mineralWorkers.first.getUnitPtr()->mineral_contents > 0)
+		if (assignedMineral.isAlive() && assignedMineral.getUnitPtr()->mineral_contents > 0)
 		{
 			for (auto & base : bases)
 			{
@@ -137,7 +137,7 @@ void WorkerManager::lowPriorityChecks()
 				}
 				for (auto & mineral : base->getMinerals())
 				{
-					if (mineral.isValid() && mineralWorkers.first.getTag() == mineral.getTag())
+					if (mineral.isValid() && assignedMineral.getTag() == mineral.getTag())
 					{
 						remove = false;
 						break;
@@ -151,26 +151,30 @@ void WorkerManager::lowPriorityChecks()
 		}
 		if (remove)
 		{
-			mineralWorkerToRemove.push_back(mineralWorkers.first);
-			for (auto & workerMineral : m_workerData.m_workerMineralMap)
-			{
-				if (workerMineral.second.isValid() && mineralWorkers.first.isValid() && workerMineral.second.getTag() == mineralWorkers.first.getTag())
-				{
-					workerMineralToRemove.push_back(workerMineral.first);
-				}
-			}
+			mineralsToRemove.push_back(assignedMineral);
 		}
 	}
-	for (auto & remove : mineralWorkerToRemove)
+	std::map<Unit, std::vector<Unit>> releasedWorkers;
+	for (auto & mineral : mineralsToRemove)
 	{
-		m_workerData.m_mineralWorkersMap.erase(remove);
+		for (auto & worker : m_workerData.releaseMineral(mineral))
+		{
+			const auto depot = m_workerData.getWorkerDepot(worker);
+			if (m_workerData.getWorkerJob(worker) == WorkerJobs::Minerals && depot.isValid() && depot.isAlive())
+				releasedWorkers[depot].push_back(worker);
+			else
+				m_workerData.setWorkerJob(worker, WorkerJobs::Idle);
+		}
 	}
-	for (auto & remove : workerMineralToRemove)
+	// A depleted patch changes the saturation of its base, so its workers are spread again on the remaining patches
+	for (auto & depotWorkers : releasedWorkers)
 	{
-		m_workerData.m_workerMineralMap.erase(remove);
-		m_workerData.setWorkerJob(remove, WorkerJobs::Idle);
+		for (auto & worker : m_workerData.assignMineralWorkers(depotWorkers.first, depotWorkers.second))
+		{
+			m_workerData.setWorkerJob(worker, WorkerJobs::Idle);
+		}
 	}
-	m_bot.StopProfiling("0.7.6.4     clean mineral and workers association");
+	PROFILE_END("clean mineral and workers association");
 }
 
 //Worker split between bases (transfer worker)
@@ -183,7 +187,7 @@ void WorkerManager::HandleWorkerTransfer()
 
 	auto & workers = getWorkers();
 	auto & bases = m_bot.Bases().getOccupiedBaseLocations(Players::Self);
-	std::set<Unit> idleWorkers = m_bot.Workers().getWorkerData().getIdleWorkers();
+	const std::vector<Unit> idleWorkers = m_bot.Workers().getWorkerData().getIdleWorkers();	// copy, the jobs change during the transfer
 	std::list<std::pair<BaseLocation*, int>> unorderedBasesWithFewWorkers;
 	std::list<std::pair<BaseLocation*, int>> unorderedBasesWithExtraWorkers;
 	for (auto & base : bases)
@@ -236,6 +240,7 @@ void WorkerManager::HandleWorkerTransfer()
 			continue;
 		auto closestWorker = this->getClosestAvailableWorkerTo(depot.getPosition());//Could be replaced by a path from a depot, once its possible.
 		int fewWorkerNeeded = baseWithFewWorkers.second;
+		std::vector<Unit> transferredWorkers;
 
 		//Transfer idle workers first then extra workers
 		for (auto & idleWorker : idleWorkers)
@@ -245,12 +250,17 @@ void WorkerManager::HandleWorkerTransfer()
 				break;
 			}
 
+			if (m_workerData.isProxyWorker(idleWorker) || m_workerData.getWorkerJob(idleWorker) != WorkerJobs::Idle)
+			{
+				continue;
+			}
+
 			if (!Util::PathFinding::IsPathToGoalSafe(closestWorker.getUnitPtr(), idleWorker.getPosition(), true, m_bot))
 			{//Path isn't safe
 				continue;
 			}
 
-			m_workerData.setWorkerJob(idleWorker, WorkerJobs::Minerals, depot);
+			transferredWorkers.push_back(idleWorker);
 			fewWorkerNeeded--;
 		}
 
@@ -300,7 +310,7 @@ void WorkerManager::HandleWorkerTransfer()
 						const auto workerDepot = m_workerData.getWorkerDepot(worker);
 						if (workerDepot.isValid() && workerDepot.getTag() == baseWithExtraWorkers.first->getResourceDepot().getTag())
 						{
-							m_workerData.setWorkerJob(worker, WorkerJobs::Minerals, depot);
+							transferredWorkers.push_back(worker);
 							extraWorkers--;
 							fewWorkerNeeded--;
 							if (extraWorkers <= 0 || fewWorkerNeeded <= 0)
@@ -312,6 +322,12 @@ void WorkerManager::HandleWorkerTransfer()
 				}
 			}
 		}
+
+		// The transferred workers are spread on the patches of their new base together
+		for (auto & worker : m_workerData.assignMineralWorkers(depot, transferredWorkers))
+		{
+			m_workerData.setWorkerJob(worker, WorkerJobs::Minerals, depot);
+		}
 	}
 }
 
@@ -457,53 +473,31 @@ void WorkerManager::handleMineralWorkers()
 		//Correct the mining workers target if its not the right one.
 		if (job == WorkerJobs::Minerals)
 		{
-			auto mineral = m_workerData.m_workerMineralMap.find(worker);
-			if (mineral != m_workerData.m_workerMineralMap.end())
+			auto mineral = m_workerData.getWorkerMineral(worker);
+			if (mineral.isValid())
 			{
-				auto depot = m_workerData.updateWorkerDepot(worker, mineral->second);
+				auto depot = m_workerData.updateWorkerDepot(worker, mineral);
 				if (depot.isValid())
 				{
-					sc2::Tag target;
-					if (worker.getUnitPtr()->orders.size() > 0)
+					// The speed mining commands are issued by the mining scheduler, here we only make sure the worker mines its own mineral
+					m_miningScheduler.track(worker, mineral, depot);
+
+					const auto & orders = worker.getUnitPtr()->orders;
+					if (!orders.empty() && orders[0].ability_id == sc2::ABILITY_ID::MOVE)//If he has a move order, let it happen.
 					{
-						if (worker.getUnitPtr()->orders[0].ability_id == sc2::ABILITY_ID::MOVE)//If he has a move order, let it happen.
-						{
-							continue;
-						}
-						target = worker.getUnitPtr()->orders[0].target_unit_tag;
+						continue;
 					}
 
 					if (worker.isReturningCargo())
 					{
-						if (!m_bot.Config().IsRealTime)
+						if (orders.empty())
 						{
-							auto distsq = Util::DistSq(worker.getPosition(), depot.getPosition());
-							if (distsq > 3.5f * 3.5f && distsq < 5 * 5 && worker.getUnitPtr()->orders.size() < 2)
-							{
-								worker.move(depot.getPosition() + Util::Normalized(worker.getPosition() - depot.getPosition()) * 3);//3 is the distance with the center of the depot, its arbitrary
-								worker.shiftRightClick(depot);
-							}
-							else if (worker.getUnitPtr()->orders.empty())
-							{
-								worker.rightClick(depot);
-							}
+							worker.rightClick(depot);
 						}
 					}
-					else
+					else if (orders.empty() || orders[0].target_unit_tag != mineral.getTag())
 					{
-						auto distToMineral = Util::DistSq(worker.getPosition(), mineral->second.getPosition());
-						if (!m_bot.Config().IsRealTime && distToMineral > 2 * 2 && distToMineral < 2.5f * 2.5f && worker.getUnitPtr()->orders.size() < 2)//Distsq 3 is arbitrary but works great
-						{
-							worker.move(mineral->second.getPosition() + Util::Normalized(worker.getPosition() - mineral->second.getPosition()) * 1.3f);//1.3 is the distance with the mineral, its arbitrary
-							worker.shiftRightClick(mineral->second);
-						}
-						else
-						{
-							if (mineral->second.getTag() != target)
-							{
-								worker.rightClick(mineral->second);
-							}
-						}
+						worker.rightClick(mineral);
 					}
 				}
 				else // No depot for the mineral, the worker shouldn't be a mineral worker
@@ -518,6 +512,10 @@ void WorkerManager::handleMineralWorkers()
 		}
 	}
 
+	PROFILE_BEGIN("miningScheduler");
+	m_miningScheduler.onFrame();
+	PROFILE_END("miningScheduler");
+
 	//split workers on first frame and handle proxy
 	if (!m_isFirstFrame)
 	{
@@ -544,46 +542,18 @@ void WorkerManager::handleMineralWorkers()
 		m_workerData.setProxyWorker(proxyWorker);
 	}
 
-	m_bot.StartProfiling("0.7.2.2     frame1WorkerSplit");
+	PROFILE_BEGIN("frame1WorkerSplit");
 	auto & main = m_bot.Bases().getOccupiedBaseLocations(Players::Self);
-	auto & closePatch = (*main.begin())->getCloseMinerals();
-	auto & farPatch = (*main.begin())->getFarMinerals();
-	std::vector<CCUnitID> usedWorkers;
-	for (auto & mineral : closePatch)
-	{
-		usedWorkers = dispatchWorkerToMineral(mineral, usedWorkers, (*main.begin())->getResourceDepot());
-	}
-	for (auto & mineral : farPatch)
-	{
-		usedWorkers = dispatchWorkerToMineral(mineral, usedWorkers, (*main.begin())->getResourceDepot());
-	}
-	for (auto & mineral : closePatch)
-	{
-		usedWorkers = dispatchWorkerToMineral(mineral, usedWorkers, (*main.begin())->getResourceDepot());
-	}
-	for (auto & mineral : farPatch)
-	{
-		usedWorkers = dispatchWorkerToMineral(mineral, usedWorkers, (*main.begin())->getResourceDepot());
-	}
-	m_bot.StopProfiling("0.7.2.2     frame1WorkerSplit");
-}
-
-std::vector<CCUnitID> WorkerManager::dispatchWorkerToMineral(const Unit & mineral, std::vector<CCUnitID> usedWorkers, const Unit & ressourceDepot)
-{
-	auto worker = getClosestAvailableWorkerTo(mineral.getPosition(), usedWorkers, 0);
-	if (!worker.isValid())
+	std::vector<Unit> splitWorkers;
+	for (auto & worker : getWorkers())
 	{
-		return usedWorkers;
+		if (isFree(worker) && !m_workerData.isProxyWorker(worker))
+		{
+			splitWorkers.push_back(worker);
+		}
 	}
-	usedWorkers.push_back(worker.getTag());
-
-	worker.rightClick(mineral);
-
-	m_workerData.m_workerMineralMap[worker] = mineral;
-	m_workerData.m_mineralWorkersMap[mineral].push_back(worker.getTag());
-
-	m_workerData.setWorkerJob(worker, WorkerJobs::Minerals, ressourceDepot);
-	return usedWorkers;
+	m_workerData.assignMineralWorkers((*main.begin())->getResourceDepot(), splitWorkers);
+	PROFILE_END("frame1WorkerSplit");
 }
 
 void WorkerManager::handleMules()
@@ -628,7 +598,7 @@ void WorkerManager::handleMules()
 				if (mineral)
 				{
 					Micro::SmartRightClick(mule.getUnitPtr(), mineral, m_bot);//Cannot be done frame 1, thats why its in the 'else' clause
-					muleHarvests[id].mineral = m_bot.GetNeutralUnits()[mineral->tag];
+					muleHarvests[id].mineral = m_bot.GetUnit(mineral->tag);
 				}
 			}
 		}
@@ -747,14 +717,14 @@ void WorkerManager::handleGasWorkers()
 		auto base = m_bot.Bases().getBaseContainingPosition(geyserPosition, Players::Self);
 		if (base == nullptr || !base->getResourceDepot().isValid())
 		{
-			m_bot.StartProfiling("0.7.3.1    setIdleWhenBaseIsDestroyed");
+			PROFILE_BEGIN("setIdleWhenBaseIsDestroyed");
 			//if the base is destroyed, remove the gas workers
 			for (int i = 0; i < numAssigned; i++)
 			{
 				auto gasWorker = getGasWorker(geyser, false, false);
 				m_workerData.setWorkerJob(gasWorker, WorkerJobs::Idle);
 			}
-			m_bot.StopProfiling("0.7.3.1    setIdleWhenBaseIsDestroyed");
+			PROFILE_END("setIdleWhenBaseIsDestroyed");
 			continue;
 		}
 
@@ -770,7 +740,7 @@ void WorkerManager::handleGasWorkers()
 
 		if (numAssigned < geyserGasWorkersTarget)
 		{
-			m_bot.StartProfiling("0.7.3.2    assignNewGasWorkers");
+			PROFILE_BEGIN("assignNewGasWorkers");
 			// if it's less than we want it to be, fill 'er up
 			bool shouldAssignThisWorker = true;
 			auto refineryWorkers = m_workerData.getAssignedWorkersRefinery(geyser);
@@ -794,11 +764,11 @@ void WorkerManager::handleGasWorkers()
 					}
 				}
 			}
-			m_bot.StopProfiling("0.7.3.2    assignNewGasWorkers");
+			PROFILE_END("assignNewGasWorkers");
 		}
 		else if (numAssigned > geyserGasWorkersTarget)
 		{
-			m_bot.StartProfiling("0.7.3.3    unassignGasWorkers");
+			PROFILE_BEGIN("unassignGasWorkers");
 			int mineralWorkerRoom = 26;//Number of free spaces for mineral workers
 			int mineralWorkersCount = m_workerData.getNumAssignedWorkers(depot);
 			int optimalWorkersCount = base->getOptimalMineralWorkerCount();
@@ -827,21 +797,21 @@ void WorkerManager::handleGasWorkers()
 					mineralWorkerRoom--;
 				}
 			}
-			m_bot.StopProfiling("0.7.3.3    unassignGasWorkers");
+			PROFILE_END("unassignGasWorkers");
 		}
     }
 
-	m_bot.StartProfiling("0.7.3.4    gasBunkerMicro");
+	PROFILE_BEGIN("gasBunkerMicro");
 #ifndef PUBLIC_RELEASE
 	std::vector<sc2::Tag> bunkerHasLoaded;
 #endif
 	for (auto & geyser : m_bot.GetAllyGeyserUnits())
 	{
-		m_bot.StartProfiling("0.7.3.4.1     initialChecks");
+		PROFILE_BEGIN("initialChecks");
 		auto base = m_bot.Bases().getBaseContainingPosition(geyser.getPosition(), Players::Self);
 		if (base == nullptr)
 		{
-			m_bot.StopProfiling("0.7.3.4.1     initialChecks");
+			PROFILE_END("initialChecks");
 			continue;
 		}
 		auto & depot = base->getResourceDepot();
@@ -852,11 +822,11 @@ void WorkerManager::handleGasWorkers()
 		}
 
 		auto workers = m_bot.Workers().m_workerData.getAssignedWorkersRefinery(geyser);
-		m_bot.StopProfiling("0.7.3.4.1     initialChecks");
+		PROFILE_END("initialChecks");
 		if (base->isGeyserSplit())
 		{
 			// COMMENTED BECAUSE IT CAUSES A VERY VERY BAD BUG WHERE THE WORKERS STOP MOVING (AND CAUSED US TO LOSE IN PROBOTS)
-			/*m_bot.StartProfiling("0.7.3.4.2     handleWorkers");
+			/*PROFILE_BEGIN("handleWorkers");
 			for (auto & worker : workers)//Handle workers inside
 			{
 				if (!worker.isValid() || !worker.isAlive() || worker.getType().isMule())
@@ -983,7 +953,7 @@ void WorkerManager::handleGasWorkers()
 					m_workerData.setWorkerJob(worker, WorkerJobs::Idle);
 				}
 			}
-			m_bot.StopProfiling("0.7.3.4.2     handleWorkers");*/
+			PROFILE_END("handleWorkers");*/
 		}
 		else
 		{
@@ -1003,7 +973,7 @@ void WorkerManager::handleGasWorkers()
 				auto hasReturningWorker = false;
 				if (!base->isGeyserSplit())
 				{
-					m_bot.StartProfiling("0.7.3.4.2     handleWorkers");
+					PROFILE_BEGIN("handleWorkers");
 					for (auto & worker : workers)//Handle workers inside
 					{
 						if (m_bot.Commander().isInside(worker.getTag()))
@@ -1077,8 +1047,8 @@ void WorkerManager::handleGasWorkers()
 							}
 					}
 				}
-					m_bot.StopProfiling("0.7.3.4.2     handleWorkers");
-					m_bot.StartProfiling("0.7.3.4.3     unloadUnwantedPassengers");
+					PROFILE_END("handleWorkers");
+					PROFILE_BEGIN("unloadUnwantedPassengers");
 					if (workers.size() == 0)//Empty bunkers if they have units inside that shouldn't be inside
 					{
 						auto passengers = bunker.getUnitPtr()->passengers;
@@ -1095,13 +1065,13 @@ void WorkerManager::handleGasWorkers()
 							}
 						}
 					}
-					m_bot.StopProfiling("0.7.3.4.3     unloadUnwantedPassengers");
+					PROFILE_END("unloadUnwantedPassengers");
 				}
 				else
 				{
 					//UNHANDLED SINGLE GEYSER
 				}
-				m_bot.StartProfiling("0.7.3.4.5     unloadOutOfPlaceWorkers");
+				PROFILE_BEGIN("unloadOutOfPlaceWorkers");
 				for (auto & unit : bunker.getUnitPtr()->passengers)
 				{
 					if (unit.unit_type != sc2::UNIT_TYPEID::TERRAN_SCV)
@@ -1124,15 +1094,17 @@ void WorkerManager::handleGasWorkers()
 						}
 					}
 				}
-				m_bot.StopProfiling("0.7.3.4.5     unloadOutOfPlaceWorkers");
+				PROFILE_END("unloadOutOfPlaceWorkers");
 			}
 		}
 	}
-	m_bot.StopProfiling("0.7.3.4    gasBunkerMicro");
+	PROFILE_END("gasBunkerMicro");
 }
 
 void WorkerManager::handleIdleWorkers()
 {
+	std::map<Unit, std::vector<Unit>> newMineralWorkers;	// <depot, workers>
+
     // for each of our workers
     for (auto & worker : m_workerData.getWorkers())
     {
@@ -1152,16 +1124,16 @@ void WorkerManager::handleIdleWorkers()
 			(workerJob != WorkerJobs::Combat) &&
 			(workerJob != WorkerJobs::Build))//Prevent premoved builder from going Idle if they lack the ressources, also prevents refinery builder from going Idle
 		{
-			m_bot.StartProfiling("0.7.4.1    setIdleJob");
+			PROFILE_BEGIN("setIdleJob");
 			m_workerData.setWorkerJob(worker, WorkerJobs::Idle);
 			workerJob = WorkerJobs::Idle;
-			m_bot.StopProfiling("0.7.4.1    setIdleJob");
+			PROFILE_END("setIdleJob");
 		}
 		else if (workerJob == WorkerJobs::Build)
 		{
 			if (!worker.isConstructingAnything())
 			{
-				m_bot.StartProfiling("0.7.4.2    checkHasBuilding");
+				PROFILE_BEGIN("checkHasBuilding");
 				bool hasBuilding = false;
 				bool isCloseToBuildingLocation = false;
 				if (idle)
@@ -1186,7 +1158,7 @@ void WorkerManager::handleIdleWorkers()
 						}
 					}
 				}
-				m_bot.StopProfiling("0.7.4.2    checkHasBuilding");
+				PROFILE_END("checkHasBuilding");
 				if (hasBuilding)
 				{
 					if (isCloseToBuildingLocation)
@@ -1205,11 +1177,11 @@ void WorkerManager::handleIdleWorkers()
 					auto orders = worker.getUnitPtr()->orders;
 					if (!orders.empty() && orders[0].ability_id != sc2::ABILITY_ID::PATROL)
 					{
-						m_bot.StartProfiling("0.7.4.3    setIdleJobToBuilder");
+						PROFILE_BEGIN("setIdleJobToBuilder");
 						//return mining
 						m_workerData.setWorkerJob(worker, WorkerJobs::Idle);
 						workerJob = WorkerJobs::Idle;
-						m_bot.StopProfiling("0.7.4.3    setIdleJobToBuilder");
+						PROFILE_END("setIdleJobToBuilder");
 					}
 				}
 			}
@@ -1223,7 +1195,7 @@ void WorkerManager::handleIdleWorkers()
 			}
 			else
 			{
-				m_bot.StartProfiling("0.7.4.4    setBuildJob");
+				PROFILE_BEGIN("setBuildJob");
 				bool isBuilder = false;
 				for(const auto & building : m_bot.Buildings().getBuildings())
 				{
@@ -1234,29 +1206,44 @@ void WorkerManager::handleIdleWorkers()
 						break;
 					}
 				}
-				m_bot.StopProfiling("0.7.4.4    setBuildJob");
+				PROFILE_END("setBuildJob");
 				
 				if (!isBuilder && !m_workerData.isProxyWorker(worker))
 				{
-					m_bot.StartProfiling("0.7.4.5    isAnyMineralAvailable");
+					PROFILE_BEGIN("isAnyMineralAvailable");
 					const bool isAnyMineralAvailable = m_workerData.isAnyMineralAvailable(worker.getPosition());
-					m_bot.StopProfiling("0.7.4.5    isAnyMineralAvailable");
+					PROFILE_END("isAnyMineralAvailable");
 					if (isAnyMineralAvailable)
 					{
-						m_bot.StartProfiling("0.7.4.6    setMineralWorker");
-						setMineralWorker(worker);
-						m_bot.StopProfiling("0.7.4.6    setMineralWorker");
+						PROFILE_BEGIN("setMineralWorker");
+						const auto depot = getClosestDepot(worker);
+						if (depot.isValid() && depot.isCompleted())
+						{
+							newMineralWorkers[depot].push_back(worker);
+						}
+						PROFILE_END("setMineralWorker");
 					}
 					else//Do not set as mineral worker if there is no place for it
 					{
-						m_bot.StartProfiling("0.7.4.7    sendIdleWorkerToMiningSpot");
+						PROFILE_BEGIN("sendIdleWorkerToMiningSpot");
 						m_workerData.sendIdleWorkerToMiningSpot(worker, false);
-						m_bot.StopProfiling("0.7.4.7    sendIdleWorkerToMiningSpot");
+						PROFILE_END("sendIdleWorkerToMiningSpot");
 					}
 				}
 			}
 		}
     }
+
+	// The new mineral workers of a depot are spread on its patches together, the ones left without a patch can still go to another base
+	PROFILE_BEGIN("assignMineralWorkers");
+	for (auto & depotWorkers : newMineralWorkers)
+	{
+		for (auto & worker : m_workerData.assignMineralWorkers(depotWorkers.first, depotWorkers.second))
+		{
+			m_workerData.setWorkerJob(worker, WorkerJobs::Minerals, depotWorkers.first);
+		}
+	}
+	PROFILE_END("assignMineralWorkers");
 }
 
 void WorkerManager::handleRepairWorkers()
@@ -1270,7 +1257,7 @@ void WorkerManager::handleRepairWorkers()
 	int mineral = m_bot.GetMinerals();
 	int gas = m_bot.GetGas();
 
-	m_bot.StartProfiling("0.7.7.1    stopRepairing");
+	PROFILE_BEGIN("stopRepairing");
     for (auto & worker : m_workerData.getWorkers())
     {
         if (!worker.isValid()) { continue; }
@@ -1334,7 +1321,7 @@ void WorkerManager::handleRepairWorkers()
             }
         }*/
     }
-	m_bot.StopProfiling("0.7.7.1    stopRepairing");
+	PROFILE_END("stopRepairing");
 
 	if (mineral < REPAIR_STATION_MIN_MINERAL)//Stop repairing if not enough minerals
 	{
@@ -1359,7 +1346,7 @@ void WorkerManager::handleRepairWorkers()
 	*/
 	int currentMaxRepairWorker = std::min(MAX_REPAIR_WORKER, (int)floor(MAX_REPAIR_WORKER * (mineral / (float)FULL_REPAIR_MINERAL)));
 
-	m_bot.StartProfiling("0.7.7.2    chooseRepairStationWorkers");
+	PROFILE_BEGIN("chooseRepairStationWorkers");
 	auto & bases = m_bot.Bases().getOccupiedBaseLocations(Players::Self);
 	for (auto base : bases)
 	{
@@ -1437,9 +1424,9 @@ void WorkerManager::handleRepairWorkers()
 			}
 		}
 	}
-	m_bot.StopProfiling("0.7.7.2    chooseRepairStationWorkers");
+	PROFILE_END("chooseRepairStationWorkers");
 
-	m_bot.StartProfiling("0.7.7.3    repairBuildings");
+	PROFILE_BEGIN("repairBuildings");
 	//Automatically repair low health buildings, maximum 1 worker
 	const float MIN_HEALTH = 50.f;
 	const float MAX_HEALTH = 100.f;
@@ -1475,9 +1462,9 @@ void WorkerManager::handleRepairWorkers()
 			}
 		}
 	}
-	m_bot.StopProfiling("0.7.7.3    repairBuildings");
+	PROFILE_END("repairBuildings");
 
-	m_bot.StartProfiling("0.7.7.4    repairSlowMechs");
+	PROFILE_BEGIN("repairSlowMechs");
 	// Automatically repair slow mechs defending our base
 	std::vector<sc2::UNIT_TYPEID> slowMechTypes = { sc2::UNIT_TYPEID::TERRAN_SIEGETANK, sc2::UNIT_TYPEID::TERRAN_SIEGETANKSIEGED, sc2::UNIT_TYPEID::TERRAN_THOR, sc2::UNIT_TYPEID::TERRAN_THORAP, sc2::UNIT_TYPEID::TERRAN_BATTLECRUISER };
 	std::map<std::string, Squad> & squads = m_bot.Commander().Combat().getSquadData().getSquads();
@@ -1516,7 +1503,7 @@ void WorkerManager::handleRepairWorkers()
 			}
 		}
 	}
-	m_bot.StopProfiling("0.7.7.4    repairSlowMechs");
+	PROFILE_END("repairSlowMechs");
 }
 
 void WorkerManager::handleBuildWorkers()
@@ -1654,7 +1641,7 @@ void WorkerManager::repairCombatBuildings()//Ignores if the path or the area aro
 		if (shouldRepair)
 		{
 			int reparator = maxReparator - floor(maxReparator * building.getHitPointsPercentage() / 100);
-			std::set<Unit> workers = getWorkers();
+			const auto & workers = getWorkers();
 			for (auto & worker : workers)
 			{
 				Unit repairedUnit = m_workerData.getWorkerRepairTarget(worker);
@@ -1874,20 +1861,6 @@ Unit WorkerManager::getClosest(const Unit unit, const std::list<Unit> units) con
 	return orderedUnits;
 }*/
 
-// set a worker to mine minerals
-void WorkerManager::setMineralWorker(const Unit & unit)
-{
-    // check if there is a mineral available to send the worker to
-    auto depot = getClosestDepot(unit);
-
-    // if there is a valid mineral
-    if (depot.isValid() && depot.isCompleted())
-    {
-        // update m_workerData with the new job
-        m_workerData.setWorkerJob(unit, WorkerJobs::Minerals, depot);
-    }
-}
-
 Unit WorkerManager::getClosestDepot(Unit worker) const
 {
     Unit closestDepot;
@@ -2191,27 +2164,20 @@ void WorkerManager::drawWorkerInformation()
 
 		if (true)//Advantage mineral worker display
 		{
-			auto & workers = getWorkers();
-			for (auto & mineralWorker : m_workerData.m_mineralWorkersMap)
+			auto mineral = m_workerData.getWorkerMineral(worker);
+			if (mineral.isValid())
 			{
-				std::ostringstream oss;
-				oss << mineralWorker.second.size();
-				m_bot.Map().drawText(mineralWorker.first.getPosition(), oss.str());
-
-				for (auto & worker : workers)
-				{
-					//if (m_workerData.getWorkerJob(worker) != WorkerJobs::Minerals)
-					//{
-					//	continue;
-					//}
-					if (std::find(mineralWorker.second.begin(), mineralWorker.second.end(), worker.getTag()) != mineralWorker.second.end())//worker.getTag() != mineralWorker.second)
-					{
-						m_bot.Map().drawLine(mineralWorker.first.getPosition(), worker.getPosition(), CCColor(0, 255, 0));
-					}
-				}
+				m_bot.Map().drawLine(mineral.getPosition(), worker.getPosition(), CCColor(0, 255, 0));
 			}
 		}
     }
+
+	for (auto & mineral : m_workerData.getAssignedMinerals())
+	{
+		std::ostringstream oss;
+		oss << m_workerData.getMineralWorkerCount(mineral);
+		m_bot.Map().drawText(mineral.getPosition(), oss.str());
+	}
 }
  
 bool WorkerManager::isFree(Unit worker) const
@@ -2280,7 +2246,7 @@ int WorkerManager::getNumWorkers()
     return count;
 }
 
-const std::set<Unit> & WorkerManager::getWorkers() const
+const std::vector<Unit> & WorkerManager::getWorkers() const
 {
 	return m_workerData.getWorkers();
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "WorkerData.h"
+#include "MiningScheduler.h"
 #include <list>
 
 class Building;
@@ -39,14 +40,12 @@ class WorkerManager
 	std::map<sc2::Tag, std::vector<Unit *>> mineralWorkers;
 	std::map<const sc2::Unit*, Unit> geyserProtectors;	//<geyser, worker>
     mutable WorkerData  m_workerData;
+	MiningScheduler m_miningScheduler;
     Unit m_previousClosestWorker;
 
-    void setMineralWorker(const Unit & unit);
-    
 	void handleGeyserProtectWorkers();
 	void freeGeyserProtectors();
 	void handleMineralWorkers();
-	std::vector<CCUnitID> dispatchWorkerToMineral(const Unit & mineral, std::vector<CCUnitID> usedWorkers, const Unit & ressourceDepot);
 	void handleMules();
     void handleGasWorkers();
 	void handleIdleWorkers();
@@ -76,7 +75,7 @@ public:
     int  getNumMineralWorkers();
     int  getNumGasWorkers();
     int  getNumWorkers();
-	const std::set<Unit> & getWorkers() const;
+	const std::vector<Unit> & getWorkers() const;
 	WorkerData & getWorkerData() const;
 	
 	void setMineralMuleDeathFrame(sc2::Tag mineral);
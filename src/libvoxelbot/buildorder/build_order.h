@@ -104,6 +104,8 @@ namespace libvoxelbot {
 		std::shared_ptr<const BuildOrder> buildOrder;
 		int buildIndex = 0;
 		sc2::UNIT_TYPEID lastChronoUnit = sc2::UNIT_TYPEID::INVALID;
+		/** Time at which the last started item of the build order finishes, kept so that a simulation can be resumed at buildIndex */
+		float lastEventTime = 0;
 
 		BuildOrderState(std::shared_ptr<const BuildOrder> buildOrder) : buildOrder(buildOrder) {}
 	};
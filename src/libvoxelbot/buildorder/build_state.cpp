@@ -5,6 +5,11 @@
 using namespace std;
 using namespace sc2;
 
+/** Ordering of the event heap, the earliest event is at the top */
+static bool isLaterEvent(const BuildEvent& a, const BuildEvent& b) {
+    return b < a;
+}
+
 libvoxelbot::BuildState::BuildState(std::vector<std::pair<sc2::UNIT_TYPEID, int>> unitCounts) {
     assert(unitCounts.size() > 0);
     race = getUnitData(unitCounts[0].first).race;
@@ -188,6 +193,8 @@ void libvoxelbot::BuildState::makeUnitsBusy(UNIT_TYPEID type, UNIT_TYPEID addon,
     if (delta == 0)
         return;
 
+    invalidateMiningSpeed();
+
     for (auto& u : units) {
         if (u.type == type && u.addon == addon) {
             u.busyUnits += delta;
@@ -211,6 +218,8 @@ void libvoxelbot::BuildState::addUnits(UNIT_TYPEID type, UNIT_TYPEID addon, int
     if (delta == 0)
         return;
 
+    invalidateMiningSpeed();
+
     for (auto& u : units) {
         if (u.type == type && u.addon == addon) {
             u.units += delta;
@@ -236,25 +245,32 @@ void libvoxelbot::BuildState::killUnits(UNIT_TYPEID type, UNIT_TYPEID addon, int
     
     assert(count > 0);
 
+    invalidateMiningSpeed();
+
     for (auto& u : units) {
         if (u.type == type && u.addon == addon) {
             u.units -= count;
             assert(u.units >= 0);
             while(u.availableUnits() < 0) {
-                bool found = false;
+                // Find the last event that keeps one of the units busy
+                int latestEvent = -1;
                 for (int i = events.size() - 1; i >= 0; i--) {
                     auto& ev = events[i];
                     if (ev.caster == type && ev.casterAddon == addon && (ev.type == BuildEventType::MakeUnitAvailable || (ev.type == BuildEventType::FinishedUnit && type != UNIT_TYPEID::PROTOSS_PROBE) || ev.type == BuildEventType::FinishedUpgrade)) {
-                        // This event is guaranteed to keep a unit busy
-                        // Let's erase the event to free the unit for other work
-                        // Note that FinishedUnit events with caster==Probe do not keep the probe busy: there will be a second MakeUnitAvailable event that marks the probe as busy for a shorter time
-                        events.erase(events.begin() + i);
-                        u.busyUnits--;
-                        found = true;
-                        break;
+                        if (latestEvent == -1 || events[latestEvent].time < ev.time) latestEvent = i;
                     }
                 }
 
+                bool found = latestEvent != -1;
+                if (found) {
+                    // This event is guaranteed to keep a unit busy
+                    // Let's erase the event to free the unit for other work
+                    // Note that FinishedUnit events with caster==Probe do not keep the probe busy: there will be a second MakeUnitAvailable event that marks the probe as busy for a shorter time
+                    events.erase(events.begin() + latestEvent);
+                    make_heap(events.begin(), events.end(), isLaterEvent);
+                    u.busyUnits--;
+                }
+
                 // TODO: Check if this happens oftens, if so it might be worth it to optimize this case
                 if (!found) {
                     // Forcefully remove busy units.
@@ -293,6 +309,8 @@ void MiningSpeed::simulateMining (libvoxelbot::BuildState& state, float dt) cons
         auto slots = base.mineralSlots();
         float weight = slots.first * 1.5f + slots.second;
         base.mineMinerals(deltaMineralsPerWeight * weight);
+        // Fewer mineral slots on a base changes the mining speed
+        if (base.mineralSlots() != slots) state.invalidateMiningSpeed();
     }
     state.resources.minerals += mineralsPerSecond * dt;
     state.resources.vespene += vespenePerSecond * dt;
@@ -341,6 +359,14 @@ std::pair<bool, float> ChronoBoostInfo::useChronoBoost(float time) {
 }
 
 MiningSpeed libvoxelbot::BuildState::miningSpeed() const {
+    if (!miningSpeedIsCached) {
+        cachedMiningSpeed = calculateMiningSpeed();
+        miningSpeedIsCached = true;
+    }
+    return cachedMiningSpeed;
+}
+
+MiningSpeed libvoxelbot::BuildState::calculateMiningSpeed() const {
     int harvesters = 0;
     int mules = 0;
     int bases = 0;
@@ -419,9 +445,17 @@ float libvoxelbot::BuildState::timeToGetResources(MiningSpeed miningSpeed, float
 }
 
 void libvoxelbot::BuildState::addEvent(BuildEvent event) {
-    // TODO: Insertion sort or something
     events.push_back(event);
-    sort(events.begin(), events.end());
+    push_heap(events.begin(), events.end(), isLaterEvent);
+}
+
+float libvoxelbot::BuildState::nextEconomicEventTime() const {
+    // The heap is not sorted, so every event has to be checked
+    float nextTime = numeric_limits<float>::infinity();
+    for (auto& ev : events) {
+        if (ev.time < nextTime && ev.impactsEconomy()) nextTime = ev.time;
+    }
+    return nextTime;
 }
 
 // All actions up to and including the end time will have been completed
@@ -430,25 +464,28 @@ void libvoxelbot::BuildState::simulate(float endTime, const function<void(const
         return;
 
     auto currentMiningSpeed = miningSpeed();
-    // int eventIndex;
-    // for (eventIndex = 0; eventIndex < events.size(); eventIndex++) {
+    // Mining is only applied when something may depend on the resources (an economic event or the callback).
+    // Between those the mining speed is constant, so the idle intervals are skipped in a single step.
+    float minedUntil = time;
     while(events.size() > 0) {
-        // TODO: Slow
-        auto ev = *events.begin();
-
-        // auto& ev = events[eventIndex];
+        auto ev = events[0];
         if (ev.time > endTime) {
             break;
         }
 
-        events.erase(events.begin());
-        float dt = ev.time - time;
-        currentMiningSpeed.simulateMining(*this, dt);
+        pop_heap(events.begin(), events.end(), isLaterEvent);
+        events.pop_back();
         time = ev.time;
 
+        bool economic = ev.impactsEconomy();
+        if (economic || eventCallback != nullptr) {
+            currentMiningSpeed.simulateMining(*this, time - minedUntil);
+            minedUntil = time;
+        }
+
         ev.apply(*this);
 
-        if (ev.impactsEconomy()) {
+        if (economic) {
             currentMiningSpeed = miningSpeed();
         } else {
             // Ideally this would always hold, but when we simulate actual bases with mineral patches the approximations used are not entirely accurate and the mining rate may change even when there is no economically significant event
@@ -461,17 +498,16 @@ void libvoxelbot::BuildState::simulate(float endTime, const function<void(const
         if (upgrades.hasUpgrade(sc2::UPGRADE_ID::WARPGATERESEARCH)) transitionToWarpgates(eventCallback);
     }
 
-    // events.erase(events.begin(), events.begin() + eventIndex);
-
     {
-        float dt = endTime - time;
+        float dt = endTime - minedUntil;
         currentMiningSpeed.simulateMining(*this, dt);
         time = endTime;
     }
 }
 
 bool libvoxelbot::BuildState::simulateBuildOrder(const BuildOrder& buildOrder, const function<void(int)> callback, bool waitUntilItemsFinished) {
-    BuildOrderState state(make_shared<BuildOrder>(buildOrder));
+    // The state does not outlive this call, so it can point to the build order without owning (and copying) it
+    BuildOrderState state(shared_ptr<const BuildOrder>(shared_ptr<const BuildOrder>(), &buildOrder));
     return simulateBuildOrder(state, callback, waitUntilItemsFinished);
 }
 
@@ -498,21 +534,13 @@ float getWarpgateBuildingTime(UNIT_TYPEID unitType, float defaultTime) {
 }
 
 bool libvoxelbot::BuildState::simulateBuildOrder(BuildOrderState& buildOrder, const function<void(int)> callback, bool waitUntilItemsFinished, float maxTime, const function<void(const BuildEvent&)>* eventCallback) {
-    float lastEventInBuildOrder = 0;
-
     // Loop through the build order
     for (; buildOrder.buildIndex < (int)buildOrder.buildOrder->size(); buildOrder.buildIndex++) {
         auto item = (*buildOrder.buildOrder)[buildOrder.buildIndex];
         if (item.chronoBoosted) buildOrder.lastChronoUnit = item.rawType();
 
         while (true) {
-            float nextSignificantEvent = numeric_limits<float>::infinity();
-            for (auto& ev : events) {
-                if (ev.impactsEconomy()) {
-                    nextSignificantEvent = ev.time;
-                    break;
-                }
-            }
+            float nextSignificantEvent = nextEconomicEventTime();
 
             bool isUnitAddon;
             int mineralCost, vespeneCost;
@@ -663,6 +691,7 @@ bool libvoxelbot::BuildState::simulateBuildOrder(BuildOrderState& buildOrder, co
 
             // Mark the caster as being busy
             casterUnit->busyUnits++;
+            invalidateMiningSpeed();
             assert(casterUnit->availableUnits() >= 0);
 
             if (casterUnit->type == UNIT_TYPEID::PROTOSS_WARPGATE) {
@@ -700,7 +729,7 @@ bool libvoxelbot::BuildState::simulateBuildOrder(BuildOrderState& buildOrder, co
             auto newEvent = BuildEvent(item.isUnitType() ? BuildEventType::FinishedUnit : BuildEventType::FinishedUpgrade, time + buildTime, casterUnit->type, ability);
             newEvent.casterAddon = casterUnit->addon;
             newEvent.chronoEndTime = chrono.second;
-            lastEventInBuildOrder = max(lastEventInBuildOrder, newEvent.time);
+            buildOrder.lastEventTime = max(buildOrder.lastEventTime, newEvent.time);
             addEvent(newEvent);
             if (casterUnit->type == UNIT_TYPEID::PROTOSS_PROBE) {
                 addEvent(BuildEvent(BuildEventType::MakeUnitAvailable, time + 6, UNIT_TYPEID::PROTOSS_PROBE, ABILITY_ID::INVALID));
@@ -712,7 +741,7 @@ bool libvoxelbot::BuildState::simulateBuildOrder(BuildOrderState& buildOrder, co
         }
     }
 
-    if (waitUntilItemsFinished) simulate(lastEventInBuildOrder, eventCallback);
+    if (waitUntilItemsFinished) simulate(buildOrder.lastEventTime, eventCallback);
     return true;
 }
 
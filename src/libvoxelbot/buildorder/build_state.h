@@ -159,7 +159,9 @@ struct libvoxelbot::BuildState {
 
     /** All units in the current state */
     std::vector<BuildUnitInfo> units;
-    /** All future events, sorted in ascending order by their time */
+    /** All future events, kept as a binary min-heap on their time (events[0] is always the next event).
+     * Use addEvent to insert events so that the heap property is preserved.
+     */
     std::vector<BuildEvent> events;
     /** Current resources */
     BuildResources resources = BuildResources(0,0);
@@ -171,6 +173,11 @@ struct libvoxelbot::BuildState {
 
 private:
     mutable uint64_t cachedHash = 0;
+    /** Mining speed only changes when harvesters, bases or mineral slots change, so it is computed only then */
+    mutable MiningSpeed cachedMiningSpeed = { 0, 0 };
+    mutable bool miningSpeedIsCached = false;
+
+    MiningSpeed calculateMiningSpeed() const;
 public:
 
     BuildState() {}
@@ -242,6 +249,14 @@ public:
     /** Returns the current mining speed of (minerals,vespene gas) per second (at normal game speed) */
     MiningSpeed miningSpeed() const;
 
+    /** Must be called after modifying the units or the bases directly instead of going through the methods of the state */
+    void invalidateMiningSpeed() {
+        miningSpeedIsCached = false;
+    }
+
+    /** Time of the next event that may change food or mining speed, infinity if there is none */
+    float nextEconomicEventTime() const;
+
     /** Returns the time it will take to get the specified resources using the given mining speed */
     float timeToGetResources(MiningSpeed miningSpeed, float mineralCost, float vespeneCost) const;
 
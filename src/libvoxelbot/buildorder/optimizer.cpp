@@ -1,6 +1,10 @@
 #include "optimizer.h"
 #include <algorithm>
+#include <atomic>
+#include <deque>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <random>
 #include <stack>
 #include <iostream>
@@ -9,6 +13,7 @@
 #include "../utilities/predicates.h"
 #include "../utilities/profiler.h"
 #include "../utilities/stdutils.h"
+#include "../utilities/thread_pool.h"
 #include "../common/unit_lists.h"
 #include "tracker.h"
 #include <cereal/archives/json.hpp>
@@ -435,14 +440,214 @@ pair<vector<int>, vector<int>> calculateStartingUnitCounts(const libvoxelbot::Bu
     return { startingUnitCounts, startingAddonCountPerUnitType };
 }
 
-/** Calculates the fitness of a given build order gene, a higher value is better */
-BuildOrderFitness calculateFitness(const libvoxelbot::BuildState& startState, const vector<int>& startingUnitCounts, const vector<int>& startingAddonCountPerUnitType, const AvailableUnitTypes& availableUnitTypes, const BuildOrderGene& gene) {
-	libvoxelbot::BuildState state = startState;
+/** Buffers reused by every fitness evaluation of a thread, so that copying the start state does not allocate once they are large enough */
+struct FitnessScratch {
+    libvoxelbot::BuildState state;
     vector<float> finishedTimes;
+};
+
+static thread_local FitnessScratch fitnessScratch;
+
+/** Cache of the simulations of the build orders evaluated during a single optimization.
+ * The genes of a generation are mostly mutations of the genes of the previous one, so their build orders share long prefixes.
+ * The build orders are stored in a trie and every few items the state of the simulation is kept as a checkpoint,
+ * a new build order is then only simulated from the deepest checkpoint along the prefix it shares with the build orders seen before.
+ * Build orders that have already been evaluated are not simulated at all.
+ * The cache can be used by several threads at the same time.
+ */
+struct BuildOrderFitnessCache {
+    /** State of the simulation right after an item of the build order has been started */
+    struct Checkpoint {
+        libvoxelbot::BuildState state;
+        UNIT_TYPEID lastChronoUnit;
+        float lastEventTime;
+    };
+
+private:
+    static const int CheckpointInterval = 4;
+    static const int MaxNodes = 1 << 18;
+    static const size_t MaxCheckpointBytes = 32 * 1024 * 1024;
+
+    struct Node {
+        BuildOrderItem item;
+        /** Time at which the item was started */
+        float startTime = 0;
+        vector<int> children;
+        int checkpoint = -1;
+        /** The item could not be executed after this prefix */
+        bool failed = false;
+        /** A build order ending with this item has been evaluated */
+        bool hasFitness = false;
+        BuildOrderFitness fitness;
+
+        explicit Node(BuildOrderItem item) : item(item) {}
+    };
+
+    const libvoxelbot::BuildState& startState;
+    mutex cacheMutex;
+    /** Node 0 is the empty build order */
+    vector<Node> nodes;
+    /** A deque so that the checkpoints can be copied outside of the lock while new ones are added */
+    deque<Checkpoint> checkpoints;
+    size_t checkpointBytes = 0;
+    atomic<bool> acceptsCheckpoints;
+    FitnessCacheStats stats;
+
+    int findChild(int node, const BuildOrderItem& item) const {
+        for (int child : nodes[node].children) {
+            if (nodes[child].item == item) return child;
+        }
+        return -1;
+    }
+
+    int findOrAddChild(int node, const BuildOrderItem& item) {
+        int child = findChild(node, item);
+        if (child == -1 && (int)nodes.size() < MaxNodes) {
+            child = nodes.size();
+            nodes.emplace_back(item);
+            nodes[node].children.push_back(child);
+        }
+        return child;
+    }
+
+    static size_t memoryFootprint(const libvoxelbot::BuildState& state) {
+        return sizeof(Checkpoint) + state.units.capacity() * sizeof(BuildUnitInfo) + state.events.capacity() * sizeof(BuildEvent) + state.baseInfos.capacity() * sizeof(BaseInfo) +
+            state.chronoInfo.energyOffsets.capacity() * sizeof(float) + state.chronoInfo.chronoEndTimes.capacity() * sizeof(pair<UNIT_TYPEID, float>);
+    }
+
+public:
+    explicit BuildOrderFitnessCache(const libvoxelbot::BuildState& startState) : startState(startState), acceptsCheckpoints(true) {
+        nodes.emplace_back(BuildOrderItem());
+    }
+
+    BuildOrderFitnessCache(const BuildOrderFitnessCache& x) = delete;
+
+    /** Prepares the simulation of a build order.
+     * Returns true and sets the fitness if the build order has already been evaluated (or if one of its prefixes could not be executed).
+     * Otherwise the state is set to the deepest checkpoint along the build order (or to the start state), the start times of the items before that checkpoint are added to startTimes
+     * and the build order state is set to continue the simulation from there.
+     */
+    bool lookup(libvoxelbot::BuildOrderState& orderState, libvoxelbot::BuildState& state, vector<float>& startTimes, BuildOrderFitness& fitness) {
+        const auto& buildOrder = *orderState.buildOrder;
+        const Checkpoint* checkpoint = nullptr;
+        int checkpointDepth = 0;
+        {
+            lock_guard<mutex> lock(cacheMutex);
+            stats.evaluations++;
+            int node = 0;
+            int depth = 0;
+            for (; depth < (int)buildOrder.size(); depth++) {
+                int child = findChild(node, buildOrder[depth]);
+                if (child == -1) break;
+                node = child;
+                if (nodes[node].failed) {
+                    stats.exactHits++;
+                    fitness = BuildOrderFitness::ReallyBad;
+                    return true;
+                }
+                startTimes.push_back(nodes[node].startTime);
+                if (nodes[node].checkpoint != -1) {
+                    checkpoint = &checkpoints[nodes[node].checkpoint];
+                    checkpointDepth = depth + 1;
+                }
+            }
+
+            if (depth == (int)buildOrder.size() && nodes[node].hasFitness) {
+                stats.exactHits++;
+                fitness = nodes[node].fitness;
+                return true;
+            }
+
+            if (checkpoint != nullptr) stats.prefixHits++;
+            stats.skippedItems += checkpointDepth;
+            stats.simulatedItems += buildOrder.size() - checkpointDepth;
+        }
+
+        startTimes.resize(checkpointDepth);
+        if (checkpoint != nullptr) {
+            state = checkpoint->state;
+            orderState.buildIndex = checkpointDepth;
+            orderState.lastChronoUnit = checkpoint->lastChronoUnit;
+            orderState.lastEventTime = checkpoint->lastEventTime;
+        } else {
+            state = startState;
+        }
+        return false;
+    }
+
+    /** True if the state of the simulation should be kept after the item at this index has been started */
+    bool wantsCheckpoint(int index) const {
+        return (index % CheckpointInterval) == CheckpointInterval - 1 && acceptsCheckpoints;
+    }
+
+    /** Adds a simulated build order to the cache.
+     * The start times are the ones of the items that could be executed, if there are fewer of them than items in the build order the next item could not be executed and the fitness is null.
+     * The checkpoints are moved into the cache, they are pairs of the index of the item and of the state right after it was started.
+     */
+    void store(const libvoxelbot::BuildOrder& buildOrder, const vector<float>& startTimes, vector<pair<int, Checkpoint>>& newCheckpoints, const BuildOrderFitness* fitness) {
+        lock_guard<mutex> lock(cacheMutex);
+        int node = 0;
+        size_t nextCheckpoint = 0;
+        for (int i = 0; i < (int)startTimes.size(); i++) {
+            node = findOrAddChild(node, buildOrder[i]);
+            if (node == -1) return;
+
+            nodes[node].startTime = startTimes[i];
+            if (nextCheckpoint < newCheckpoints.size() && newCheckpoints[nextCheckpoint].first == i) {
+                auto& checkpoint = newCheckpoints[nextCheckpoint++].second;
+                // Another thread may have simulated the same prefix in the meantime
+                if (nodes[node].checkpoint == -1 && acceptsCheckpoints) {
+                    checkpointBytes += memoryFootprint(checkpoint.state);
+                    if (checkpointBytes >= MaxCheckpointBytes) acceptsCheckpoints = false;
+                    nodes[node].checkpoint = checkpoints.size();
+                    checkpoints.push_back(move(checkpoint));
+                }
+            }
+        }
+
+        if (fitness != nullptr) {
+            nodes[node].hasFitness = true;
+            nodes[node].fitness = *fitness;
+        } else if (startTimes.size() < buildOrder.size()) {
+            node = findOrAddChild(node, buildOrder[startTimes.size()]);
+            if (node != -1) nodes[node].failed = true;
+        }
+    }
+
+    FitnessCacheStats getStats() {
+        lock_guard<mutex> lock(cacheMutex);
+        FitnessCacheStats result = stats;
+        result.nodes = nodes.size();
+        result.checkpoints = checkpoints.size();
+        result.memoryBytes = nodes.capacity() * sizeof(Node) + checkpointBytes;
+        for (auto& node : nodes) result.memoryBytes += node.children.capacity() * sizeof(int);
+        return result;
+    }
+};
+
+/** Calculates the fitness of a given build order gene, a higher value is better */
+BuildOrderFitness calculateFitness(const libvoxelbot::BuildState& startState, const vector<int>& startingUnitCounts, const vector<int>& startingAddonCountPerUnitType, const AvailableUnitTypes& availableUnitTypes, const BuildOrderGene& gene, BuildOrderFitnessCache* cache = nullptr) {
+    libvoxelbot::BuildState& state = fitnessScratch.state;
+    vector<float>& finishedTimes = fitnessScratch.finishedTimes;
+    finishedTimes.clear();
     auto buildOrder = gene.constructBuildOrder(startState.race, startState.foodAvailableInFuture(), startingUnitCounts, startingAddonCountPerUnitType, availableUnitTypes);
-    if (!state.simulateBuildOrder(buildOrder, [&](int) {
+    // The state does not outlive this call, so it can point to the build order without owning it
+    libvoxelbot::BuildOrderState orderState(shared_ptr<const libvoxelbot::BuildOrder>(shared_ptr<const libvoxelbot::BuildOrder>(), &buildOrder));
+    if (cache == nullptr) {
+        state = startState;
+    } else {
+        BuildOrderFitness cachedFitness;
+        if (cache->lookup(orderState, state, finishedTimes, cachedFitness)) return cachedFitness;
+    }
+
+    vector<pair<int, BuildOrderFitnessCache::Checkpoint>> newCheckpoints;
+    if (!state.simulateBuildOrder(orderState, [&](int index) {
             finishedTimes.push_back(state.time);
-        })) {
+            if (cache != nullptr && cache->wantsCheckpoint(index)) {
+                newCheckpoints.push_back({ index, { state, orderState.lastChronoUnit, orderState.lastEventTime } });
+            }
+        }, true)) {
+        if (cache != nullptr) cache->store(buildOrder, finishedTimes, newCheckpoints, nullptr);
         // Build order could not be executed, that is bad.
         return BuildOrderFitness::ReallyBad;
     }
@@ -485,7 +690,9 @@ BuildOrderFitness calculateFitness(const libvoxelbot::BuildState& startState, co
     float dt = max(state.time - originalTime, 1.0f);
     MiningSpeed miningSpeedPerSecond = { (miningSpeed2.mineralsPerSecond - miningSpeed.mineralsPerSecond) / dt, (miningSpeed2.vespenePerSecond - miningSpeed.vespenePerSecond) / dt };
 
-    return BuildOrderFitness(time, resources, miningSpeed, miningSpeedPerSecond);
+    BuildOrderFitness fitness(time, resources, miningSpeed, miningSpeedPerSecond);
+    if (cache != nullptr) cache->store(buildOrder, finishedTimes, newCheckpoints, &fitness);
+    return fitness;
     // return -max(avgTime * 2, 2 * 60.0f) + (state.resources.minerals + 2 * state.resources.vespene) * 0.001 + (miningSpeed.mineralsPerSecond + 2 * miningSpeed.vespenePerSecond) * 60 * 0.005;
 }
 
@@ -582,12 +789,12 @@ void printMiningSpeedFuture(const libvoxelbot::BuildState& startState) {
  * This will try to swap adjacent items in the build order as well as trying to remove all non-essential items.
  */
 // TODO: Add operation to remove all items that are implied anyway (i.e. if removing the item and then adding in implicit steps returns the same result as just adding in the implicit steps)
-BuildOrderGene locallyOptimizeGene(const libvoxelbot::BuildState& startState, const vector<int>& startingUnitCounts, const vector<int>& startingAddonCountPerUnitType, const AvailableUnitTypes& availableUnitTypes, const vector<int>& actionRequirements, const BuildOrderGene& gene) {
+BuildOrderGene locallyOptimizeGene(const libvoxelbot::BuildState& startState, const vector<int>& startingUnitCounts, const vector<int>& startingAddonCountPerUnitType, const AvailableUnitTypes& availableUnitTypes, const vector<int>& actionRequirements, const BuildOrderGene& gene, BuildOrderFitnessCache* cache = nullptr) {
     vector<int> currentActionRequirements = actionRequirements;
     for (auto b : gene.buildOrder)
         currentActionRequirements[b.type]--;
 
-    auto startFitness = calculateFitness(startState, startingUnitCounts, startingAddonCountPerUnitType, availableUnitTypes, gene);
+    auto startFitness = calculateFitness(startState, startingUnitCounts, startingAddonCountPerUnitType, availableUnitTypes, gene, cache);
     auto fitness = startFitness;
     BuildOrderGene newGene = gene;
     for (int i = 0; i < 2; i++) {
@@ -600,7 +807,7 @@ BuildOrderGene locallyOptimizeGene(const libvoxelbot::BuildState& startState, co
                     auto orig = newGene.buildOrder[j];
                     newGene.buildOrder.erase(newGene.buildOrder.begin() + j);
 
-                    auto newFitness = calculateFitness(startState, startingUnitCounts, startingAddonCountPerUnitType, availableUnitTypes, newGene);
+                    auto newFitness = calculateFitness(startState, startingUnitCounts, startingAddonCountPerUnitType, availableUnitTypes, newGene, cache);
 
                     // Check if the new fitness is better
                     // Also always remove non-essential items at the end of the build order
@@ -619,7 +826,7 @@ BuildOrderGene locallyOptimizeGene(const libvoxelbot::BuildState& startState, co
                 // Try swapping
                 if (j + 1 < newGene.buildOrder.size()) {
                     swap(newGene.buildOrder[j], newGene.buildOrder[j + 1]);
-                    auto newFitness = calculateFitness(startState, startingUnitCounts, startingAddonCountPerUnitType, availableUnitTypes, newGene);
+                    auto newFitness = calculateFitness(startState, startingUnitCounts, startingAddonCountPerUnitType, availableUnitTypes, newGene, cache);
 
                     if (fitness < newFitness) {
                         fitness = newFitness;
@@ -894,6 +1101,20 @@ std::pair<libvoxelbot::BuildOrder, BuildOrderFitness> findBestBuildOrderGeneticW
         gene = BuildOrderGene(rnd, actionRequirements);
         gene.validate(actionRequirements);
     }
+
+    // The fitness of the genes of a generation are independent, they are evaluated in parallel.
+    // The buffers are kept between generations to avoid reallocating them every iteration.
+    ThreadPool pool(max(1, params.threadCount));
+    // Most genes share long prefixes with the genes evaluated before, their simulation resumes from the cached state of the longest one
+    unique_ptr<BuildOrderFitnessCache> cache;
+    if (params.useFitnessCache) cache = make_unique<BuildOrderFitnessCache>(startState);
+    vector<BuildOrderFitness> fitness;
+    vector<int> indices;
+    vector<BuildOrderGene> nextGeneration;
+    const function<void(int)> evaluateFitness = [&](int j) {
+        fitness[j] = calculateFitness(startState, startingUnitCounts, startingAddonCountPerUnitType, availableUnitTypes, generation[j], cache.get());
+    };
+
     for (int i = 0; i <= params.iterations; i++) {
         if (i == 150 && seed != nullptr) {
             // Add in the seed here
@@ -901,19 +1122,19 @@ std::pair<libvoxelbot::BuildOrder, BuildOrderFitness> findBestBuildOrderGeneticW
             generation[generation.size() - 1].validate(actionRequirements);
         }
 
-        vector<BuildOrderFitness> fitness(generation.size());
-        vector<int> indices;
-        vector<BuildOrderGene> nextGeneration;
+        fitness.resize(generation.size());
+        indices.clear();
+        nextGeneration.clear();
+        pool.parallelFor((int)generation.size(), evaluateFitness);
         
         if (params.varianceBias <= 0) {
-            indices = vector<int>(generation.size());
+            indices.resize(generation.size());
             for (size_t j = 0; j < generation.size(); j++) {
                 indices[j] = j;
-                fitness[j] = calculateFitness(startState, startingUnitCounts, startingAddonCountPerUnitType, availableUnitTypes, generation[j]);
             }
 
-            sortByValueDescending<int, float>(indices, [=](int index) { return -fitness[index].time; });
-            sortByValueDescendingBubble<int, BuildOrderFitness>(indices, [=](int index) { return fitness[index]; });
+            sortByValueDescending<int, float>(indices, [&](int index) { return -fitness[index].time; });
+            sortByValueDescendingBubble<int, BuildOrderFitness>(indices, [&](int index) { return fitness[index]; });
             // Add the N best performing genes
             for (int j = 0; j < min(5, params.genePoolSize); j++) {
                 nextGeneration.push_back(generation[indices[j]]);
@@ -921,10 +1142,6 @@ std::pair<libvoxelbot::BuildOrder, BuildOrderFitness> findBestBuildOrderGeneticW
             // Add a random one as well
             nextGeneration.push_back(generation[uniform_int_distribution<int>(0, indices.size() - 1)(rnd)]);
         } else {
-            for (size_t j = 0; j < generation.size(); j++) {
-                fitness[j] = calculateFitness(startState, startingUnitCounts, startingAddonCountPerUnitType, availableUnitTypes, generation[j]);
-            }
-
             // Add the N best performing genes
             for (int j = 0; j < min(5, params.genePoolSize); j++) {
                 float bestScore = -100000000;
@@ -949,11 +1166,12 @@ std::pair<libvoxelbot::BuildOrder, BuildOrderFitness> findBestBuildOrderGeneticW
         }
 
         if ((i % 50) == 0 && i != 0) {
-            for (auto& g : nextGeneration) {
+            pool.parallelFor((int)nextGeneration.size(), [&](int j) {
+                auto& g = nextGeneration[j];
                 g.validate(actionRequirements);
-                g = locallyOptimizeGene(startState, startingUnitCounts, startingAddonCountPerUnitType, availableUnitTypes, actionRequirements, g);
+                g = locallyOptimizeGene(startState, startingUnitCounts, startingAddonCountPerUnitType, availableUnitTypes, actionRequirements, g, cache.get());
                 g.validate(actionRequirements);
-            }
+            });
 
             // Expand build orders
             if (i > 150) {
@@ -989,13 +1207,19 @@ std::pair<libvoxelbot::BuildOrder, BuildOrderFitness> findBestBuildOrderGeneticW
         // In particular it always removes non-essential items at the end of the build order which can make it worse (this is kinda a bug though)
         // assert(lastBestFitness <= fitness[indices[0]].score());
         lastBestFitness = fitness[indices[0]].score();
+
+        if (params.maxMillis > 0) {
+            watch.stop();
+            if (watch.millis() > params.maxMillis) break;
+        }
     }
     
-    generation[0] = locallyOptimizeGene(startState, startingUnitCounts, startingAddonCountPerUnitType, availableUnitTypes, actionRequirements, generation[0]);
+    generation[0] = locallyOptimizeGene(startState, startingUnitCounts, startingAddonCountPerUnitType, availableUnitTypes, actionRequirements, generation[0], cache.get());
 
-    auto fitness = calculateFitness(startState, startingUnitCounts, startingAddonCountPerUnitType, availableUnitTypes, generation[0]);
+    auto bestFitness = calculateFitness(startState, startingUnitCounts, startingAddonCountPerUnitType, availableUnitTypes, generation[0], cache.get());
+    if (params.cacheStats != nullptr) *params.cacheStats = cache != nullptr ? cache->getStats() : FitnessCacheStats();
 
-    return make_pair(generation[0].constructBuildOrder(startState.race, startState.foodAvailableInFuture(), startingUnitCounts, startingAddonCountPerUnitType, availableUnitTypes), fitness);
+    return make_pair(generation[0].constructBuildOrder(startState.race, startState.foodAvailableInFuture(), startingUnitCounts, startingAddonCountPerUnitType, availableUnitTypes), bestFitness);
 }
 
 vector<UNIT_TYPEID> buildOrderProBO = {
@@ -37,6 +37,28 @@ struct BuildOrderFitness {
     bool operator<(const BuildOrderFitness& other) const;
 };
 
+/** Statistics of the build order prefix cache used while evaluating the fitness of the genes */
+struct FitnessCacheStats {
+    /** Number of fitness evaluations that went through the cache */
+    int evaluations = 0;
+    /** Evaluations of a build order that had already been evaluated (or whose prefix could not be executed) */
+    int exactHits = 0;
+    /** Evaluations that resumed the simulation from the checkpoint of a prefix */
+    int prefixHits = 0;
+    /** Build order items that had to be simulated */
+    long long simulatedItems = 0;
+    /** Build order items that were skipped thanks to a checkpoint */
+    long long skippedItems = 0;
+    int nodes = 0;
+    int checkpoints = 0;
+    /** Approximate memory used by the cache in bytes */
+    size_t memoryBytes = 0;
+
+    float hitRate() const {
+        return evaluations > 0 ? (exactHits + prefixHits) / (float)evaluations : 0;
+    }
+};
+
 struct BuildOptimizerParams {
     int genePoolSize = 25;
     int iterations = 512;
@@ -44,6 +66,14 @@ struct BuildOptimizerParams {
     float mutationRateMove = 0.025f;
     float varianceBias = 0;
     bool allowChronoBoost = true;
+    /** Stop iterating once this many milliseconds have been spent (0 for no limit) */
+    double maxMillis = 0;
+    /** Number of threads evaluating the fitness of the genes, including the calling thread */
+    int threadCount = 1;
+    /** Resume the simulation of the genes from the cached states of the build order prefixes they share with the genes evaluated before */
+    bool useFitnessCache = true;
+    /** If not null, filled with the statistics of the fitness cache at the end of the optimization */
+    FitnessCacheStats* cacheStats = nullptr;
 };
 
 std::pair<libvoxelbot::BuildOrder, std::vector<bool>> expandBuildOrderWithImplicitSteps (const libvoxelbot::BuildState& startState, libvoxelbot::BuildOrder buildOrder);
@@ -174,7 +174,8 @@ class CachingBot : public sc2::Agent {
 
             // Try loading and re-saving the data to make sure that everything is loaded correctly
             int hash = hashFile(UNIT_DATA_CACHE_PATH);
-            auto unit_types2 = load_unit_data();
+            ifstream saved_unit_data(UNIT_DATA_CACHE_PATH);
+            auto unit_types2 = parse_unit_data(saved_unit_data);
             save_unit_data(unit_types2, "/tmp/unit_data.data");
             int hash2 = hashFile("/tmp/unit_data.data");
             if (hash != hash2) {
@@ -0,0 +1,191 @@
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "../generated/abilities.h"
+#include "../generated/abilities_data.h"
+#include "../generated/units_data.h"
+#include "../generated/upgrades_data.h"
+#include "../utilities/data_pack.h"
+#include "../utilities/unit_data_caching.h"
+#include "sc2api/sc2_api.h"
+
+using namespace sc2;
+using namespace std;
+
+// Packs the data written by the caching bot in the generated directory into the data pack memory mapped by the bot.
+// Run it again, from the bin directory, whenever the generated data changes.
+
+struct DataPackWriter {
+    vector<PackedUnitType> unitTypes;
+    vector<PackedWeapon> weapons;
+    vector<PackedDamageBonus> damageBonuses;
+    vector<PackedAbility> abilities;
+    vector<PackedUpgrade> upgrades;
+    vector<PackedUnitAbility> unitAbilities;
+    vector<PackedUnitTable> unitTables;
+    vector<int32_t> ids;
+    vector<char> strings;
+
+    DataPackRange addString(const string& s) {
+        DataPackRange range = { (uint32_t)strings.size(), (uint32_t)s.size() };
+        strings.insert(strings.end(), s.begin(), s.end());
+        return range;
+    }
+
+    template<class T>
+    DataPackRange addIds(const vector<T>& values) {
+        DataPackRange range = { (uint32_t)ids.size(), (uint32_t)values.size() };
+        for (auto v : values) {
+            ids.push_back((int32_t)v);
+        }
+        return range;
+    }
+
+    void addUnitType(const UnitTypeData& type) {
+        PackedUnitType packed = {};
+        packed.unit_type_id = (int32_t)type.unit_type_id;
+        packed.name = addString(type.name);
+        packed.cargo_size = type.cargo_size;
+        packed.mineral_cost = type.mineral_cost;
+        packed.vespene_cost = type.vespene_cost;
+        packed.attributes = addIds(type.attributes);
+        packed.movement_speed = type.movement_speed;
+        packed.armor = type.armor;
+        packed.weapons = { (uint32_t)weapons.size(), (uint32_t)type.weapons.size() };
+        for (auto& w : type.weapons) {
+            PackedWeapon packedWeapon = {};
+            packedWeapon.type = (int32_t)w.type;
+            packedWeapon.damage = w.damage_;
+            packedWeapon.damage_bonus = { (uint32_t)damageBonuses.size(), (uint32_t)w.damage_bonus.size() };
+            for (auto& b : w.damage_bonus) {
+                damageBonuses.push_back({ (int32_t)b.attribute, b.bonus });
+            }
+            packedWeapon.attacks = w.attacks;
+            packedWeapon.range = w.range;
+            packedWeapon.speed = w.speed;
+            weapons.push_back(packedWeapon);
+        }
+        packed.food_required = type.food_required;
+        packed.food_provided = type.food_provided;
+        packed.ability_id = (int32_t)type.ability_id;
+        packed.race = (int32_t)type.race;
+        packed.build_time = type.build_time;
+        packed.sight_range = type.sight_range;
+        packed.tech_alias = addIds(type.tech_alias);
+        packed.unit_alias = (int32_t)type.unit_alias;
+        packed.tech_requirement = (int32_t)type.tech_requirement;
+        packed.available = type.available;
+        packed.has_minerals = type.has_minerals;
+        packed.has_vespene = type.has_vespene;
+        packed.require_attached = type.require_attached;
+        unitTypes.push_back(packed);
+    }
+
+    void addAbility(const AbilityData& ability) {
+        PackedAbility packed = {};
+        packed.ability_id = (int32_t)ability.ability_id;
+        packed.link_name = addString(ability.link_name);
+        packed.link_index = ability.link_index;
+        packed.button_name = addString(ability.button_name);
+        packed.friendly_name = addString(ability.friendly_name);
+        packed.hotkey = addString(ability.hotkey);
+        packed.remaps_to_ability_id = ability.remaps_to_ability_id;
+        packed.remaps_from_ability_id = addIds(ability.remaps_from_ability_id);
+        packed.target = (int32_t)ability.target;
+        packed.footprint_radius = ability.footprint_radius;
+        packed.cast_range = ability.cast_range;
+        packed.available = ability.available;
+        packed.allow_minimap = ability.allow_minimap;
+        packed.allow_autocast = ability.allow_autocast;
+        packed.is_building = ability.is_building;
+        packed.is_instant_placement = ability.is_instant_placement;
+        abilities.push_back(packed);
+    }
+
+    void addUpgrade(const UpgradeData& upgrade) {
+        PackedUpgrade packed = {};
+        packed.upgrade_id = upgrade.upgrade_id;
+        packed.name = addString(upgrade.name);
+        packed.mineral_cost = upgrade.mineral_cost;
+        packed.vespene_cost = upgrade.vespene_cost;
+        packed.ability_id = (int32_t)upgrade.ability_id;
+        packed.research_time = upgrade.research_time;
+        upgrades.push_back(packed);
+    }
+
+    bool write(const string& path) const {
+        DataPackHeader header = {};
+        memcpy(header.magic, DATA_PACK_MAGIC, sizeof(DATA_PACK_MAGIC));
+        header.version = DATA_PACK_VERSION;
+        header.table_count = DATA_PACK_TABLE_COUNT;
+
+        vector<char> body;
+        auto addTable = [&](DataPackTable table, const auto& records) {
+            using Record = typename decay<decltype(records)>::type::value_type;
+            // The tables start on 8 bytes boundaries so that the records can be read in place
+            body.resize((sizeof(DataPackHeader) + body.size() + 7) / 8 * 8 - sizeof(DataPackHeader));
+            header.tables[table].offset = sizeof(DataPackHeader) + body.size();
+            header.tables[table].count = (uint32_t)records.size();
+            header.tables[table].record_size = sizeof(Record);
+            const char* bytes = reinterpret_cast<const char*>(records.data());
+            body.insert(body.end(), bytes, bytes + records.size() * sizeof(Record));
+        };
+        addTable(DATA_PACK_UNIT_TYPES, unitTypes);
+        addTable(DATA_PACK_WEAPONS, weapons);
+        addTable(DATA_PACK_DAMAGE_BONUSES, damageBonuses);
+        addTable(DATA_PACK_ABILITIES, abilities);
+        addTable(DATA_PACK_UPGRADES, upgrades);
+        addTable(DATA_PACK_UNIT_ABILITIES, unitAbilities);
+        addTable(DATA_PACK_UNIT_TABLES, unitTables);
+        addTable(DATA_PACK_IDS, ids);
+        addTable(DATA_PACK_STRINGS, strings);
+
+        ofstream file(path, ios::binary);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(body.data(), body.size());
+        return (bool)file;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    const string path = argc > 1 ? argv[1] : DATA_PACK_PATH;
+
+    auto unitStream = stringstream(string((char*)LIBVOXELBOT_DATA_UNITS, LIBVOXELBOT_DATA_UNITS_SIZE));
+    auto abilityStream = stringstream(string((char*)LIBVOXELBOT_DATA_ABILITIES, LIBVOXELBOT_DATA_ABILITIES_SIZE));
+    auto upgradeStream = stringstream(string((char*)LIBVOXELBOT_DATA_UPGRADES, LIBVOXELBOT_DATA_UPGRADES_SIZE));
+
+    DataPackWriter writer;
+    for (auto& type : parse_unit_data(unitStream)) {
+        writer.addUnitType(type);
+    }
+    for (auto& ability : parse_ability_data(abilityStream)) {
+        writer.addAbility(ability);
+    }
+    for (auto& upgrade : parse_upgrade_data(upgradeStream)) {
+        writer.addUpgrade(upgrade);
+    }
+
+    for (auto pair : unit_type_has_ability) {
+        writer.unitAbilities.push_back({ pair.first, pair.second });
+    }
+    if (unit_type_is_flying.size() != unit_type_initial_health.size() || unit_type_radius.size() != unit_type_initial_health.size()) {
+        cerr << "The generated unit tables do not have the same size" << endl;
+        return 1;
+    }
+    for (size_t i = 0; i < unit_type_initial_health.size(); i++) {
+        PackedUnitTable table = {};
+        table.initial_health = unit_type_initial_health[i].first;
+        table.initial_shield = unit_type_initial_health[i].second;
+        table.radius = unit_type_radius[i];
+        table.is_flying = unit_type_is_flying[i];
+        writer.unitTables.push_back(table);
+    }
+
+    if (!writer.write(path)) {
+        cerr << "Could not write the data pack at " << path << endl;
+        return 1;
+    }
+    cout << "Wrote " << writer.unitTypes.size() << " unit types, " << writer.abilities.size() << " abilities and " << writer.upgrades.size() << " upgrades to " << path << endl;
+    return 0;
+}
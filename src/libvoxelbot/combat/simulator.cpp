@@ -262,7 +262,7 @@ CombatResult CombatPredictor::predict_engage(const CombatState& inputState, bool
 
 CombatResult CombatPredictor::predict_engage(const CombatState& inputState, CombatSettings settings, CombatRecording* recording, int defenderPlayer, CCBot * bot) const {
 	if (bot)
-		bot->StartProfiling("s.2.1 PrepareForEngagement");
+		PROFILE_BEGIN("PrepareForEngagement");
 #if CACHE_COMBAT
     auto h = combatHash(inputState, badMicro, defenderPlayer);
     counter++;
@@ -342,10 +342,10 @@ CombatResult CombatPredictor::predict_engage(const CombatState& inputState, Comb
     }
 	
 	if (bot)
-		bot->StopProfiling("s.2.1 PrepareForEngagement");
+		PROFILE_END("PrepareForEngagement");
     for (int it = 0; it < MAX_ITERATIONS && changed; it++) {
 		if (bot)
-			bot->StartProfiling("s.2.2 PrepareIteration");
+			PROFILE_BEGIN("PrepareIteration");
         int hasAir1 = 0;
         int hasAir2 = 0;
         int hasGround1 = 0;
@@ -404,10 +404,10 @@ CombatResult CombatPredictor::predict_engage(const CombatState& inputState, Comb
             cout << "Iteration " << it << " Time: " << time << endl;
         changed = false;
 		if (bot)
-			bot->StopProfiling("s.2.2 PrepareIteration");
+			PROFILE_END("PrepareIteration");
 
 		if (bot)
-			bot->StartProfiling("s.2.3 GuardianShield");
+			PROFILE_BEGIN("GuardianShield");
         // Check guardian shields.
         // Guardian shield is approximated as each shield protecting a fixed area of units as long
         // as the shield is active. The first N units in each army, such that the total area of all units up to unit N, are assumed to be protected
@@ -436,7 +436,7 @@ CombatResult CombatPredictor::predict_engage(const CombatState& inputState, Comb
             guardianShieldedUnitFraction[group] = min(0.8f, guardianShieldedArea / (0.001f+ totalArea));
         }
 		if (bot)
-			bot->StopProfiling("s.2.3 GuardianShield");
+			PROFILE_END("GuardianShield");
 
 		bool groupHasTarget = false;
         for (int group = 0; group < 2; group++) {
@@ -476,12 +476,12 @@ CombatResult CombatPredictor::predict_engage(const CombatState& inputState, Comb
                     continue;
 
 				if (bot)
-					bot->StartProfiling("s.2.4 CalculateDPS");
+					PROFILE_BEGIN("CalculateDPS");
                 auto& unitTypeData = getUnitData(unit.type);
                 float airDPS = env.calculateDPS(unit, true);
                 float groundDPS = env.calculateDPS(unit, false);
 				if (bot)
-					bot->StopProfiling("s.2.4 CalculateDPS");
+					PROFILE_END("CalculateDPS");
 
                 if (debug)
                     cout << "Processing " << UnitTypeToName(unit.type) << " " << unit.health << "+" << unit.shield << " "
@@ -489,7 +489,7 @@ CombatResult CombatPredictor::predict_engage(const CombatState& inputState, Comb
 
                 if (unit.type == UNIT_TYPEID::TERRAN_MEDIVAC) {
 					if (bot)
-						bot->StartProfiling("s.2.5 Medivac");
+						PROFILE_BEGIN("Medivac");
                     if (unit.energy > 0) {
                         // Pick a random target
                         size_t offset = (size_t)rand() % g1.size();
@@ -510,14 +510,14 @@ CombatResult CombatPredictor::predict_engage(const CombatState& inputState, Comb
                         }
                     }
 					if (bot)
-						bot->StopProfiling("s.2.5 Medivac");
+						PROFILE_END("Medivac");
                     continue;
                 }
 
                 if (unit.type == UNIT_TYPEID::PROTOSS_SHIELDBATTERY) {
                     if (unit.energy > 0) {
 						if (bot)
-							bot->StartProfiling("s.2.6 ShieldBattery");
+							PROFILE_BEGIN("ShieldBattery");
                         // Pick a random target
                         size_t offset = (size_t)rand() % g1.size();
                         const float SHIELDS_PER_NORMAL_SPEED_SECOND = 50.4 / 1.4f;
@@ -539,7 +539,7 @@ CombatResult CombatPredictor::predict_engage(const CombatState& inputState, Comb
                             }
                         }
 						if (bot)
-							bot->StopProfiling("s.2.6 ShieldBattery");
+							PROFILE_END("ShieldBattery");
                     }
                     continue;
                 }
@@ -547,7 +547,7 @@ CombatResult CombatPredictor::predict_engage(const CombatState& inputState, Comb
                 if (unit.type == UNIT_TYPEID::ZERG_INFESTOR) {
                     if (unit.energy > 25) {
 						if (bot)
-							bot->StartProfiling("s.2.7 Infestor");
+							PROFILE_BEGIN("Infestor");
                         // Spawn an infested terran
                         unit.energy -= 25;
                         auto u = makeUnit(unit.owner, UNIT_TYPEID::ZERG_INFESTORTERRAN);
@@ -560,7 +560,7 @@ CombatResult CombatPredictor::predict_engage(const CombatState& inputState, Comb
                         g1.push_back(&**temporaryUnits.rbegin());
                         changed = true;
 						if (bot)
-							bot->StopProfiling("s.2.7 Infestor");
+							PROFILE_END("Infestor");
                     }
                     continue;
                 }
@@ -578,7 +578,7 @@ CombatResult CombatPredictor::predict_engage(const CombatState& inputState, Comb
 
                 if (unit.type == UNIT_TYPEID::PROTOSS_SENTRY && unit.energy >= 75 && !didActivateGuardianShield) {
 					if (bot)
-						bot->StartProfiling("s.2.8 Sentry");
+						PROFILE_BEGIN("Sentry");
                     if (!guardianShieldCoversAllUnits[group]) {
                         unit.energy -= 75;
                         unit.buffTimer = 11.0f;
@@ -587,7 +587,7 @@ CombatResult CombatPredictor::predict_engage(const CombatState& inputState, Comb
                         didActivateGuardianShield = true;
                     }
 					if (bot)
-						bot->StopProfiling("s.2.8 Sentry");
+						PROFILE_END("Sentry");
                 }
 
                 if (airDPS == 0 && groundDPS == 0)
@@ -633,7 +633,7 @@ CombatResult CombatPredictor::predict_engage(const CombatState& inputState, Comb
                 const WeaponInfo* bestWeapon = nullptr;
 
 				if (bot)
-					bot->StartProfiling("s.2.9 GetTarget");
+					PROFILE_BEGIN("GetTarget");
                 for (size_t j = 0; j < g2.size(); j++) {
                     auto& other = *g2[j];
                     if (other.health == 0)
@@ -691,12 +691,12 @@ CombatResult CombatPredictor::predict_engage(const CombatState& inputState, Comb
                     }
                 }
 				if (bot)
-					bot->StopProfiling("s.2.9 GetTarget");
+					PROFILE_END("GetTarget");
 
                 if (bestTarget != nullptr) {
 					groupHasTarget = true;
 					if (bot)
-						bot->StartProfiling("s.2.10 ComputeDamage");
+						PROFILE_BEGIN("ComputeDamage");
                     if (isUnitMelee) {
                         numMeleeUnitsUsed += 1;
                     }
@@ -753,7 +753,7 @@ CombatResult CombatPredictor::predict_engage(const CombatState& inputState, Comb
                     // TODO: Better rule: units only apply splash to other units that have a shorter range than themselves, or this unit has a higher movement speed than the other one
                     if (settings.enableSplash && remainingSplash > 0.001f && (!isUnitMelee || isMelee(other.type)) && g2.size() > 0) {
 						if (bot)
-							bot->StartProfiling("s.2.10.1  ComputeSplashDamage");
+							PROFILE_BEGIN("ComputeSplashDamage");
                         // Apply remaining splash to other random melee units
                         size_t offset = (size_t)rand() % g2.size();
                         for (size_t j = 0; j < g2.size() && remainingSplash > 0.001f; j++) {
@@ -779,10 +779,10 @@ CombatResult CombatPredictor::predict_engage(const CombatState& inputState, Comb
                             }
                         }
 						if (bot)
-							bot->StopProfiling("s.2.10.1  ComputeSplashDamage");
+							PROFILE_END("ComputeSplashDamage");
                     }
 					if (bot)
-						bot->StopProfiling("s.2.10 ComputeDamage");
+						PROFILE_END("ComputeDamage");
                 }
             }
 
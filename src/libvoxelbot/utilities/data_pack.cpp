@@ -0,0 +1,140 @@
+#include "data_pack.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#ifdef _WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+static const uint32_t recordSizes[DATA_PACK_TABLE_COUNT] = {
+    sizeof(PackedUnitType),
+    sizeof(PackedWeapon),
+    sizeof(PackedDamageBonus),
+    sizeof(PackedAbility),
+    sizeof(PackedUpgrade),
+    sizeof(PackedUnitAbility),
+    sizeof(PackedUnitTable),
+    sizeof(int32_t),
+    sizeof(char),
+};
+
+DataPack::~DataPack() {
+    close();
+}
+
+void DataPack::close() {
+    if (!data)
+        return;
+#ifdef _WINDOWS
+    UnmapViewOfFile(data);
+    CloseHandle(mappingHandle);
+    CloseHandle(fileHandle);
+    mappingHandle = nullptr;
+    fileHandle = nullptr;
+#else
+    munmap(const_cast<char*>(data), size);
+#endif
+    data = nullptr;
+    size = 0;
+}
+
+bool DataPack::open(const string& path) {
+    close();
+#ifdef _WINDOWS
+    fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE) {
+        fileHandle = nullptr;
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(fileHandle, &fileSize);
+    mappingHandle = fileSize.QuadPart > 0 ? CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    const void* view = mappingHandle ? MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        if (mappingHandle)
+            CloseHandle(mappingHandle);
+        CloseHandle(fileHandle);
+        mappingHandle = nullptr;
+        fileHandle = nullptr;
+        return false;
+    }
+    data = static_cast<const char*>(view);
+    size = size_t(fileSize.QuadPart);
+#else
+    const int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0)
+        return false;
+    struct stat fileStat;
+    void* view = fstat(file, &fileStat) == 0 && fileStat.st_size > 0 ? mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0) : MAP_FAILED;
+    ::close(file);
+    if (view == MAP_FAILED)
+        return false;
+    data = static_cast<const char*>(view);
+    size = size_t(fileStat.st_size);
+#endif
+
+    // Validate the tables, then every range of the records, once so that the accessors do not need any check
+    bool valid = size >= sizeof(DataPackHeader);
+    if (valid) {
+        const DataPackHeader& h = header();
+        valid = memcmp(h.magic, DATA_PACK_MAGIC, sizeof(DATA_PACK_MAGIC)) == 0 && h.version == DATA_PACK_VERSION && h.table_count == DATA_PACK_TABLE_COUNT;
+        for (uint32_t i = 0; valid && i < DATA_PACK_TABLE_COUNT; i++) {
+            const DataPackTableEntry& table = h.tables[i];
+            valid = table.record_size == recordSizes[i] && table.offset % 8 == 0 && table.offset <= size && uint64_t(table.count) * table.record_size <= size - table.offset;
+        }
+    }
+    if (!valid || !validateRanges()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool DataPack::validateRanges() const {
+    const auto inTable = [this](DataPackRange range, DataPackTable table) {
+        return uint64_t(range.offset) + range.count <= count(table);
+    };
+
+    const PackedUnitType* unitTypes = records<PackedUnitType>(DATA_PACK_UNIT_TYPES);
+    for (uint32_t i = 0; i < count(DATA_PACK_UNIT_TYPES); i++) {
+        const PackedUnitType& type = unitTypes[i];
+        if (!inTable(type.name, DATA_PACK_STRINGS) || !inTable(type.attributes, DATA_PACK_IDS) || !inTable(type.weapons, DATA_PACK_WEAPONS) || !inTable(type.tech_alias, DATA_PACK_IDS))
+            return false;
+    }
+    const PackedWeapon* weapons = records<PackedWeapon>(DATA_PACK_WEAPONS);
+    for (uint32_t i = 0; i < count(DATA_PACK_WEAPONS); i++) {
+        if (!inTable(weapons[i].damage_bonus, DATA_PACK_DAMAGE_BONUSES))
+            return false;
+    }
+    const PackedAbility* abilities = records<PackedAbility>(DATA_PACK_ABILITIES);
+    for (uint32_t i = 0; i < count(DATA_PACK_ABILITIES); i++) {
+        const PackedAbility& ability = abilities[i];
+        if (!inTable(ability.link_name, DATA_PACK_STRINGS) || !inTable(ability.button_name, DATA_PACK_STRINGS) || !inTable(ability.friendly_name, DATA_PACK_STRINGS)
+            || !inTable(ability.hotkey, DATA_PACK_STRINGS) || !inTable(ability.remaps_from_ability_id, DATA_PACK_IDS))
+            return false;
+    }
+    const PackedUpgrade* upgrades = records<PackedUpgrade>(DATA_PACK_UPGRADES);
+    for (uint32_t i = 0; i < count(DATA_PACK_UPGRADES); i++) {
+        if (!inTable(upgrades[i].name, DATA_PACK_STRINGS))
+            return false;
+    }
+    return true;
+}
+
+const DataPack& getDataPack() {
+    // Initialized once, also when the first use is on the background thread initializing the combat simulator
+    static DataPack pack;
+    static bool opened = pack.open(DATA_PACK_PATH);
+    if (!opened) {
+        cerr << "Could not open the data pack at " << DATA_PACK_PATH << ", it is written by the MicroMachineDataPack target" << endl;
+        exit(1);
+    }
+    return pack;
+}
@@ -0,0 +1,178 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// Versioned binary pack of the game data: unit types with their weapons, abilities, upgrades and the per unit type tables.
+// It is written once by the data pack generator and memory mapped read-only at startup, so nothing is parsed and the
+// pages are shared by every bot process reading it. All records have a fixed layout, the variable length fields are
+// ranges in the id, damage bonus, weapon and string tables.
+
+const char DATA_PACK_MAGIC[8] = { 'V', 'B', 'D', 'A', 'T', 'A', 'P', 'K' };
+const uint32_t DATA_PACK_VERSION = 1;
+const std::string DATA_PACK_PATH = "data/libvoxelbot.pack";
+
+enum DataPackTable : uint32_t {
+    DATA_PACK_UNIT_TYPES,
+    DATA_PACK_WEAPONS,
+    DATA_PACK_DAMAGE_BONUSES,
+    DATA_PACK_ABILITIES,
+    DATA_PACK_UPGRADES,
+    DATA_PACK_UNIT_ABILITIES,
+    DATA_PACK_UNIT_TABLES,
+    DATA_PACK_IDS,
+    DATA_PACK_STRINGS,
+    DATA_PACK_TABLE_COUNT,
+};
+
+struct DataPackRange {
+    uint32_t offset;
+    uint32_t count;
+};
+
+struct DataPackTableEntry {
+    uint64_t offset;        // from the start of the pack, aligned to 8 bytes
+    uint32_t count;
+    uint32_t record_size;   // checked against the layout of the reader
+};
+
+struct DataPackHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t table_count;
+    DataPackTableEntry tables[DATA_PACK_TABLE_COUNT];
+};
+
+struct PackedDamageBonus {
+    int32_t attribute;
+    float bonus;
+};
+
+struct PackedWeapon {
+    int32_t type;
+    float damage;
+    DataPackRange damage_bonus;
+    uint32_t attacks;
+    float range;
+    float speed;
+};
+
+struct PackedUnitType {
+    int32_t unit_type_id;
+    DataPackRange name;
+    int32_t cargo_size;
+    int32_t mineral_cost;
+    int32_t vespene_cost;
+    DataPackRange attributes;   // ids
+    float movement_speed;
+    float armor;
+    DataPackRange weapons;
+    float food_required;
+    float food_provided;
+    int32_t ability_id;
+    int32_t race;
+    float build_time;
+    float sight_range;
+    DataPackRange tech_alias;   // ids
+    int32_t unit_alias;
+    int32_t tech_requirement;
+    uint8_t available;
+    uint8_t has_minerals;
+    uint8_t has_vespene;
+    uint8_t require_attached;
+};
+
+struct PackedAbility {
+    int32_t ability_id;
+    DataPackRange link_name;
+    uint32_t link_index;
+    DataPackRange button_name;
+    DataPackRange friendly_name;
+    DataPackRange hotkey;
+    uint32_t remaps_to_ability_id;
+    DataPackRange remaps_from_ability_id;   // ids
+    int32_t target;
+    float footprint_radius;
+    float cast_range;
+    uint8_t available;
+    uint8_t allow_minimap;
+    uint8_t allow_autocast;
+    uint8_t is_building;
+    uint8_t is_instant_placement;
+    uint8_t padding[3];
+};
+
+struct PackedUpgrade {
+    uint32_t upgrade_id;
+    DataPackRange name;
+    uint32_t mineral_cost;
+    uint32_t vespene_cost;
+    int32_t ability_id;
+    float research_time;
+};
+
+struct PackedUnitAbility {
+    int32_t unit_type_id;
+    int32_t ability_id;
+};
+
+// Indexed by unit type id
+struct PackedUnitTable {
+    float initial_health;
+    float initial_shield;
+    float radius;
+    uint8_t is_flying;
+    uint8_t padding[3];
+};
+
+static_assert(sizeof(DataPackHeader) == 16 + 16 * DATA_PACK_TABLE_COUNT, "the data pack header must not be padded");
+static_assert(sizeof(PackedWeapon) == 28, "the data pack records must not be padded");
+static_assert(sizeof(PackedUnitType) == 92, "the data pack records must not be padded");
+static_assert(sizeof(PackedAbility) == 72, "the data pack records must not be padded");
+static_assert(sizeof(PackedUpgrade) == 28, "the data pack records must not be padded");
+static_assert(sizeof(PackedUnitTable) == 16, "the data pack records must not be padded");
+
+// Read-only mapping of a data pack
+class DataPack {
+    const char* data = nullptr;
+    size_t size = 0;
+#ifdef _WINDOWS
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+
+public:
+    DataPack() = default;
+    DataPack(const DataPack&) = delete;
+    DataPack& operator=(const DataPack&) = delete;
+    ~DataPack();
+
+    // Returns false if the file is missing, truncated, from another version of the pack or has a range outside of its table
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return data != nullptr; }
+
+    uint32_t count(DataPackTable table) const {
+        return header().tables[table].count;
+    }
+
+    template<class T>
+    const T* records(DataPackTable table) const {
+        return reinterpret_cast<const T*>(data + header().tables[table].offset);
+    }
+
+    template<class T>
+    const T* records(DataPackRange range, DataPackTable table) const {
+        return records<T>(table) + range.offset;
+    }
+
+    std::string getString(DataPackRange range) const {
+        return std::string(records<char>(DATA_PACK_STRINGS) + range.offset, range.count);
+    }
+
+private:
+    const DataPackHeader& header() const { return *reinterpret_cast<const DataPackHeader*>(data); }
+    bool validateRanges() const;
+};
+
+// The pack at DATA_PACK_PATH, mapped on first use. Exits if it cannot be opened, the bot cannot run without it.
+const DataPack& getDataPack();
@@ -1,6 +1,5 @@
 #include "mappings.h"
 #include <iostream>
-#include "../generated/abilities.h"
 #include "../utilities/predicates.h"
 #include "sc2api/sc2_agent.h"
 #include "sc2api/sc2_api.h"
@@ -27,6 +26,12 @@ static vector<bool> mIsStructure;
 static vector<UPGRADE_ID> mUpgradeUpgradeDependency;
 static vector<UNIT_TYPEID> mUpgradeUnitDependency;
 
+// Loaded from the data pack
+static vector<pair<int,int>> unit_type_has_ability;
+static vector<pair<float,float>> unit_type_initial_health;
+static vector<bool> unit_type_is_flying;
+static vector<float> unit_type_radius;
+
 static bool mappingInitialized = false;
 
 UNIT_TYPEID canonicalize(UNIT_TYPEID unitType) {
@@ -370,6 +375,7 @@ void initMappings(const ObservationInterface* observation) {
     mUnitTypes = observation->GetUnitTypeData();
     mAbilities = observation->GetAbilityData();
     mUpgrades = observation->GetUpgradeData();
+    load_unit_tables(unit_type_has_ability, unit_type_initial_health, unit_type_is_flying, unit_type_radius);
     init();
 }
 
@@ -379,6 +385,7 @@ void initMappings() {
     mUnitTypes = load_unit_data();
     mAbilities = load_ability_data();
     mUpgrades = load_upgrade_data();
+    load_unit_tables(unit_type_has_ability, unit_type_initial_health, unit_type_is_flying, unit_type_radius);
     init();
 }
 
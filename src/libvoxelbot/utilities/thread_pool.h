@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A fixed set of worker threads that run the iterations of a loop in parallel.
+// The calling thread takes part in the work, so a pool with a single thread runs everything on the caller.
+
+struct ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable startCondition;
+    std::condition_variable doneCondition;
+    const std::function<void(int)>* task = nullptr;
+    int taskCount = 0;
+    std::atomic<int> nextTask;
+    int busyWorkers = 0;
+    int generation = 0;
+    bool stopping = false;
+
+    void runTasks() {
+        for (int i = nextTask++; i < taskCount; i = nextTask++) (*task)(i);
+    }
+
+    void workerLoop() {
+        int lastGeneration = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                startCondition.wait(lock, [&] { return stopping || generation != lastGeneration; });
+                if (stopping) return;
+                lastGeneration = generation;
+            }
+
+            runTasks();
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (--busyWorkers == 0) doneCondition.notify_one();
+        }
+    }
+
+public:
+    explicit ThreadPool(int threadCount) : nextTask(0) {
+        for (int i = 1; i < threadCount; i++) workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+
+    ThreadPool(const ThreadPool& x) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        startCondition.notify_all();
+        for (auto& worker : workers) worker.join();
+    }
+
+    int size() const {
+        return (int)workers.size() + 1;
+    }
+
+    /** Calls task(i) for every i in [0, count) and returns once all of them are done */
+    void parallelFor(int count, const std::function<void(int)>& task) {
+        if (workers.empty() || count <= 1) {
+            for (int i = 0; i < count; i++) task(i);
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            this->task = &task;
+            taskCount = count;
+            nextTask = 0;
+            busyWorkers = (int)workers.size();
+            generation++;
+        }
+        startCondition.notify_all();
+
+        runTasks();
+
+        std::unique_lock<std::mutex> lock(mutex);
+        doneCondition.wait(lock, [&] { return busyWorkers == 0; });
+        this->task = nullptr;
+    }
+};
@@ -1,9 +1,6 @@
 #include "unit_data_caching.h"
-#include "../generated/units_data.h"
-#include "../generated/upgrades_data.h"
-#include "../generated/abilities_data.h"
+#include "data_pack.h"
 #include <string>
-#include <sstream>
 #include <cereal/archives/binary.hpp>
 #include <cereal/types/string.hpp>
 #include "sc2_serialization.h"
@@ -69,13 +66,7 @@ void save_unit_data(const vector<UnitTypeData>& unit_types, string path) {
     stream.close();
 }
 
-std::vector<sc2::UnitTypeData> load_unit_data() {
-    // auto stream = ifstream(UNIT_DATA_CACHE_PATH);
-	auto stream = stringstream(string((char*)LIBVOXELBOT_DATA_UNITS, LIBVOXELBOT_DATA_UNITS_SIZE));
-    if (!stream) {
-        cerr << "Could not open unit data cache file at " << UNIT_DATA_CACHE_PATH << endl;
-        exit(1);
-    }
+std::vector<sc2::UnitTypeData> parse_unit_data(istream& stream) {
     int nUnits;
     stream >> nUnits;
     vector<UnitTypeData> unit_types(nUnits);
@@ -150,7 +141,6 @@ std::vector<sc2::UnitTypeData> load_unit_data() {
         type.tech_requirement = (UNIT_TYPEID)tech_req;
         stream >> type.require_attached;
     }
-    //stream.close();
 
     // Some sanity checks
     assert(unit_types[(int)UNIT_TYPEID::ZERG_OVERLORD].food_provided == 8);
@@ -233,20 +223,12 @@ void save_ability_data(vector<AbilityData> abilities) {
     file.close();
 }
 
-std::vector<sc2::AbilityData> load_ability_data() {
-	auto file = stringstream(string((char*)LIBVOXELBOT_DATA_ABILITIES, LIBVOXELBOT_DATA_ABILITIES_SIZE));
-    // std::ifstream file(ABILITY_DATA_CACHE_PATH, std::ios::binary);
-    if (!file) {
-        cerr << "Could not open unit data cache file at " << ABILITY_DATA_CACHE_PATH << endl;
-        exit(1);
-    }
-
+std::vector<sc2::AbilityData> parse_ability_data(istream& file) {
     vector<SerializableAbility> abilities2;
     {
         cereal::BinaryInputArchive archive(file);
         archive(abilities2);
     }
-    //file.close();
 
     vector<AbilityData> abilities;
     for (auto& a : abilities2) {
@@ -285,19 +267,141 @@ void save_upgrade_data(vector<UpgradeData> upgrades) {
 }
 
 
-std::vector<sc2::UpgradeData> load_upgrade_data() {
-	auto file = stringstream(string((char*)LIBVOXELBOT_DATA_UPGRADES, LIBVOXELBOT_DATA_UPGRADES_SIZE));
-    // std::ifstream file(UPGRADE_DATA_CACHE_PATH, std::ios::binary);
-    if (!file) {
-        cerr << "Could not open upgrade data cache file at " << UPGRADE_DATA_CACHE_PATH << endl;
-        exit(1);
-    }
-
+std::vector<sc2::UpgradeData> parse_upgrade_data(istream& file) {
     vector<sc2::UpgradeData> upgrades;
     {
         cereal::BinaryInputArchive archive(file);
         archive(upgrades);
     }
-    //file.close();
     return upgrades;
 }
+
+static vector<int> packedIds(const DataPack& pack, DataPackRange range) {
+    const int32_t* ids = pack.records<int32_t>(range, DATA_PACK_IDS);
+    return vector<int>(ids, ids + range.count);
+}
+
+std::vector<sc2::UnitTypeData> load_unit_data() {
+    const DataPack& pack = getDataPack();
+    const PackedUnitType* packedTypes = pack.records<PackedUnitType>(DATA_PACK_UNIT_TYPES);
+    vector<UnitTypeData> unit_types(pack.count(DATA_PACK_UNIT_TYPES));
+    for (size_t i = 0; i < unit_types.size(); i++) {
+        const PackedUnitType& packed = packedTypes[i];
+        UnitTypeData& type = unit_types[i];
+        type.unit_type_id = (UNIT_TYPEID)packed.unit_type_id;
+        type.name = pack.getString(packed.name);
+        type.available = packed.available != 0;
+        type.cargo_size = packed.cargo_size;
+        type.mineral_cost = packed.mineral_cost;
+        type.vespene_cost = packed.vespene_cost;
+        for (int a : packedIds(pack, packed.attributes)) {
+            type.attributes.push_back((Attribute)a);
+        }
+        type.movement_speed = packed.movement_speed;
+        type.armor = packed.armor;
+
+        const PackedWeapon* packedWeapons = pack.records<PackedWeapon>(packed.weapons, DATA_PACK_WEAPONS);
+        type.weapons = vector<Weapon>(packed.weapons.count);
+        for (size_t j = 0; j < type.weapons.size(); j++) {
+            const PackedWeapon& packedWeapon = packedWeapons[j];
+            Weapon& w = type.weapons[j];
+            w.type = (Weapon::TargetType)packedWeapon.type;
+            w.damage_ = packedWeapon.damage;
+            const PackedDamageBonus* bonuses = pack.records<PackedDamageBonus>(packedWeapon.damage_bonus, DATA_PACK_DAMAGE_BONUSES);
+            w.damage_bonus = vector<DamageBonus>(packedWeapon.damage_bonus.count);
+            for (size_t k = 0; k < w.damage_bonus.size(); k++) {
+                w.damage_bonus[k].attribute = (Attribute)bonuses[k].attribute;
+                w.damage_bonus[k].bonus = bonuses[k].bonus;
+            }
+            w.attacks = packedWeapon.attacks;
+            w.range = packedWeapon.range;
+            w.speed = packedWeapon.speed;
+        }
+
+        type.food_required = packed.food_required;
+        type.food_provided = packed.food_provided;
+        type.ability_id = (ABILITY_ID)packed.ability_id;
+        type.race = (Race)packed.race;
+        type.build_time = packed.build_time;
+        type.has_minerals = packed.has_minerals != 0;
+        type.has_vespene = packed.has_vespene != 0;
+        type.sight_range = packed.sight_range;
+        for (int a : packedIds(pack, packed.tech_alias)) {
+            type.tech_alias.push_back((UNIT_TYPEID)a);
+        }
+        type.unit_alias = (UNIT_TYPEID)packed.unit_alias;
+        type.tech_requirement = (UNIT_TYPEID)packed.tech_requirement;
+        type.require_attached = packed.require_attached != 0;
+    }
+
+    assert(unit_types[(int)UNIT_TYPEID::ZERG_OVERLORD].food_provided == 8);
+    assert(unit_types[(int)UNIT_TYPEID::TERRAN_SCV].mineral_cost == 50);
+    assert(unit_types[(int)UNIT_TYPEID::ZERG_ROACH].ability_id == ABILITY_ID::TRAIN_ROACH);
+    return unit_types;
+}
+
+std::vector<sc2::AbilityData> load_ability_data() {
+    const DataPack& pack = getDataPack();
+    const PackedAbility* packedAbilities = pack.records<PackedAbility>(DATA_PACK_ABILITIES);
+    vector<AbilityData> abilities(pack.count(DATA_PACK_ABILITIES));
+    for (size_t i = 0; i < abilities.size(); i++) {
+        const PackedAbility& packed = packedAbilities[i];
+        AbilityData& a = abilities[i];
+        a.available = packed.available != 0;
+        a.ability_id = packed.ability_id;
+        a.link_name = pack.getString(packed.link_name);
+        a.link_index = packed.link_index;
+        a.button_name = pack.getString(packed.button_name);
+        a.friendly_name = pack.getString(packed.friendly_name);
+        a.hotkey = pack.getString(packed.hotkey);
+        a.remaps_to_ability_id = packed.remaps_to_ability_id;
+        for (int id : packedIds(pack, packed.remaps_from_ability_id)) {
+            a.remaps_from_ability_id.push_back((uint32_t)id);
+        }
+        a.target = (AbilityData::Target)packed.target;
+        a.allow_minimap = packed.allow_minimap != 0;
+        a.allow_autocast = packed.allow_autocast != 0;
+        a.is_building = packed.is_building != 0;
+        a.footprint_radius = packed.footprint_radius;
+        a.is_instant_placement = packed.is_instant_placement != 0;
+        a.cast_range = packed.cast_range;
+    }
+    return abilities;
+}
+
+std::vector<sc2::UpgradeData> load_upgrade_data() {
+    const DataPack& pack = getDataPack();
+    const PackedUpgrade* packedUpgrades = pack.records<PackedUpgrade>(DATA_PACK_UPGRADES);
+    vector<UpgradeData> upgrades(pack.count(DATA_PACK_UPGRADES));
+    for (size_t i = 0; i < upgrades.size(); i++) {
+        const PackedUpgrade& packed = packedUpgrades[i];
+        UpgradeData& u = upgrades[i];
+        u.upgrade_id = packed.upgrade_id;
+        u.name = pack.getString(packed.name);
+        u.mineral_cost = packed.mineral_cost;
+        u.vespene_cost = packed.vespene_cost;
+        u.ability_id = (ABILITY_ID)packed.ability_id;
+        u.research_time = packed.research_time;
+    }
+    return upgrades;
+}
+
+void load_unit_tables(vector<pair<int,int>>& unit_type_has_ability, vector<pair<float,float>>& unit_type_initial_health, vector<bool>& unit_type_is_flying, vector<float>& unit_type_radius) {
+    const DataPack& pack = getDataPack();
+    const PackedUnitAbility* unitAbilities = pack.records<PackedUnitAbility>(DATA_PACK_UNIT_ABILITIES);
+    unit_type_has_ability.clear();
+    for (uint32_t i = 0; i < pack.count(DATA_PACK_UNIT_ABILITIES); i++) {
+        unit_type_has_ability.push_back({ unitAbilities[i].unit_type_id, unitAbilities[i].ability_id });
+    }
+
+    const PackedUnitTable* unitTables = pack.records<PackedUnitTable>(DATA_PACK_UNIT_TABLES);
+    const uint32_t nUnits = pack.count(DATA_PACK_UNIT_TABLES);
+    unit_type_initial_health = vector<pair<float,float>>(nUnits);
+    unit_type_is_flying = vector<bool>(nUnits);
+    unit_type_radius = vector<float>(nUnits);
+    for (uint32_t i = 0; i < nUnits; i++) {
+        unit_type_initial_health[i] = { unitTables[i].initial_health, unitTables[i].initial_shield };
+        unit_type_is_flying[i] = unitTables[i].is_flying != 0;
+        unit_type_radius[i] = unitTables[i].radius;
+    }
+}
@@ -8,8 +8,16 @@ const std::string UPGRADE_DATA_CACHE_PATH = "sc2-libvoxelbot/libvoxelbot/generat
 const std::string ABILITY_DATA_CACHE_PATH = "sc2-libvoxelbot/libvoxelbot/generated/abilities.bin";
 
 void save_unit_data(const std::vector<sc2::UnitTypeData>& unit_types, std::string path=UNIT_DATA_CACHE_PATH);
-std::vector<sc2::UnitTypeData> load_unit_data();
 void save_ability_data(std::vector<sc2::AbilityData> abilities);
 void save_upgrade_data(std::vector<sc2::UpgradeData> upgrades);
+
+// Parse the files written by the save functions, only the data pack generator needs them
+std::vector<sc2::UnitTypeData> parse_unit_data(std::istream& stream);
+std::vector<sc2::AbilityData> parse_ability_data(std::istream& stream);
+std::vector<sc2::UpgradeData> parse_upgrade_data(std::istream& stream);
+
+// Read from the memory mapped data pack
+std::vector<sc2::UnitTypeData> load_unit_data();
 std::vector<sc2::AbilityData> load_ability_data();
-std::vector<sc2::UpgradeData> load_upgrade_data();
\ No newline at end of file
+std::vector<sc2::UpgradeData> load_upgrade_data();
+void load_unit_tables(std::vector<std::pair<int,int>>& unit_type_has_ability, std::vector<std::pair<float,float>>& unit_type_initial_health, std::vector<bool>& unit_type_is_flying, std::vector<float>& unit_type_radius);
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "CCBot.h"
 #include "JSONTools.h"
 #include "Util.h"
+#include "Logger.h"
 #include "LadderInterface.h"
 #include <cstdio>
 #include <csignal>
@@ -66,6 +67,8 @@ void handler(int sig) {
 	struct tm *timeinfo = localtime(&t);
 	strftime(buffer, sizeof(buffer), "%d-%m-%Y %H:%M:%S", timeinfo);
 	std::string str(buffer);
+	// Write the last logs before the stack trace
+	Logger::Flush();
 	std::cout << str << std::endl;
 
 	// print out all the frames to stderr
@@ -0,0 +1,151 @@
+#include "OfflineGame.h"
+#include "../CCBot.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+
+#ifdef ROBUST_MODE
+jmp_buf gBuffer;
+#endif
+
+// Replays a recorded snapshot through the bot without the game and reports the time spent in each manager.
+// Usage: MicroMachineBenchmark <snapshot> [--config <BotConfig.txt>] [--start <game loop>] [--frames <count>] [--seed <seed>] [--depth <depth>]
+namespace
+{
+	struct ProbeStats
+	{
+		std::string name;
+		int depth;
+		long long totalTime = 0;	// in microseconds
+		long long maxFrameTime = 0;
+		long long calls = 0;
+	};
+
+	void PrintUsage()
+	{
+		std::cerr << "Usage: MicroMachineBenchmark <snapshot> [--config <BotConfig.txt>] [--start <game loop>] [--frames <count>] [--seed <seed>] [--depth <depth>]" << std::endl;
+	}
+
+	long long GetPercentile(std::vector<long long> values, float percentile)
+	{
+		if (values.empty())
+			return 0;
+		const size_t index = std::min(values.size() - 1, size_t(percentile * values.size()));
+		std::nth_element(values.begin(), values.begin() + index, values.end());
+		return values[index];
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		PrintUsage();
+		return 1;
+	}
+	const std::string snapshotPath = argv[1];
+	std::string configPath = BotConfig().ConfigFileLocation;
+	uint32_t startLoop = 0;
+	size_t maxFrames = 0;
+	unsigned seed = 0;
+	int maxDepth = 2;		// OnStep, the managers and their main parts
+	for (int i = 2; i + 1 < argc; i += 2)
+	{
+		const std::string option = argv[i];
+		if (option == "--config")
+			configPath = argv[i + 1];
+		else if (option == "--start")
+			startLoop = std::strtoul(argv[i + 1], nullptr, 10);
+		else if (option == "--frames")
+			maxFrames = std::strtoul(argv[i + 1], nullptr, 10);
+		else if (option == "--seed")
+			seed = std::strtoul(argv[i + 1], nullptr, 10);
+		else if (option == "--depth")
+			maxDepth = std::atoi(argv[i + 1]);
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	OfflineGame game;
+	bool loaded = game.load(snapshotPath);
+	if (loaded)
+	{
+		// From the last key frame before it, a replay always starts with the state of a whole frame
+		game.seek(startLoop);
+		loaded = game.nextFrame();
+	}
+	if (!loaded)
+	{
+		std::cerr << "Could not read the snapshot " << snapshotPath << std::endl;
+		return 1;
+	}
+
+	std::srand(seed);
+	CCBot bot("MicroMachine", "offline", false);
+	bot.SetOpponentId("offline");
+	bot.Config().ConfigFileLocation = configPath;
+	bot.SetOfflineGame(&game, &game, &game);
+	bot.OnGameStart();
+
+	// The probes are merged by path, the same name can be found under different parents
+	std::vector<ProbeStats> probes;
+	std::map<std::string, size_t> probeIndices;
+	std::vector<std::string> path;
+	std::vector<long long> stepTimes;
+	do
+	{
+		bot.OnStep();
+
+		for (const auto & entry : Profiler::LastFrame())
+		{
+			path.resize(entry.depth);
+			path.push_back(*entry.name);
+			if (entry.depth > maxDepth || path.front() != "OnStep")
+				continue;
+			if (entry.depth == 0)
+				stepTimes.push_back(entry.frameTime);
+			std::string key;
+			for (const auto & name : path)
+				key += name + "/";
+			const auto it = probeIndices.find(key);
+			size_t index;
+			if (it == probeIndices.end())
+			{
+				index = probes.size();
+				probeIndices[key] = index;
+				probes.push_back(ProbeStats());
+				probes.back().name = *entry.name;
+				probes.back().depth = entry.depth;
+			}
+			else
+			{
+				index = it->second;
+			}
+			auto & probe = probes[index];
+			probe.totalTime += entry.frameTime;
+			probe.maxFrameTime = std::max(probe.maxFrameTime, entry.frameTime);
+			probe.calls += entry.frameCalls;
+		}
+	} while ((maxFrames == 0 || game.getFrameCount() < maxFrames) && game.nextFrame());
+
+	bot.OnGameEnd();
+
+	const size_t frames = game.getFrameCount();
+	std::cout << "Replayed " << frames << " frames of " << snapshotPath << std::endl;
+	std::cout << "Step (ms): p50 " << 0.001f * GetPercentile(stepTimes, 0.5f) << ", p99 " << 0.001f * GetPercentile(stepTimes, 0.99f) << ", max " << 0.001f * GetPercentile(stepTimes, 1.f) << std::endl;
+	std::cout << std::left << std::setw(56) << "Probe" << std::right << std::setw(12) << "total (ms)" << std::setw(12) << "avg (ms)" << std::setw(12) << "max (ms)" << std::setw(12) << "calls" << std::endl;
+	std::cout << std::fixed << std::setprecision(3);
+	for (const auto & probe : probes)
+	{
+		std::cout << std::left << std::setw(56) << std::string(2 * probe.depth, ' ') + probe.name << std::right
+			<< std::setw(12) << 0.001 * probe.totalTime
+			<< std::setw(12) << 0.001 * probe.totalTime / frames
+			<< std::setw(12) << 0.001 * probe.maxFrameTime
+			<< std::setw(12) << probe.calls << std::endl;
+	}
+	std::cout << "Commands: " << game.getCommandCount() << ", digest " << std::hex << game.getCommandsDigest() << std::dec << std::endl;
+	return 0;
+}
@@ -0,0 +1,311 @@
+#include "OfflineGame.h"
+#include "../CCBot.h"
+#include "../DistanceMap.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+
+#ifdef ROBUST_MODE
+jmp_buf gBuffer;
+#endif
+
+// Times the hot functions of the bot on a fixture, the state of the bot at a game loop of a recorded snapshot.
+// Each case runs in batches long enough to be measured by the clock, the time per call of each batch is a sample, and the
+// statistics of the samples are written as JSON, so a change can be compared before and after on the same machine with the same fixture.
+// Usage: MicroMachineMicroBenchmarks <snapshot> [--config <BotConfig.txt>] [--start <game loop>] [--samples <count>] [--filter <text>] [--output <file.json>]
+
+// Friend of CombatCommander to time its influence maps
+class MicroBenchmarks
+{
+public:
+
+	static void UpdateInfluenceMaps(CCBot & bot) { bot.Commander().Combat().updateInfluenceMaps(); }
+};
+
+namespace
+{
+	const auto WARMUP_TIME = std::chrono::milliseconds(50);
+	const auto MIN_BATCH_TIME = std::chrono::milliseconds(2);	// much longer than the resolution of the clock
+	const size_t MAX_BATCH_SIZE = 1 << 20;
+
+	struct BenchmarkCase
+	{
+		std::string name;
+		std::function<void()> run;		// empty when the fixture has nothing for that case
+	};
+
+	void PrintUsage()
+	{
+		std::cerr << "Usage: MicroMachineMicroBenchmarks <snapshot> [--config <BotConfig.txt>] [--start <game loop>] [--samples <count>] [--filter <text>] [--output <file.json>]" << std::endl;
+	}
+
+	double RunBatch(const std::function<void()> & run, size_t batchSize)
+	{
+		const auto startTime = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < batchSize; ++i)
+			run();
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - startTime).count();
+	}
+
+	// Value at that rank of the sorted samples, interpolated between the two closest ones
+	double GetQuantile(const std::vector<double> & sortedSamples, double quantile)
+	{
+		const double rank = quantile * (sortedSamples.size() - 1);
+		const size_t lower = size_t(rank);
+		const size_t upper = std::min(lower + 1, sortedSamples.size() - 1);
+		return sortedSamples[lower] + (rank - lower) * (sortedSamples[upper] - sortedSamples[lower]);
+	}
+
+	json Measure(const BenchmarkCase & benchmarkCase, size_t sampleCount)
+	{
+		json result;
+		result["name"] = benchmarkCase.name;
+		if (!benchmarkCase.run)
+		{
+			result["skipped"] = true;
+			return result;
+		}
+
+		// Warm up the caches and the lazy initializations, then find a batch size that takes long enough to be timed
+		const auto warmupStart = std::chrono::steady_clock::now();
+		do
+		{
+			benchmarkCase.run();
+		} while (std::chrono::steady_clock::now() - warmupStart < WARMUP_TIME);
+		size_t batchSize = 1;
+		while (batchSize < MAX_BATCH_SIZE && RunBatch(benchmarkCase.run, batchSize) < std::chrono::duration<double, std::nano>(MIN_BATCH_TIME).count())
+			batchSize *= 2;
+
+		std::vector<double> samples;
+		for (size_t i = 0; i < sampleCount; ++i)
+			samples.push_back(RunBatch(benchmarkCase.run, batchSize) / batchSize);
+		std::sort(samples.begin(), samples.end());
+
+		const size_t n = samples.size();
+		double mean = 0;
+		for (const auto sample : samples)
+			mean += sample;
+		mean /= n;
+		double variance = 0;
+		for (const auto sample : samples)
+			variance += (sample - mean) * (sample - mean);
+		const double standardDeviation = n > 1 ? std::sqrt(variance / (n - 1)) : 0;
+		const double median = GetQuantile(samples, 0.5);
+		std::vector<double> deviations;
+		for (const auto sample : samples)
+			deviations.push_back(std::abs(sample - median));
+		std::sort(deviations.begin(), deviations.end());
+		const double medianAbsoluteDeviation = GetQuantile(deviations, 0.5);
+		// Distribution free 95% confidence interval of the median, from the ranks of the binomial distribution
+		const double halfWidth = 0.98 * std::sqrt(double(n));
+		const size_t lowerRank = size_t(std::max(0.0, std::floor(n / 2.0 - halfWidth)));
+		const size_t upperRank = std::min(n - 1, size_t(std::ceil(n / 2.0 + halfWidth)));
+		// Outliers are usually the scheduler or a cache flush, they are counted but kept in the samples
+		const double outlierDistance = 3 * 1.4826 * medianAbsoluteDeviation;
+		size_t outliers = 0;
+		for (const auto sample : samples)
+		{
+			if (std::abs(sample - median) > outlierDistance)
+				++outliers;
+		}
+
+		result["batch_size"] = batchSize;
+		result["samples"] = n;
+		result["min_ns"] = samples.front();
+		result["median_ns"] = median;
+		result["median_ci95_ns"] = { samples[lowerRank], samples[upperRank] };
+		result["mean_ns"] = mean;
+		result["stddev_ns"] = standardDeviation;
+		result["mad_ns"] = medianAbsoluteDeviation;
+		result["p95_ns"] = GetQuantile(samples, 0.95);
+		result["max_ns"] = samples.back();
+		result["outliers"] = outliers;
+		return result;
+	}
+
+	sc2::Units GetUnitPtrs(const std::vector<Unit> & units)
+	{
+		sc2::Units unitPtrs;
+		for (const auto & unit : units)
+			unitPtrs.push_back(unit.getUnitPtr());
+		return unitPtrs;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		PrintUsage();
+		return 1;
+	}
+	const std::string snapshotPath = argv[1];
+	std::string configPath = BotConfig().ConfigFileLocation;
+	uint32_t startLoop = 0;
+	size_t sampleCount = 30;
+	std::string filter;
+	std::string outputPath;
+	for (int i = 2; i + 1 < argc; i += 2)
+	{
+		const std::string option = argv[i];
+		if (option == "--config")
+			configPath = argv[i + 1];
+		else if (option == "--start")
+			startLoop = std::strtoul(argv[i + 1], nullptr, 10);
+		else if (option == "--samples")
+			sampleCount = std::max(1ul, std::strtoul(argv[i + 1], nullptr, 10));
+		else if (option == "--filter")
+			filter = argv[i + 1];
+		else if (option == "--output")
+			outputPath = argv[i + 1];
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	// The fixture: the bot replays the snapshot from the key frame before the start until the start,
+	// so the managers have the state they had during the game
+	OfflineGame game;
+	bool loaded = game.load(snapshotPath);
+	if (loaded)
+	{
+		game.seek(startLoop);
+		loaded = game.nextFrame();
+	}
+	if (!loaded)
+	{
+		std::cerr << "Could not read the snapshot " << snapshotPath << std::endl;
+		return 1;
+	}
+
+	std::srand(0);
+	CCBot bot("MicroMachine", "offline", false);
+	bot.SetOpponentId("offline");
+	bot.Config().ConfigFileLocation = configPath;
+	bot.SetOfflineGame(&game, &game, &game);
+	bot.OnGameStart();
+	bot.OnStep();
+	while (game.GetGameLoop() < startLoop && game.nextFrame())
+		bot.OnStep();
+
+	// Our army, or our workers when there is none yet, against the known enemies
+	sc2::Units allyUnits = GetUnitPtrs(bot.Commander().Combat().GetCombatUnits());
+	if (allyUnits.empty())
+	{
+		for (const auto & unit : bot.UnitInfo().getUnits(Players::Self))
+		{
+			if (unit.getType().isWorker())
+				allyUnits.push_back(unit.getUnitPtr());
+		}
+	}
+	const sc2::Units enemyUnits = GetUnitPtrs(bot.GetKnownEnemyUnits());
+	const sc2::Unit * groundUnit = nullptr;
+	for (const auto unit : allyUnits)
+	{
+		if (!unit->is_flying)
+		{
+			groundUnit = unit;
+			break;
+		}
+	}
+	const sc2::Unit * closestEnemy = groundUnit && !enemyUnits.empty() ? *std::min_element(enemyUnits.begin(), enemyUnits.end(), [groundUnit](const sc2::Unit * a, const sc2::Unit * b)
+	{
+		return Util::DistSq(a->pos, groundUnit->pos) < Util::DistSq(b->pos, groundUnit->pos);
+	}) : nullptr;
+	const CCPosition enemyBase = bot.GetEnemyStartLocations().empty() ? CCPosition() : bot.GetEnemyStartLocations()[0];
+	const Building supplyDepot(MetaTypeEnum::SupplyDepot.getUnitType(), Util::GetTilePosition(bot.GetStartLocation()));
+	const std::vector<sc2::UNIT_TYPEID> noSpecialTypes;
+
+	const std::vector<BenchmarkCase> cases =
+	{
+		{ "Util::PathFinding::FindOptimalPath (to target)", !closestEnemy ? std::function<void()>() : [&]()
+			{
+				Util::PathFinding::FindOptimalPath(groundUnit, closestEnemy->pos, CCPosition(), Util::GetAttackRangeForTarget(groundUnit, closestEnemy, bot), false, false, true, false, 0.f, false, false, bot);
+			} },
+		{ "Util::PathFinding::FindOptimalPathToSafety", !groundUnit ? std::function<void()>() : [&]()
+			{
+				Util::PathFinding::FindOptimalPathToSafety(groundUnit, bot.GetStartLocation(), false, bot);
+			} },
+		{ "Util::PathFinding::FindEngagePosition", !closestEnemy ? std::function<void()>() : [&]()
+			{
+				Util::PathFinding::FindEngagePosition(groundUnit, closestEnemy, Util::GetAttackRangeForTarget(groundUnit, closestEnemy, bot), bot);
+			} },
+		{ "Util::PathFinding::FindOptimalPathWithoutLimit (to enemy base)", !groundUnit || enemyBase == CCPosition() ? std::function<void()>() : [&]()
+			{
+				Util::PathFinding::FindOptimalPathWithoutLimit(groundUnit, enemyBase, bot);
+			} },
+		{ "Util::getThreats", allyUnits.empty() || enemyUnits.empty() ? std::function<void()>() : [&]()
+			{
+				sc2::Units threats;
+				for (const auto unit : allyUnits)
+				{
+					threats.clear();
+					Util::getThreats(unit, enemyUnits, threats, bot);
+				}
+			} },
+		{ "Util::GetUnitClusters", allyUnits.empty() ? std::function<void()>() : [&]()
+			{
+				Util::GetUnitClusters(allyUnits, noSpecialTypes, true, bot);
+			} },
+		{ "Util::SimulateCombat", allyUnits.empty() || enemyUnits.empty() ? std::function<void()>() : [&]()
+			{
+				Util::SimulateCombat(allyUnits, enemyUnits, false, true, bot);
+			} },
+		{ "CombatCommander::updateInfluenceMaps", [&]()
+			{
+				MicroBenchmarks::UpdateInfluenceMaps(bot);
+			} },
+		{ "DistanceMap::computeDistanceMap", [&]()
+			{
+				DistanceMap distanceMap;
+				distanceMap.computeDistanceMap(bot, Util::GetTilePosition(bot.GetStartLocation()));
+			} },
+		{ "BuildingPlacer::getBuildLocationNear (supply depot)", [&]()
+			{
+				bot.Buildings().getBuildingPlacer().getBuildLocationNear(supplyDepot, false, true, true);
+			} }
+	};
+
+	json results;
+	results["snapshot"] = snapshotPath;
+	results["map"] = Util::GetMapName();
+	results["game_loop"] = game.GetGameLoop();
+	results["ally_units"] = allyUnits.size();
+	results["enemy_units"] = enemyUnits.size();
+	results["cases"] = json::array();
+	for (const auto & benchmarkCase : cases)
+	{
+		if (!filter.empty() && benchmarkCase.name.find(filter) == std::string::npos)
+			continue;
+		const auto result = Measure(benchmarkCase, sampleCount);
+		results["cases"].push_back(result);
+		std::cerr << std::left << std::setw(64) << benchmarkCase.name << std::right;
+		if (result.count("skipped"))
+			std::cerr << "skipped, nothing to run it on in the fixture" << std::endl;
+		else
+			std::cerr << std::setw(14) << std::fixed << std::setprecision(0) << result["median_ns"].get<double>() << " ns (median)" << std::endl;
+	}
+
+	bot.OnGameEnd();
+
+	if (outputPath.empty())
+	{
+		std::cout << results.dump(4) << std::endl;
+	}
+	else
+	{
+		std::ofstream output(outputPath);
+		output << results.dump(4) << std::endl;
+		if (!output)
+		{
+			std::cerr << "Could not write " << outputPath << std::endl;
+			return 1;
+		}
+	}
+	return 0;
+}
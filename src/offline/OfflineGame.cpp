@@ -0,0 +1,203 @@
+#include "OfflineGame.h"
+#include "../libvoxelbot/utilities/unit_data_caching.h"
+#include <cmath>
+
+bool OfflineGame::load(const std::string & path)
+{
+	if (!m_reader.open(path, m_header))
+		return false;
+	m_unitTypes = load_unit_data();
+	m_abilities = load_ability_data();
+	m_upgrades = load_upgrade_data();
+	return true;
+}
+
+bool OfflineGame::nextFrame()
+{
+	if (!m_reader.readFrame())
+		return false;
+	++m_frameCount;
+
+	// Like in the API, the units that are not in the frame keep their last state and the dead ones are only flagged
+	m_units.clear();
+	for (const auto & recordedUnit : m_frame->units)
+	{
+		auto & unit = m_unitPool[recordedUnit.tag];
+		if (!unit)
+			unit.reset(new sc2::Unit());
+		*unit = recordedUnit;
+		m_units.push_back(unit.get());
+	}
+	for (const auto tag : m_frame->deadUnits)
+	{
+		const auto it = m_unitPool.find(tag);
+		if (it != m_unitPool.end())
+			it->second->is_alive = false;
+	}
+
+	m_unitAbilities.clear();
+	for (size_t i = 0; i < m_frame->abilities.size(); ++i)
+		m_unitAbilities[m_frame->abilities[i].unit_tag] = i;
+
+	// The actions of the previous step were sent by the game
+	m_commands.clear();
+	m_requestAction.Clear();
+	return true;
+}
+
+const sc2::Unit * OfflineGame::GetUnit(sc2::Tag tag) const
+{
+	const auto it = m_unitPool.find(tag);
+	return it == m_unitPool.end() ? nullptr : it->second.get();
+}
+
+int OfflineGame::getTileIndex(const sc2::Point2D & point) const
+{
+	const int x = int(point.x);
+	const int y = int(point.y);
+	if (x < 0 || y < 0 || x >= m_header.gameInfo.width || y >= m_header.gameInfo.height)
+		return -1;
+	return x + y * m_header.gameInfo.width;
+}
+
+bool OfflineGame::HasCreep(const sc2::Point2D & point) const
+{
+	const int index = getTileIndex(point);
+	return index >= 0 && index < int(m_frame->creep.size()) && m_frame->creep[index] != 0;
+}
+
+sc2::Visibility OfflineGame::GetVisibility(const sc2::Point2D & point) const
+{
+	const int index = getTileIndex(point);
+	return index >= 0 && index < int(m_frame->visibility.size()) ? sc2::Visibility(m_frame->visibility[index]) : sc2::Visibility::Hidden;
+}
+
+bool OfflineGame::IsPathable(const sc2::Point2D & point) const
+{
+	const int index = getTileIndex(point);
+	return index >= 0 && index < int(m_header.pathable.size()) && m_header.pathable[index] != 0;
+}
+
+bool OfflineGame::IsPlacable(const sc2::Point2D & point) const
+{
+	const int index = getTileIndex(point);
+	return index >= 0 && index < int(m_header.placable.size()) && m_header.placable[index] != 0;
+}
+
+sc2::AvailableAbilities OfflineGame::GetAbilitiesForUnit(const sc2::Unit * unit, bool ignore_resource_requirements)
+{
+	const auto it = m_unitAbilities.find(unit->tag);
+	if (it != m_unitAbilities.end())
+		return m_frame->abilities[it->second];
+	sc2::AvailableAbilities abilities;
+	abilities.unit_tag = unit->tag;
+	abilities.unit_type_id = unit->unit_type;
+	return abilities;
+}
+
+std::vector<sc2::AvailableAbilities> OfflineGame::GetAbilitiesForUnits(const sc2::Units & units, bool ignore_resource_requirements)
+{
+	std::vector<sc2::AvailableAbilities> abilities;
+	abilities.reserve(units.size());
+	for (const auto unit : units)
+		abilities.push_back(GetAbilitiesForUnit(unit, ignore_resource_requirements));
+	return abilities;
+}
+
+bool OfflineGame::Placement(const sc2::AbilityID & ability, const sc2::Point2D & target_pos, const sc2::Unit * unit)
+{
+	for (const auto & placement : m_frame->placements)
+	{
+		if (placement.ability == ability && std::abs(placement.position.x - target_pos.x) < 0.01f && std::abs(placement.position.y - target_pos.y) < 0.01f)
+			return placement.result;
+	}
+
+	const uint32_t abilityId = ability;
+	const float footprintRadius = abilityId < m_abilities.size() ? m_abilities[abilityId].footprint_radius : 0.f;
+	const bool refinery = ability == sc2::ABILITY_ID::BUILD_REFINERY || ability == sc2::ABILITY_ID::BUILD_ASSIMILATOR || ability == sc2::ABILITY_ID::BUILD_EXTRACTOR;
+	bool onGeyser = false;
+	for (const auto other : m_units)
+	{
+		if (other == unit || other->is_flying)
+			continue;
+		const float range = footprintRadius + other->radius;
+		if (std::abs(other->pos.x - target_pos.x) >= range || std::abs(other->pos.y - target_pos.y) >= range)
+			continue;
+		// The refineries are placed on a free geyser, the geysers that have one are not neutral anymore
+		if (refinery && other->alliance == sc2::Unit::Alliance::Neutral && other->vespene_contents > 0)
+		{
+			onGeyser = true;
+			continue;
+		}
+		return false;
+	}
+	if (refinery)
+		return onGeyser;
+
+	for (float x = target_pos.x - footprintRadius + 0.5f; x < target_pos.x + footprintRadius; ++x)
+	{
+		for (float y = target_pos.y - footprintRadius + 0.5f; y < target_pos.y + footprintRadius; ++y)
+		{
+			if (!IsPlacable(sc2::Point2D(x, y)))
+				return false;
+		}
+	}
+	return true;
+}
+
+void OfflineGame::addCommand(sc2::Tag tag, sc2::AbilityID ability, uint64_t target)
+{
+	// FNV-1a
+	const uint64_t values[] = { m_frame->gameLoop, tag, uint32_t(ability), target };
+	for (const auto value : values)
+	{
+		m_commandsDigest ^= value;
+		m_commandsDigest *= 1099511628211ull;
+	}
+	m_commands.push_back(tag);
+	++m_commandCount;
+}
+
+void OfflineGame::UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, bool queued_command)
+{
+	addCommand(unit->tag, ability, 0);
+}
+
+void OfflineGame::UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, const sc2::Point2D & point, bool queued_command)
+{
+	addCommand(unit->tag, ability, uint64_t(point.x * 256) << 32 | uint32_t(point.y * 256));
+}
+
+void OfflineGame::UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, const sc2::Unit * target, bool queued_command)
+{
+	addCommand(unit->tag, ability, target->tag);
+}
+
+void OfflineGame::UnitCommand(const sc2::Units & units, sc2::AbilityID ability, bool queued_move)
+{
+	for (const auto unit : units)
+		UnitCommand(unit, ability, queued_move);
+}
+
+void OfflineGame::UnitCommand(const sc2::Units & units, sc2::AbilityID ability, const sc2::Point2D & point, bool queued_command)
+{
+	for (const auto unit : units)
+		UnitCommand(unit, ability, point, queued_command);
+}
+
+void OfflineGame::UnitCommand(const sc2::Units & units, sc2::AbilityID ability, const sc2::Unit * target, bool queued_command)
+{
+	for (const auto unit : units)
+		UnitCommand(unit, ability, target, queued_command);
+}
+
+void OfflineGame::ToggleAutocast(sc2::Tag unit_tag, sc2::AbilityID ability)
+{
+	addCommand(unit_tag, ability, 0);
+}
+
+void OfflineGame::SendActions()
+{
+	m_commandCount += m_requestAction.actions_size();
+	m_requestAction.Clear();
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "../GameInterfaces.h"
+#include "../GameSnapshot.h"
+#include "s2clientprotocol/sc2api.pb.h"
+#include <memory>
+#include <unordered_map>
+
+// Stands in for the game by replaying a recorded snapshot (see GameSnapshotRecorder), one frame per step of the bot.
+// The commands of the bot are only counted, the next frame is always the recorded one, so a replay is deterministic.
+// The static data (unit types, abilities and upgrades) come from the tables generated for libvoxelbot.
+class OfflineGame : public GameObservation, public GameQuery, public GameActions
+{
+	GameSnapshotReader m_reader;
+	GameSnapshotHeader m_header;
+	const GameSnapshotFrame * m_frame = &m_reader.getFrame();
+	sc2::UnitTypes m_unitTypes;
+	sc2::Abilities m_abilities;
+	sc2::Upgrades m_upgrades;
+	std::unordered_map<sc2::Tag, std::unique_ptr<sc2::Unit>> m_unitPool;	// like the API, a unit keeps its address for the whole game
+	sc2::Units m_units;														// in the current frame
+	std::unordered_map<sc2::Tag, size_t> m_unitAbilities;					// index in the abilities of the frame
+	std::vector<sc2::Tag> m_commands;
+	SC2APIProtocol::RequestAction m_requestAction;
+	size_t m_frameCount = 0;
+	size_t m_commandCount = 0;
+	uint64_t m_commandsDigest = 14695981039346656037ull;
+
+	void addCommand(sc2::Tag tag, sc2::AbilityID ability, uint64_t target);
+	int getTileIndex(const sc2::Point2D & point) const;
+
+public:
+
+	bool load(const std::string & path);
+	// Makes the next recorded frame the current one, false at the end of the snapshot
+	bool nextFrame();
+	// The next frame will be the last key frame at or before that game loop, the replay can start from there
+	void seek(uint32_t gameLoop) { m_reader.seek(gameLoop); }
+
+	size_t getFrameCount() const { return m_frameCount; }
+	size_t getCommandCount() const { return m_commandCount; }
+	// Hash of every command given during the replay, equal between two replays where the bot took the same decisions
+	uint64_t getCommandsDigest() const { return m_commandsDigest; }
+
+	uint32_t GetPlayerID() const override { return m_header.playerId; }
+	uint32_t GetGameLoop() const override { return m_frame->gameLoop; }
+	sc2::Units GetUnits() const override { return m_units; }
+	const sc2::Unit * GetUnit(sc2::Tag tag) const override;
+	const std::vector<sc2::PowerSource> & GetPowerSources() const override { return m_frame->powerSources; }
+	const std::vector<sc2::Effect> & GetEffects() const override { return m_frame->effects; }
+	const sc2::Score & GetScore() const override { return m_frame->score; }
+	const sc2::Abilities & GetAbilityData(bool force_refresh = false) const override { return m_abilities; }
+	const sc2::UnitTypes & GetUnitTypeData(bool force_refresh = false) const override { return m_unitTypes; }
+	const sc2::Upgrades & GetUpgradeData(bool force_refresh = false) const override { return m_upgrades; }
+	const sc2::Buffs & GetBuffData(bool force_refresh = false) const override { return m_header.buffs; }
+	const sc2::Effects & GetEffectData(bool force_refresh = false) const override { return m_header.effects; }
+	const sc2::GameInfo & GetGameInfo() const override { return m_header.gameInfo; }
+	int32_t GetMinerals() const override { return m_frame->minerals; }
+	int32_t GetVespene() const override { return m_frame->vespene; }
+	int32_t GetFoodCap() const override { return m_frame->foodCap; }
+	int32_t GetFoodUsed() const override { return m_frame->foodUsed; }
+	sc2::Point2D GetCameraPos() const override { return m_frame->cameraPos; }
+	sc2::Point3D GetStartLocation() const override { return m_header.startLocation; }
+	std::vector<sc2::PlayerResult> GetResults() const override { return m_frame->results; }
+	bool HasCreep(const sc2::Point2D & point) const override;
+	sc2::Visibility GetVisibility(const sc2::Point2D & point) const override;
+	bool IsPathable(const sc2::Point2D & point) const override;
+	bool IsPlacable(const sc2::Point2D & point) const override;
+
+	// Answered from the abilities recorded for our units
+	sc2::AvailableAbilities GetAbilitiesForUnit(const sc2::Unit * unit, bool ignore_resource_requirements = false) override;
+	std::vector<sc2::AvailableAbilities> GetAbilitiesForUnits(const sc2::Units & units, bool ignore_resource_requirements = false) override;
+	// The recorded answer when the bot asked the same during the recording, else an approximation of the answer of the game
+	// from the placement grid and the ground units of the frame
+	bool Placement(const sc2::AbilityID & ability, const sc2::Point2D & target_pos, const sc2::Unit * unit = nullptr) override;
+
+	void UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, bool queued_command = false) override;
+	void UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, const sc2::Point2D & point, bool queued_command = false) override;
+	void UnitCommand(const sc2::Unit * unit, sc2::AbilityID ability, const sc2::Unit * target, bool queued_command = false) override;
+	void UnitCommand(const sc2::Units & units, sc2::AbilityID ability, bool queued_move = false) override;
+	void UnitCommand(const sc2::Units & units, sc2::AbilityID ability, const sc2::Point2D & point, bool queued_command = false) override;
+	void UnitCommand(const sc2::Units & units, sc2::AbilityID ability, const sc2::Unit * target, bool queued_command = false) override;
+	const std::vector<sc2::Tag> & Commands() const override { return m_commands; }
+	void ToggleAutocast(sc2::Tag unit_tag, sc2::AbilityID ability) override;
+	void SendChat(const std::string & message, sc2::ChatChannel channel = sc2::ChatChannel::All) override {}
+	SC2APIProtocol::RequestAction * GetRequestAction() override { return &m_requestAction; }
+	void SendActions() override;
+};